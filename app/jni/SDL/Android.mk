@@ -27,6 +27,7 @@ LOCAL_SRC_FILES := \
 	$(wildcard $(LOCAL_PATH)/src/camera/*.c) \
 	$(wildcard $(LOCAL_PATH)/src/camera/android/*.c) \
 	$(wildcard $(LOCAL_PATH)/src/camera/dummy/*.c) \
+	$(wildcard $(LOCAL_PATH)/src/camera/synthetic/*.c) \
 	$(wildcard $(LOCAL_PATH)/src/core/*.c) \
 	$(wildcard $(LOCAL_PATH)/src/core/android/*.c) \
 	$(wildcard $(LOCAL_PATH)/src/cpuinfo/*.c) \
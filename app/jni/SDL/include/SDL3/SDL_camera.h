@@ -101,6 +101,35 @@ typedef enum SDL_CameraPosition
     SDL_CAMERA_POSITION_BACK_FACING
 } SDL_CameraPosition;
 
+/**
+ * What a camera does with a new frame when every output surface is full.
+ *
+ * \since This enum is available since SDL 3.0.0.
+ *
+ * \sa SDL_OpenCameraWithProperties
+ */
+typedef enum SDL_CameraOverflowPolicy
+{
+    SDL_CAMERA_OVERFLOW_DROP_NEWEST,    /**< Discard the new frame; the app keeps getting the frames already queued. */
+    SDL_CAMERA_OVERFLOW_DROP_OLDEST,    /**< Discard the oldest queued frame to make room for the new one. */
+    SDL_CAMERA_OVERFLOW_BLOCK           /**< Leave frames with the device until the app releases a surface. */
+} SDL_CameraOverflowPolicy;
+
+/**
+ * How a camera fits its frames into a requested size with a different aspect
+ * ratio.
+ *
+ * \since This enum is available since SDL 3.0.0.
+ *
+ * \sa SDL_OpenCameraWithProperties
+ */
+typedef enum SDL_CameraFit
+{
+    SDL_CAMERA_FIT_STRETCH,     /**< Scale the whole frame to the requested size, distorting it if the aspect ratios differ. */
+    SDL_CAMERA_FIT_LETTERBOX,   /**< Scale the whole frame to fit inside the requested size, with black bars filling the rest. */
+    SDL_CAMERA_FIT_CROP         /**< Scale the frame to cover the requested size, cutting off what sticks out. */
+} SDL_CameraFit;
+
 
 /**
  * Use this function to get the number of built-in camera drivers.
@@ -298,9 +327,63 @@ extern SDL_DECLSPEC SDL_CameraPosition SDLCALL SDL_GetCameraPosition(SDL_CameraI
  *
  * \sa SDL_GetCameras
  * \sa SDL_GetCameraFormat
+ * \sa SDL_OpenCameraWithProperties
  */
 extern SDL_DECLSPEC SDL_Camera * SDLCALL SDL_OpenCamera(SDL_CameraID instance_id, const SDL_CameraSpec *spec);
 
+/**
+ * Open a camera with the specified properties.
+ *
+ * This behaves like SDL_OpenCamera(), but also lets the app size the queue of
+ * frames waiting to be acquired and choose what happens when it fills up.
+ *
+ * These are the supported properties:
+ *
+ * - `SDL_PROP_CAMERA_CREATE_SPEC_POINTER`: a pointer to the SDL_CameraSpec
+ *   the device should provide, or NULL to let SDL choose one. The spec is
+ *   copied before this function returns.
+ * - `SDL_PROP_CAMERA_CREATE_QUEUE_DEPTH_NUMBER`: the number of output
+ *   surfaces, shared between queued frames and frames the app holds. It is
+ *   clamped to the range 2 to 64, and defaults to 8.
+ * - `SDL_PROP_CAMERA_CREATE_OVERFLOW_POLICY_NUMBER`: an
+ *   SDL_CameraOverflowPolicy value for new frames that arrive while every
+ *   output surface is in use, defaults to SDL_CAMERA_OVERFLOW_DROP_NEWEST.
+ *   SDL_CAMERA_OVERFLOW_BLOCK fails on drivers that deliver frames from their
+ *   own thread, like Android and Emscripten.
+ * - `SDL_PROP_CAMERA_CREATE_FIT_NUMBER`: an SDL_CameraFit value for when the
+ *   spec asks for a size the device can't provide directly, defaults to
+ *   SDL_CAMERA_FIT_STRETCH. SDL scales camera frames with an area-averaging
+ *   filter when shrinking them by half or more, and bilinear filtering
+ *   otherwise.
+ * - `SDL_PROP_CAMERA_CREATE_BORROW_FRAMES_BOOLEAN`: true to have
+ *   SDL_AcquireCameraFrame() hand out the device's own buffers, in the
+ *   device's native format and size, instead of copies converted to the
+ *   requested spec. Nothing is copied or converted unless the app calls
+ *   SDL_ConvertCameraFrame() on a frame. Since the device's buffers are
+ *   limited, fewer frames may be queued than the queue depth asks for, and
+ *   held frames should be released promptly. SDL_GetCameraFormat() still
+ *   reports the requested spec. Defaults to false.
+ *
+ * \param instance_id the camera device instance ID.
+ * \param props the properties to use.
+ * \returns an SDL_Camera object or NULL on failure; call SDL_GetError() for
+ *          more information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_OpenCamera
+ * \sa SDL_GetCameraProperties
+ */
+extern SDL_DECLSPEC SDL_Camera * SDLCALL SDL_OpenCameraWithProperties(SDL_CameraID instance_id, SDL_PropertiesID props);
+
+#define SDL_PROP_CAMERA_CREATE_SPEC_POINTER             "SDL.camera.create.spec"
+#define SDL_PROP_CAMERA_CREATE_QUEUE_DEPTH_NUMBER       "SDL.camera.create.queue_depth"
+#define SDL_PROP_CAMERA_CREATE_OVERFLOW_POLICY_NUMBER   "SDL.camera.create.overflow_policy"
+#define SDL_PROP_CAMERA_CREATE_FIT_NUMBER               "SDL.camera.create.fit"
+#define SDL_PROP_CAMERA_CREATE_BORROW_FRAMES_BOOLEAN    "SDL.camera.create.borrow_frames"
+
 /**
  * Query if camera access has been approved by the user.
  *
@@ -352,6 +435,20 @@ extern SDL_DECLSPEC SDL_CameraID SDLCALL SDL_GetCameraID(SDL_Camera *camera);
 /**
  * Get the properties associated with an opened camera.
  *
+ * The following read-only properties describe the queue of frames waiting
+ * for the app. They are refreshed every time this function is called:
+ *
+ * - `SDL_PROP_CAMERA_QUEUE_CAPACITY_NUMBER`: the number of output surfaces.
+ * - `SDL_PROP_CAMERA_QUEUE_DEPTH_NUMBER`: the number of frames waiting to
+ *   be acquired right now.
+ * - `SDL_PROP_CAMERA_QUEUE_PEAK_DEPTH_NUMBER`: the most frames that have
+ *   been waiting at once since the camera was opened.
+ * - `SDL_PROP_CAMERA_FRAMES_DROPPED_NUMBER`: the number of frames discarded
+ *   because every output surface was in use.
+ * - `SDL_PROP_CAMERA_QUEUE_WAIT_NS_NUMBER`: the total time, in nanoseconds,
+ *   the camera has waited for the app to release a surface. This only grows
+ *   with SDL_CAMERA_OVERFLOW_BLOCK.
+ *
  * \param camera the SDL_Camera obtained from SDL_OpenCamera().
  * \returns a valid property ID on success or 0 on failure; call
  *          SDL_GetError() for more information.
@@ -362,6 +459,12 @@ extern SDL_DECLSPEC SDL_CameraID SDLCALL SDL_GetCameraID(SDL_Camera *camera);
  */
 extern SDL_DECLSPEC SDL_PropertiesID SDLCALL SDL_GetCameraProperties(SDL_Camera *camera);
 
+#define SDL_PROP_CAMERA_QUEUE_CAPACITY_NUMBER       "SDL.camera.queue.capacity"
+#define SDL_PROP_CAMERA_QUEUE_DEPTH_NUMBER          "SDL.camera.queue.depth"
+#define SDL_PROP_CAMERA_QUEUE_PEAK_DEPTH_NUMBER     "SDL.camera.queue.peak_depth"
+#define SDL_PROP_CAMERA_FRAMES_DROPPED_NUMBER       "SDL.camera.queue.frames_dropped"
+#define SDL_PROP_CAMERA_QUEUE_WAIT_NS_NUMBER        "SDL.camera.queue.wait_ns"
+
 /**
  * Get the spec that a camera is using when generating images.
  *
@@ -416,6 +519,27 @@ extern SDL_DECLSPEC bool SDLCALL SDL_GetCameraFormat(SDL_Camera *camera, SDL_Cam
  * SDL_EVENT_CAMERA_DEVICE_DENIED) event, or poll SDL_IsCameraApproved()
  * occasionally until it returns non-zero.
  *
+ * Each frame carries metadata in its surface properties, which you can get
+ * with SDL_GetSurfaceProperties(). They are valid until the frame is
+ * released:
+ *
+ * - `SDL_PROP_CAMERA_FRAME_TIMESTAMP_NUMBER`: the same value as
+ *   `timestampNS`: when the frame was captured, in nanoseconds, on the same
+ *   clock as SDL_GetTicksNS().
+ * - `SDL_PROP_CAMERA_FRAME_DRIVER_TIMESTAMP_NUMBER`: the capture time the
+ *   platform reported, in nanoseconds on the platform's own clock, or 0 if it
+ *   didn't report one.
+ * - `SDL_PROP_CAMERA_FRAME_SEQUENCE_NUMBER`: the frame's sequence number.
+ *   Where the platform numbers frames, frames it lost leave gaps; otherwise
+ *   SDL numbers the frames it receives.
+ * - `SDL_PROP_CAMERA_FRAME_DROPPED_NUMBER`: how many frames were lost since
+ *   the previous frame acquired from this camera, by the platform or by SDL's
+ *   frame queue.
+ * - `SDL_PROP_CAMERA_FRAME_CONVERSION_NS_NUMBER`: how long SDL spent scaling
+ *   and converting the frame, in nanoseconds. For frames borrowed with
+ *   `SDL_PROP_CAMERA_CREATE_BORROW_FRAMES_BOOLEAN`, this is set by
+ *   SDL_ConvertCameraFrame().
+ *
  * \param camera opened camera device.
  * \param timestampNS a pointer filled in with the frame's timestamp, or 0 on
  *                    error. Can be NULL.
@@ -430,6 +554,12 @@ extern SDL_DECLSPEC bool SDLCALL SDL_GetCameraFormat(SDL_Camera *camera, SDL_Cam
  */
 extern SDL_DECLSPEC SDL_Surface * SDLCALL SDL_AcquireCameraFrame(SDL_Camera *camera, Uint64 *timestampNS);
 
+#define SDL_PROP_CAMERA_FRAME_TIMESTAMP_NUMBER          "SDL.camera.frame.timestamp"
+#define SDL_PROP_CAMERA_FRAME_DRIVER_TIMESTAMP_NUMBER   "SDL.camera.frame.driver_timestamp"
+#define SDL_PROP_CAMERA_FRAME_SEQUENCE_NUMBER           "SDL.camera.frame.sequence"
+#define SDL_PROP_CAMERA_FRAME_DROPPED_NUMBER            "SDL.camera.frame.dropped"
+#define SDL_PROP_CAMERA_FRAME_CONVERSION_NS_NUMBER      "SDL.camera.frame.conversion_ns"
+
 /**
  * Release a frame of video acquired from a camera.
  *
@@ -439,7 +569,8 @@ extern SDL_DECLSPEC SDL_Surface * SDLCALL SDL_AcquireCameraFrame(SDL_Camera *cam
  * SDL_AcquireCameraFrame(). This function should be called as quickly as
  * possible after acquisition, as SDL keeps a small FIFO queue of surfaces for
  * video frames; if surfaces aren't released in a timely manner, SDL may drop
- * upcoming video frames from the camera.
+ * video frames from the camera, as chosen by
+ * `SDL_PROP_CAMERA_CREATE_OVERFLOW_POLICY_NUMBER`.
  *
  * If the app needs to keep the surface for a significant time, they should
  * make a copy of it and release the original.
@@ -458,6 +589,35 @@ extern SDL_DECLSPEC SDL_Surface * SDLCALL SDL_AcquireCameraFrame(SDL_Camera *cam
  */
 extern SDL_DECLSPEC void SDLCALL SDL_ReleaseCameraFrame(SDL_Camera *camera, SDL_Surface *frame);
 
+/**
+ * Get a borrowed camera frame in the format the camera was opened with.
+ *
+ * When a camera is opened with `SDL_PROP_CAMERA_CREATE_BORROW_FRAMES_BOOLEAN`
+ * set, frames are in the device's native format and size. This function
+ * scales and converts such a frame to the spec requested when the camera was
+ * opened, the first time it is called for that frame.
+ *
+ * If the frame already matches the requested spec, or the camera is not
+ * borrowing frames, this returns `frame` itself.
+ *
+ * The returned surface belongs to the camera and is valid until `frame` is
+ * released with SDL_ReleaseCameraFrame(); don't free it.
+ *
+ * \param camera opened camera device.
+ * \param frame a frame acquired with SDL_AcquireCameraFrame() and not yet
+ *              released.
+ * \returns a surface in the requested spec or NULL on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_AcquireCameraFrame
+ * \sa SDL_OpenCameraWithProperties
+ */
+extern SDL_DECLSPEC SDL_Surface * SDLCALL SDL_ConvertCameraFrame(SDL_Camera *camera, SDL_Surface *frame);
+
 /**
  * Use this function to shut down camera processing and close the camera
  * device.
@@ -527,6 +527,81 @@ extern "C" {
  */
 #define SDL_HINT_CAMERA_DRIVER "SDL_CAMERA_DRIVER"
 
+/**
+ * A variable listing the specs advertised by the synthetic camera driver.
+ *
+ * The synthetic camera generates its own frames, so the camera pipeline can
+ * be exercised and benchmarked without hardware. It has to be requested
+ * explicitly with SDL_HINT_CAMERA_DRIVER set to "synthetic".
+ *
+ * The variable is a comma-separated list of "FORMAT WIDTHxHEIGHT@FPS"
+ * entries, such as "NV12 1280x720@30,YUY2 640x480@0". FORMAT is an
+ * SDL_PixelFormat name with or without the "SDL_PIXELFORMAT_" prefix, and a
+ * framerate of 0 delivers frames as fast as they are consumed.
+ *
+ * This defaults to "NV12 1920x1080@30,NV12 1280x720@30,NV12 640x480@30"
+ *
+ * This hint should be set before SDL_Init() is called.
+ *
+ * \since This hint is available since SDL 3.0.0.
+ */
+#define SDL_HINT_CAMERA_SYNTHETIC_SPECS "SDL_CAMERA_SYNTHETIC_SPECS"
+
+/**
+ * Specify a file of raw frames for the synthetic camera driver to replay.
+ *
+ * The file holds tightly packed frames in the format and size of the opened
+ * spec, and is replayed in a loop. When unset, the synthetic camera shows
+ * moving color bars.
+ *
+ * This hint should be set before a camera is opened.
+ *
+ * \since This hint is available since SDL 3.0.0.
+ */
+#define SDL_HINT_CAMERA_SYNTHETIC_FILE "SDL_CAMERA_SYNTHETIC_FILE"
+
+/**
+ * A variable controlling the frame timing jitter of the synthetic camera
+ * driver.
+ *
+ * Each frame is delivered and timestamped up to this many milliseconds
+ * before or after its nominal time, at most half a frame interval. The
+ * default value is "0".
+ *
+ * This hint should be set before a camera is opened.
+ *
+ * \since This hint is available since SDL 3.0.0.
+ */
+#define SDL_HINT_CAMERA_SYNTHETIC_JITTER "SDL_CAMERA_SYNTHETIC_JITTER"
+
+/**
+ * A variable controlling the share of frames dropped by the synthetic camera
+ * driver.
+ *
+ * The value is the probability, between "0.0" and "0.99", that a frame is
+ * never delivered. Dropped frames leave a gap in the frame timestamps. The
+ * default value is "0.0".
+ *
+ * This hint should be set before a camera is opened.
+ *
+ * \since This hint is available since SDL 3.0.0.
+ */
+#define SDL_HINT_CAMERA_SYNTHETIC_DROP_RATE "SDL_CAMERA_SYNTHETIC_DROP_RATE"
+
+/**
+ * A variable controlling how many frame buffers the synthetic camera driver
+ * pretends to have.
+ *
+ * Like a V4L2 device with a fixed pool of mmap buffers, the driver loses
+ * frames while every buffer is out with SDL or the app. The default value is
+ * "0", which means there is no limit.
+ *
+ * This hint should be set before a camera is opened.
+ *
+ * \since This hint is available since SDL 3.0.0.
+ */
+#define SDL_HINT_CAMERA_SYNTHETIC_BUFFERS "SDL_CAMERA_SYNTHETIC_BUFFERS"
+
 /**
  * A variable that limits what CPU features are available.
  *
@@ -2823,6 +2898,28 @@ extern "C" {
  */
 #define SDL_HINT_RENDER_METAL_PREFER_LOW_POWER_DEVICE "SDL_RENDER_METAL_PREFER_LOW_POWER_DEVICE"
 
+/**
+ * A variable controlling how many threads the software renderer uses to draw
+ * large render targets.
+ *
+ * The target is split into bands of rows that are drawn in parallel, each
+ * running the queued commands that touch it in order. The output is
+ * identical to drawing on one thread. Lines, scaled copies and rotated
+ * copies are still drawn on the calling thread, in order with everything
+ * else. Small targets are always drawn on the calling thread.
+ *
+ * The variable can be set to the following values:
+ *
+ * - "0" or "1": Draw on the calling thread. (default)
+ * - "auto": Use one thread per logical CPU core.
+ * - "N": Use up to N threads, including the calling thread.
+ *
+ * This hint can be set anytime.
+ *
+ * \since This hint is available since SDL 3.0.0.
+ */
+#define SDL_HINT_RENDER_SOFTWARE_THREADS "SDL_RENDER_SOFTWARE_THREADS"
+
 /**
  * A variable controlling whether updates to the SDL screen surface should be
  * synchronized with the vertical refresh, to avoid tearing.
@@ -2977,6 +3074,28 @@ extern "C" {
  */
 #define SDL_HINT_STORAGE_USER_DRIVER "SDL_STORAGE_USER_DRIVER"
 
+/**
+ * A variable controlling the filter used when a surface is shrunk to half its
+ * size or less, in either direction, with SDL_SCALEMODE_LINEAR.
+ *
+ * The 2x2 bilinear filter only samples the four source pixels nearest each
+ * destination pixel, so large reductions skip most of the image and alias.
+ * The other filters weigh every source pixel the destination pixel covers.
+ *
+ * The variable can be set to the following values:
+ *
+ * - "bilinear": Use the 2x2 bilinear filter at every size.
+ * - "area": Average the source pixels each destination pixel covers.
+ *   (default)
+ * - "lanczos": Use a Lanczos-3 filter, which is sharper than "area" but
+ *   slower and may ring around hard edges.
+ *
+ * This hint can be set anytime.
+ *
+ * \since This hint is available since SDL 3.0.0.
+ */
+#define SDL_HINT_SURFACE_DOWNSCALE_FILTER "SDL_SURFACE_DOWNSCALE_FILTER"
+
 /**
  * Specifies whether SDL_THREAD_PRIORITY_TIME_CRITICAL should be treated as
  * realtime.
@@ -4011,6 +4130,27 @@ extern "C" {
  */
 #define SDL_HINT_XINPUT_ENABLED "SDL_XINPUT_ENABLED"
 
+/**
+ * A variable controlling how many threads are used to convert large images
+ * between YUV and RGB formats.
+ *
+ * The image is split into bands of rows that are converted in parallel, and
+ * the conversion functions still return once the whole image is done. The
+ * output is identical to the single-threaded conversion. Small images are
+ * always converted on the calling thread.
+ *
+ * The variable can be set to the following values:
+ *
+ * - "0" or "1": Conversions run on the calling thread. (default)
+ * - "auto": Use one thread per logical CPU core.
+ * - "N": Use up to N threads, including the calling thread.
+ *
+ * This hint can be set anytime.
+ *
+ * \since This hint is available since SDL 3.0.0.
+ */
+#define SDL_HINT_YUV_CONVERSION_THREADS "SDL_YUV_CONVERSION_THREADS"
+
 /**
  * A variable controlling response to SDL_assert failures.
  *
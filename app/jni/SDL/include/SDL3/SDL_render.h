@@ -402,6 +402,21 @@ extern SDL_DECLSPEC const char * SDLCALL SDL_GetRendererName(SDL_Renderer *rende
  *   enabled, this will be 1.0. This property can change dynamically when
  *   SDL_EVENT_DISPLAY_HDR_STATE_CHANGED is sent.
  *
+ * With the software renderer:
+ *
+ * - `SDL_PROP_RENDERER_SOFTWARE_SCRATCH_ALLOCATIONS_NUMBER`: the number of
+ *   scratch surfaces allocated so far for rotated and scaled copies. This
+ *   stops growing once the scratch surface cache covers the frame's draws.
+ * - `SDL_PROP_RENDERER_SOFTWARE_SCRATCH_REUSES_NUMBER`: the number of times
+ *   a cached scratch surface was reused instead of allocating a new one.
+ * - `SDL_PROP_RENDERER_SOFTWARE_TILED_COMMANDS_NUMBER`: the number of draw
+ *   commands split across threads so far, when
+ *   SDL_HINT_RENDER_SOFTWARE_THREADS enables that.
+ * - `SDL_PROP_RENDERER_SOFTWARE_SERIAL_COMMANDS_NUMBER`: the number of draw
+ *   commands that ran on the calling thread in that mode, because their
+ *   output depends on how they are clipped (lines, scaled and rotated
+ *   copies).
+ *
  * With the direct3d renderer:
  *
  * - `SDL_PROP_RENDERER_D3D9_DEVICE_POINTER`: the IDirect3DDevice9 associated
@@ -461,6 +476,10 @@ extern SDL_DECLSPEC SDL_PropertiesID SDLCALL SDL_GetRendererProperties(SDL_Rende
 #define SDL_PROP_RENDERER_HDR_ENABLED_BOOLEAN                       "SDL.renderer.HDR_enabled"
 #define SDL_PROP_RENDERER_SDR_WHITE_POINT_FLOAT                     "SDL.renderer.SDR_white_point"
 #define SDL_PROP_RENDERER_HDR_HEADROOM_FLOAT                        "SDL.renderer.HDR_headroom"
+#define SDL_PROP_RENDERER_SOFTWARE_SCRATCH_ALLOCATIONS_NUMBER      "SDL.renderer.software.scratch_allocations"
+#define SDL_PROP_RENDERER_SOFTWARE_SCRATCH_REUSES_NUMBER           "SDL.renderer.software.scratch_reuses"
+#define SDL_PROP_RENDERER_SOFTWARE_TILED_COMMANDS_NUMBER           "SDL.renderer.software.tiled_commands"
+#define SDL_PROP_RENDERER_SOFTWARE_SERIAL_COMMANDS_NUMBER          "SDL.renderer.software.serial_commands"
 #define SDL_PROP_RENDERER_D3D9_DEVICE_POINTER                       "SDL.renderer.d3d9.device"
 #define SDL_PROP_RENDERER_D3D11_DEVICE_POINTER                      "SDL.renderer.d3d11.device"
 #define SDL_PROP_RENDERER_D3D11_SWAPCHAIN_POINTER                   "SDL.renderer.d3d11.swap_chain"
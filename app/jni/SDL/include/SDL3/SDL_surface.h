@@ -1249,6 +1249,92 @@ extern SDL_DECLSPEC bool SDLCALL SDL_BlitSurfaceTiledWithScale(SDL_Surface *src,
  */
 extern SDL_DECLSPEC bool SDLCALL SDL_BlitSurface9Grid(SDL_Surface *src, const SDL_Rect *srcrect, int left_width, int right_width, int top_height, int bottom_height, float scale, SDL_ScaleMode scaleMode, SDL_Surface *dst, const SDL_Rect *dstrect);
 
+/**
+ * The kind of software blit routine chosen for a pair of surfaces.
+ *
+ * \since This enum is available since SDL 3.0.0.
+ *
+ * \sa SDL_GetBlitStats
+ */
+typedef enum SDL_BlitPath
+{
+    SDL_BLITPATH_COPY,          /**< row copies between surfaces of the same format */
+    SDL_BLITPATH_INDEXED,       /**< a routine specialized for an indexed source format */
+    SDL_BLITPATH_BLEND,         /**< a routine specialized for alpha blending */
+    SDL_BLITPATH_CONVERT,       /**< a routine specialized for converting between packed formats */
+    SDL_BLITPATH_GENERATED,     /**< one of the generated routines for common 32-bit format pairs */
+    SDL_BLITPATH_SLOW,          /**< the generic per-pixel fallback */
+    SDL_BLITPATH_SLOW_FLOAT     /**< the generic floating point fallback, used for colorspace conversion and formats wider than 32 bits */
+} SDL_BlitPath;
+
+/**
+ * Usage counters for one kind of software blit, see SDL_GetBlitStats().
+ *
+ * \since This struct is available since SDL 3.0.0.
+ *
+ * \sa SDL_GetBlitStats
+ */
+typedef struct SDL_BlitStats
+{
+    SDL_PixelFormat src_format;     /**< the format of the source surface */
+    SDL_PixelFormat dst_format;     /**< the format of the destination surface */
+    SDL_Colorspace src_colorspace;  /**< the colorspace of the source surface */
+    SDL_Colorspace dst_colorspace;  /**< the colorspace of the destination surface */
+    SDL_BlendMode blend_mode;       /**< the blend mode of the source surface */
+    bool color_mod;                 /**< true if the source color is modulated */
+    bool alpha_mod;                 /**< true if the source alpha is modulated */
+    bool colorkey;                  /**< true if the source has a color key */
+    bool scaled;                    /**< true for blits stretched with SDL_SCALEMODE_NEAREST */
+    SDL_BlitPath path;              /**< the kind of routine doing the blit */
+    Uint64 maps;                    /**< the number of times a surface was set up for this kind of blit */
+    Uint64 blits;                   /**< the number of blits done */
+    Uint64 pixels;                  /**< the number of destination pixels written */
+} SDL_BlitStats;
+
+/**
+ * Get usage counters for the software blit routines.
+ *
+ * SDL picks a blit routine the first time a surface is blitted to a
+ * destination, and again whenever the formats, colorspaces, blend mode, color
+ * and alpha modulation, color key or scale mode change. The choice is cached
+ * for each combination of those, so setting up the same kind of blit again is
+ * cheap. Each combination seen so far is reported here along with the kind of
+ * routine chosen and how often it was used, which helps to find blits that
+ * fall back to the slow generic paths.
+ *
+ * Blits of RLE accelerated surfaces and linear scaling are not counted.
+ *
+ * If `count` is not NULL, it will be filled with the number of elements in
+ * the returned array.
+ *
+ * \param count a pointer filled in with the number of elements in the list,
+ *              may be NULL.
+ * \returns a NULL terminated array of pointers to SDL_BlitStats or NULL on
+ *          failure; call SDL_GetError() for more information. This is a
+ *          single allocation that should be freed with SDL_free() when it is
+ *          no longer needed.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_ResetBlitStats
+ */
+extern SDL_DECLSPEC SDL_BlitStats ** SDLCALL SDL_GetBlitStats(int *count);
+
+/**
+ * Reset the software blit usage counters to zero.
+ *
+ * The cached choice of blit routine is kept.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_GetBlitStats
+ */
+extern SDL_DECLSPEC void SDLCALL SDL_ResetBlitStats(void);
+
 /**
  * Map an RGB triple to an opaque pixel value for a surface.
  *
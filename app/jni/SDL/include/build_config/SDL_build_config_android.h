@@ -209,6 +209,7 @@
 /* Enable the camera driver */
 #ifndef SDL_CAMERA_DISABLED
 #define SDL_CAMERA_DRIVER_ANDROID 1
+#define SDL_CAMERA_DRIVER_SYNTHETIC 1
 #endif /* SDL_CAMERA_DISABLED */
 
 /* Enable nl_langinfo and high-res file times on version 26 and higher. */
@@ -50,6 +50,9 @@ static const CameraBootStrap *const bootstrap[] = {
 #ifdef SDL_CAMERA_DRIVER_MEDIAFOUNDATION
     &MEDIAFOUNDATION_bootstrap,
 #endif
+#ifdef SDL_CAMERA_DRIVER_SYNTHETIC
+    &SYNTHETICCAMERA_bootstrap,
+#endif
 #ifdef SDL_CAMERA_DRIVER_DUMMY
     &DUMMYCAMERA_bootstrap,
 #endif
@@ -225,6 +228,54 @@ static void ZombieReleaseFrame(SDL_Camera *device, SDL_Surface *frame) // Reclai
     // we just leave zombie_pixels alone, as we'll reuse it for every new frame until the camera is closed.
 }
 
+// Claim a free output slot for the next frame. Returns -1 if every slot is queued or held by the app.
+static int ReserveOutputSlot(SDL_Camera *device)
+{
+    for (int i = 0; i < device->num_output_slots; i++) {
+        if (SDL_CompareAndSwapAtomicInt(&device->output_slots[i].state, CAMERA_OUTPUT_SLOT_FREE, CAMERA_OUTPUT_SLOT_FILLING)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Hand a filled slot to the app. Only the camera thread may call this.
+static void PushOutputSlot(SDL_Camera *device, int slot)
+{
+    const Uint32 write = (Uint32) SDL_GetAtomicInt(&device->output_write);
+    SDL_SetAtomicInt(&device->output_slots[slot].state, CAMERA_OUTPUT_SLOT_QUEUED);
+    SDL_SetAtomicInt(&device->output_queue[write & device->output_queue_mask], slot);
+    SDL_SetAtomicInt(&device->output_write, (int) (write + 1));
+
+    const int depth = (int) (write + 1 - (Uint32) SDL_GetAtomicInt(&device->output_read));
+    if (depth > SDL_GetAtomicInt(&device->peak_queue_depth)) {
+        SDL_SetAtomicInt(&device->peak_queue_depth, depth);
+    }
+}
+
+// Take the oldest queued slot, or -1 if nothing is queued. The app calls this to acquire a frame, and the camera thread to drop one.
+static int PopOutputSlot(SDL_Camera *device)
+{
+    while (true) {
+        const Uint32 read = (Uint32) SDL_GetAtomicInt(&device->output_read);
+        if (read == (Uint32) SDL_GetAtomicInt(&device->output_write)) {
+            return -1;
+        }
+        // if someone else moves output_read first, this entry might be stale, but then the CAS fails and we try again.
+        const int slot = SDL_GetAtomicInt(&device->output_queue[read & device->output_queue_mask]);
+        if (SDL_CompareAndSwapAtomicInt(&device->output_read, (int) read, (int) (read + 1))) {
+            return slot;
+        }
+    }
+}
+
+static void CountDroppedFrame(SDL_Camera *device)
+{
+    SDL_LockSpinlock(&device->stats_lock);
+    device->frames_dropped++;
+    SDL_UnlockSpinlock(&device->stats_lock);
+}
+
 static void ClosePhysicalCamera(SDL_Camera *device)
 {
     if (!device) {
@@ -241,39 +292,67 @@ static void ClosePhysicalCamera(SDL_Camera *device)
     }
 
     // release frames that are queued up somewhere...
-    if (!device->needs_conversion && !device->needs_scaling) {
-        for (SurfaceList *i = device->filled_output_surfaces.next; i != NULL; i = i->next) {
-            device->ReleaseFrame(device, i->surface);
-        }
-        for (SurfaceList *i = device->app_held_output_surfaces.next; i != NULL; i = i->next) {
-            device->ReleaseFrame(device, i->surface);
+    if (device->passthrough) {
+        for (int i = 0; i < device->num_output_slots; i++) {
+            const int state = SDL_GetAtomicInt(&device->output_slots[i].state);
+            if ((state == CAMERA_OUTPUT_SLOT_QUEUED) || (state == CAMERA_OUTPUT_SLOT_HELD)) {
+                device->ReleaseFrame(device, device->output_slots[i].surface);
+            }
         }
     }
 
     camera_driver.impl.CloseDevice(device);
 
     SDL_DestroyProperties(device->props);
+    device->props = 0;
 
     SDL_DestroySurface(device->acquire_surface);
     device->acquire_surface = NULL;
     SDL_DestroySurface(device->conversion_surface);
     device->conversion_surface = NULL;
+    SDL_DestroyCameraScaler(device->scaler);
+    device->scaler = NULL;
 
-    for (int i = 0; i < SDL_arraysize(device->output_surfaces); i++) {
-        SDL_DestroySurface(device->output_surfaces[i].surface);
+    if (device->output_slots) {
+        for (int i = 0; i < device->num_output_slots; i++) {
+            SDL_DestroySurface(device->output_slots[i].surface);
+            SDL_DestroySurface(device->output_slots[i].converted);
+        }
+        SDL_free(device->output_slots);
+        device->output_slots = NULL;
     }
-    SDL_zeroa(device->output_surfaces);
+    device->num_output_slots = 0;
+    device->reserved_output_slot = -1;
+
+    SDL_free(device->output_queue);
+    device->output_queue = NULL;
+    device->output_queue_mask = 0;
+    SDL_SetAtomicInt(&device->output_read, 0);
+    SDL_SetAtomicInt(&device->output_write, 0);
+
+    SDL_DestroySemaphore(device->output_released);
+    device->output_released = NULL;
+
+    SDL_DestroyMutex(device->convert_lock);
+    device->convert_lock = NULL;
+    device->borrow_frames = false;
+    device->passthrough = false;
+    device->buffer_count = 0;
+
+    device->frames_dropped = 0;
+    device->queue_wait_ns = 0;
+    SDL_SetAtomicInt(&device->peak_queue_depth, 0);
 
     SDL_aligned_free(device->zombie_pixels);
 
     device->permission = 0;
     device->zombie_pixels = NULL;
-    device->filled_output_surfaces.next = NULL;
-    device->empty_output_surfaces.next = NULL;
-    device->app_held_output_surfaces.next = NULL;
 
     device->base_timestamp = 0;
     device->adjust_timestamp = 0;
+    device->next_sequence = 0;
+    device->last_acquired_sequence = 0;
+    device->acquired_any = false;
 }
 
 // this must not be called while `device` is still in a device list, or while a device's camera thread is still running.
@@ -789,8 +868,65 @@ void SDL_CameraThreadSetup(SDL_Camera *device)
 #endif
 }
 
+static bool IsCameraLetterboxed(SDL_Camera *device)
+{
+    return device->needs_scaling && ((device->scale_dstrect.w != device->spec.width) || (device->scale_dstrect.h != device->spec.height));
+}
+
+static void ScaleCameraFrame(SDL_Camera *device, SDL_Surface *src, SDL_Surface *dst)
+{
+    // the scaler only fails if it runs out of memory, so fall back to the plain stretch then.
+    if (!device->scaler || !SDL_CameraScale(device->scaler, src, dst)) {
+        SDL_SoftStretch(src, &device->scale_srcrect, dst, &device->scale_dstrect, SDL_SCALEMODE_NEAREST);
+    }
+}
+
+// Scale and convert a frame in the backend's format into the app-requested spec.
+static void ConvertCameraFrame(SDL_Camera *device, SDL_Surface *acquired, SDL_Surface *output_surface)
+{
+    SDL_Surface *srcsurf = acquired;
+    if (device->needs_scaling == -1) {  // downscaling? Do it first, in the native format, so there's less to convert.  -1: downscale, 0: no scaling, 1: upscale
+        SDL_Surface *dstsurf = device->needs_conversion ? device->conversion_surface : output_surface;
+        ScaleCameraFrame(device, srcsurf, dstsurf);
+        srcsurf = dstsurf;
+    }
+    if (device->needs_conversion) {
+        SDL_Surface *dstsurf = (device->needs_scaling == 1) ? device->conversion_surface : output_surface;
+        SDL_ConvertPixels(srcsurf->w, srcsurf->h,
+                          srcsurf->format, srcsurf->pixels, srcsurf->pitch,
+                          dstsurf->format, dstsurf->pixels, dstsurf->pitch);
+        srcsurf = dstsurf;
+    }
+    if (device->needs_scaling == 1) {  // upscaling? Do it last.  -1: downscale, 0: no scaling, 1: upscale
+        ScaleCameraFrame(device, srcsurf, output_surface);
+    }
+}
+
 bool SDL_CameraThreadIterate(SDL_Camera *device)
 {
+    if (SDL_GetAtomicInt(&device->shutdown)) {
+        return false;  // we're done, shut it down.
+    }
+
+    // claim an output slot before taking a frame from the backend. If the app is holding or hasn't acquired all of
+    //  them yet and we're meant to block, leave the frame with the backend until a slot comes back.
+    if (device->reserved_output_slot < 0) {
+        device->reserved_output_slot = ReserveOutputSlot(device);
+        if ((device->reserved_output_slot < 0) && (device->overflow_policy == SDL_CAMERA_OVERFLOW_BLOCK)) {
+            const Uint64 start = SDL_GetTicksNS();
+            SDL_WaitSemaphoreTimeout(device->output_released, 10);  // time out now and then so we notice shutdown.
+            const Uint64 waited = SDL_GetTicksNS() - start;
+            SDL_LockSpinlock(&device->stats_lock);
+            device->queue_wait_ns += waited;
+            SDL_UnlockSpinlock(&device->stats_lock);
+
+            device->reserved_output_slot = ReserveOutputSlot(device);
+            if (device->reserved_output_slot < 0) {
+                return true;  // still nothing; try again next time.
+            }
+        }
+    }
+
     SDL_LockMutex(device->lock);
 
     if (SDL_GetAtomicInt(&device->shutdown)) {
@@ -807,13 +943,21 @@ bool SDL_CameraThreadIterate(SDL_Camera *device)
     bool failed = false;  // set to true if disaster worthy of treating the device as lost has happened.
     SDL_Surface *acquired = NULL;
     SDL_Surface *output_surface = NULL;
-    SurfaceList *slist = NULL;
+    int slot = -1;
     Uint64 timestampNS = 0;
+    Uint64 driver_timestampNS = 0;
+    Uint64 sequence = 0;
 
     // AcquireFrame SHOULD NOT BLOCK, as we are holding a lock right now. Block in WaitDevice instead!
-    const SDL_CameraFrameResult rc = device->AcquireFrame(device, device->acquire_surface, &timestampNS);
+    device->acquire_sequence = -1;
+    const SDL_CameraFrameResult rc = device->AcquireFrame(device, device->acquire_surface, &driver_timestampNS);
 
     if (rc == SDL_CAMERA_FRAME_READY) {  // new frame acquired!
+        const Uint64 now = SDL_GetTicksNS();
+
+        sequence = (device->acquire_sequence >= 0) ? (Uint64) device->acquire_sequence : device->next_sequence;
+        device->next_sequence = sequence + 1;
+
         #if DEBUG_CAMERA
         SDL_Log("CAMERA: New frame available! pixels=%p pitch=%d", device->acquire_surface->pixels, device->acquire_surface->pitch);
         #endif
@@ -826,26 +970,60 @@ bool SDL_CameraThreadIterate(SDL_Camera *device)
             device->ReleaseFrame(device, device->acquire_surface);
             device->acquire_surface->pixels = NULL;
             device->acquire_surface->pitch = 0;
-        } else if (device->empty_output_surfaces.next == NULL) {
-            // uhoh, no output frames available! Either the app is slow, or it forgot to release frames when done with them. Drop this new frame.
-            #if DEBUG_CAMERA
-            SDL_Log("CAMERA: No empty output surfaces! Dropping frame!");
-            #endif
-            device->ReleaseFrame(device, device->acquire_surface);
-            device->acquire_surface->pixels = NULL;
-            device->acquire_surface->pitch = 0;
         } else {
-            if (!device->adjust_timestamp) {
-                device->adjust_timestamp = SDL_GetTicksNS();
-                device->base_timestamp = timestampNS;
+            slot = device->reserved_output_slot;
+            if (slot < 0) {
+                slot = ReserveOutputSlot(device);
             }
-            timestampNS = (timestampNS - device->base_timestamp) + device->adjust_timestamp;
+            if ((slot < 0) && (device->overflow_policy == SDL_CAMERA_OVERFLOW_DROP_OLDEST)) {
+                slot = PopOutputSlot(device);  // steal the oldest frame the app hasn't acquired yet.
+                if (slot >= 0) {
+                    #if DEBUG_CAMERA
+                    SDL_Log("CAMERA: No empty output surfaces! Dropping oldest frame!");
+                    #endif
+                    SDL_Surface *stale = device->output_slots[slot].surface;
+                    if (device->passthrough) {
+                        device->ReleaseFrame(device, stale);
+                        stale->pixels = NULL;
+                        stale->pitch = 0;
+                    }
+                    SDL_SetAtomicInt(&device->output_slots[slot].state, CAMERA_OUTPUT_SLOT_FILLING);
+                    CountDroppedFrame(device);
+                }
+            }
+
+            if (slot < 0) {
+                // uhoh, no output frames available! Either the app is slow, or it forgot to release frames when done with them. Drop this new frame.
+                #if DEBUG_CAMERA
+                SDL_Log("CAMERA: No empty output surfaces! Dropping frame!");
+                #endif
+                device->ReleaseFrame(device, device->acquire_surface);
+                device->acquire_surface->pixels = NULL;
+                device->acquire_surface->pitch = 0;
+                CountDroppedFrame(device);
+            } else {
+                if (!driver_timestampNS) {
+                    timestampNS = now;  // the backend doesn't know when this was captured; when it arrived will have to do.
+                } else {
+                    if (!device->adjust_timestamp) {
+                        device->adjust_timestamp = now;
+                        device->base_timestamp = driver_timestampNS;
+                    }
+                    timestampNS = (driver_timestampNS - device->base_timestamp) + device->adjust_timestamp;
+                    if (timestampNS > now) {
+                        // the first frame took longer to reach us than this one did, so the offset was too big.
+                        //  Pull it back, so frames never look like they're from the future.
+                        device->adjust_timestamp -= timestampNS - now;
+                        timestampNS = now;
+                    }
+                }
 
-            slist = device->empty_output_surfaces.next;
-            output_surface = slist->surface;
-            device->empty_output_surfaces.next = slist->next;
-            acquired = device->acquire_surface;
-            slist->timestampNS = timestampNS;
+                device->reserved_output_slot = -1;
+                output_surface = device->output_slots[slot].surface;
+                acquired = device->acquire_surface;
+                device->output_slots[slot].timestampNS = timestampNS;
+                device->output_slots[slot].sequence = sequence;
+            }
         }
     } else if (rc == SDL_CAMERA_FRAME_SKIP) {  // no frame available yet; not an error.
         #if 0 //DEBUG_CAMERA
@@ -858,17 +1036,18 @@ bool SDL_CameraThreadIterate(SDL_Camera *device)
         failed = true;
     }
 
-    // we can let go of the lock once we've tried to grab a frame of video and maybe moved the output frame off the empty list.
+    // we can let go of the lock once we've tried to grab a frame of video.
     // this lets us chew up the CPU for conversion and scaling without blocking other threads.
     SDL_UnlockMutex(device->lock);
 
     if (failed) {
-        SDL_assert(slist == NULL);
+        SDL_assert(slot < 0);
         SDL_assert(acquired == NULL);
         SDL_CameraDisconnected(device);  // doh.
     } else if (acquired) {  // we have a new frame, scale/convert if necessary and queue it for the app!
-        SDL_assert(slist != NULL);
-        if (!device->needs_scaling && !device->needs_conversion) {  // no conversion needed? Just move the pointer/pitch into the output surface.
+        SDL_assert(slot >= 0);
+        Uint64 conversion_ns = 0;
+        if (device->passthrough) {  // no conversion needed (or the app will ask for it)? Just move the pointer/pitch into the output surface.
             #if DEBUG_CAMERA
             SDL_Log("CAMERA: Frame is going through without conversion!");
             #endif
@@ -880,22 +1059,9 @@ bool SDL_CameraThreadIterate(SDL_Camera *device)
             #if DEBUG_CAMERA
             SDL_Log("CAMERA: Frame is getting converted!");
             #endif
-            SDL_Surface *srcsurf = acquired;
-            if (device->needs_scaling == -1) {  // downscaling? Do it first.  -1: downscale, 0: no scaling, 1: upscale
-                SDL_Surface *dstsurf = device->needs_conversion ? device->conversion_surface : output_surface;
-                SDL_SoftStretch(srcsurf, NULL, dstsurf, NULL, SDL_SCALEMODE_NEAREST);  // !!! FIXME: linear scale? letterboxing?
-                srcsurf = dstsurf;
-            }
-            if (device->needs_conversion) {
-                SDL_Surface *dstsurf = (device->needs_scaling == 1) ? device->conversion_surface : output_surface;
-                SDL_ConvertPixels(srcsurf->w, srcsurf->h,
-                                  srcsurf->format, srcsurf->pixels, srcsurf->pitch,
-                                  dstsurf->format, dstsurf->pixels, dstsurf->pitch);
-                srcsurf = dstsurf;
-            }
-            if (device->needs_scaling == 1) {  // upscaling? Do it last.  -1: downscale, 0: no scaling, 1: upscale
-                SDL_SoftStretch(srcsurf, NULL, output_surface, NULL, SDL_SCALEMODE_NEAREST);  // !!! FIXME: linear scale? letterboxing?
-            }
+            const Uint64 start = SDL_GetTicksNS();
+            ConvertCameraFrame(device, acquired, output_surface);
+            conversion_ns = SDL_GetTicksNS() - start;
 
             // we made a copy, so we can give the driver back its resources.
             device->ReleaseFrame(device, acquired);
@@ -905,11 +1071,17 @@ bool SDL_CameraThreadIterate(SDL_Camera *device)
         acquired->pixels = NULL;
         acquired->pitch = 0;
 
+        // the app can't see this slot yet, so it's safe to update the frame's metadata here.
+        const SDL_PropertiesID props = SDL_GetSurfaceProperties(output_surface);
+        if (props) {
+            SDL_SetNumberProperty(props, SDL_PROP_CAMERA_FRAME_TIMESTAMP_NUMBER, (Sint64) timestampNS);
+            SDL_SetNumberProperty(props, SDL_PROP_CAMERA_FRAME_DRIVER_TIMESTAMP_NUMBER, (Sint64) driver_timestampNS);
+            SDL_SetNumberProperty(props, SDL_PROP_CAMERA_FRAME_SEQUENCE_NUMBER, (Sint64) sequence);
+            SDL_SetNumberProperty(props, SDL_PROP_CAMERA_FRAME_CONVERSION_NS_NUMBER, (Sint64) conversion_ns);
+        }
+
         // make the filled output surface available to the app.
-        SDL_LockMutex(device->lock);
-        slist->next = device->filled_output_surfaces.next;
-        device->filled_output_surfaces.next = slist;
-        SDL_UnlockMutex(device->lock);
+        PushOutputSlot(device, slot);
     }
 
     return true;  // always go on if not shutting down, even if device failed.
@@ -949,6 +1121,44 @@ static int SDLCALL CameraThread(void *devicep)
     return 0;
 }
 
+// Work out which part of a srcw x srch frame to scale, and where it lands in a dstw x dsth frame.
+static void GetCameraFitRects(int srcw, int srch, int dstw, int dsth, SDL_CameraFit fit, bool even, SDL_Rect *srcrect, SDL_Rect *dstrect)
+{
+    srcrect->x = srcrect->y = 0;
+    srcrect->w = srcw;
+    srcrect->h = srch;
+    dstrect->x = dstrect->y = 0;
+    dstrect->w = dstw;
+    dstrect->h = dsth;
+
+    const Sint64 srcaspect = ((Sint64) srcw) * dsth;  // compare srcw/srch against dstw/dsth without dividing.
+    const Sint64 dstaspect = ((Sint64) dstw) * srch;
+    const int align = even ? 2 : 1;  // subsampled YUV needs even offsets and sizes.
+
+    if ((fit == SDL_CAMERA_FIT_CROP) && (srcaspect != dstaspect)) {
+        if (srcaspect > dstaspect) {  // source is wider, cut off the sides.
+            srcrect->w = (int) ((((Sint64) srch) * dstw / dsth) / align * align);
+        } else {  // source is taller, cut off the top and bottom.
+            srcrect->h = (int) ((((Sint64) srcw) * dsth / dstw) / align * align);
+        }
+        srcrect->x = ((srcw - srcrect->w) / 2) / align * align;
+        srcrect->y = ((srch - srcrect->h) / 2) / align * align;
+    } else if ((fit == SDL_CAMERA_FIT_LETTERBOX) && (srcaspect != dstaspect)) {
+        if (srcaspect > dstaspect) {  // source is wider, bars above and below.
+            dstrect->h = (int) ((((Sint64) dstw) * srch / srcw) / align * align);
+        } else {  // source is taller, bars on the sides.
+            dstrect->w = (int) ((((Sint64) dsth) * srcw / srch) / align * align);
+        }
+        dstrect->x = ((dstw - dstrect->w) / 2) / align * align;
+        dstrect->y = ((dsth - dstrect->h) / 2) / align * align;
+    }
+
+    srcrect->w = SDL_max(srcrect->w, 1);
+    srcrect->h = SDL_max(srcrect->h, 1);
+    dstrect->w = SDL_max(dstrect->w, 1);
+    dstrect->h = SDL_max(dstrect->h, 1);
+}
+
 static void ChooseBestCameraSpec(SDL_Camera *device, const SDL_CameraSpec *spec, SDL_CameraSpec *closest)
 {
     // Find the closest available native format/size...
@@ -1068,6 +1278,44 @@ static void ChooseBestCameraSpec(SDL_Camera *device, const SDL_CameraSpec *spec,
 
 SDL_Camera *SDL_OpenCamera(SDL_CameraID instance_id, const SDL_CameraSpec *spec)
 {
+    const SDL_PropertiesID props = SDL_CreateProperties();
+    SDL_SetPointerProperty(props, SDL_PROP_CAMERA_CREATE_SPEC_POINTER, (void *) spec);
+    SDL_Camera *camera = SDL_OpenCameraWithProperties(instance_id, props);
+    SDL_DestroyProperties(props);
+    return camera;
+}
+
+SDL_Camera *SDL_OpenCameraWithProperties(SDL_CameraID instance_id, SDL_PropertiesID props)
+{
+    const SDL_CameraSpec *spec = (const SDL_CameraSpec *) SDL_GetPointerProperty(props, SDL_PROP_CAMERA_CREATE_SPEC_POINTER, NULL);
+    const int queue_depth = (int) SDL_clamp(SDL_GetNumberProperty(props, SDL_PROP_CAMERA_CREATE_QUEUE_DEPTH_NUMBER, 8), 2, 64);
+    const bool borrow_frames = SDL_GetBooleanProperty(props, SDL_PROP_CAMERA_CREATE_BORROW_FRAMES_BOOLEAN, false);
+    const SDL_CameraOverflowPolicy overflow_policy = (SDL_CameraOverflowPolicy) SDL_GetNumberProperty(props, SDL_PROP_CAMERA_CREATE_OVERFLOW_POLICY_NUMBER, SDL_CAMERA_OVERFLOW_DROP_NEWEST);
+    switch (overflow_policy) {
+    case SDL_CAMERA_OVERFLOW_DROP_NEWEST:
+    case SDL_CAMERA_OVERFLOW_DROP_OLDEST:
+    case SDL_CAMERA_OVERFLOW_BLOCK:
+        // backends that deliver frames on their own callback thread have no way to offer a refused frame again, and must never be blocked.
+        if (camera_driver.impl.ProvidesOwnCallbackThread) {
+            SDL_SetError("This camera driver can't block on the app releasing frames");
+            return NULL;
+        }
+        break;
+    default:
+        SDL_SetError("Unknown camera overflow policy");
+        return NULL;
+    }
+    const SDL_CameraFit fit = (SDL_CameraFit) SDL_GetNumberProperty(props, SDL_PROP_CAMERA_CREATE_FIT_NUMBER, SDL_CAMERA_FIT_STRETCH);
+    switch (fit) {
+    case SDL_CAMERA_FIT_STRETCH:
+    case SDL_CAMERA_FIT_LETTERBOX:
+    case SDL_CAMERA_FIT_CROP:
+        break;
+    default:
+        SDL_SetError("Unknown camera fit");
+        return NULL;
+    }
+
     SDL_Camera *device = ObtainPhysicalCamera(instance_id);
     if (!device) {
         return NULL;
@@ -1134,6 +1382,18 @@ SDL_Camera *SDL_OpenCamera(SDL_CameraID instance_id, const SDL_CameraSpec *spec)
 
     device->needs_conversion = (closest.format != device->spec.format);
 
+    // borrowed frames go to the app in the backend's buffers, and only get converted if the app asks for that.
+    device->borrow_frames = borrow_frames;
+    device->passthrough = borrow_frames || (!device->needs_scaling && !device->needs_conversion);
+    if (borrow_frames && (device->needs_scaling || device->needs_conversion)) {
+        device->convert_lock = SDL_CreateMutex();
+        if (!device->convert_lock) {
+            ClosePhysicalCamera(device);
+            ReleaseCamera(device);
+            return NULL;
+        }
+    }
+
     device->acquire_surface = SDL_CreateSurfaceFrom(closest.width, closest.height, closest.format, NULL, 0);
     if (!device->acquire_surface) {
         ClosePhysicalCamera(device);
@@ -1156,21 +1416,42 @@ SDL_Camera *SDL_OpenCamera(SDL_CameraID instance_id, const SDL_CameraSpec *spec)
         SDL_SetSurfaceColorspace(device->conversion_surface, closest.colorspace);
     }
 
-    // output surfaces are in the app-requested format. If no conversion is necessary, we'll just use the pointers
-    // the backend fills into acquired_surface, and you can get all the way from DMA access in the camera hardware
-    // to the app without a single copy. Otherwise, these will be full surfaces that hold converted/scaled copies.
+    // output surfaces are in the app-requested format. If no conversion is necessary (or the app borrows frames),
+    // we'll just use the pointers the backend fills into acquired_surface, and you can get all the way from DMA
+    // access in the camera hardware to the app without a single copy. Otherwise, these will be full surfaces that
+    // hold converted/scaled copies.
 
-    for (int i = 0; i < (SDL_arraysize(device->output_surfaces) - 1); i++) {
-        device->output_surfaces[i].next = &device->output_surfaces[i + 1];
+    // frames passed through still sit in the backend's buffers, so if it only has so many, keep one free for it
+    // to capture into. Otherwise it stalls while the app holds the rest, and there's nothing fresh to replace
+    // stale queued frames with.
+    int num_slots = queue_depth;
+    if (device->passthrough && (device->buffer_count > 0)) {
+        num_slots = SDL_clamp(device->buffer_count - 1, 1, queue_depth);
     }
-    device->empty_output_surfaces.next = device->output_surfaces;
 
-    for (int i = 0; i < SDL_arraysize(device->output_surfaces); i++) {
+    Uint32 queue_size = 1;
+    while (queue_size < (Uint32) num_slots) {
+        queue_size <<= 1;
+    }
+    device->output_slots = (CameraOutputSlot *) SDL_calloc(num_slots, sizeof (CameraOutputSlot));
+    device->output_queue = (SDL_AtomicInt *) SDL_calloc(queue_size, sizeof (SDL_AtomicInt));
+    device->output_released = (overflow_policy == SDL_CAMERA_OVERFLOW_BLOCK) ? SDL_CreateSemaphore(0) : NULL;
+    if (!device->output_slots || !device->output_queue || ((overflow_policy == SDL_CAMERA_OVERFLOW_BLOCK) && !device->output_released)) {
+        ClosePhysicalCamera(device);
+        ReleaseCamera(device);
+        return NULL;
+    }
+    device->num_output_slots = num_slots;
+    device->output_queue_mask = queue_size - 1;
+    device->overflow_policy = overflow_policy;
+    device->reserved_output_slot = -1;
+
+    for (int i = 0; i < num_slots; i++) {
         SDL_Surface *surf;
-        if (device->needs_scaling || device->needs_conversion) {
-            surf = SDL_CreateSurface(device->spec.width, device->spec.height, device->spec.format);
+        if (device->passthrough) {
+            surf = SDL_CreateSurfaceFrom(closest.width, closest.height, closest.format, NULL, 0);
         } else {
-            surf = SDL_CreateSurfaceFrom(device->spec.width, device->spec.height, device->spec.format, NULL, 0);
+            surf = SDL_CreateSurface(device->spec.width, device->spec.height, device->spec.format);
         }
         if (!surf) {
             ClosePhysicalCamera(device);
@@ -1179,7 +1460,27 @@ SDL_Camera *SDL_OpenCamera(SDL_CameraID instance_id, const SDL_CameraSpec *spec)
         }
         SDL_SetSurfaceColorspace(surf, closest.colorspace);
 
-        device->output_surfaces[i].surface = surf;
+        device->output_slots[i].surface = surf;
+    }
+
+    if (device->needs_scaling) {
+        // downscale in the device's format before converting, upscale in the app's format after converting.
+        const SDL_PixelFormat scale_format = (device->needs_scaling < 0) ? closest.format : device->spec.format;
+        GetCameraFitRects(closest.width, closest.height, device->spec.width, device->spec.height, fit,
+                          SDL_ISPIXELFORMAT_FOURCC(scale_format), &device->scale_srcrect, &device->scale_dstrect);
+        device->scaler = SDL_CreateCameraScaler(scale_format, &device->scale_srcrect, &device->scale_dstrect);  // NULL is okay, we'll fall back to SDL_SoftStretch.
+
+        // letterboxing leaves the edges of the scaled frame alone, so make them black once, up front.
+        //  (borrowed frames get their converted surfaces cleared when they are first made.)
+        if (IsCameraLetterboxed(device)) {
+            if ((device->needs_scaling < 0) && device->needs_conversion) {
+                SDL_ClearSurface(device->conversion_surface, 0.0f, 0.0f, 0.0f, 1.0f);
+            } else if (!device->passthrough) {
+                for (int i = 0; i < num_slots; i++) {
+                    SDL_ClearSurface(device->output_slots[i].surface, 0.0f, 0.0f, 0.0f, 1.0f);
+                }
+            }
+        }
     }
 
     device->drop_frames = 1;
@@ -1215,36 +1516,40 @@ SDL_Surface *SDL_AcquireCameraFrame(SDL_Camera *camera, Uint64 *timestampNS)
 
     SDL_Camera *device = (SDL_Camera *) camera;  // currently there's no separation between physical and logical device.
 
-    ObtainPhysicalCameraObj(device);
+    // this doesn't take device->lock; frames come off output_queue lock-free, so we never wait on the camera thread.
+    RefPhysicalCamera(device);
 
     if (device->permission <= 0) {
-        ReleaseCamera(device);
+        UnrefPhysicalCamera(device);
         SDL_SetError("Camera permission has not been granted");
         return NULL;
     }
 
     SDL_Surface *result = NULL;
 
-    // frames are in this list from newest to oldest, so find the end of the list...
-    SurfaceList *slistprev = &device->filled_output_surfaces;
-    SurfaceList *slist = slistprev;
-    while (slist->next) {
-        slistprev = slist;
-        slist = slist->next;
-    }
-
-    const bool list_is_empty = (slist == slistprev);
-    if (!list_is_empty) { // report the oldest frame.
+    const int slot = PopOutputSlot(device);  // report the oldest frame.
+    if (slot >= 0) {
+        CameraOutputSlot *output = &device->output_slots[slot];
         if (timestampNS) {
-            *timestampNS = slist->timestampNS;
+            *timestampNS = output->timestampNS;
         }
-        result = slist->surface;
-        slistprev->next = slist->next;  // remove from filled list.
-        slist->next = device->app_held_output_surfaces.next;  // add to app_held list.
-        device->app_held_output_surfaces.next = slist;
+        result = output->surface;
+
+        // frames lost anywhere between the previous frame the app got and this one: by the hardware, or in our queue.
+        Uint64 dropped = 0;
+        SDL_LockSpinlock(&device->stats_lock);
+        if (device->acquired_any && (output->sequence > device->last_acquired_sequence)) {
+            dropped = output->sequence - device->last_acquired_sequence - 1;
+        }
+        device->last_acquired_sequence = output->sequence;
+        device->acquired_any = true;
+        SDL_UnlockSpinlock(&device->stats_lock);
+        SDL_SetNumberProperty(SDL_GetSurfaceProperties(result), SDL_PROP_CAMERA_FRAME_DROPPED_NUMBER, (Sint64) dropped);
+
+        SDL_SetAtomicInt(&output->state, CAMERA_OUTPUT_SLOT_HELD);
     }
 
-    ReleaseCamera(device);
+    UnrefPhysicalCamera(device);
 
     return result;
 }
@@ -1256,39 +1561,99 @@ void SDL_ReleaseCameraFrame(SDL_Camera *camera, SDL_Surface *frame)
     }
 
     SDL_Camera *device = (SDL_Camera *) camera;  // currently there's no separation between physical and logical device.
-    ObtainPhysicalCameraObj(device);
+    RefPhysicalCamera(device);
 
-    SurfaceList *slistprev = &device->app_held_output_surfaces;
-    SurfaceList *slist;
-    for (slist = slistprev->next; slist != NULL; slist = slist->next) {
-        if (slist->surface == frame) {
+    CameraOutputSlot *output = NULL;
+    for (int i = 0; i < device->num_output_slots; i++) {
+        if ((device->output_slots[i].surface == frame) && (SDL_GetAtomicInt(&device->output_slots[i].state) == CAMERA_OUTPUT_SLOT_HELD)) {
+            output = &device->output_slots[i];
             break;
         }
-        slistprev = slist;
     }
 
-    if (!slist) {
-        ReleaseCamera(device);
+    if (!output) {
+        UnrefPhysicalCamera(device);
         return;
     }
 
     // this pointer was owned by the backend (DMA memory or whatever), clear it out.
-    if (!device->needs_conversion && !device->needs_scaling) {
+    //  (held under the lock, so a disconnect can't swap in the zombie interfaces and tear the backend down mid-call.)
+    if (device->passthrough) {
+        SDL_LockMutex(device->lock);
         device->ReleaseFrame(device, frame);
+        SDL_UnlockMutex(device->lock);
         frame->pixels = NULL;
         frame->pitch = 0;
     }
 
-    slist->timestampNS = 0;
+    output->timestampNS = 0;
+    output->converted_valid = false;
 
-    // remove from app_held list...
-    slistprev->next = slist->next;
+    // the camera thread can fill it again now.
+    SDL_SetAtomicInt(&output->state, CAMERA_OUTPUT_SLOT_FREE);
+    if (device->output_released) {
+        SDL_SignalSemaphore(device->output_released);
+    }
 
-    // insert at front of empty list (and we'll use it first when we need to fill a new frame).
-    slist->next = device->empty_output_surfaces.next;
-    device->empty_output_surfaces.next = slist;
+    UnrefPhysicalCamera(device);
+}
 
-    ReleaseCamera(device);
+SDL_Surface *SDL_ConvertCameraFrame(SDL_Camera *camera, SDL_Surface *frame)
+{
+    if (!camera) {
+        SDL_InvalidParamError("camera");
+        return NULL;
+    } else if (!frame) {
+        SDL_InvalidParamError("frame");
+        return NULL;
+    }
+
+    SDL_Camera *device = (SDL_Camera *) camera;  // currently there's no separation between physical and logical device.
+
+    if (!device->borrow_frames || (!device->needs_scaling && !device->needs_conversion)) {
+        return frame;  // already in the requested spec.
+    }
+
+    RefPhysicalCamera(device);
+
+    CameraOutputSlot *output = NULL;
+    for (int i = 0; i < device->num_output_slots; i++) {
+        if ((device->output_slots[i].surface == frame) && (SDL_GetAtomicInt(&device->output_slots[i].state) == CAMERA_OUTPUT_SLOT_HELD)) {
+            output = &device->output_slots[i];
+            break;
+        }
+    }
+
+    SDL_Surface *result = NULL;
+    if (!output) {
+        SDL_SetError("Not a frame acquired from this camera");
+    } else {
+        // the camera thread never converts borrowed frames, so this only waits on other app threads converting.
+        SDL_LockMutex(device->convert_lock);
+        if (!output->converted) {
+            output->converted = SDL_CreateSurface(device->spec.width, device->spec.height, device->spec.format);
+            if (output->converted) {
+                SDL_SetSurfaceColorspace(output->converted, device->actual_spec.colorspace);
+                if (IsCameraLetterboxed(device) && ((device->needs_scaling > 0) || !device->needs_conversion)) {
+                    SDL_ClearSurface(output->converted, 0.0f, 0.0f, 0.0f, 1.0f);
+                }
+            }
+        }
+        if (output->converted) {
+            if (!output->converted_valid) {
+                const Uint64 start = SDL_GetTicksNS();
+                ConvertCameraFrame(device, frame, output->converted);
+                SDL_SetNumberProperty(SDL_GetSurfaceProperties(frame), SDL_PROP_CAMERA_FRAME_CONVERSION_NS_NUMBER, (Sint64) (SDL_GetTicksNS() - start));
+                output->converted_valid = true;
+            }
+            result = output->converted;
+        }
+        SDL_UnlockMutex(device->convert_lock);
+    }
+
+    UnrefPhysicalCamera(device);
+
+    return result;
 }
 
 SDL_CameraID SDL_GetCameraID(SDL_Camera *camera)
@@ -1318,6 +1683,18 @@ SDL_PropertiesID SDL_GetCameraProperties(SDL_Camera *camera)
             device->props = SDL_CreateProperties();
         }
         result = device->props;
+        if (result && device->output_slots) {
+            const Uint32 depth = (Uint32) SDL_GetAtomicInt(&device->output_write) - (Uint32) SDL_GetAtomicInt(&device->output_read);
+            SDL_LockSpinlock(&device->stats_lock);
+            const Uint64 frames_dropped = device->frames_dropped;
+            const Uint64 queue_wait_ns = device->queue_wait_ns;
+            SDL_UnlockSpinlock(&device->stats_lock);
+            SDL_SetNumberProperty(result, SDL_PROP_CAMERA_QUEUE_CAPACITY_NUMBER, device->num_output_slots);
+            SDL_SetNumberProperty(result, SDL_PROP_CAMERA_QUEUE_DEPTH_NUMBER, depth);
+            SDL_SetNumberProperty(result, SDL_PROP_CAMERA_QUEUE_PEAK_DEPTH_NUMBER, SDL_GetAtomicInt(&device->peak_queue_depth));
+            SDL_SetNumberProperty(result, SDL_PROP_CAMERA_FRAMES_DROPPED_NUMBER, (Sint64) frames_dropped);
+            SDL_SetNumberProperty(result, SDL_PROP_CAMERA_QUEUE_WAIT_NS_NUMBER, (Sint64) queue_wait_ns);
+        }
         ReleaseCamera(device);
     }
 
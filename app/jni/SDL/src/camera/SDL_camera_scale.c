@@ -0,0 +1,434 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2024 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+#include "SDL_syscamera.h"
+
+// Resampling for camera frames. This works on each plane of the camera's native format, so YUV frames are
+//  scaled before color conversion, and only has to handle 8-bit samples. Each axis is filtered separately:
+//  a box (area-averaging) filter when shrinking by 2x or more, and bilinear otherwise.
+
+#define CAMERA_SCALE_WEIGHT_BITS 12
+#define CAMERA_SCALE_WEIGHT_ONE (1 << CAMERA_SCALE_WEIGHT_BITS)
+#define CAMERA_SCALE_MAX_PLANES 3
+
+typedef struct CameraScaleAxis
+{
+    int *start;        // first source sample for each destination sample
+    int *count;        // number of source samples that contribute to each destination sample
+    int *offset;       // where each destination sample's weights begin in `weights`
+    Uint16 *weights;   // weights for each destination sample, summing to CAMERA_SCALE_WEIGHT_ONE
+    int taps;          // the most source samples any destination sample reads
+} CameraScaleAxis;
+
+// Where a plane's samples are in memory, relative to the surface's pixels.
+typedef struct CameraPlaneLayout
+{
+    int offset;          // bytes from the start of the plane to its first sample's first channel
+    int sample_stride;   // bytes between horizontally adjacent samples
+    int channel_stride;  // bytes between channels of one sample
+    int channels;
+    int xshift;          // log2 of horizontal subsampling
+    int yshift;          // log2 of vertical subsampling
+} CameraPlaneLayout;
+
+typedef struct CameraScalePlane
+{
+    CameraPlaneLayout layout;
+    SDL_Rect srcrect;    // in this plane's samples
+    SDL_Rect dstrect;
+    CameraScaleAxis x;
+    CameraScaleAxis y;
+    bool resample;       // packed 1 or 4 channels shrunk 2x or more both ways, done by SDL_SoftStretchSamples()
+} CameraScalePlane;
+
+struct SDL_CameraScaler
+{
+    SDL_PixelFormat format;
+    int num_planes;
+    CameraScalePlane planes[CAMERA_SCALE_MAX_PLANES];
+    size_t rows_len;  // samples in `rows`, enough for the plane that needs the most
+    Uint16 *rows;     // ring of the last `y.taps` horizontally filtered source rows, 4 fractional bits
+    Uint32 *accum;    // one destination row being summed vertically
+    size_t accum_len;
+};
+
+static int GetCameraPlaneLayouts(SDL_PixelFormat format, CameraPlaneLayout *layouts)
+{
+    SDL_memset(layouts, 0, sizeof (*layouts) * CAMERA_SCALE_MAX_PLANES);
+
+    #define SET_LAYOUT(i, off, sstride, cstride, chans, xs, ys) \
+        layouts[i].offset = off; layouts[i].sample_stride = sstride; layouts[i].channel_stride = cstride; \
+        layouts[i].channels = chans; layouts[i].xshift = xs; layouts[i].yshift = ys
+
+    switch (format) {
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+        SET_LAYOUT(0, 0, 1, 1, 1, 0, 0);
+        SET_LAYOUT(1, 0, 2, 1, 2, 1, 1);
+        return 2;
+    case SDL_PIXELFORMAT_YV12:
+    case SDL_PIXELFORMAT_IYUV:
+        SET_LAYOUT(0, 0, 1, 1, 1, 0, 0);
+        SET_LAYOUT(1, 0, 1, 1, 1, 1, 1);
+        SET_LAYOUT(2, 0, 1, 1, 1, 1, 1);
+        return 3;
+    case SDL_PIXELFORMAT_YUY2:
+    case SDL_PIXELFORMAT_YVYU:
+        SET_LAYOUT(0, 0, 2, 1, 1, 0, 0);
+        SET_LAYOUT(1, 1, 4, 2, 2, 1, 0);
+        return 2;
+    case SDL_PIXELFORMAT_UYVY:
+        SET_LAYOUT(0, 1, 2, 1, 1, 0, 0);
+        SET_LAYOUT(1, 0, 4, 2, 2, 1, 0);
+        return 2;
+    default:
+        break;
+    }
+
+    // packed RGB formats with 8 bits in every channel can be filtered byte by byte. The padding byte of the
+    //  XRGB8888 family counts as a channel of its own: 24 bits per pixel, but 4 bytes.
+    if (!SDL_ISPIXELFORMAT_FOURCC(format) &&
+        (((SDL_PIXELTYPE(format) == SDL_PIXELTYPE_PACKED32) && (SDL_PIXELLAYOUT(format) == SDL_PACKEDLAYOUT_8888)) ||
+         ((SDL_PIXELTYPE(format) == SDL_PIXELTYPE_ARRAYU8) && (SDL_BYTESPERPIXEL(format) == 3)))) {
+        const int bpp = SDL_BYTESPERPIXEL(format);
+        SET_LAYOUT(0, 0, bpp, 1, bpp, 0, 0);
+        return 1;
+    }
+
+    #undef SET_LAYOUT
+
+    return 0;  // not a format we can resample.
+}
+
+// Find each plane's first byte in `surface`, matching the plane order of GetCameraPlaneLayouts().
+static void GetCameraPlanes(SDL_Surface *surface, Uint8 **planes, int *pitches)
+{
+    Uint8 *pixels = (Uint8 *) surface->pixels;
+    const int pitch = surface->pitch;
+    const int h = surface->h;
+
+    planes[0] = pixels;
+    pitches[0] = pitch;
+
+    switch (surface->format) {
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+        planes[1] = pixels + pitch * h;
+        pitches[1] = 2 * ((pitch + 1) / 2);
+        break;
+    case SDL_PIXELFORMAT_YV12:
+    case SDL_PIXELFORMAT_IYUV:
+        planes[1] = pixels + pitch * h;
+        pitches[1] = (pitch + 1) / 2;
+        planes[2] = planes[1] + pitches[1] * ((h + 1) / 2);
+        pitches[2] = pitches[1];
+        break;
+    case SDL_PIXELFORMAT_YUY2:
+    case SDL_PIXELFORMAT_YVYU:
+    case SDL_PIXELFORMAT_UYVY:
+        planes[1] = pixels;
+        pitches[1] = pitch;
+        break;
+    default:
+        break;
+    }
+}
+
+static void FreeCameraScaleAxis(CameraScaleAxis *axis)
+{
+    SDL_free(axis->start);
+    SDL_free(axis->count);
+    SDL_free(axis->offset);
+    SDL_free(axis->weights);
+    SDL_zerop(axis);
+}
+
+// Work out which source samples feed each destination sample along one axis, and how much each one counts.
+static bool BuildCameraScaleAxis(CameraScaleAxis *axis, int srcpos, int srclen, int dstlen)
+{
+    const double ratio = (double) srclen / (double) dstlen;
+    const bool box = (ratio >= 2.0);
+    const int max_taps = box ? ((int) SDL_ceil(ratio) + 1) : 2;
+
+    axis->start = (int *) SDL_malloc(sizeof (int) * dstlen);
+    axis->count = (int *) SDL_malloc(sizeof (int) * dstlen);
+    axis->offset = (int *) SDL_malloc(sizeof (int) * dstlen);
+    axis->weights = (Uint16 *) SDL_malloc(sizeof (Uint16) * dstlen * max_taps);
+    double *w = (double *) SDL_malloc(sizeof (double) * max_taps);
+    if (!axis->start || !axis->count || !axis->offset || !axis->weights || !w) {
+        FreeCameraScaleAxis(axis);
+        SDL_free(w);
+        return false;
+    }
+
+    int offset = 0;
+    axis->taps = 0;
+    for (int i = 0; i < dstlen; i++) {
+        int first, count;
+
+        if (box) {
+            // average every source sample the destination sample covers, counting partly-covered ones by how much is covered.
+            const double lo = i * ratio;
+            const double hi = SDL_min((i + 1) * ratio, (double) srclen);
+            first = (int) lo;
+            count = 0;
+            for (int k = first; (k < srclen) && (k < hi); k++) {
+                const double overlap = SDL_min(hi, (double) (k + 1)) - SDL_max(lo, (double) k);
+                w[count] = overlap / ratio;
+                count++;
+            }
+        } else {
+            // bilinear, with sample centers lined up between source and destination.
+            double pos = (i + 0.5) * ratio - 0.5;
+            if (pos < 0.0) {
+                pos = 0.0;
+            }
+            first = (int) pos;
+            const double frac = pos - first;
+            if ((first >= srclen - 1) || (frac == 0.0)) {
+                first = SDL_min(first, srclen - 1);
+                count = 1;
+                w[0] = 1.0;
+            } else {
+                count = 2;
+                w[0] = 1.0 - frac;
+                w[1] = frac;
+            }
+        }
+
+        SDL_assert(count <= max_taps);
+
+        // quantize, handing any rounding error to the heaviest tap so the weights always sum to exactly one.
+        int total = 0;
+        int heaviest = 0;
+        for (int k = 0; k < count; k++) {
+            const int q = (int) (w[k] * CAMERA_SCALE_WEIGHT_ONE + 0.5);
+            axis->weights[offset + k] = (Uint16) q;
+            total += q;
+            if (q > axis->weights[offset + heaviest]) {
+                heaviest = k;
+            }
+        }
+        axis->weights[offset + heaviest] = (Uint16) (axis->weights[offset + heaviest] + (CAMERA_SCALE_WEIGHT_ONE - total));
+
+        axis->start[i] = srcpos + first;
+        axis->count[i] = count;
+        axis->offset[i] = offset;
+        axis->taps = SDL_max(axis->taps, count);
+        offset += count;
+    }
+
+    SDL_free(w);
+    return true;
+}
+
+// Scale a rect on the full-resolution frame down to a subsampled plane.
+static void GetCameraPlaneRect(const SDL_Rect *rect, int xshift, int yshift, SDL_Rect *result)
+{
+    result->x = rect->x >> xshift;
+    result->y = rect->y >> yshift;
+    result->w = ((rect->x + rect->w + (1 << xshift) - 1) >> xshift) - result->x;
+    result->h = ((rect->y + rect->h + (1 << yshift) - 1) >> yshift) - result->y;
+}
+
+void SDL_DestroyCameraScaler(SDL_CameraScaler *scaler)
+{
+    if (scaler) {
+        for (int i = 0; i < scaler->num_planes; i++) {
+            FreeCameraScaleAxis(&scaler->planes[i].x);
+            FreeCameraScaleAxis(&scaler->planes[i].y);
+        }
+        SDL_free(scaler->rows);
+        SDL_free(scaler->accum);
+        SDL_free(scaler);
+    }
+}
+
+// Allocate the working rows of the generic path, if they aren't already.
+static bool AllocCameraScaleRows(SDL_CameraScaler *scaler)
+{
+    if (!scaler->rows) {
+        scaler->rows = (Uint16 *) SDL_malloc(scaler->rows_len * sizeof (Uint16));
+    }
+    if (!scaler->accum) {
+        scaler->accum = (Uint32 *) SDL_malloc(scaler->accum_len * sizeof (Uint32));
+    }
+    return (scaler->rows && scaler->accum);
+}
+
+SDL_CameraScaler *SDL_CreateCameraScaler(SDL_PixelFormat format, const SDL_Rect *srcrect, const SDL_Rect *dstrect)
+{
+    CameraPlaneLayout layouts[CAMERA_SCALE_MAX_PLANES];
+    const int num_planes = GetCameraPlaneLayouts(format, layouts);
+    if (num_planes == 0) {
+        return NULL;  // not an error, the caller falls back to SDL_SoftStretch().
+    }
+
+    SDL_CameraScaler *scaler = (SDL_CameraScaler *) SDL_calloc(1, sizeof (*scaler));
+    if (!scaler) {
+        return NULL;
+    }
+
+    scaler->format = format;
+    scaler->num_planes = num_planes;
+
+    bool generic = false;
+    for (int i = 0; i < num_planes; i++) {
+        CameraScalePlane *plane = &scaler->planes[i];
+        SDL_copyp(&plane->layout, &layouts[i]);
+        GetCameraPlaneRect(srcrect, plane->layout.xshift, plane->layout.yshift, &plane->srcrect);
+        GetCameraPlaneRect(dstrect, plane->layout.xshift, plane->layout.yshift, &plane->dstrect);
+        if (!BuildCameraScaleAxis(&plane->x, plane->srcrect.x, plane->srcrect.w, plane->dstrect.w) ||
+            !BuildCameraScaleAxis(&plane->y, plane->srcrect.y, plane->srcrect.h, plane->dstrect.h)) {
+            scaler->num_planes = i + 1;
+            SDL_DestroyCameraScaler(scaler);
+            return NULL;
+        }
+        // both axes are box filtered then, which is SDL_STRETCH_FILTER_AREA with SIMD row kernels.
+        plane->resample = ((plane->layout.channels == 1) || (plane->layout.channels == 4)) &&
+                          (plane->layout.sample_stride == plane->layout.channels) && (plane->layout.channel_stride == 1) &&
+                          (plane->srcrect.w >= 2 * plane->dstrect.w) && (plane->srcrect.h >= 2 * plane->dstrect.h);
+        const size_t rowlen = (size_t) plane->dstrect.w * plane->layout.channels;
+        scaler->rows_len = SDL_max(scaler->rows_len, rowlen * plane->y.taps);
+        scaler->accum_len = SDL_max(scaler->accum_len, rowlen);
+        generic = generic || !plane->resample;
+    }
+
+    // resampled planes only need these if SDL_SoftStretchSamples() runs out of memory, so they're allocated then.
+    if (generic && !AllocCameraScaleRows(scaler)) {
+        SDL_DestroyCameraScaler(scaler);
+        return NULL;
+    }
+
+    return scaler;
+}
+
+static bool ScaleCameraPlane(SDL_CameraScaler *scaler, const CameraScalePlane *plane, const Uint8 *src, int src_pitch, Uint8 *dst, int dst_pitch)
+{
+    const CameraPlaneLayout *layout = &plane->layout;
+    const int channels = layout->channels;
+    const int sstride = layout->sample_stride;
+    const int cstride = layout->channel_stride;
+    const int dstw = plane->dstrect.w;
+    const int dsth = plane->dstrect.h;
+    const int rowlen = dstw * channels;
+    const CameraScaleAxis *xaxis = &plane->x;
+    const CameraScaleAxis *yaxis = &plane->y;
+    const int taps = yaxis->taps;
+
+    src += layout->offset;
+    dst += layout->offset + (plane->dstrect.y * dst_pitch) + (plane->dstrect.x * sstride);
+
+    if (plane->resample) {
+        const Uint8 *srcpixels = src + (plane->srcrect.y * src_pitch) + (plane->srcrect.x * sstride);
+        if (SDL_SoftStretchSamples(srcpixels, plane->srcrect.w, plane->srcrect.h, src_pitch, dst, dstw, dsth, dst_pitch, channels, SDL_STRETCH_FILTER_AREA)) {
+            return true;
+        }
+        // out of memory for the coefficient tables, so do it the slow way.
+        if (!AllocCameraScaleRows(scaler)) {
+            return false;
+        }
+    }
+
+    // destination rows read overlapping runs of source rows that only ever move down, so each source row is
+    //  filtered horizontally once, into a ring holding the last `taps` of them.
+    Uint32 *accum = scaler->accum;
+    int filtered = 0;  // source rows, from the top of srcrect, that went through the horizontal pass
+    for (int y = 0; y < dsth; y++) {
+        const Uint16 *w = yaxis->weights + yaxis->offset[y];
+        const int count = yaxis->count[y];
+        const int first = yaxis->start[y] - plane->srcrect.y;
+
+        // horizontal pass: the new source rows, into 16-bit samples with 4 fractional bits.
+        for (filtered = SDL_max(filtered, first); filtered < first + count; filtered++) {
+            const Uint8 *srcrow = src + ((plane->srcrect.y + filtered) * src_pitch);
+            Uint16 *out = scaler->rows + ((size_t) (filtered % taps) * rowlen);
+            for (int x = 0; x < dstw; x++) {
+                const Uint8 *s = srcrow + (xaxis->start[x] * sstride);
+                const Uint16 *xw = xaxis->weights + xaxis->offset[x];
+                const int xcount = xaxis->count[x];
+                for (int c = 0; c < channels; c++) {
+                    const Uint8 *sc = s + (c * cstride);
+                    Uint32 sum = 0;
+                    for (int k = 0; k < xcount; k++) {
+                        sum += (Uint32) xw[k] * sc[k * sstride];
+                    }
+                    *(out++) = (Uint16) ((sum + (1 << (CAMERA_SCALE_WEIGHT_BITS - 5))) >> (CAMERA_SCALE_WEIGHT_BITS - 4));
+                }
+            }
+        }
+
+        // vertical pass: sum the filtered rows this destination row covers, then round back to 8 bits.
+        const Uint16 *row = scaler->rows + ((size_t) (first % taps) * rowlen);
+        for (int i = 0; i < rowlen; i++) {
+            accum[i] = (Uint32) w[0] * row[i];
+        }
+        for (int k = 1; k < count; k++) {
+            const Uint32 weight = w[k];
+            row = scaler->rows + ((size_t) ((first + k) % taps) * rowlen);
+            for (int i = 0; i < rowlen; i++) {
+                accum[i] += weight * row[i];
+            }
+        }
+
+        Uint8 *out = dst + (y * dst_pitch);
+        const Uint32 *a = accum;
+        if ((channels == sstride) && (cstride == 1)) {  // tightly packed, write straight through.
+            for (int i = 0; i < rowlen; i++) {
+                out[i] = (Uint8) ((a[i] + (1 << (CAMERA_SCALE_WEIGHT_BITS + 3))) >> (CAMERA_SCALE_WEIGHT_BITS + 4));
+            }
+        } else {
+            for (int x = 0; x < dstw; x++) {
+                for (int c = 0; c < channels; c++) {
+                    out[(x * sstride) + (c * cstride)] = (Uint8) ((*(a++) + (1 << (CAMERA_SCALE_WEIGHT_BITS + 3))) >> (CAMERA_SCALE_WEIGHT_BITS + 4));
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool SDL_CameraScale(SDL_CameraScaler *scaler, SDL_Surface *src, SDL_Surface *dst)
+{
+    SDL_assert(src->format == scaler->format);
+    SDL_assert(dst->format == scaler->format);
+
+    Uint8 *srcplanes[CAMERA_SCALE_MAX_PLANES] = { NULL, NULL, NULL };
+    Uint8 *dstplanes[CAMERA_SCALE_MAX_PLANES] = { NULL, NULL, NULL };
+    int srcpitches[CAMERA_SCALE_MAX_PLANES] = { 0, 0, 0 };
+    int dstpitches[CAMERA_SCALE_MAX_PLANES] = { 0, 0, 0 };
+
+    if (!src->pixels || !dst->pixels) {
+        return SDL_SetError("Camera frame has no pixels");
+    }
+
+    GetCameraPlanes(src, srcplanes, srcpitches);
+    GetCameraPlanes(dst, dstplanes, dstpitches);
+
+    for (int i = 0; i < scaler->num_planes; i++) {
+        if (!ScaleCameraPlane(scaler, &scaler->planes[i], srcplanes[i], srcpitches[i], dstplanes[i], dstpitches[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
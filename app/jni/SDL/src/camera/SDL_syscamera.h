@@ -66,6 +66,13 @@ typedef struct CameraFormatAddData
 
 bool SDL_AddCameraFormat(CameraFormatAddData *data, SDL_PixelFormat format, SDL_Colorspace colorspace, int w, int h, int framerate_numerator, int framerate_denominator);
 
+// Resamples frames of one pixel format from a source rect to a destination rect, plane by plane, so YUV
+//  frames can be scaled before they are converted. Returns NULL if `format` isn't supported; use SDL_SoftStretch() then.
+typedef struct SDL_CameraScaler SDL_CameraScaler;
+extern SDL_CameraScaler *SDL_CreateCameraScaler(SDL_PixelFormat format, const SDL_Rect *srcrect, const SDL_Rect *dstrect);
+extern bool SDL_CameraScale(SDL_CameraScaler *scaler, SDL_Surface *src, SDL_Surface *dst);
+extern void SDL_DestroyCameraScaler(SDL_CameraScaler *scaler);
+
 typedef enum SDL_CameraFrameResult
 {
     SDL_CAMERA_FRAME_ERROR,
@@ -73,12 +80,24 @@ typedef enum SDL_CameraFrameResult
     SDL_CAMERA_FRAME_READY
 } SDL_CameraFrameResult;
 
-typedef struct SurfaceList
+// Who owns an output surface right now. Only the owner may touch the surface or move it to the next state.
+typedef enum CameraOutputSlotState
+{
+    CAMERA_OUTPUT_SLOT_FREE,     // nobody; the camera thread may claim it.
+    CAMERA_OUTPUT_SLOT_FILLING,  // the camera thread is filling it.
+    CAMERA_OUTPUT_SLOT_QUEUED,   // waiting in output_queue for the app.
+    CAMERA_OUTPUT_SLOT_HELD      // the app acquired it and hasn't released it yet.
+} CameraOutputSlotState;
+
+typedef struct CameraOutputSlot
 {
     SDL_Surface *surface;
     Uint64 timestampNS;
-    struct SurfaceList *next;
-} SurfaceList;
+    Uint64 sequence;
+    SDL_AtomicInt state;  // a CameraOutputSlotState
+    SDL_Surface *converted;  // for borrowed frames: the frame in the app-requested spec, made on demand by SDL_ConvertCameraFrame.
+    bool converted_valid;    // true if `converted` holds this frame rather than an older one.
+} CameraOutputSlot;
 
 // Define the SDL camera driver structure
 struct SDL_Camera
@@ -124,20 +143,51 @@ struct SDL_Camera
     // Backend timestamp of first acquired frame, so we can keep these meaningful regardless of epoch.
     Uint64 base_timestamp;
 
-    // SDL timestamp of first acquired frame, so we can roughly convert to SDL ticks.
+    // SDL timestamp of first acquired frame, so we can roughly convert to SDL ticks. This gets pulled back if a
+    //  later frame arrives with less delay than the first one did.
     Uint64 adjust_timestamp;
 
+    // Backends that number their frames (counting ones the hardware lost) set this in AcquireFrame. It's -1
+    //  otherwise, and SDL numbers frames itself, in next_sequence.
+    Sint64 acquire_sequence;
+    Uint64 next_sequence;
+
     // Pixel data flows from the driver into these, then gets converted for the app if necessary.
     SDL_Surface *acquire_surface;
 
-    // acquire_surface converts or scales to this surface before landing in output_surfaces, if necessary.
+    // acquire_surface converts or scales to this surface before landing in output_slots, if necessary.
     SDL_Surface *conversion_surface;
 
-    // A queue of surfaces that buffer converted/scaled frames of video until the app claims them.
-    SurfaceList output_surfaces[8];
-    SurfaceList filled_output_surfaces;        // this is FIFO
-    SurfaceList empty_output_surfaces;         // this is LIFO
-    SurfaceList app_held_output_surfaces;
+    // Surfaces that buffer converted/scaled frames of video until the app claims them.
+    CameraOutputSlot *output_slots;
+    int num_output_slots;
+
+    // Slot the camera thread has claimed for the next frame, or -1. Only the camera thread touches this.
+    int reserved_output_slot;
+
+    // Ring of indices into output_slots, oldest first, so frames go from the camera thread to the app without
+    //  taking `lock`. Only the camera thread advances output_write; the app advances output_read to acquire a
+    //  frame, and the camera thread does too when it drops the oldest frame, so output_read only moves by CAS.
+    SDL_AtomicInt *output_queue;
+    Uint32 output_queue_mask;
+    SDL_AtomicInt output_read;
+    SDL_AtomicInt output_write;
+
+    // What to do with a new frame when every output slot is in use.
+    SDL_CameraOverflowPolicy overflow_policy;
+
+    // Signaled when the app releases a frame, so a camera thread using SDL_CAMERA_OVERFLOW_BLOCK can wake up.
+    SDL_Semaphore *output_released;
+
+    // Queue statistics. These only change when a frame is dropped or the camera thread has to wait.
+    SDL_SpinLock stats_lock;
+    Uint64 frames_dropped;
+    Uint64 queue_wait_ns;
+    SDL_AtomicInt peak_queue_depth;
+
+    // Sequence number of the last frame the app acquired, so each frame can report the gap since then. Guarded by stats_lock.
+    Uint64 last_acquired_sequence;
+    bool acquired_any;
 
     // A fake video frame we allocate if the camera fails/disconnects.
     Uint8 *zombie_pixels;
@@ -145,9 +195,30 @@ struct SDL_Camera
     // non-zero if acquire_surface needs to be scaled for final output.
     int needs_scaling;  // -1: downscale, 0: no scaling, 1: upscale
 
+    // The part of the frame that gets scaled, and where it lands, as chosen by SDL_PROP_CAMERA_CREATE_FIT_NUMBER.
+    SDL_Rect scale_srcrect;
+    SDL_Rect scale_dstrect;
+
+    // Does the scaling, if needs_scaling is non-zero. NULL if the format needs SDL_SoftStretch() instead.
+    SDL_CameraScaler *scaler;
+
     // true if acquire_surface needs to be converted for final output.
     bool needs_conversion;
 
+    // true if the app opened the camera with SDL_PROP_CAMERA_CREATE_BORROW_FRAMES_BOOLEAN, so frames are only
+    //  scaled/converted when the app calls SDL_ConvertCameraFrame.
+    bool borrow_frames;
+
+    // true if frames reach the app in the backend's buffers: no conversion is needed, or the app borrows frames.
+    bool passthrough;
+
+    // Serializes SDL_ConvertCameraFrame calls, which share conversion_surface and scaler.
+    SDL_Mutex *convert_lock;
+
+    // How many frames the backend can have out at once, if frames it hands over still sit in a fixed pool of
+    //  buffers (V4L2 mmap buffers, etc). OpenDevice sets this; zero means there's no such limit.
+    int buffer_count;
+
     // Current state flags
     SDL_AtomicInt shutdown;
     SDL_AtomicInt zombie;
@@ -211,6 +282,7 @@ typedef struct CameraBootStrap
 
 // Not all of these are available in a given build. Use #ifdefs, etc.
 extern CameraBootStrap DUMMYCAMERA_bootstrap;
+extern CameraBootStrap SYNTHETICCAMERA_bootstrap;
 extern CameraBootStrap PIPEWIRECAMERA_bootstrap;
 extern CameraBootStrap V4L2_bootstrap;
 extern CameraBootStrap COREMEDIA_bootstrap;
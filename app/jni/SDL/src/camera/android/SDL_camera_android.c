@@ -61,6 +61,9 @@
 
 #include "../../core/android/SDL_android.h"
 
+// How many images the AImageReader can have out at once.
+#define ANDROID_CAMERA_BUFFERS 10
+
 static void *libcamera2ndk = NULL;
 typedef ACameraManager* (*pfnACameraManager_create)(void);
 typedef camera_status_t (*pfnACameraManager_registerAvailabilityCallback)(ACameraManager*, const ACameraManager_AvailabilityCallbacks*);
@@ -490,7 +493,7 @@ static bool PrepareCamera(SDL_Camera *device)
 
     if ((res = pACameraManager_openCamera(cameraMgr, (const char *) device->handle, &dev_callbacks, &device->hidden->device)) != ACAMERA_OK) {
         return SetCameraError("Failed to open camera", res);
-    } else if ((res2 = pAImageReader_new(spec->width, spec->height, format_sdl_to_android(spec->format), 10 /* nb buffers */, &device->hidden->reader)) != AMEDIA_OK) {
+    } else if ((res2 = pAImageReader_new(spec->width, spec->height, format_sdl_to_android(spec->format), ANDROID_CAMERA_BUFFERS, &device->hidden->reader)) != AMEDIA_OK) {
         return SetMediaError("Error AImageReader_new", res2);
     } else if ((res2 = pAImageReader_getWindow(device->hidden->reader, &device->hidden->window)) != AMEDIA_OK) {
         return SetMediaError("Error AImageReader_getWindow", res2);
@@ -557,6 +560,9 @@ static bool ANDROIDCAMERA_OpenDevice(SDL_Camera *device, const SDL_CameraSpec *s
         return false;
     }
 
+    // device->buffer_count stays 0: AcquireFrame copies each image out and deletes it right away, so frames the app
+    //  holds never keep an AImageReader buffer.
+
     RefPhysicalCamera(device);  // ref'd until permission callback fires.
 
     // just in case SDL_OpenCamera is overwriting device->spec as CameraPermissionCallback runs, we work from a different copy.
@@ -0,0 +1,381 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2024 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_internal.h"
+
+#ifdef SDL_CAMERA_DRIVER_SYNTHETIC
+
+// A camera that generates its own frames, so the camera pipeline can be exercised and benchmarked without hardware.
+
+#include "../SDL_syscamera.h"
+#include "../../video/SDL_pixels_c.h"
+
+#define SYNTHETIC_DEFAULT_SPECS    "NV12 1920x1080@30,NV12 1280x720@30,NV12 640x480@30"
+#define SYNTHETIC_PATTERN_FRAMES   4
+#define SYNTHETIC_MAX_DROP_RATE    0.99f
+
+struct SDL_PrivateCameraData
+{
+    Uint8 *frames;      // the test pattern or the replayed file, one tightly packed frame after the other
+    size_t frame_size;
+    int pitch;
+    int num_frames;
+    Uint64 interval_ns; // 0 if uncapped
+    Uint64 jitter_ns;
+    float drop_rate;
+    int buffers;        // 0 if unlimited
+    SDL_AtomicInt buffers_out;
+    Uint64 rng;
+    Uint64 start_ns;
+    Uint64 sequence;    // index of the next frame in the timeline
+    Uint64 due_ns;      // capture time of the next frame
+};
+
+static const SDL_PixelFormat synthetic_formats[] = {
+    SDL_PIXELFORMAT_NV12,
+    SDL_PIXELFORMAT_NV21,
+    SDL_PIXELFORMAT_YUY2,
+    SDL_PIXELFORMAT_UYVY,
+    SDL_PIXELFORMAT_YVYU,
+    SDL_PIXELFORMAT_YV12,
+    SDL_PIXELFORMAT_IYUV,
+    SDL_PIXELFORMAT_XRGB8888,
+    SDL_PIXELFORMAT_ARGB8888,
+    SDL_PIXELFORMAT_XBGR8888,
+    SDL_PIXELFORMAT_ABGR8888,
+    SDL_PIXELFORMAT_RGB24,
+    SDL_PIXELFORMAT_BGR24,
+    SDL_PIXELFORMAT_RGB565
+};
+
+static SDL_PixelFormat SYNTHETICCAMERA_GetFormatByName(const char *name, size_t len)
+{
+    int i;
+
+    for (i = 0; i < SDL_arraysize(synthetic_formats); ++i) {
+        // Accept both "NV12" and "SDL_PIXELFORMAT_NV12"
+        const char *fullname = SDL_GetPixelFormatName(synthetic_formats[i]);
+        const char *shortname = fullname + SDL_strlen("SDL_PIXELFORMAT_");
+        if ((SDL_strlen(fullname) == len && SDL_strncasecmp(fullname, name, len) == 0) ||
+            (SDL_strlen(shortname) == len && SDL_strncasecmp(shortname, name, len) == 0)) {
+            return synthetic_formats[i];
+        }
+    }
+    return SDL_PIXELFORMAT_UNKNOWN;
+}
+
+// Parses one "FORMAT WIDTHxHEIGHT@FPS" entry, where an fps of 0 means uncapped.
+static bool SYNTHETICCAMERA_ParseSpec(const char *str, const char *end, SDL_CameraSpec *spec)
+{
+    const char *name;
+    char *next;
+    double fps = 30.0;
+
+    while (str < end && SDL_isspace(*str)) {
+        ++str;
+    }
+    name = str;
+    while (str < end && !SDL_isspace(*str)) {
+        ++str;
+    }
+
+    spec->format = SYNTHETICCAMERA_GetFormatByName(name, (size_t)(str - name));
+    if (spec->format == SDL_PIXELFORMAT_UNKNOWN) {
+        return false;
+    }
+    spec->colorspace = SDL_GetDefaultColorspaceForFormat(spec->format);
+
+    spec->width = (int)SDL_strtol(str, &next, 10);
+    if (next >= end || *next != 'x') {
+        return false;
+    }
+    spec->height = (int)SDL_strtol(next + 1, &next, 10);
+    if (next < end && *next == '@') {
+        fps = SDL_strtod(next + 1, &next);
+    }
+    if (next > end || spec->width <= 0 || spec->height <= 0 || fps < 0.0) {
+        return false;
+    }
+
+    if (fps == 0.0) {
+        spec->framerate_numerator = 0;
+        spec->framerate_denominator = 1;
+    } else if (fps == SDL_floor(fps)) {
+        spec->framerate_numerator = (int)fps;
+        spec->framerate_denominator = 1;
+    } else {
+        spec->framerate_numerator = (int)SDL_round(fps * 1000.0);
+        spec->framerate_denominator = 1000;
+    }
+    return true;
+}
+
+// Renders moving color bars above a gray ramp, converted to the camera format.
+static bool SYNTHETICCAMERA_GeneratePattern(SDL_Camera *device, const SDL_CameraSpec *spec)
+{
+    static const Uint32 bars[] = {
+        0xFFFFFFFF, 0xFFFFFF00, 0xFF00FFFF, 0xFF00FF00, 0xFFFF00FF, 0xFFFF0000, 0xFF0000FF, 0xFF000000
+    };
+    struct SDL_PrivateCameraData *hidden = device->hidden;
+    const int w = spec->width;
+    const int h = spec->height;
+    Uint32 *rgb;
+    int i, x, y;
+    bool result = true;
+
+    rgb = (Uint32 *)SDL_malloc((size_t)w * h * sizeof(Uint32));
+    if (!rgb) {
+        return false;
+    }
+
+    for (i = 0; result && i < hidden->num_frames; ++i) {
+        const int shift = (int)((Sint64)i * w / hidden->num_frames);
+        for (y = 0; y < h; ++y) {
+            Uint32 *row = rgb + (size_t)y * w;
+            if (y < h - h / 4) {
+                for (x = 0; x < w; ++x) {
+                    row[x] = bars[(int)((Sint64)((x + shift) % w) * SDL_arraysize(bars) / w)];
+                }
+            } else {
+                for (x = 0; x < w; ++x) {
+                    const Uint32 level = (Uint32)((Sint64)x * 255 / SDL_max(w - 1, 1));
+                    row[x] = 0xFF000000 | (level << 16) | (level << 8) | level;
+                }
+            }
+        }
+        result = SDL_ConvertPixelsAndColorspace(w, h, SDL_PIXELFORMAT_XRGB8888, SDL_COLORSPACE_SRGB, 0, rgb, w * (int)sizeof(Uint32),
+                                                spec->format, spec->colorspace, 0, hidden->frames + (size_t)i * hidden->frame_size, hidden->pitch);
+    }
+
+    SDL_free(rgb);
+    return result;
+}
+
+static void SYNTHETICCAMERA_ScheduleNextFrame(struct SDL_PrivateCameraData *hidden)
+{
+    // Dropped frames keep their slot in the timeline, so they show up as gaps in the timestamps.
+    while (hidden->drop_rate > 0.0f && SDL_randf_r(&hidden->rng) < hidden->drop_rate) {
+        ++hidden->sequence;
+    }
+
+    hidden->due_ns = hidden->start_ns + hidden->sequence * hidden->interval_ns;
+    if (hidden->jitter_ns) {
+        const Sint64 offset = (Sint64)(SDL_randf_r(&hidden->rng) * (float)(2 * hidden->jitter_ns)) - (Sint64)hidden->jitter_ns;
+        hidden->due_ns = (Uint64)SDL_max((Sint64)hidden->due_ns + offset, 0);
+    }
+}
+
+static bool SYNTHETICCAMERA_OpenDevice(SDL_Camera *device, const SDL_CameraSpec *spec)
+{
+    struct SDL_PrivateCameraData *hidden;
+    const char *file = SDL_GetHint(SDL_HINT_CAMERA_SYNTHETIC_FILE);
+    const char *hint;
+    size_t size, pitch;
+
+    if (!SDL_CalculateSurfaceSize(spec->format, spec->width, spec->height, &size, &pitch, true)) {
+        return false;
+    }
+
+    hidden = (struct SDL_PrivateCameraData *)SDL_calloc(1, sizeof(*hidden));
+    if (!hidden) {
+        return false;
+    }
+    device->hidden = hidden;
+    hidden->frame_size = size;
+    hidden->pitch = (int)pitch;
+
+    if (file && *file) {
+        // Replay raw frames of the opened spec, looping at the end of the file
+        size_t file_size = 0;
+        hidden->frames = (Uint8 *)SDL_LoadFile(file, &file_size);
+        if (!hidden->frames) {
+            goto failed;
+        }
+        hidden->num_frames = (int)SDL_min(file_size / size, SDL_MAX_SINT32);
+        if (hidden->num_frames == 0) {
+            SDL_SetError("'%s' doesn't hold a %dx%d %s frame", file, spec->width, spec->height, SDL_GetPixelFormatName(spec->format));
+            goto failed;
+        }
+    } else {
+        hidden->num_frames = SYNTHETIC_PATTERN_FRAMES;
+        hidden->frames = (Uint8 *)SDL_malloc(size * hidden->num_frames);
+        if (!hidden->frames || !SYNTHETICCAMERA_GeneratePattern(device, spec)) {
+            goto failed;
+        }
+    }
+
+    if (spec->framerate_numerator > 0 && spec->framerate_denominator > 0) {
+        hidden->interval_ns = SDL_NS_PER_SECOND * (Uint64)spec->framerate_denominator / (Uint64)spec->framerate_numerator;
+    }
+
+    hint = SDL_GetHint(SDL_HINT_CAMERA_SYNTHETIC_JITTER);
+    if (hint && hidden->interval_ns) {
+        // Keep frames in order: a frame never moves past the middle of its neighbors' slots
+        const double jitter_ns = SDL_strtod(hint, NULL) * SDL_NS_PER_MS;
+        hidden->jitter_ns = (Uint64)SDL_clamp(jitter_ns, 0.0, (double)(hidden->interval_ns / 2));
+    }
+
+    hint = SDL_GetHint(SDL_HINT_CAMERA_SYNTHETIC_DROP_RATE);
+    if (hint) {
+        hidden->drop_rate = SDL_clamp((float)SDL_strtod(hint, NULL), 0.0f, SYNTHETIC_MAX_DROP_RATE);
+    }
+
+    hint = SDL_GetHint(SDL_HINT_CAMERA_SYNTHETIC_BUFFERS);
+    if (hint) {
+        hidden->buffers = SDL_max(SDL_atoi(hint), 0);
+        device->buffer_count = hidden->buffers;
+    }
+
+    hidden->rng = 0x5EED;  // a fixed seed keeps benchmark runs reproducible
+    hidden->start_ns = SDL_GetTicksNS();
+    SYNTHETICCAMERA_ScheduleNextFrame(hidden);
+
+    // There is no permission prompt for a synthetic camera.
+    SDL_CameraPermissionOutcome(device, true);
+
+    return true;
+
+failed:
+    SDL_free(hidden->frames);
+    SDL_free(hidden);
+    device->hidden = NULL;
+    return false;
+}
+
+static void SYNTHETICCAMERA_CloseDevice(SDL_Camera *device)
+{
+    if (device->hidden) {
+        SDL_free(device->hidden->frames);
+        SDL_free(device->hidden);
+        device->hidden = NULL;
+    }
+}
+
+static bool SYNTHETICCAMERA_WaitDevice(SDL_Camera *device)
+{
+    const Uint64 now = SDL_GetTicksNS();
+
+    if (device->hidden->due_ns > now) {
+        SDL_DelayNS(device->hidden->due_ns - now);
+    }
+    return true;
+}
+
+static SDL_CameraFrameResult SYNTHETICCAMERA_AcquireFrame(SDL_Camera *device, SDL_Surface *frame, Uint64 *timestampNS)
+{
+    struct SDL_PrivateCameraData *hidden = device->hidden;
+    const Uint64 now = SDL_GetTicksNS();
+
+    if (hidden->due_ns > now) {
+        return SDL_CAMERA_FRAME_SKIP;
+    }
+
+    // Like a real sensor, frames that weren't picked up before the next one was due are lost.
+    if (hidden->interval_ns && now - hidden->start_ns >= (hidden->sequence + 1) * hidden->interval_ns) {
+        hidden->sequence = (now - hidden->start_ns) / hidden->interval_ns;
+        SYNTHETICCAMERA_ScheduleNextFrame(hidden);
+        if (hidden->due_ns > now) {
+            return SDL_CAMERA_FRAME_SKIP;
+        }
+    }
+
+    // With every buffer handed out, there is nowhere to capture into and the frame is lost.
+    if (hidden->buffers && SDL_GetAtomicInt(&hidden->buffers_out) >= hidden->buffers) {
+        ++hidden->sequence;
+        SYNTHETICCAMERA_ScheduleNextFrame(hidden);
+        return SDL_CAMERA_FRAME_SKIP;
+    }
+    SDL_AddAtomicInt(&hidden->buffers_out, 1);
+
+    frame->pixels = hidden->frames + (size_t)(hidden->sequence % hidden->num_frames) * hidden->frame_size;
+    frame->pitch = hidden->pitch;
+    *timestampNS = hidden->interval_ns ? hidden->due_ns : now;
+    device->acquire_sequence = (Sint64) hidden->sequence;
+
+    ++hidden->sequence;
+    SYNTHETICCAMERA_ScheduleNextFrame(hidden);
+
+    return SDL_CAMERA_FRAME_READY;
+}
+
+static void SYNTHETICCAMERA_ReleaseFrame(SDL_Camera *device, SDL_Surface *frame)
+{
+    // The frames are owned by the device and never written after open, just give the buffer back.
+    SDL_AddAtomicInt(&device->hidden->buffers_out, -1);
+}
+
+static void SYNTHETICCAMERA_DetectDevices(void)
+{
+    CameraFormatAddData add_data;
+    const char *specs = SDL_GetHint(SDL_HINT_CAMERA_SYNTHETIC_SPECS);
+
+    if (!specs || !*specs) {
+        specs = SYNTHETIC_DEFAULT_SPECS;
+    }
+
+    SDL_zero(add_data);
+    while (*specs) {
+        const char *end = SDL_strchr(specs, ',');
+        SDL_CameraSpec spec;
+
+        if (!end) {
+            end = specs + SDL_strlen(specs);
+        }
+        if (SYNTHETICCAMERA_ParseSpec(specs, end, &spec)) {
+            if (!SDL_AddCameraFormat(&add_data, spec.format, spec.colorspace, spec.width, spec.height, spec.framerate_numerator, spec.framerate_denominator)) {
+                break;  // Probably out of memory; we'll go with what we have, if anything.
+            }
+        }
+        specs = *end ? end + 1 : end;
+    }
+
+    if (add_data.num_specs > 0) {
+        SDL_AddCamera("SDL synthetic camera", SDL_CAMERA_POSITION_UNKNOWN, add_data.num_specs, add_data.specs, (void *)(size_t)0x1);
+    }
+    SDL_free(add_data.specs);
+}
+
+static void SYNTHETICCAMERA_FreeDeviceHandle(SDL_Camera *device)
+{
+}
+
+static void SYNTHETICCAMERA_Deinitialize(void)
+{
+}
+
+static bool SYNTHETICCAMERA_Init(SDL_CameraDriverImpl *impl)
+{
+    impl->DetectDevices = SYNTHETICCAMERA_DetectDevices;
+    impl->OpenDevice = SYNTHETICCAMERA_OpenDevice;
+    impl->CloseDevice = SYNTHETICCAMERA_CloseDevice;
+    impl->WaitDevice = SYNTHETICCAMERA_WaitDevice;
+    impl->AcquireFrame = SYNTHETICCAMERA_AcquireFrame;
+    impl->ReleaseFrame = SYNTHETICCAMERA_ReleaseFrame;
+    impl->FreeDeviceHandle = SYNTHETICCAMERA_FreeDeviceHandle;
+    impl->Deinitialize = SYNTHETICCAMERA_Deinitialize;
+
+    return true;
+}
+
+CameraBootStrap SYNTHETICCAMERA_bootstrap = {
+    "synthetic", "SDL synthetic camera driver", SYNTHETICCAMERA_Init, true
+};
+
+#endif // SDL_CAMERA_DRIVER_SYNTHETIC
@@ -146,7 +146,7 @@ static SDL_CameraFrameResult V4L2_AcquireFrame(SDL_Camera *device, SDL_Surface *
                 }
             }
 
-            *timestampNS = SDL_GetTicksNS();  // oh well, close enough.
+            *timestampNS = 0;  // read() doesn't tell us when the frame was captured, so SDL will use when it arrived.
             frame->pixels = device->hidden->buffers[0].start;
             frame->pitch = device->hidden->driver_pitch;
             break;
@@ -182,6 +182,7 @@ static SDL_CameraFrameResult V4L2_AcquireFrame(SDL_Camera *device, SDL_Surface *
             device->hidden->buffers[buf.index].available = 1;
 
             *timestampNS = (((Uint64) buf.timestamp.tv_sec) * SDL_NS_PER_SECOND) + SDL_US_TO_NS(buf.timestamp.tv_usec);
+            device->acquire_sequence = (Sint64) buf.sequence;
 
             #if DEBUG_CAMERA
             SDL_Log("CAMERA: debug mmap: image %d/%d  data[0]=%p", buf.index, device->hidden->nb_buffers, (void*)frame->pixels);
@@ -226,6 +227,7 @@ static SDL_CameraFrameResult V4L2_AcquireFrame(SDL_Camera *device, SDL_Surface *
             device->hidden->buffers[i].available = 1;
 
             *timestampNS = (((Uint64) buf.timestamp.tv_sec) * SDL_NS_PER_SECOND) + SDL_US_TO_NS(buf.timestamp.tv_usec);
+            device->acquire_sequence = (Sint64) buf.sequence;
 
             #if DEBUG_CAMERA
             SDL_Log("CAMERA: debug userptr: image %d/%d  data[0]=%p", buf.index, device->hidden->nb_buffers, (void*)frame->pixels);
@@ -602,6 +604,7 @@ static bool V4L2_OpenDevice(SDL_Camera *device, const SDL_CameraSpec *spec)
     }
 
     device->hidden->io = io;
+    device->buffer_count = device->hidden->nb_buffers;
 
     device->hidden->buffers = SDL_calloc(device->hidden->nb_buffers, sizeof(*device->hidden->buffers));
     if (!device->hidden->buffers) {
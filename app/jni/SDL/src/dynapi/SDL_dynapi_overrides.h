@@ -91,6 +91,7 @@
 #define SDL_CompareAndSwapAtomicU32 SDL_CompareAndSwapAtomicU32_REAL
 #define SDL_ComposeCustomBlendMode SDL_ComposeCustomBlendMode_REAL
 #define SDL_ConvertAudioSamples SDL_ConvertAudioSamples_REAL
+#define SDL_ConvertCameraFrame SDL_ConvertCameraFrame_REAL
 #define SDL_ConvertEventToRenderCoordinates SDL_ConvertEventToRenderCoordinates_REAL
 #define SDL_ConvertPixels SDL_ConvertPixels_REAL
 #define SDL_ConvertPixelsAndColorspace SDL_ConvertPixelsAndColorspace_REAL
@@ -261,6 +262,7 @@
 #define SDL_GetAudioStreamProperties SDL_GetAudioStreamProperties_REAL
 #define SDL_GetAudioStreamQueued SDL_GetAudioStreamQueued_REAL
 #define SDL_GetBasePath SDL_GetBasePath_REAL
+#define SDL_GetBlitStats SDL_GetBlitStats_REAL
 #define SDL_GetBooleanProperty SDL_GetBooleanProperty_REAL
 #define SDL_GetCPUCacheLineSize SDL_GetCPUCacheLineSize_REAL
 #define SDL_GetCameraDriver SDL_GetCameraDriver_REAL
@@ -681,6 +683,7 @@
 #define SDL_OpenAudioDevice SDL_OpenAudioDevice_REAL
 #define SDL_OpenAudioDeviceStream SDL_OpenAudioDeviceStream_REAL
 #define SDL_OpenCamera SDL_OpenCamera_REAL
+#define SDL_OpenCameraWithProperties SDL_OpenCameraWithProperties_REAL
 #define SDL_OpenFileStorage SDL_OpenFileStorage_REAL
 #define SDL_OpenGamepad SDL_OpenGamepad_REAL
 #define SDL_OpenHaptic SDL_OpenHaptic_REAL
@@ -778,6 +781,7 @@
 #define SDL_ReportAssertion SDL_ReportAssertion_REAL
 #define SDL_RequestAndroidPermission SDL_RequestAndroidPermission_REAL
 #define SDL_ResetAssertionReport SDL_ResetAssertionReport_REAL
+#define SDL_ResetBlitStats SDL_ResetBlitStats_REAL
 #define SDL_ResetHint SDL_ResetHint_REAL
 #define SDL_ResetHints SDL_ResetHints_REAL
 #define SDL_ResetKeyboard SDL_ResetKeyboard_REAL
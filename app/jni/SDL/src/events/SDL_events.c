@@ -1469,7 +1469,8 @@ bool SDL_WaitEventTimeoutNS(SDL_Event *event, Sint64 timeoutNS)
             }
             delay = SDL_min((expiration - now), delay);
         }
-        SDL_DelayNS(delay);
+        // SDL_DelayNS() spins through its last timeslice, which would keep a whole CPU busy while waiting
+        SDL_SYS_DelayNS(delay);
     }
 #endif // SDL_PLATFORM_ANDROID
 }
@@ -34,6 +34,8 @@
 #include "SDL_rotate.h"
 #include "SDL_triangle.h"
 #include "../../video/SDL_pixels_c.h"
+#include "../../video/SDL_rowpool_c.h"
+#include "../../video/SDL_surface_c.h"
 
 // SDL surface based renderer implementation
 
@@ -45,10 +47,43 @@ typedef struct
     SDL_Color color;
 } SW_DrawStateCache;
 
+// Scratch surfaces are kept for this many command queue passes after their last use.
+#define SW_SCRATCH_SURFACE_COUNT    16
+#define SW_SCRATCH_SURFACE_MAX_IDLE 60
+
+typedef struct
+{
+    SDL_Surface *surface;
+    int rows; // rows of pixel memory, 0 for surfaces wrapping foreign pixels
+    Uint64 last_used;
+    bool in_use;
+} SW_ScratchSurface;
+
+// Source surfaces each band keeps its own view of while rasterizing tiled commands.
+#define SW_TILE_SOURCE_COUNT 16
+
+// A draw command that can be split into bands of rows, with the draw state it had in the queue.
+typedef struct
+{
+    const SDL_RenderCommand *cmd;
+    SDL_Rect clip;   // viewport and clip rect, in surface coordinates
+    int y0, y1;      // rows the command can touch
+    Uint32 pixel;    // the draw color mapped to the surface, for clears, fills and points
+    SDL_Color color;
+} SW_TileCommand;
+
 typedef struct
 {
     SDL_Surface *surface;
     SDL_Surface *window;
+    SW_ScratchSurface scratch[SW_SCRATCH_SURFACE_COUNT];
+    Uint64 pass;
+    Sint64 scratch_allocations;
+    Sint64 scratch_reuses;
+    SW_TileCommand *tile_commands;
+    int max_tile_commands;
+    Sint64 tiled_commands;
+    Sint64 serial_commands;
 } SW_RenderData;
 
 static SDL_Surface *SW_ActivateRenderer(SDL_Renderer *renderer)
@@ -67,6 +102,112 @@ static SDL_Surface *SW_ActivateRenderer(SDL_Renderer *renderer)
     return data->surface;
 }
 
+static void SW_ResetScratchSurface(SDL_Surface *surface, int h, void *pixels)
+{
+    surface->h = h;
+    if (pixels) {
+        surface->pixels = pixels;
+    }
+    SDL_SetSurfaceClipRect(surface, NULL);
+    SDL_SetSurfaceColorKey(surface, false, 0);
+    SDL_SetSurfaceColorMod(surface, 255, 255, 255);
+    SDL_SetSurfaceAlphaMod(surface, 255);
+    SDL_SetSurfaceBlendMode(surface, SDL_ISPIXELFORMAT_ALPHA(surface->format) ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+}
+
+/* Returns a surface for temporary use while running the command queue, reusing a cached one if possible.
+ * With pixels set, the surface wraps them like SDL_CreateSurfaceFrom. Otherwise it owns pixel memory
+ * with room for the guard rows of SDLgfx_rotateSurface, and its contents are undefined.
+ * The surface has the default state of a new one and must be returned with SW_ReleaseScratchSurface.
+ */
+static SDL_Surface *SW_AcquireScratchSurface(SW_RenderData *data, int w, int h, SDL_PixelFormat format, void *pixels, int pitch)
+{
+    SW_ScratchSurface *slot = NULL;
+    SDL_Surface *surface;
+    int i;
+
+    for (i = 0; i < SW_SCRATCH_SURFACE_COUNT; ++i) {
+        SW_ScratchSurface *entry = &data->scratch[i];
+
+        if (!entry->surface) {
+            if (!slot || slot->surface) {
+                slot = entry;
+            }
+            continue;
+        }
+        if (entry->in_use) {
+            continue;
+        }
+        if (entry->surface->w == w && entry->surface->format == format &&
+            (pixels ? (entry->rows == 0 && entry->surface->h == h && entry->surface->pitch == pitch)
+                    : (entry->rows >= h + SDLGFX_ROTATE_GUARD_ROWS))) {
+            SW_ResetScratchSurface(entry->surface, h, pixels);
+            entry->in_use = true;
+            ++data->scratch_reuses;
+            return entry->surface;
+        }
+        // Otherwise prefer an empty slot, then the least recently used surface
+        if (!slot || (slot->surface && entry->last_used < slot->last_used)) {
+            slot = entry;
+        }
+    }
+
+    if (pixels) {
+        surface = SDL_CreateSurfaceFrom(w, h, format, pixels, pitch);
+    } else {
+        surface = SDL_CreateSurface(w, h + SDLGFX_ROTATE_GUARD_ROWS, format);
+        if (surface) {
+            SW_ResetScratchSurface(surface, h, NULL);
+        }
+    }
+    if (!surface) {
+        return NULL;
+    }
+    ++data->scratch_allocations;
+
+    if (slot) {
+        if (slot->surface) {
+            SDL_DestroySurface(slot->surface);
+        }
+        slot->surface = surface;
+        slot->rows = pixels ? 0 : h + SDLGFX_ROTATE_GUARD_ROWS;
+        slot->in_use = true;
+    }
+    return surface;
+}
+
+static void SW_ReleaseScratchSurface(SW_RenderData *data, SDL_Surface *surface)
+{
+    int i;
+
+    if (!surface) {
+        return;
+    }
+    for (i = 0; i < SW_SCRATCH_SURFACE_COUNT; ++i) {
+        SW_ScratchSurface *entry = &data->scratch[i];
+        if (entry->surface == surface) {
+            entry->in_use = false;
+            entry->last_used = data->pass;
+            return;
+        }
+    }
+    SDL_DestroySurface(surface);
+}
+
+static void SW_TrimScratchSurfaces(SW_RenderData *data, bool all)
+{
+    int i;
+
+    for (i = 0; i < SW_SCRATCH_SURFACE_COUNT; ++i) {
+        SW_ScratchSurface *entry = &data->scratch[i];
+        if (entry->surface && !entry->in_use &&
+            (all || data->pass - entry->last_used > SW_SCRATCH_SURFACE_MAX_IDLE)) {
+            SDL_DestroySurface(entry->surface);
+            entry->surface = NULL;
+        }
+    }
+}
+
 static void SW_WindowEvent(SDL_Renderer *renderer, const SDL_WindowEvent *event)
 {
     SW_RenderData *data = (SW_RenderData *)renderer->internal;
@@ -315,12 +456,92 @@ static bool Blit_to_Screen(SDL_Surface *src, SDL_Rect *srcrect, SDL_Surface *sur
     return result;
 }
 
+// Returns true if the pixels of src can be written to dst by only replacing the alpha channel.
+static bool SW_IsRGBCopyCompatible(const SDL_PixelFormatDetails *src, const SDL_PixelFormatDetails *dst)
+{
+    return src->bits_per_pixel == 32 && dst->bits_per_pixel == 32 &&
+           SDL_PIXELLAYOUT(src->format) == SDL_PACKEDLAYOUT_8888 &&
+           SDL_PIXELLAYOUT(dst->format) == SDL_PACKEDLAYOUT_8888 &&
+           src->Rmask == dst->Rmask && src->Gmask == dst->Gmask && src->Bmask == dst->Bmask;
+}
+
+/* Scales (nearest), flips and rotates srcrect of an opaque 32-bit source by a multiple of 90 degrees,
+ * writing each destination pixel exactly once. The sampling matches SDL_BlitSurfaceScaled with
+ * SDL_SCALEMODE_NEAREST followed by the 90 degree path of SDLgfx_rotateSurface and a plain blit.
+ */
+static bool SW_CopyRotated90(SDL_Surface *src, const SDL_Rect *srcrect, SDL_Surface *surface, const SDL_Rect *final_rect,
+                             const SDL_Rect *rect_dest, int angle90, const SDL_FlipMode flip)
+{
+    const int w = final_rect->w;
+    const int h = final_rect->h;
+    const Uint32 rgbmask = surface->fmt->Rmask | surface->fmt->Gmask | surface->fmt->Bmask;
+    const Uint32 amask = surface->fmt->Amask;
+    const Uint8 *pixels;
+    Uint64 pos, inc;
+    SDL_Rect dstrect, cliprect;
+    size_t *xoffs, *yoffs;
+    bool xreverse, yreverse, isstack;
+    int i, x, y;
+
+    dstrect.x = final_rect->x + rect_dest->x;
+    dstrect.y = final_rect->y + rect_dest->y;
+    dstrect.w = rect_dest->w;
+    dstrect.h = rect_dest->h;
+    if (!SDL_GetRectIntersection(&surface->clip_rect, &dstrect, &cliprect)) {
+        return true;
+    }
+
+    xoffs = SDL_small_alloc(size_t, w + h, &isstack);
+    if (!xoffs) {
+        return false;
+    }
+    yoffs = xoffs + w;
+
+    /* The rotation only reverses or swaps the scaled axes, so it folds into the per-axis
+     * lookup tables together with the flips. The odd angles walk the source by columns.
+     */
+    xreverse = ((flip & SDL_FLIP_HORIZONTAL) != 0) != (angle90 == 2 || angle90 == 3);
+    yreverse = ((flip & SDL_FLIP_VERTICAL) != 0) != (angle90 == 1 || angle90 == 2);
+
+    inc = ((Uint64)srcrect->w << 16) / w;
+    for (i = 0, pos = inc / 2; i < w; ++i, pos += inc) {
+        xoffs[xreverse ? w - 1 - i : i] = (size_t)(srcrect->x + (int)(pos >> 16)) * sizeof(Uint32);
+    }
+    inc = ((Uint64)srcrect->h << 16) / h;
+    for (i = 0, pos = inc / 2; i < h; ++i, pos += inc) {
+        yoffs[yreverse ? h - 1 - i : i] = (size_t)(srcrect->y + (int)(pos >> 16)) * src->pitch;
+    }
+
+    pixels = (const Uint8 *)src->pixels;
+    for (y = cliprect.y - dstrect.y; y < cliprect.y - dstrect.y + cliprect.h; ++y) {
+        Uint32 *dst = (Uint32 *)((Uint8 *)surface->pixels + (size_t)(dstrect.y + y) * surface->pitch) + cliprect.x;
+        const int x0 = cliprect.x - dstrect.x;
+        const int x1 = x0 + cliprect.w;
+
+        if (angle90 & 1) {
+            const Uint8 *column = pixels + xoffs[y];
+            for (x = x0; x < x1; ++x) {
+                *dst++ = (*(const Uint32 *)(column + yoffs[x]) & rgbmask) | amask;
+            }
+        } else {
+            const Uint8 *row = pixels + yoffs[y];
+            for (x = x0; x < x1; ++x) {
+                *dst++ = (*(const Uint32 *)(row + xoffs[x]) & rgbmask) | amask;
+            }
+        }
+    }
+
+    SDL_small_free(xoffs, isstack);
+    return true;
+}
+
 static bool SW_RenderCopyEx(SDL_Renderer *renderer, SDL_Surface *surface, SDL_Texture *texture,
                             const SDL_Rect *srcrect, const SDL_Rect *final_rect,
                             const double angle, const SDL_FPoint *center, const SDL_FlipMode flip, float scale_x, float scale_y)
 {
+    SW_RenderData *data = (SW_RenderData *)renderer->internal;
     SDL_Surface *src = (SDL_Surface *)texture->internal;
-    SDL_Rect tmp_rect;
+    SDL_Rect tmp_rect, copy_rect;
     SDL_Surface *src_clone, *src_rotated, *src_scaled;
     SDL_Surface *mask = NULL, *mask_rotated = NULL;
     bool result = true;
@@ -329,6 +550,9 @@ static bool SW_RenderCopyEx(SDL_Renderer *renderer, SDL_Surface *surface, SDL_Te
     int applyModulation = false;
     int blitRequired = false;
     int isOpaque = false;
+    int angle90 = -1;
+    bool copyRotated = false;
+    bool sampleSource = false;
 
     if (!SDL_SurfaceValid(surface)) {
         return false;
@@ -351,7 +575,7 @@ static bool SW_RenderCopyEx(SDL_Renderer *renderer, SDL_Surface *surface, SDL_Te
     /* Clone the source surface but use its pixel buffer directly.
      * The original source surface must be treated as read-only.
      */
-    src_clone = SDL_CreateSurfaceFrom(src->w, src->h, src->format, src->pixels, src->pitch);
+    src_clone = SW_AcquireScratchSurface(data, src->w, src->h, src->format, src->pixels, src->pitch);
     if (!src_clone) {
         if (SDL_MUSTLOCK(src)) {
             SDL_UnlockSurface(src);
@@ -390,14 +614,35 @@ static bool SW_RenderCopyEx(SDL_Renderer *renderer, SDL_Surface *surface, SDL_Te
         isOpaque = true;
     }
 
+    /* Opaque, unmodulated copies at a multiple of 90 degrees don't need the intermediate rotated surface.
+     * The destination pixels are written directly and, unless a linear downscale is required,
+     * they are sampled straight from the texture.
+     */
+    if (isOpaque && !applyModulation && scale_x == 1.0f && scale_y == 1.0f && (int)(angle / 90) == angle / 90 &&
+        final_rect->w > 0 && final_rect->h > 0 && srcrect->w > 0 && srcrect->h > 0 &&
+        srcrect->x >= 0 && srcrect->y >= 0 && srcrect->x + srcrect->w <= src->w && srcrect->y + srcrect->h <= src->h &&
+        !SDL_MUSTLOCK(surface) && surface->colorspace == SDL_COLORSPACE_SRGB) {
+        angle90 = (int)(angle / 90) % 4;
+        if (angle90 < 0) {
+            angle90 += 4;
+        }
+        copyRotated = true;
+        if ((texture->scaleMode == SDL_SCALEMODE_NEAREST || (srcrect->w == final_rect->w && srcrect->h == final_rect->h)) &&
+            SW_IsRGBCopyCompatible(src->fmt, surface->fmt)) {
+            sampleSource = true;
+        }
+    }
+    copy_rect = *srcrect;
+
     /* The NONE blend mode requires a mask for non-opaque surfaces. This mask will be used
      * to clear the pixels in the destination surface. The other steps are explained below.
      */
     if (blendmode == SDL_BLENDMODE_NONE && !isOpaque) {
-        mask = SDL_CreateSurface(final_rect->w, final_rect->h, SDL_PIXELFORMAT_ARGB8888);
+        mask = SW_AcquireScratchSurface(data, final_rect->w, final_rect->h, SDL_PIXELFORMAT_ARGB8888, NULL, 0);
         if (!mask) {
             result = false;
         } else {
+            SDL_FillSurfaceRect(mask, NULL, 0);
             SDL_SetSurfaceBlendMode(mask, SDL_BLENDMODE_MOD);
         }
     }
@@ -405,40 +650,60 @@ static bool SW_RenderCopyEx(SDL_Renderer *renderer, SDL_Surface *surface, SDL_Te
     /* Create a new surface should there be a format mismatch or if scaling, cropping,
      * or modulation is required. It's possible to use the source surface directly otherwise.
      */
-    if (result && (blitRequired || applyModulation)) {
+    if (result && (blitRequired || applyModulation) && !sampleSource) {
         SDL_Rect scale_rect = tmp_rect;
-        src_scaled = SDL_CreateSurface(final_rect->w, final_rect->h, SDL_PIXELFORMAT_ARGB8888);
+        src_scaled = SW_AcquireScratchSurface(data, final_rect->w, final_rect->h, SDL_PIXELFORMAT_ARGB8888, NULL, 0);
         if (!src_scaled) {
             result = false;
         } else {
             SDL_SetSurfaceBlendMode(src_clone, SDL_BLENDMODE_NONE);
             result = SDL_BlitSurfaceScaled(src_clone, srcrect, src_scaled, &scale_rect, texture->scaleMode);
-            SDL_DestroySurface(src_clone);
+            SW_ReleaseScratchSurface(data, src_clone);
             src_clone = src_scaled;
             src_scaled = NULL;
+            copy_rect = tmp_rect;
         }
     }
 
+    if (copyRotated && !SW_IsRGBCopyCompatible(src_clone->fmt, surface->fmt)) {
+        copyRotated = false;
+    }
+
     // SDLgfx_rotateSurface is going to make decisions depending on the blend mode.
     SDL_SetSurfaceBlendMode(src_clone, blendmode);
 
-    if (result) {
+    if (result && copyRotated) {
         SDL_Rect rect_dest;
         double cangle, sangle;
 
         SDLgfx_rotozoomSurfaceSizeTrig(tmp_rect.w, tmp_rect.h, angle, center,
                                        &rect_dest, &cangle, &sangle);
-        src_rotated = SDLgfx_rotateSurface(src_clone, angle,
-                                           (texture->scaleMode == SDL_SCALEMODE_NEAREST) ? 0 : 1, flip & SDL_FLIP_HORIZONTAL, flip & SDL_FLIP_VERTICAL,
-                                           &rect_dest, cangle, sangle, center);
+        result = SW_CopyRotated90(src_clone, &copy_rect, surface, final_rect, &rect_dest, angle90, flip);
+    } else if (result) {
+        SDL_Rect rect_dest;
+        double cangle, sangle;
+
+        SDLgfx_rotozoomSurfaceSizeTrig(tmp_rect.w, tmp_rect.h, angle, center,
+                                       &rect_dest, &cangle, &sangle);
+        src_rotated = SW_AcquireScratchSurface(data, rect_dest.w, rect_dest.h, src_clone->format, NULL, 0);
+        if (src_rotated && !SDLgfx_rotateSurface(src_clone, src_rotated, angle,
+                                                 (texture->scaleMode == SDL_SCALEMODE_NEAREST) ? 0 : 1, flip & SDL_FLIP_HORIZONTAL, flip & SDL_FLIP_VERTICAL,
+                                                 &rect_dest, cangle, sangle, center)) {
+            SW_ReleaseScratchSurface(data, src_rotated);
+            src_rotated = NULL;
+        }
         if (!src_rotated) {
             result = false;
         }
         if (result && mask) {
             // The mask needed for the NONE blend mode gets rotated with the same parameters.
-            mask_rotated = SDLgfx_rotateSurface(mask, angle,
-                                                false, 0, 0,
-                                                &rect_dest, cangle, sangle, center);
+            mask_rotated = SW_AcquireScratchSurface(data, rect_dest.w, rect_dest.h, mask->format, NULL, 0);
+            if (mask_rotated && !SDLgfx_rotateSurface(mask, mask_rotated, angle,
+                                                      false, 0, 0,
+                                                      &rect_dest, cangle, sangle, center)) {
+                SW_ReleaseScratchSurface(data, mask_rotated);
+                mask_rotated = NULL;
+            }
             if (!mask_rotated) {
                 result = false;
             }
@@ -486,21 +751,21 @@ static bool SW_RenderCopyEx(SDL_Renderer *renderer, SDL_Surface *surface, SDL_Te
                          * mode modulates the colors with the alpha channel, a surface without an alpha mask needs
                          * to be created. This makes all source pixels opaque and the colors get copied correctly.
                          */
-                        SDL_Surface *src_rotated_rgb = SDL_CreateSurfaceFrom(src_rotated->w, src_rotated->h, src_rotated->format, src_rotated->pixels, src_rotated->pitch);
+                        SDL_Surface *src_rotated_rgb = SW_AcquireScratchSurface(data, src_rotated->w, src_rotated->h, src_rotated->format, src_rotated->pixels, src_rotated->pitch);
                         if (!src_rotated_rgb) {
                             result = false;
                         } else {
                             SDL_SetSurfaceBlendMode(src_rotated_rgb, SDL_BLENDMODE_ADD);
                             // Renderer scaling, if needed
                             result = Blit_to_Screen(src_rotated_rgb, NULL, surface, &tmp_rect, scale_x, scale_y, texture->scaleMode);
-                            SDL_DestroySurface(src_rotated_rgb);
+                            SW_ReleaseScratchSurface(data, src_rotated_rgb);
                         }
                     }
                 }
-                SDL_DestroySurface(mask_rotated);
+                SW_ReleaseScratchSurface(data, mask_rotated);
             }
             if (src_rotated) {
-                SDL_DestroySurface(src_rotated);
+                SW_ReleaseScratchSurface(data, src_rotated);
             }
         }
     }
@@ -509,10 +774,10 @@ static bool SW_RenderCopyEx(SDL_Renderer *renderer, SDL_Surface *surface, SDL_Te
         SDL_UnlockSurface(src);
     }
     if (mask) {
-        SDL_DestroySurface(mask);
+        SW_ReleaseScratchSurface(data, mask);
     }
     if (src_clone) {
-        SDL_DestroySurface(src_clone);
+        SW_ReleaseScratchSurface(data, src_clone);
     }
     return result;
 }
@@ -643,24 +908,30 @@ static void PrepTextureForCopy(const SDL_RenderCommand *cmd, SW_DrawStateCache *
     SDL_SetSurfaceBlendMode(surface, blend);
 }
 
+static void GetDrawClipRect(const SW_DrawStateCache *drawstate, SDL_Rect *clip_rect)
+{
+    const SDL_Rect *viewport = drawstate->viewport;
+    const SDL_Rect *cliprect = drawstate->cliprect;
+
+    if (cliprect && viewport) {
+        clip_rect->x = cliprect->x + viewport->x;
+        clip_rect->y = cliprect->y + viewport->y;
+        clip_rect->w = cliprect->w;
+        clip_rect->h = cliprect->h;
+        SDL_GetRectIntersection(viewport, clip_rect, clip_rect);
+    } else {
+        *clip_rect = *viewport;
+    }
+}
+
 static void SetDrawState(SDL_Surface *surface, SW_DrawStateCache *drawstate)
 {
     if (drawstate->surface_cliprect_dirty) {
-        const SDL_Rect *viewport = drawstate->viewport;
-        const SDL_Rect *cliprect = drawstate->cliprect;
-        SDL_assert_release(viewport != NULL); // the higher level should have forced a SDL_RENDERCMD_SETVIEWPORT
-
-        if (cliprect && viewport) {
-            SDL_Rect clip_rect;
-            clip_rect.x = cliprect->x + viewport->x;
-            clip_rect.y = cliprect->y + viewport->y;
-            clip_rect.w = cliprect->w;
-            clip_rect.h = cliprect->h;
-            SDL_GetRectIntersection(viewport, &clip_rect, &clip_rect);
-            SDL_SetSurfaceClipRect(surface, &clip_rect);
-        } else {
-            SDL_SetSurfaceClipRect(surface, drawstate->viewport);
-        }
+        SDL_Rect clip_rect;
+        SDL_assert_release(drawstate->viewport != NULL); // the higher level should have forced a SDL_RENDERCMD_SETVIEWPORT
+
+        GetDrawClipRect(drawstate, &clip_rect);
+        SDL_SetSurfaceClipRect(surface, &clip_rect);
         drawstate->surface_cliprect_dirty = false;
     }
 }
@@ -671,294 +942,710 @@ static void SW_InvalidateCachedState(SDL_Renderer *renderer)
 }
 
 
-static bool SW_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, void *vertices, size_t vertsize)
+static void SW_RunCommand(SDL_Renderer *renderer, SDL_Surface *surface, SDL_RenderCommand *cmd, void *vertices, SW_DrawStateCache *drawstate)
 {
-    SDL_Surface *surface = SW_ActivateRenderer(renderer);
-    SW_DrawStateCache drawstate;
+    SW_RenderData *data = (SW_RenderData *)renderer->internal;
 
-    if (!SDL_SurfaceValid(surface)) {
-        return false;
+    switch (cmd->command) {
+    case SDL_RENDERCMD_SETDRAWCOLOR:
+    {
+        drawstate->color.r = (Uint8)SDL_roundf(SDL_clamp(cmd->data.color.color.r * cmd->data.color.color_scale, 0.0f, 1.0f) * 255.0f);
+        drawstate->color.g = (Uint8)SDL_roundf(SDL_clamp(cmd->data.color.color.g * cmd->data.color.color_scale, 0.0f, 1.0f) * 255.0f);
+        drawstate->color.b = (Uint8)SDL_roundf(SDL_clamp(cmd->data.color.color.b * cmd->data.color.color_scale, 0.0f, 1.0f) * 255.0f);
+        drawstate->color.a = (Uint8)SDL_roundf(SDL_clamp(cmd->data.color.color.a, 0.0f, 1.0f) * 255.0f);
+        break;
     }
 
-    drawstate.viewport = NULL;
-    drawstate.cliprect = NULL;
-    drawstate.surface_cliprect_dirty = true;
-    drawstate.color.r = 0;
-    drawstate.color.g = 0;
-    drawstate.color.b = 0;
-    drawstate.color.a = 0;
+    case SDL_RENDERCMD_SETVIEWPORT:
+    {
+        drawstate->viewport = &cmd->data.viewport.rect;
+        drawstate->surface_cliprect_dirty = true;
+        break;
+    }
 
-    while (cmd) {
-        switch (cmd->command) {
-        case SDL_RENDERCMD_SETDRAWCOLOR:
-        {
-            drawstate.color.r = (Uint8)SDL_roundf(SDL_clamp(cmd->data.color.color.r * cmd->data.color.color_scale, 0.0f, 1.0f) * 255.0f);
-            drawstate.color.g = (Uint8)SDL_roundf(SDL_clamp(cmd->data.color.color.g * cmd->data.color.color_scale, 0.0f, 1.0f) * 255.0f);
-            drawstate.color.b = (Uint8)SDL_roundf(SDL_clamp(cmd->data.color.color.b * cmd->data.color.color_scale, 0.0f, 1.0f) * 255.0f);
-            drawstate.color.a = (Uint8)SDL_roundf(SDL_clamp(cmd->data.color.color.a, 0.0f, 1.0f) * 255.0f);
-            break;
-        }
+    case SDL_RENDERCMD_SETCLIPRECT:
+    {
+        drawstate->cliprect = cmd->data.cliprect.enabled ? &cmd->data.cliprect.rect : NULL;
+        drawstate->surface_cliprect_dirty = true;
+        break;
+    }
 
-        case SDL_RENDERCMD_SETVIEWPORT:
-        {
-            drawstate.viewport = &cmd->data.viewport.rect;
-            drawstate.surface_cliprect_dirty = true;
-            break;
+    case SDL_RENDERCMD_CLEAR:
+    {
+        const Uint8 r = (Uint8)SDL_roundf(SDL_clamp(cmd->data.color.color.r * cmd->data.color.color_scale, 0.0f, 1.0f) * 255.0f);
+        const Uint8 g = (Uint8)SDL_roundf(SDL_clamp(cmd->data.color.color.g * cmd->data.color.color_scale, 0.0f, 1.0f) * 255.0f);
+        const Uint8 b = (Uint8)SDL_roundf(SDL_clamp(cmd->data.color.color.b * cmd->data.color.color_scale, 0.0f, 1.0f) * 255.0f);
+        const Uint8 a = (Uint8)SDL_roundf(SDL_clamp(cmd->data.color.color.a, 0.0f, 1.0f) * 255.0f);
+        // By definition the clear ignores the clip rect
+        SDL_SetSurfaceClipRect(surface, NULL);
+        SDL_FillSurfaceRect(surface, NULL, SDL_MapSurfaceRGBA(surface, r, g, b, a));
+        drawstate->surface_cliprect_dirty = true;
+        break;
+    }
+
+    case SDL_RENDERCMD_DRAW_POINTS:
+    {
+        const Uint8 r = drawstate->color.r;
+        const Uint8 g = drawstate->color.g;
+        const Uint8 b = drawstate->color.b;
+        const Uint8 a = drawstate->color.a;
+        const int count = (int)cmd->data.draw.count;
+        SDL_Point *verts = (SDL_Point *)(((Uint8 *)vertices) + cmd->data.draw.first);
+        const SDL_BlendMode blend = cmd->data.draw.blend;
+        SetDrawState(surface, drawstate);
+
+        // Apply viewport
+        if (drawstate->viewport && (drawstate->viewport->x || drawstate->viewport->y)) {
+            int i;
+            for (i = 0; i < count; i++) {
+                verts[i].x += drawstate->viewport->x;
+                verts[i].y += drawstate->viewport->y;
+            }
         }
 
-        case SDL_RENDERCMD_SETCLIPRECT:
-        {
-            drawstate.cliprect = cmd->data.cliprect.enabled ? &cmd->data.cliprect.rect : NULL;
-            drawstate.surface_cliprect_dirty = true;
-            break;
+        if (blend == SDL_BLENDMODE_NONE) {
+            SDL_DrawPoints(surface, verts, count, SDL_MapSurfaceRGBA(surface, r, g, b, a));
+        } else {
+            SDL_BlendPoints(surface, verts, count, blend, r, g, b, a);
         }
+        break;
+    }
 
-        case SDL_RENDERCMD_CLEAR:
-        {
-            const Uint8 r = (Uint8)SDL_roundf(SDL_clamp(cmd->data.color.color.r * cmd->data.color.color_scale, 0.0f, 1.0f) * 255.0f);
-            const Uint8 g = (Uint8)SDL_roundf(SDL_clamp(cmd->data.color.color.g * cmd->data.color.color_scale, 0.0f, 1.0f) * 255.0f);
-            const Uint8 b = (Uint8)SDL_roundf(SDL_clamp(cmd->data.color.color.b * cmd->data.color.color_scale, 0.0f, 1.0f) * 255.0f);
-            const Uint8 a = (Uint8)SDL_roundf(SDL_clamp(cmd->data.color.color.a, 0.0f, 1.0f) * 255.0f);
-            // By definition the clear ignores the clip rect
-            SDL_SetSurfaceClipRect(surface, NULL);
-            SDL_FillSurfaceRect(surface, NULL, SDL_MapSurfaceRGBA(surface, r, g, b, a));
-            drawstate.surface_cliprect_dirty = true;
-            break;
+    case SDL_RENDERCMD_DRAW_LINES:
+    {
+        const Uint8 r = drawstate->color.r;
+        const Uint8 g = drawstate->color.g;
+        const Uint8 b = drawstate->color.b;
+        const Uint8 a = drawstate->color.a;
+        const int count = (int)cmd->data.draw.count;
+        SDL_Point *verts = (SDL_Point *)(((Uint8 *)vertices) + cmd->data.draw.first);
+        const SDL_BlendMode blend = cmd->data.draw.blend;
+        SetDrawState(surface, drawstate);
+
+        // Apply viewport
+        if (drawstate->viewport && (drawstate->viewport->x || drawstate->viewport->y)) {
+            int i;
+            for (i = 0; i < count; i++) {
+                verts[i].x += drawstate->viewport->x;
+                verts[i].y += drawstate->viewport->y;
+            }
         }
 
-        case SDL_RENDERCMD_DRAW_POINTS:
-        {
-            const Uint8 r = drawstate.color.r;
-            const Uint8 g = drawstate.color.g;
-            const Uint8 b = drawstate.color.b;
-            const Uint8 a = drawstate.color.a;
-            const int count = (int)cmd->data.draw.count;
-            SDL_Point *verts = (SDL_Point *)(((Uint8 *)vertices) + cmd->data.draw.first);
-            const SDL_BlendMode blend = cmd->data.draw.blend;
-            SetDrawState(surface, &drawstate);
+        if (blend == SDL_BLENDMODE_NONE) {
+            SDL_DrawLines(surface, verts, count, SDL_MapSurfaceRGBA(surface, r, g, b, a));
+        } else {
+            SDL_BlendLines(surface, verts, count, blend, r, g, b, a);
+        }
+        break;
+    }
 
-            // Apply viewport
-            if (drawstate.viewport && (drawstate.viewport->x || drawstate.viewport->y)) {
-                int i;
-                for (i = 0; i < count; i++) {
-                    verts[i].x += drawstate.viewport->x;
-                    verts[i].y += drawstate.viewport->y;
-                }
+    case SDL_RENDERCMD_FILL_RECTS:
+    {
+        const Uint8 r = drawstate->color.r;
+        const Uint8 g = drawstate->color.g;
+        const Uint8 b = drawstate->color.b;
+        const Uint8 a = drawstate->color.a;
+        const int count = (int)cmd->data.draw.count;
+        SDL_Rect *verts = (SDL_Rect *)(((Uint8 *)vertices) + cmd->data.draw.first);
+        const SDL_BlendMode blend = cmd->data.draw.blend;
+        SetDrawState(surface, drawstate);
+
+        // Apply viewport
+        if (drawstate->viewport && (drawstate->viewport->x || drawstate->viewport->y)) {
+            int i;
+            for (i = 0; i < count; i++) {
+                verts[i].x += drawstate->viewport->x;
+                verts[i].y += drawstate->viewport->y;
             }
+        }
+
+        if (blend == SDL_BLENDMODE_NONE) {
+            SDL_FillSurfaceRects(surface, verts, count, SDL_MapSurfaceRGBA(surface, r, g, b, a));
+        } else {
+            SDL_BlendFillRects(surface, verts, count, blend, r, g, b, a);
+        }
+        break;
+    }
+
+    case SDL_RENDERCMD_COPY:
+    {
+        SDL_Rect *verts = (SDL_Rect *)(((Uint8 *)vertices) + cmd->data.draw.first);
+        const SDL_Rect *srcrect = verts;
+        SDL_Rect *dstrect = verts + 1;
+        SDL_Texture *texture = cmd->data.draw.texture;
+        SDL_Surface *src = (SDL_Surface *)texture->internal;
+
+        SetDrawState(surface, drawstate);
+
+        PrepTextureForCopy(cmd, drawstate);
 
-            if (blend == SDL_BLENDMODE_NONE) {
-                SDL_DrawPoints(surface, verts, count, SDL_MapSurfaceRGBA(surface, r, g, b, a));
+        // Apply viewport
+        if (drawstate->viewport && (drawstate->viewport->x || drawstate->viewport->y)) {
+            dstrect->x += drawstate->viewport->x;
+            dstrect->y += drawstate->viewport->y;
+        }
+
+        if (srcrect->w == dstrect->w && srcrect->h == dstrect->h) {
+            SDL_BlitSurface(src, srcrect, surface, dstrect);
+        } else {
+            /* If scaling is ever done, permanently disable RLE (which doesn't support scaling)
+             * to avoid potentially frequent RLE encoding/decoding.
+             */
+            SDL_SetSurfaceRLE(surface, 0);
+
+            // Prevent to do scaling + clipping on viewport boundaries as it may lose proportion
+            if (dstrect->x < 0 || dstrect->y < 0 || dstrect->x + dstrect->w > surface->w || dstrect->y + dstrect->h > surface->h) {
+                SDL_Surface *tmp = SW_AcquireScratchSurface(data, dstrect->w, dstrect->h, src->format, NULL, 0);
+                // Scale to an intermediate surface, then blit
+                if (tmp) {
+                    SDL_Rect r;
+                    SDL_BlendMode blendmode;
+                    Uint8 alphaMod, rMod, gMod, bMod;
+
+                    SDL_GetSurfaceBlendMode(src, &blendmode);
+                    SDL_GetSurfaceAlphaMod(src, &alphaMod);
+                    SDL_GetSurfaceColorMod(src, &rMod, &gMod, &bMod);
+
+                    r.x = 0;
+                    r.y = 0;
+                    r.w = dstrect->w;
+                    r.h = dstrect->h;
+
+                    SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_NONE);
+                    SDL_SetSurfaceColorMod(src, 255, 255, 255);
+                    SDL_SetSurfaceAlphaMod(src, 255);
+
+                    SDL_BlitSurfaceScaled(src, srcrect, tmp, &r, texture->scaleMode);
+
+                    SDL_SetSurfaceColorMod(tmp, rMod, gMod, bMod);
+                    SDL_SetSurfaceAlphaMod(tmp, alphaMod);
+                    SDL_SetSurfaceBlendMode(tmp, blendmode);
+
+                    SDL_BlitSurface(tmp, NULL, surface, dstrect);
+                    SW_ReleaseScratchSurface(data, tmp);
+                    // No need to set back r/g/b/a/blendmode to 'src' since it's done in PrepTextureForCopy()
+                }
             } else {
-                SDL_BlendPoints(surface, verts, count, blend, r, g, b, a);
+                SDL_BlitSurfaceScaled(src, srcrect, surface, dstrect, texture->scaleMode);
             }
-            break;
         }
+        break;
+    }
 
-        case SDL_RENDERCMD_DRAW_LINES:
-        {
-            const Uint8 r = drawstate.color.r;
-            const Uint8 g = drawstate.color.g;
-            const Uint8 b = drawstate.color.b;
-            const Uint8 a = drawstate.color.a;
-            const int count = (int)cmd->data.draw.count;
-            SDL_Point *verts = (SDL_Point *)(((Uint8 *)vertices) + cmd->data.draw.first);
-            const SDL_BlendMode blend = cmd->data.draw.blend;
-            SetDrawState(surface, &drawstate);
+    case SDL_RENDERCMD_COPY_EX:
+    {
+        CopyExData *copydata = (CopyExData *)(((Uint8 *)vertices) + cmd->data.draw.first);
+        SetDrawState(surface, drawstate);
+        PrepTextureForCopy(cmd, drawstate);
+
+        // Apply viewport
+        if (drawstate->viewport && (drawstate->viewport->x || drawstate->viewport->y)) {
+            copydata->dstrect.x += drawstate->viewport->x;
+            copydata->dstrect.y += drawstate->viewport->y;
+        }
+
+        SW_RenderCopyEx(renderer, surface, cmd->data.draw.texture, &copydata->srcrect,
+                        &copydata->dstrect, copydata->angle, &copydata->center, copydata->flip,
+                        copydata->scale_x, copydata->scale_y);
+        break;
+    }
+
+    case SDL_RENDERCMD_GEOMETRY:
+    {
+        int i;
+        SDL_Rect *verts = (SDL_Rect *)(((Uint8 *)vertices) + cmd->data.draw.first);
+        const int count = (int)cmd->data.draw.count;
+        SDL_Texture *texture = cmd->data.draw.texture;
+        const SDL_BlendMode blend = cmd->data.draw.blend;
+
+        SetDrawState(surface, drawstate);
+
+        if (texture) {
+            SDL_Surface *src = (SDL_Surface *)texture->internal;
+
+            GeometryCopyData *ptr = (GeometryCopyData *)verts;
+
+            PrepTextureForCopy(cmd, drawstate);
 
             // Apply viewport
-            if (drawstate.viewport && (drawstate.viewport->x || drawstate.viewport->y)) {
-                int i;
+            if (drawstate->viewport && (drawstate->viewport->x || drawstate->viewport->y)) {
+                SDL_Point vp;
+                vp.x = drawstate->viewport->x;
+                vp.y = drawstate->viewport->y;
+                trianglepoint_2_fixedpoint(&vp);
                 for (i = 0; i < count; i++) {
-                    verts[i].x += drawstate.viewport->x;
-                    verts[i].y += drawstate.viewport->y;
+                    ptr[i].dst.x += vp.x;
+                    ptr[i].dst.y += vp.y;
                 }
             }
 
-            if (blend == SDL_BLENDMODE_NONE) {
-                SDL_DrawLines(surface, verts, count, SDL_MapSurfaceRGBA(surface, r, g, b, a));
-            } else {
-                SDL_BlendLines(surface, verts, count, blend, r, g, b, a);
+            for (i = 0; i < count; i += 3, ptr += 3) {
+                SDL_SW_BlitTriangle(
+                    src,
+                    &(ptr[0].src), &(ptr[1].src), &(ptr[2].src),
+                    surface,
+                    &(ptr[0].dst), &(ptr[1].dst), &(ptr[2].dst),
+                    ptr[0].color, ptr[1].color, ptr[2].color,
+                    cmd->data.draw.texture_address_mode);
             }
-            break;
-        }
-
-        case SDL_RENDERCMD_FILL_RECTS:
-        {
-            const Uint8 r = drawstate.color.r;
-            const Uint8 g = drawstate.color.g;
-            const Uint8 b = drawstate.color.b;
-            const Uint8 a = drawstate.color.a;
-            const int count = (int)cmd->data.draw.count;
-            SDL_Rect *verts = (SDL_Rect *)(((Uint8 *)vertices) + cmd->data.draw.first);
-            const SDL_BlendMode blend = cmd->data.draw.blend;
-            SetDrawState(surface, &drawstate);
+        } else {
+            GeometryFillData *ptr = (GeometryFillData *)verts;
 
             // Apply viewport
-            if (drawstate.viewport && (drawstate.viewport->x || drawstate.viewport->y)) {
-                int i;
+            if (drawstate->viewport && (drawstate->viewport->x || drawstate->viewport->y)) {
+                SDL_Point vp;
+                vp.x = drawstate->viewport->x;
+                vp.y = drawstate->viewport->y;
+                trianglepoint_2_fixedpoint(&vp);
                 for (i = 0; i < count; i++) {
-                    verts[i].x += drawstate.viewport->x;
-                    verts[i].y += drawstate.viewport->y;
+                    ptr[i].dst.x += vp.x;
+                    ptr[i].dst.y += vp.y;
                 }
             }
 
-            if (blend == SDL_BLENDMODE_NONE) {
-                SDL_FillSurfaceRects(surface, verts, count, SDL_MapSurfaceRGBA(surface, r, g, b, a));
-            } else {
-                SDL_BlendFillRects(surface, verts, count, blend, r, g, b, a);
+            for (i = 0; i < count; i += 3, ptr += 3) {
+                SDL_SW_FillTriangle(surface, &(ptr[0].dst), &(ptr[1].dst), &(ptr[2].dst), blend, ptr[0].color, ptr[1].color, ptr[2].color);
             }
+        }
+        break;
+    }
+
+    case SDL_RENDERCMD_NO_OP:
+        break;
+    }
+
+}
+
+/* The tiled path splits the render target into bands of rows and rasterizes each band on its own thread,
+ * running every command that touches it in queue order. A band only clips commands vertically, and the
+ * fills, points, unscaled copies and triangles it runs produce each pixel independently of the clip rect,
+ * so the result is identical to running the queue serially. Commands whose pixels depend on where they are
+ * clipped (lines, scaled and rotated copies, copies from the target itself) are run on the calling thread
+ * between bands of work, which keeps the order of everything else around them.
+ */
+typedef struct
+{
+    SDL_Surface *surface;
+    void *vertices;
+    const SW_TileCommand *commands;
+    int num_commands;
+} SW_TileJob;
+
+typedef struct
+{
+    SDL_Surface *src;
+    SDL_Surface *view;
+} SW_TileSource;
+
+// Each band draws through its own surfaces, so the clip rect, color mods and blit mapping aren't shared between threads.
+static SDL_Surface *SW_CreateTileView(SDL_Surface *surface)
+{
+    SDL_Surface *view = SDL_CreateSurfaceFrom(surface->w, surface->h, surface->format, surface->pixels, surface->pitch);
+
+    if (view) {
+        SDL_Palette *palette = SDL_GetSurfacePalette(surface);
+        Uint32 colorkey;
+
+        if (palette) {
+            SDL_SetSurfacePalette(view, palette);
+        }
+        if (SDL_GetSurfaceColorKey(surface, &colorkey)) {
+            SDL_SetSurfaceColorKey(view, true, colorkey);
+        }
+        SDL_SetSurfaceColorspace(view, SDL_GetSurfaceColorspace(surface));
+    }
+    return view;
+}
+
+static SDL_Surface *SW_GetTileSource(SW_TileSource *sources, SDL_Surface *src)
+{
+    int i;
+
+    for (i = 0; i < SW_TILE_SOURCE_COUNT; ++i) {
+        if (sources[i].src == src) {
+            return sources[i].view;
+        }
+        if (!sources[i].src) {
             break;
         }
+    }
+    if (i == SW_TILE_SOURCE_COUNT) {
+        // Out of room, drop the oldest view
+        SDL_DestroySurface(sources[0].view);
+        SDL_memmove(&sources[0], &sources[1], (SW_TILE_SOURCE_COUNT - 1) * sizeof(*sources));
+        i = SW_TILE_SOURCE_COUNT - 1;
+    }
+    sources[i].view = SW_CreateTileView(src);
+    sources[i].src = sources[i].view ? src : NULL;
+    return sources[i].view;
+}
 
-        case SDL_RENDERCMD_COPY:
-        {
-            SDL_Rect *verts = (SDL_Rect *)(((Uint8 *)vertices) + cmd->data.draw.first);
-            const SDL_Rect *srcrect = verts;
-            SDL_Rect *dstrect = verts + 1;
-            SDL_Texture *texture = cmd->data.draw.texture;
-            SDL_Surface *src = (SDL_Surface *)texture->internal;
+static void SDLCALL SW_RunTileBand(void *userdata, int row, int rows)
+{
+    const SW_TileJob *job = (const SW_TileJob *)userdata;
+    SW_TileSource sources[SW_TILE_SOURCE_COUNT];
+    SDL_Surface *dst;
+    int i;
 
-            SetDrawState(surface, &drawstate);
+    dst = SW_CreateTileView(job->surface);
+    if (!dst) {
+        return;
+    }
+    SDL_zeroa(sources);
 
-            PrepTextureForCopy(cmd, &drawstate);
+    for (i = 0; i < job->num_commands; ++i) {
+        const SW_TileCommand *tile = &job->commands[i];
+        const SDL_RenderCommand *cmd = tile->cmd;
+        SDL_Rect clip_rect;
 
-            // Apply viewport
-            if (drawstate.viewport && (drawstate.viewport->x || drawstate.viewport->y)) {
-                dstrect->x += drawstate.viewport->x;
-                dstrect->y += drawstate.viewport->y;
-            }
+        if (tile->y1 <= row || tile->y0 >= row + rows) {
+            continue;
+        }
+        clip_rect.x = tile->clip.x;
+        clip_rect.y = SDL_max(tile->clip.y, row);
+        clip_rect.w = tile->clip.w;
+        clip_rect.h = SDL_min(tile->clip.y + tile->clip.h, row + rows) - clip_rect.y;
+        SDL_SetSurfaceClipRect(dst, &clip_rect);
 
-            if (srcrect->w == dstrect->w && srcrect->h == dstrect->h) {
-                SDL_BlitSurface(src, srcrect, surface, dstrect);
+        switch (cmd->command) {
+        case SDL_RENDERCMD_CLEAR:
+            SDL_FillSurfaceRect(dst, NULL, tile->pixel);
+            break;
+
+        case SDL_RENDERCMD_DRAW_POINTS:
+        {
+            const SDL_Point *verts = (const SDL_Point *)(((Uint8 *)job->vertices) + cmd->data.draw.first);
+            if (cmd->data.draw.blend == SDL_BLENDMODE_NONE) {
+                SDL_DrawPoints(dst, verts, (int)cmd->data.draw.count, tile->pixel);
             } else {
-                /* If scaling is ever done, permanently disable RLE (which doesn't support scaling)
-                 * to avoid potentially frequent RLE encoding/decoding.
-                 */
-                SDL_SetSurfaceRLE(surface, 0);
-
-                // Prevent to do scaling + clipping on viewport boundaries as it may lose proportion
-                if (dstrect->x < 0 || dstrect->y < 0 || dstrect->x + dstrect->w > surface->w || dstrect->y + dstrect->h > surface->h) {
-                    SDL_Surface *tmp = SDL_CreateSurface(dstrect->w, dstrect->h, src->format);
-                    // Scale to an intermediate surface, then blit
-                    if (tmp) {
-                        SDL_Rect r;
-                        SDL_BlendMode blendmode;
-                        Uint8 alphaMod, rMod, gMod, bMod;
-
-                        SDL_GetSurfaceBlendMode(src, &blendmode);
-                        SDL_GetSurfaceAlphaMod(src, &alphaMod);
-                        SDL_GetSurfaceColorMod(src, &rMod, &gMod, &bMod);
-
-                        r.x = 0;
-                        r.y = 0;
-                        r.w = dstrect->w;
-                        r.h = dstrect->h;
-
-                        SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_NONE);
-                        SDL_SetSurfaceColorMod(src, 255, 255, 255);
-                        SDL_SetSurfaceAlphaMod(src, 255);
-
-                        SDL_BlitSurfaceScaled(src, srcrect, tmp, &r, texture->scaleMode);
-
-                        SDL_SetSurfaceColorMod(tmp, rMod, gMod, bMod);
-                        SDL_SetSurfaceAlphaMod(tmp, alphaMod);
-                        SDL_SetSurfaceBlendMode(tmp, blendmode);
-
-                        SDL_BlitSurface(tmp, NULL, surface, dstrect);
-                        SDL_DestroySurface(tmp);
-                        // No need to set back r/g/b/a/blendmode to 'src' since it's done in PrepTextureForCopy()
-                    }
-                } else {
-                    SDL_BlitSurfaceScaled(src, srcrect, surface, dstrect, texture->scaleMode);
-                }
+                SDL_BlendPoints(dst, verts, (int)cmd->data.draw.count, cmd->data.draw.blend, tile->color.r, tile->color.g, tile->color.b, tile->color.a);
             }
             break;
         }
 
-        case SDL_RENDERCMD_COPY_EX:
+        case SDL_RENDERCMD_FILL_RECTS:
         {
-            CopyExData *copydata = (CopyExData *)(((Uint8 *)vertices) + cmd->data.draw.first);
-            SetDrawState(surface, &drawstate);
-            PrepTextureForCopy(cmd, &drawstate);
-
-            // Apply viewport
-            if (drawstate.viewport && (drawstate.viewport->x || drawstate.viewport->y)) {
-                copydata->dstrect.x += drawstate.viewport->x;
-                copydata->dstrect.y += drawstate.viewport->y;
+            const SDL_Rect *verts = (const SDL_Rect *)(((Uint8 *)job->vertices) + cmd->data.draw.first);
+            if (cmd->data.draw.blend == SDL_BLENDMODE_NONE) {
+                SDL_FillSurfaceRects(dst, verts, (int)cmd->data.draw.count, tile->pixel);
+            } else {
+                SDL_BlendFillRects(dst, verts, (int)cmd->data.draw.count, cmd->data.draw.blend, tile->color.r, tile->color.g, tile->color.b, tile->color.a);
             }
+            break;
+        }
 
-            SW_RenderCopyEx(renderer, surface, cmd->data.draw.texture, &copydata->srcrect,
-                            &copydata->dstrect, copydata->angle, &copydata->center, copydata->flip,
-                            copydata->scale_x, copydata->scale_y);
+        case SDL_RENDERCMD_COPY:
+        {
+            const SDL_Rect *verts = (const SDL_Rect *)(((Uint8 *)job->vertices) + cmd->data.draw.first);
+            SDL_Surface *src = SW_GetTileSource(sources, (SDL_Surface *)cmd->data.draw.texture->internal);
+            if (src) {
+                SDL_SetSurfaceColorMod(src, tile->color.r, tile->color.g, tile->color.b);
+                SDL_SetSurfaceAlphaMod(src, tile->color.a);
+                SDL_SetSurfaceBlendMode(src, cmd->data.draw.blend);
+                SDL_BlitSurface(src, &verts[0], dst, &verts[1]);
+            }
             break;
         }
 
         case SDL_RENDERCMD_GEOMETRY:
         {
-            int i;
-            SDL_Rect *verts = (SDL_Rect *)(((Uint8 *)vertices) + cmd->data.draw.first);
             const int count = (int)cmd->data.draw.count;
-            SDL_Texture *texture = cmd->data.draw.texture;
-            const SDL_BlendMode blend = cmd->data.draw.blend;
+            const void *verts = ((Uint8 *)job->vertices) + cmd->data.draw.first;
+            int j;
 
-            SetDrawState(surface, &drawstate);
+            // The triangle functions adjust the points they're given, so each band works on copies.
+            if (cmd->data.draw.texture) {
+                const GeometryCopyData *ptr = (const GeometryCopyData *)verts;
+                SDL_Surface *src = SW_GetTileSource(sources, (SDL_Surface *)cmd->data.draw.texture->internal);
+                if (!src) {
+                    break;
+                }
+                SDL_SetSurfaceColorMod(src, tile->color.r, tile->color.g, tile->color.b);
+                SDL_SetSurfaceAlphaMod(src, tile->color.a);
+                SDL_SetSurfaceBlendMode(src, cmd->data.draw.blend);
+                for (j = 0; j < count; j += 3, ptr += 3) {
+                    SDL_Point s0 = ptr[0].src, s1 = ptr[1].src, s2 = ptr[2].src;
+                    SDL_Point d0 = ptr[0].dst, d1 = ptr[1].dst, d2 = ptr[2].dst;
+                    SDL_SW_BlitTriangle(src, &s0, &s1, &s2, dst, &d0, &d1, &d2,
+                                        ptr[0].color, ptr[1].color, ptr[2].color,
+                                        cmd->data.draw.texture_address_mode);
+                }
+            } else {
+                const GeometryFillData *ptr = (const GeometryFillData *)verts;
+                for (j = 0; j < count; j += 3, ptr += 3) {
+                    SDL_Point d0 = ptr[0].dst, d1 = ptr[1].dst, d2 = ptr[2].dst;
+                    SDL_SW_FillTriangle(dst, &d0, &d1, &d2, cmd->data.draw.blend, ptr[0].color, ptr[1].color, ptr[2].color);
+                }
+            }
+            break;
+        }
 
-            if (texture) {
-                SDL_Surface *src = (SDL_Surface *)texture->internal;
+        default:
+            SDL_assert(!"Command can't be tiled");
+            break;
+        }
+    }
 
-                GeometryCopyData *ptr = (GeometryCopyData *)verts;
+    for (i = 0; i < SW_TILE_SOURCE_COUNT; ++i) {
+        SDL_DestroySurface(sources[i].view);
+    }
+    SDL_DestroySurface(dst);
+}
 
-                PrepTextureForCopy(cmd, &drawstate);
+// Returns true if the command can be split across bands, which means its pixels don't depend on the clip rect.
+static bool SW_CanTileCommand(SDL_Surface *surface, const SDL_RenderCommand *cmd, void *vertices, const SW_DrawStateCache *drawstate)
+{
+    SDL_Surface *src = NULL;
 
-                // Apply viewport
-                if (drawstate.viewport && (drawstate.viewport->x || drawstate.viewport->y)) {
-                    SDL_Point vp;
-                    vp.x = drawstate.viewport->x;
-                    vp.y = drawstate.viewport->y;
-                    trianglepoint_2_fixedpoint(&vp);
-                    for (i = 0; i < count; i++) {
-                        ptr[i].dst.x += vp.x;
-                        ptr[i].dst.y += vp.y;
-                    }
-                }
+    if (cmd->command == SDL_RENDERCMD_CLEAR) {
+        return true;
+    } else if (!drawstate->viewport) {
+        return false;
+    }
 
-                for (i = 0; i < count; i += 3, ptr += 3) {
-                    SDL_SW_BlitTriangle(
-                        src,
-                        &(ptr[0].src), &(ptr[1].src), &(ptr[2].src),
-                        surface,
-                        &(ptr[0].dst), &(ptr[1].dst), &(ptr[2].dst),
-                        ptr[0].color, ptr[1].color, ptr[2].color,
-                        cmd->data.draw.texture_address_mode);
-                }
-            } else {
-                GeometryFillData *ptr = (GeometryFillData *)verts;
-
-                // Apply viewport
-                if (drawstate.viewport && (drawstate.viewport->x || drawstate.viewport->y)) {
-                    SDL_Point vp;
-                    vp.x = drawstate.viewport->x;
-                    vp.y = drawstate.viewport->y;
-                    trianglepoint_2_fixedpoint(&vp);
-                    for (i = 0; i < count; i++) {
-                        ptr[i].dst.x += vp.x;
-                        ptr[i].dst.y += vp.y;
-                    }
-                }
+    switch (cmd->command) {
+    case SDL_RENDERCMD_DRAW_POINTS:
+    case SDL_RENDERCMD_FILL_RECTS:
+        return true;
 
-                for (i = 0; i < count; i += 3, ptr += 3) {
-                    SDL_SW_FillTriangle(surface, &(ptr[0].dst), &(ptr[1].dst), &(ptr[2].dst), blend, ptr[0].color, ptr[1].color, ptr[2].color);
-                }
+    case SDL_RENDERCMD_COPY:
+    {
+        const SDL_Rect *verts = (const SDL_Rect *)(((Uint8 *)vertices) + cmd->data.draw.first);
+        if (verts[0].w != verts[1].w || verts[0].h != verts[1].h) {
+            return false;
+        }
+        src = (SDL_Surface *)cmd->data.draw.texture->internal;
+        break;
+    }
+
+    case SDL_RENDERCMD_GEOMETRY:
+        if (cmd->data.draw.texture) {
+            src = (SDL_Surface *)cmd->data.draw.texture->internal;
+        }
+        break;
+
+    default:
+        return false;
+    }
+
+    // Reading from the target would see other bands' writes, and RLE encoded surfaces don't have plain pixels to share.
+    return !src || (src != surface && !(src->internal_flags & SDL_INTERNAL_SURFACE_RLEACCEL));
+}
+
+// Applies the viewport to the command's vertices and finds the rows it can touch, as SW_RunCommand would draw it.
+static void SW_PrepareTileCommand(SDL_Surface *surface, SDL_RenderCommand *cmd, void *vertices, SW_DrawStateCache *drawstate, SW_TileCommand *tile)
+{
+    const SDL_Rect *viewport = drawstate->viewport;
+    const bool offset = viewport && (viewport->x || viewport->y);
+    const SDL_Rect bounds = { 0, 0, surface->w, surface->h };
+    int y0 = 0, y1 = surface->h;
+    int i;
+
+    tile->cmd = cmd;
+    tile->color = drawstate->color;
+    tile->pixel = 0;
+    if (viewport) {
+        GetDrawClipRect(drawstate, &tile->clip);
+    } else {
+        tile->clip = bounds;
+    }
+
+    switch (cmd->command) {
+    case SDL_RENDERCMD_CLEAR:
+    {
+        // By definition the clear ignores the clip rect
+        const Uint8 r = (Uint8)SDL_roundf(SDL_clamp(cmd->data.color.color.r * cmd->data.color.color_scale, 0.0f, 1.0f) * 255.0f);
+        const Uint8 g = (Uint8)SDL_roundf(SDL_clamp(cmd->data.color.color.g * cmd->data.color.color_scale, 0.0f, 1.0f) * 255.0f);
+        const Uint8 b = (Uint8)SDL_roundf(SDL_clamp(cmd->data.color.color.b * cmd->data.color.color_scale, 0.0f, 1.0f) * 255.0f);
+        const Uint8 a = (Uint8)SDL_roundf(SDL_clamp(cmd->data.color.color.a, 0.0f, 1.0f) * 255.0f);
+        tile->pixel = SDL_MapSurfaceRGBA(surface, r, g, b, a);
+        tile->clip = bounds;
+        drawstate->surface_cliprect_dirty = true;
+        break;
+    }
+
+    case SDL_RENDERCMD_DRAW_POINTS:
+    {
+        SDL_Point *verts = (SDL_Point *)(((Uint8 *)vertices) + cmd->data.draw.first);
+        const int count = (int)cmd->data.draw.count;
+        y0 = SDL_MAX_SINT32;
+        y1 = SDL_MIN_SINT32;
+        for (i = 0; i < count; i++) {
+            if (offset) {
+                verts[i].x += viewport->x;
+                verts[i].y += viewport->y;
             }
-            break;
+            y0 = SDL_min(y0, verts[i].y);
+            y1 = SDL_max(y1, verts[i].y + 1);
         }
+        tile->pixel = SDL_MapSurfaceRGBA(surface, tile->color.r, tile->color.g, tile->color.b, tile->color.a);
+        break;
+    }
+
+    case SDL_RENDERCMD_FILL_RECTS:
+    {
+        SDL_Rect *verts = (SDL_Rect *)(((Uint8 *)vertices) + cmd->data.draw.first);
+        const int count = (int)cmd->data.draw.count;
+        y0 = SDL_MAX_SINT32;
+        y1 = SDL_MIN_SINT32;
+        for (i = 0; i < count; i++) {
+            if (offset) {
+                verts[i].x += viewport->x;
+                verts[i].y += viewport->y;
+            }
+            y0 = SDL_min(y0, verts[i].y);
+            y1 = SDL_max(y1, verts[i].y + verts[i].h);
+        }
+        tile->pixel = SDL_MapSurfaceRGBA(surface, tile->color.r, tile->color.g, tile->color.b, tile->color.a);
+        break;
+    }
+
+    case SDL_RENDERCMD_COPY:
+    {
+        SDL_Rect *dstrect = (SDL_Rect *)(((Uint8 *)vertices) + cmd->data.draw.first) + 1;
+        if (offset) {
+            dstrect->x += viewport->x;
+            dstrect->y += viewport->y;
+        }
+        y0 = dstrect->y;
+        y1 = dstrect->y + dstrect->h;
+        PrepTextureForCopy(cmd, drawstate);
+        break;
+    }
+
+    case SDL_RENDERCMD_GEOMETRY:
+    {
+        const int count = (int)cmd->data.draw.count;
+        SDL_Point vp;
+        vp.x = viewport->x;
+        vp.y = viewport->y;
+        trianglepoint_2_fixedpoint(&vp);
+        if (cmd->data.draw.texture) {
+            GeometryCopyData *ptr = (GeometryCopyData *)(((Uint8 *)vertices) + cmd->data.draw.first);
+            PrepTextureForCopy(cmd, drawstate);
+            for (i = 0; offset && i < count; i++) {
+                ptr[i].dst.x += vp.x;
+                ptr[i].dst.y += vp.y;
+            }
+        } else {
+            GeometryFillData *ptr = (GeometryFillData *)(((Uint8 *)vertices) + cmd->data.draw.first);
+            for (i = 0; offset && i < count; i++) {
+                ptr[i].dst.x += vp.x;
+                ptr[i].dst.y += vp.y;
+            }
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+
+    SDL_GetRectIntersection(&tile->clip, &bounds, &tile->clip);
+    tile->y0 = SDL_max(y0, tile->clip.y);
+    tile->y1 = SDL_min(y1, tile->clip.y + tile->clip.h);
+}
 
+static void SW_FlushTileCommands(SW_TileJob *job, int threads)
+{
+    if (job->num_commands > 0) {
+        SDL_RunRowPool(job->surface->h, 1, threads, SW_RunTileBand, job);
+        job->num_commands = 0;
+    }
+}
+
+static void SW_RunCommandQueueTiled(SDL_Renderer *renderer, SDL_Surface *surface, SDL_RenderCommand *cmd, void *vertices, SW_DrawStateCache *drawstate, int threads)
+{
+    SW_RenderData *data = (SW_RenderData *)renderer->internal;
+    SW_TileJob job;
+
+    job.surface = surface;
+    job.vertices = vertices;
+    job.commands = data->tile_commands;
+    job.num_commands = 0;
+
+    while (cmd) {
+        switch (cmd->command) {
+        case SDL_RENDERCMD_SETDRAWCOLOR:
+        case SDL_RENDERCMD_SETVIEWPORT:
+        case SDL_RENDERCMD_SETCLIPRECT:
         case SDL_RENDERCMD_NO_OP:
+            // These only change the draw state, so they don't need to wait for queued tiles.
+            SW_RunCommand(renderer, surface, cmd, vertices, drawstate);
             break;
-        }
 
+        default:
+            if (SW_CanTileCommand(surface, cmd, vertices, drawstate)) {
+                if (job.num_commands == data->max_tile_commands) {
+                    const int max_tile_commands = data->max_tile_commands ? data->max_tile_commands * 2 : 64;
+                    SW_TileCommand *tile_commands = (SW_TileCommand *)SDL_realloc(data->tile_commands, max_tile_commands * sizeof(*tile_commands));
+                    if (tile_commands) {
+                        data->tile_commands = tile_commands;
+                        data->max_tile_commands = max_tile_commands;
+                        job.commands = tile_commands;
+                    } else {
+                        SW_FlushTileCommands(&job, threads);
+                    }
+                }
+                if (job.num_commands < data->max_tile_commands) {
+                    SW_TileCommand *tile = &data->tile_commands[job.num_commands];
+                    SW_PrepareTileCommand(surface, cmd, vertices, drawstate, tile);
+                    if (tile->y0 < tile->y1) {
+                        ++job.num_commands;
+                    }
+                    ++data->tiled_commands;
+                    break;
+                }
+            }
+
+            // This one has to see everything before it drawn, and be drawn before anything after it.
+            SW_FlushTileCommands(&job, threads);
+            drawstate->surface_cliprect_dirty = true;
+            SW_RunCommand(renderer, surface, cmd, vertices, drawstate);
+            ++data->serial_commands;
+            break;
+        }
         cmd = cmd->next;
     }
+    SW_FlushTileCommands(&job, threads);
+}
+
+static bool SW_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, void *vertices, size_t vertsize)
+{
+    SW_RenderData *data = (SW_RenderData *)renderer->internal;
+    SDL_Surface *surface = SW_ActivateRenderer(renderer);
+    SW_DrawStateCache drawstate;
+    int threads;
+
+    if (!SDL_SurfaceValid(surface)) {
+        return false;
+    }
+
+    drawstate.viewport = NULL;
+    drawstate.cliprect = NULL;
+    drawstate.surface_cliprect_dirty = true;
+    drawstate.color.r = 0;
+    drawstate.color.g = 0;
+    drawstate.color.b = 0;
+    drawstate.color.a = 0;
+
+    threads = SDL_GetRowPoolThreadCount(SDL_HINT_RENDER_SOFTWARE_THREADS, surface->w, surface->h);
+    if (threads > 1 && !SDL_MUSTLOCK(surface)) {
+        SW_RunCommandQueueTiled(renderer, surface, cmd, vertices, &drawstate, threads);
+    } else {
+        while (cmd) {
+            SW_RunCommand(renderer, surface, cmd, vertices, &drawstate);
+            cmd = cmd->next;
+        }
+    }
+
+    // Drop the scratch surfaces that haven't been needed for a while and publish the cache counters
+    ++data->pass;
+    SW_TrimScratchSurfaces(data, false);
+    SDL_SetNumberProperty(SDL_GetRendererProperties(renderer), SDL_PROP_RENDERER_SOFTWARE_SCRATCH_ALLOCATIONS_NUMBER, data->scratch_allocations);
+    SDL_SetNumberProperty(SDL_GetRendererProperties(renderer), SDL_PROP_RENDERER_SOFTWARE_SCRATCH_REUSES_NUMBER, data->scratch_reuses);
+    SDL_SetNumberProperty(SDL_GetRendererProperties(renderer), SDL_PROP_RENDERER_SOFTWARE_TILED_COMMANDS_NUMBER, data->tiled_commands);
+    SDL_SetNumberProperty(SDL_GetRendererProperties(renderer), SDL_PROP_RENDERER_SOFTWARE_SERIAL_COMMANDS_NUMBER, data->serial_commands);
 
     return true;
 }
@@ -1014,6 +1701,8 @@ static void SW_DestroyRenderer(SDL_Renderer *renderer)
     if (window) {
         SDL_DestroyWindowSurface(window);
     }
+    SW_TrimScratchSurfaces(data, true);
+    SDL_free(data->tile_commands);
     SDL_free(data);
 }
 
@@ -71,7 +71,7 @@ This catches any potential overflows which seem to happen with
 just the right src image dimensions and scale/rotation and can lead
 to a situation where the program can segfault.
 */
-#define GUARD_ROWS (2)
+#define GUARD_ROWS SDLGFX_ROTATE_GUARD_ROWS
 
 /**
 Returns colorkey info for a surface
@@ -463,7 +463,8 @@ static void transformSurfaceY(SDL_Surface *src, SDL_Surface *dst, int isin, int
 /**
 Rotates and zooms a surface with different horizontal and vertival scaling factors and optional anti-aliasing.
 
-Rotates a 32-bit or 8-bit 'src' surface to newly created 'dst' surface.
+Rotates a 32-bit or 8-bit 'src' surface to newly created 'dst' surface, or to the 'dst'
+surface passed in to be reused.
 'angle' is the rotation in degrees, 'center' the rotation center. If 'smooth' is set
 then the destination 32-bit surface is anti-aliased. 8-bit surfaces must have a colorkey. 32-bit
 surfaces must have a 8888 layout with red, green, blue and alpha masks (any ordering goes).
@@ -473,6 +474,8 @@ surface and sets the colorkey or fills the it with the colorkey before copying t
 When using the NONE and MOD modes, color and alpha modulation must be applied before using this function.
 
 \param src The surface to rotozoom.
+\param dst An optional surface to reuse, NULL to create one. It must have the size of 'rect_dest',
+the format of 'src' and pixel memory for GUARD_ROWS additional rows.
 \param angle The angle to rotate in degrees.
 \param smooth Antialiasing flag; set to SMOOTHING_ON to enable.
 \param flipx Set to 1 to flip the image horizontally
@@ -485,7 +488,7 @@ When using the NONE and MOD modes, color and alpha modulation must be applied be
 
 */
 
-SDL_Surface *SDLgfx_rotateSurface(SDL_Surface *src, double angle, int smooth, int flipx, int flipy,
+SDL_Surface *SDLgfx_rotateSurface(SDL_Surface *src, SDL_Surface *dst, double angle, int smooth, int flipx, int flipy,
                      const SDL_Rect *rect_dest, double cangle, double sangle, const SDL_FPoint *center)
 {
     SDL_Surface *rz_dst;
@@ -493,6 +496,7 @@ SDL_Surface *SDLgfx_rotateSurface(SDL_Surface *src, double angle, int smooth, in
     SDL_BlendMode blendmode;
     Uint32 colorkey = 0;
     bool colorKeyAvailable = false;
+    bool filled = false;
     double sangleinv, cangleinv;
 
     // Sanity check
@@ -517,7 +521,13 @@ SDL_Surface *SDLgfx_rotateSurface(SDL_Surface *src, double angle, int smooth, in
 
     // Alloc space to completely contain the rotated surface
     rz_dst = NULL;
-    if (is8bit) {
+    if (dst) {
+        // Reuse the surface provided by the caller
+        rz_dst = dst;
+        if (is8bit) {
+            SDL_SetSurfacePalette(rz_dst, src->palette);
+        }
+    } else if (is8bit) {
         // Target surface is 8 bit
         rz_dst = SDL_CreateSurface(rect_dest->w, rect_dest->h + GUARD_ROWS, src->format);
         if (rz_dst) {
@@ -542,6 +552,7 @@ SDL_Surface *SDLgfx_rotateSurface(SDL_Surface *src, double angle, int smooth, in
         // If available, the colorkey will be used to discard the pixels that are outside of the rotated area.
         SDL_SetSurfaceColorKey(rz_dst, true, colorkey);
         SDL_FillSurfaceRect(rz_dst, NULL, colorkey);
+        filled = true;
     } else if (blendmode == SDL_BLENDMODE_NONE) {
         blendmode = SDL_BLENDMODE_BLEND;
     } else if (blendmode == SDL_BLENDMODE_MOD || blendmode == SDL_BLENDMODE_MUL) {
@@ -550,6 +561,7 @@ SDL_Surface *SDLgfx_rotateSurface(SDL_Surface *src, double angle, int smooth, in
          */
         colorkey = SDL_MapSurfaceRGBA(rz_dst, 255, 255, 255, 0);
         SDL_FillSurfaceRect(rz_dst, NULL, colorkey);
+        filled = true;
         /* Setting a white colorkey for the destination surface makes the final blit discard
          * all pixels outside of the rotated area. This doesn't interfere with anything because
          * white pixels are already a no-op and the MOD blend mode does not interact with alpha.
@@ -562,7 +574,9 @@ SDL_Surface *SDLgfx_rotateSurface(SDL_Surface *src, double angle, int smooth, in
     // Lock source surface
     if (SDL_MUSTLOCK(src)) {
         if (!SDL_LockSurface(src)) {
-            SDL_DestroySurface(rz_dst);
+            if (rz_dst != dst) {
+                SDL_DestroySurface(rz_dst);
+            }
             return NULL;
         }
     }
@@ -582,6 +596,13 @@ SDL_Surface *SDLgfx_rotateSurface(SDL_Surface *src, double angle, int smooth, in
         angle90 = -1;
     }
 
+    /* A reused surface isn't zeroed like a new one, and the arbitrary angle paths
+     * leave the pixels outside of the rotated area untouched.
+     */
+    if (dst && !filled && angle90 < 0) {
+        SDL_memset(rz_dst->pixels, 0, (size_t)rz_dst->pitch * rz_dst->h);
+    }
+
     if (is8bit) {
         // Call the 8-bit transformation routine to do the rotation
         if (angle90 >= 0) {
@@ -22,7 +22,10 @@
 #ifndef SDL_rotate_h_
 #define SDL_rotate_h_
 
-extern SDL_Surface *SDLgfx_rotateSurface(SDL_Surface *src, double angle, int smooth, int flipx, int flipy,
+// Number of rows of pixel memory a destination passed to SDLgfx_rotateSurface needs below its height.
+#define SDLGFX_ROTATE_GUARD_ROWS 2
+
+extern SDL_Surface *SDLgfx_rotateSurface(SDL_Surface *src, SDL_Surface *dst, double angle, int smooth, int flipx, int flipy,
                                          const SDL_Rect *rect_dest, double cangle, double sangle, const SDL_FPoint *center);
 extern void SDLgfx_rotozoomSurfaceSizeTrig(int width, int height, double angle, const SDL_FPoint *center,
                                            SDL_Rect *rect_dest, double *cangle, double *sangle);
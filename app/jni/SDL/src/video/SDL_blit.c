@@ -28,6 +28,243 @@
 #include "SDL_RLEaccel_c.h"
 #include "SDL_pixels_c.h"
 
+/* Everything SDL_CalculateBlit() looks at when choosing a blit function for a
+ * non-indexed surface pair. The scale mode is part of the flags, as
+ * SDL_COPY_NEAREST.
+ */
+typedef struct SDL_BlitCacheKey
+{
+    SDL_PixelFormat src_format;
+    SDL_PixelFormat dst_format;
+    SDL_Colorspace src_colorspace;
+    SDL_Colorspace dst_colorspace;
+    Uint32 flags;
+} SDL_BlitCacheKey;
+
+struct SDL_BlitCacheEntry
+{
+    SDL_BlitCacheKey key;
+
+    // These are protected by the lock
+    SDL_SpinLock lock;
+    SDL_BlitFunc func;
+    SDL_BlitPath path;
+    Uint64 maps;
+    Uint64 blits_carry;
+    Uint64 pixels_carry;
+
+    /* Counted on every blit without locking, possibly from several threads at once.
+     * These wrap around, and the thread that wraps one carries it into its total under the lock.
+     */
+    SDL_AtomicInt blits;
+    SDL_AtomicInt pixels;
+};
+
+static SDL_HashTable *SDL_blit_cache;
+static SDL_SpinLock SDL_blit_cache_lock;
+
+static Uint32 SDL_HashBlitCacheKey(const void *key, void *unused)
+{
+    return SDL_murmur3_32(key, sizeof(SDL_BlitCacheKey), 0);
+}
+
+static bool SDL_KeyMatchBlitCacheKey(const void *a, const void *b, void *unused)
+{
+    return SDL_memcmp(a, b, sizeof(SDL_BlitCacheKey)) == 0;
+}
+
+static SDL_BlitCacheEntry *SDL_GetBlitCacheEntry(SDL_Surface *surface, SDL_Surface *dst, SDL_BlitCacheEntry *last)
+{
+    SDL_BlitCacheKey key;
+    SDL_BlitCacheEntry *entry = NULL;
+
+    SDL_zero(key);
+    key.src_format = surface->format;
+    key.dst_format = dst->format;
+    key.src_colorspace = surface->colorspace;
+    key.dst_colorspace = dst->colorspace;
+    key.flags = (Uint32)(surface->map.info.flags & ~SDL_COPY_RLE_MASK);
+
+    // Entries live until SDL_Quit(), so the one used last time can be checked without locking
+    if (last && SDL_memcmp(&last->key, &key, sizeof(key)) == 0) {
+        return last;
+    }
+
+    SDL_LockSpinlock(&SDL_blit_cache_lock);
+
+    if (!SDL_blit_cache) {
+        SDL_blit_cache = SDL_CreateHashTable(NULL, 32, SDL_HashBlitCacheKey, SDL_KeyMatchBlitCacheKey, SDL_NukeFreeValue, false);
+        if (!SDL_blit_cache) {
+            goto done;
+        }
+    }
+
+    if (SDL_FindInHashTable(SDL_blit_cache, &key, (const void **)&entry)) {
+        goto done;
+    }
+
+    entry = (SDL_BlitCacheEntry *)SDL_calloc(1, sizeof(*entry));
+    if (!entry) {
+        goto done;
+    }
+    entry->key = key;
+
+    if (!SDL_InsertIntoHashTable(SDL_blit_cache, &entry->key, entry)) {
+        SDL_free(entry);
+        entry = NULL;
+        goto done;
+    }
+
+done:
+    SDL_UnlockSpinlock(&SDL_blit_cache_lock);
+
+    return entry;
+}
+
+void SDL_QuitBlitCache(void)
+{
+    if (SDL_blit_cache) {
+        SDL_DestroyHashTable(SDL_blit_cache);
+        SDL_blit_cache = NULL;
+    }
+}
+
+static SDL_BlendMode SDL_GetBlitCacheBlendMode(Uint32 flags)
+{
+    switch (flags & SDL_COPY_BLEND_MASK) {
+    case SDL_COPY_BLEND:
+        return SDL_BLENDMODE_BLEND;
+    case SDL_COPY_BLEND_PREMULTIPLIED:
+        return SDL_BLENDMODE_BLEND_PREMULTIPLIED;
+    case SDL_COPY_ADD:
+        return SDL_BLENDMODE_ADD;
+    case SDL_COPY_ADD_PREMULTIPLIED:
+        return SDL_BLENDMODE_ADD_PREMULTIPLIED;
+    case SDL_COPY_MOD:
+        return SDL_BLENDMODE_MOD;
+    case SDL_COPY_MUL:
+        return SDL_BLENDMODE_MUL;
+    default:
+        return SDL_BLENDMODE_NONE;
+    }
+}
+
+SDL_BlitStats **SDL_GetBlitStats(int *count)
+{
+    SDL_BlitStats **result = NULL;
+    const void *key;
+    const void *value;
+    void *iter;
+    int i, num_entries = 0;
+
+    if (count) {
+        *count = 0;
+    }
+
+    SDL_LockSpinlock(&SDL_blit_cache_lock);
+
+    if (SDL_blit_cache) {
+        iter = NULL;
+        while (SDL_IterateHashTable(SDL_blit_cache, &key, &value, &iter)) {
+            ++num_entries;
+        }
+    }
+
+    result = (SDL_BlitStats **)SDL_malloc(((num_entries + 1) * sizeof(*result)) + (num_entries * sizeof(**result)));
+    if (result) {
+        SDL_BlitStats *stats = (SDL_BlitStats *)(result + (num_entries + 1));
+
+        i = 0;
+        iter = NULL;
+        while (i < num_entries && SDL_IterateHashTable(SDL_blit_cache, &key, &value, &iter)) {
+            SDL_BlitCacheEntry *entry = (SDL_BlitCacheEntry *)value;
+
+            stats->src_format = entry->key.src_format;
+            stats->dst_format = entry->key.dst_format;
+            stats->src_colorspace = entry->key.src_colorspace;
+            stats->dst_colorspace = entry->key.dst_colorspace;
+            stats->blend_mode = SDL_GetBlitCacheBlendMode(entry->key.flags);
+            stats->color_mod = (entry->key.flags & SDL_COPY_MODULATE_COLOR) != 0;
+            stats->alpha_mod = (entry->key.flags & SDL_COPY_MODULATE_ALPHA) != 0;
+            stats->colorkey = (entry->key.flags & SDL_COPY_COLORKEY) != 0;
+            stats->scaled = (entry->key.flags & SDL_COPY_NEAREST) != 0;
+
+            SDL_LockSpinlock(&entry->lock);
+            stats->path = entry->path;
+            stats->maps = entry->maps;
+            stats->blits = entry->blits_carry + (Uint32)SDL_GetAtomicInt(&entry->blits);
+            stats->pixels = entry->pixels_carry + (Uint32)SDL_GetAtomicInt(&entry->pixels);
+            SDL_UnlockSpinlock(&entry->lock);
+
+            result[i++] = stats++;
+        }
+        result[i] = NULL;
+
+        if (count) {
+            *count = i;
+        }
+    }
+
+    SDL_UnlockSpinlock(&SDL_blit_cache_lock);
+
+    return result;
+}
+
+// Count one blit, without taking any lock unless a counter wraps around
+static void SDL_CountBlit(SDL_BlitCacheEntry *entry, Uint64 pixels)
+{
+    Uint64 carry = 0;
+    Uint32 before;
+
+    before = (Uint32)SDL_AddAtomicInt(&entry->blits, 1);
+    if (before == 0xFFFFFFFFu) {
+        carry = 1;
+    }
+
+    // a blit too large for the counter goes straight into the total
+    if (pixels < 0x80000000u) {
+        before = (Uint32)SDL_AddAtomicInt(&entry->pixels, (int)pixels);
+        if ((Uint32)(before + (Uint32)pixels) < before) {
+            pixels = 0x100000000u;
+        } else {
+            pixels = 0;
+        }
+    }
+
+    if (carry || pixels) {
+        SDL_LockSpinlock(&entry->lock);
+        entry->blits_carry += carry << 32;
+        entry->pixels_carry += pixels;
+        SDL_UnlockSpinlock(&entry->lock);
+    }
+}
+
+void SDL_ResetBlitStats(void)
+{
+    const void *key;
+    const void *value;
+    void *iter;
+
+    SDL_LockSpinlock(&SDL_blit_cache_lock);
+
+    if (SDL_blit_cache) {
+        iter = NULL;
+        while (SDL_IterateHashTable(SDL_blit_cache, &key, &value, &iter)) {
+            SDL_BlitCacheEntry *entry = (SDL_BlitCacheEntry *)value;
+
+            SDL_LockSpinlock(&entry->lock);
+            entry->maps = 0;
+            entry->blits_carry = 0;
+            entry->pixels_carry = 0;
+            SDL_SetAtomicInt(&entry->blits, 0);
+            SDL_SetAtomicInt(&entry->pixels, 0);
+            SDL_UnlockSpinlock(&entry->lock);
+        }
+    }
+
+    SDL_UnlockSpinlock(&SDL_blit_cache_lock);
+}
+
 // The general purpose software blit routine
 static bool SDLCALL SDL_SoftBlit(SDL_Surface *src, const SDL_Rect *srcrect,
                                 SDL_Surface *dst, const SDL_Rect *dstrect)
@@ -82,6 +319,10 @@ static bool SDLCALL SDL_SoftBlit(SDL_Surface *src, const SDL_Rect *srcrect,
             info->dst_pitch - info->dst_w * info->dst_fmt->bytes_per_pixel;
         RunBlit = (SDL_BlitFunc)src->map.data;
 
+        if (src->map.cache_entry) {
+            SDL_CountBlit(src->map.cache_entry, (Uint64)dstrect->w * dstrect->h);
+        }
+
         // Run the actual software blit
         RunBlit(info);
     }
@@ -179,9 +420,15 @@ static SDL_BlitFunc SDL_ChooseBlitFunc(SDL_PixelFormat src_format, SDL_PixelForm
 bool SDL_CalculateBlit(SDL_Surface *surface, SDL_Surface *dst)
 {
     SDL_BlitFunc blit = NULL;
+    SDL_BlitPath path = SDL_BLITPATH_SLOW;
     SDL_BlitMap *map = &surface->map;
+    SDL_BlitCacheEntry *entry;
     SDL_Colorspace src_colorspace = surface->colorspace;
     SDL_Colorspace dst_colorspace = dst->colorspace;
+    SDL_BlitCacheEntry *last = map->cache_entry;
+    bool cacheable;
+
+    map->cache_entry = NULL;
 
     // We don't currently support blitting to < 8 bpp surfaces
     if (SDL_BITSPERPIXEL(dst->format) < 8) {
@@ -213,41 +460,63 @@ bool SDL_CalculateBlit(SDL_Surface *surface, SDL_Surface *dst)
     }
 #endif
 
+    /* Blits between indexed formats depend on the palettes, everything else
+     * only on the formats, colorspaces and flags, so the choice can be reused.
+     */
+    cacheable = (!SDL_ISPIXELFORMAT_INDEXED(surface->format) && !SDL_ISPIXELFORMAT_INDEXED(dst->format));
+    entry = SDL_GetBlitCacheEntry(surface, dst, last);
+    if (entry) {
+        SDL_LockSpinlock(&entry->lock);
+        ++entry->maps;
+        if (cacheable && entry->func) {
+            blit = entry->func;
+            path = entry->path;
+        }
+        SDL_UnlockSpinlock(&entry->lock);
+    }
+
     // Choose a standard blit function
     if (!blit) {
         if (src_colorspace != dst_colorspace ||
             SDL_BYTESPERPIXEL(surface->format) > 4 ||
             SDL_BYTESPERPIXEL(dst->format) > 4) {
             blit = SDL_Blit_Slow_Float;
+            path = SDL_BLITPATH_SLOW_FLOAT;
         }
     }
     if (!blit) {
         if (map->identity && !(map->info.flags & ~SDL_COPY_RLE_DESIRED)) {
             blit = SDL_BlitCopy;
+            path = SDL_BLITPATH_COPY;
         } else if (SDL_ISPIXELFORMAT_10BIT(surface->format) ||
                    SDL_ISPIXELFORMAT_10BIT(dst->format)) {
             blit = SDL_Blit_Slow;
+            path = SDL_BLITPATH_SLOW;
         }
 #if SDL_HAVE_BLIT_0
         else if (SDL_BITSPERPIXEL(surface->format) < 8 &&
                  SDL_ISPIXELFORMAT_INDEXED(surface->format)) {
             blit = SDL_CalculateBlit0(surface);
+            path = SDL_BLITPATH_INDEXED;
         }
 #endif
 #if SDL_HAVE_BLIT_1
         else if (SDL_BYTESPERPIXEL(surface->format) == 1 &&
                  SDL_ISPIXELFORMAT_INDEXED(surface->format)) {
             blit = SDL_CalculateBlit1(surface);
+            path = SDL_BLITPATH_INDEXED;
         }
 #endif
 #if SDL_HAVE_BLIT_A
         else if (map->info.flags & SDL_COPY_BLEND) {
             blit = SDL_CalculateBlitA(surface);
+            path = SDL_BLITPATH_BLEND;
         }
 #endif
 #if SDL_HAVE_BLIT_N
         else {
             blit = SDL_CalculateBlitN(surface);
+            path = SDL_BLITPATH_CONVERT;
         }
 #endif
     }
@@ -259,6 +528,7 @@ bool SDL_CalculateBlit(SDL_Surface *surface, SDL_Surface *dst)
         blit =
             SDL_ChooseBlitFunc(src_format, dst_format, map->info.flags,
                                SDL_GeneratedBlitFuncTable);
+        path = SDL_BLITPATH_GENERATED;
     }
 #endif
 
@@ -276,6 +546,7 @@ bool SDL_CalculateBlit(SDL_Surface *surface, SDL_Surface *dst)
              (dst_format == SDL_PIXELFORMAT_INDEX8 && dst->palette)) &&
             !SDL_ISPIXELFORMAT_FOURCC(dst_format)) {
             blit = SDL_Blit_Slow;
+            path = SDL_BLITPATH_SLOW;
         }
     }
     map->data = (void *)blit;
@@ -286,5 +557,15 @@ bool SDL_CalculateBlit(SDL_Surface *surface, SDL_Surface *dst)
         return SDL_SetError("Blit combination not supported");
     }
 
+    if (entry) {
+        SDL_LockSpinlock(&entry->lock);
+        if (cacheable) {
+            entry->func = blit;
+        }
+        entry->path = path;
+        SDL_UnlockSpinlock(&entry->lock);
+        map->cache_entry = entry;
+    }
+
     return true;
 }
@@ -53,6 +53,9 @@ extern const Uint16 SDL_expand_byte_10[];
 #define SDL_CPU_ALTIVEC_PREFETCH   0x00000008
 #define SDL_CPU_ALTIVEC_NOPREFETCH 0x00000010
 
+// Transfer tables cached by SDL_Blit_Slow_Float, see SDL_blit_slow.c
+typedef struct SDL_BlitFloatLUT SDL_BlitFloatLUT;
+
 typedef struct
 {
     SDL_Surface *src_surface;
@@ -71,6 +74,7 @@ typedef struct
     const SDL_Palette *dst_pal;
     Uint8 *table;
     SDL_HashTable *palette_map;
+    SDL_BlitFloatLUT *float_lut;
     int flags;
     Uint32 colorkey;
     Uint8 r, g, b, a;
@@ -89,6 +93,9 @@ typedef struct
 
 typedef bool (SDLCALL *SDL_Blit) (struct SDL_Surface *src, const SDL_Rect *srcrect, struct SDL_Surface *dst, const SDL_Rect *dstrect);
 
+// Shared entry in the blit function cache, see SDL_blit.c
+typedef struct SDL_BlitCacheEntry SDL_BlitCacheEntry;
+
 // Blit mapping definition
 typedef struct SDL_BlitMap
 {
@@ -96,6 +103,7 @@ typedef struct SDL_BlitMap
     SDL_Blit blit;
     void *data;
     SDL_BlitInfo info;
+    SDL_BlitCacheEntry *cache_entry;
 
     /* the version count matches the destination; mismatch indicates
        an invalid mapping */
@@ -105,6 +113,7 @@ typedef struct SDL_BlitMap
 
 // Functions found in SDL_blit.c
 extern bool SDL_CalculateBlit(SDL_Surface *surface, SDL_Surface *dst);
+extern void SDL_QuitBlitCache(void);
 
 /* Functions found in SDL_blit_*.c */
 extern SDL_BlitFunc SDL_CalculateBlit0(SDL_Surface *surface);
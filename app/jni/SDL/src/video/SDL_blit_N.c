@@ -41,6 +41,8 @@
 #define BLIT_FEATURE_HAS_ALTIVEC                0x02
 #define BLIT_FEATURE_ALTIVEC_DONT_USE_PREFETCH  0x04
 #define BLIT_FEATURE_HAS_ARM_SIMD               0x08
+#define BLIT_FEATURE_HAS_SSE41                  0x10
+#define BLIT_FEATURE_HAS_AVX2                   0x20
 
 #ifdef SDL_ALTIVEC_BLITTERS
 #ifdef SDL_PLATFORM_MACOS
@@ -891,7 +893,8 @@ static Uint32 GetBlitFeatures(void)
 #endif
 #else
 // Feature 1 is has-MMX
-#define GetBlitFeatures() ((SDL_HasMMX() ? BLIT_FEATURE_HAS_MMX : 0) | (SDL_HasARMSIMD() ? BLIT_FEATURE_HAS_ARM_SIMD : 0))
+#define GetBlitFeatures() ((SDL_HasMMX() ? BLIT_FEATURE_HAS_MMX : 0) | (SDL_HasARMSIMD() ? BLIT_FEATURE_HAS_ARM_SIMD : 0) | \
+                           (SDL_HasSSE41() ? BLIT_FEATURE_HAS_SSE41 : 0) | (SDL_HasAVX2() ? BLIT_FEATURE_HAS_AVX2 : 0))
 #endif
 
 #ifdef SDL_ARM_SIMD_BLITTERS
@@ -2799,6 +2802,435 @@ static void Blit_3or4_to_3or4__inversed_rgb(SDL_BlitInfo *info)
     }
 }
 
+#if defined(SDL_SSE4_1_INTRINSICS) || defined(SDL_AVX2_INTRINSICS)
+
+#if SDL_HAVE_BLIT_N_RGB565
+/* Multipliers reproducing the RGB565_*_LUT tables exactly:
+ * (v * RGB565_SCALE5) >> 7 for red and blue, (v * RGB565_SCALE6) >> 10 for green.
+ * The vector code gets the same result with a 16-bit high multiply of v << 9 and v << 6.
+ */
+#define RGB565_SCALE5 1053
+#define RGB565_SCALE6 4139
+
+// Shuffle control moving R, G, B, 0xFF bytes into the byte order of a 4 bpp dst format
+static void GetRGB565Shuffle(const SDL_PixelFormatDetails *dstfmt, Uint8 shuffle[16])
+{
+    int i, j;
+
+    for (i = 0; i < 4; ++i) {
+        for (j = 0; j < 4; ++j) {
+            shuffle[i * 4 + j] = (Uint8)(i * 4 + 3);
+        }
+        shuffle[i * 4 + dstfmt->Rshift / 8] = (Uint8)(i * 4 + 0);
+        shuffle[i * 4 + dstfmt->Gshift / 8] = (Uint8)(i * 4 + 1);
+        shuffle[i * 4 + dstfmt->Bshift / 8] = (Uint8)(i * 4 + 2);
+    }
+}
+#endif // SDL_HAVE_BLIT_N_RGB565
+
+// Whether the RGB masks are those of XRGB8888 or XBGR8888, the triplets the Blit_3or4_to_3or4 entries match
+static bool IsRGB888Triplet(const SDL_PixelFormatDetails *fmt)
+{
+    return fmt->Gmask == 0x0000FF00 &&
+           ((fmt->Rmask == 0x00FF0000 && fmt->Bmask == 0x000000FF) ||
+            (fmt->Rmask == 0x000000FF && fmt->Bmask == 0x00FF0000));
+}
+
+/* Shuffle control for 4 pixels of a 3 or 4 bpp -> 3 or 4 bpp swizzle.
+ * This writes the same bytes as the scalar blitter the pair would get: the dst
+ * alpha (or padding) byte is cleared and filled with info->a for SET_ALPHA or 0,
+ * like BlitNtoN, except that the padding byte is left as it was (*keep) where
+ * Blit_3or4_to_3or4__same_rgb or __inversed_rgb would only write the RGB bytes.
+ */
+static void GetSwizzleShuffle(const SDL_BlitInfo *info, Uint8 shuffle[16], Uint32 *alpha, Uint32 *keep)
+{
+    const SDL_PixelFormatDetails *srcfmt = info->src_fmt;
+    const SDL_PixelFormatDetails *dstfmt = info->dst_fmt;
+    const int srcbpp = srcfmt->bytes_per_pixel;
+    const int dstbpp = dstfmt->bytes_per_pixel;
+    int p[4], alpha_channel;
+    int i, j;
+
+    get_permutation(srcfmt, dstfmt, &p[0], &p[1], &p[2], &p[3], &alpha_channel);
+
+    SDL_memset(shuffle, 0x80, 16);
+    for (i = 0; i < 4; ++i) {
+        for (j = 0; j < dstbpp; ++j) {
+            shuffle[i * dstbpp + j] = (Uint8)(i * srcbpp + p[j]);
+        }
+    }
+
+    *alpha = 0;
+    *keep = 0;
+    if (dstbpp == 4 && !(srcfmt->Amask && dstfmt->Amask)) {
+        const bool keep_padding = (srcbpp == 4 && dstfmt->Amask &&
+                                   srcfmt->Rmask == dstfmt->Rmask &&
+                                   srcfmt->Gmask == dstfmt->Gmask &&
+                                   srcfmt->Bmask == dstfmt->Bmask);
+        for (i = 0; i < 4; ++i) {
+            if (keep_padding) {
+                // Blit4to4MaskAlpha ORs the alpha into the source padding byte
+                shuffle[i * 4 + alpha_channel] = (Uint8)(i * 4 + alpha_channel);
+            } else {
+                shuffle[i * 4 + alpha_channel] = 0x80;
+            }
+        }
+        if (dstfmt->Amask) {
+            *alpha = (Uint32)info->a << (alpha_channel * 8);
+        } else if (HAVE_FAST_WRITE_INT8 && IsRGB888Triplet(srcfmt) && IsRGB888Triplet(dstfmt) &&
+                   // Those entries take 3 bpp sources, but only inversed 4 bpp ones
+                   (srcbpp == 3 || srcfmt->Rmask != dstfmt->Rmask)) {
+            *keep = (Uint32)0xFF << (alpha_channel * 8);
+        }
+    }
+}
+
+// Swizzles up to 4 pixels through temporary buffers, used for the end of each row
+static void SDL_TARGETING("sse4.1") BlitSwizzleTail(const Uint8 *src, int srcbpp, Uint8 *dst, int dstbpp, int width,
+                                                    __m128i shuffle, __m128i alpha, __m128i keep)
+{
+    while (width > 0) {
+        const int n = SDL_min(width, 4);
+        Uint8 buf[16], out[16];
+        __m128i pixels;
+
+        SDL_memcpy(buf, src, (size_t)n * srcbpp);
+        SDL_memcpy(out, dst, (size_t)n * dstbpp);
+        pixels = _mm_or_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)buf), shuffle), alpha);
+        pixels = _mm_or_si128(pixels, _mm_and_si128(_mm_loadu_si128((const __m128i *)out), keep));
+        _mm_storeu_si128((__m128i *)out, pixels);
+        SDL_memcpy(dst, out, (size_t)n * dstbpp);
+
+        src += n * srcbpp;
+        dst += n * dstbpp;
+        width -= n;
+    }
+}
+
+#endif // SDL_SSE4_1_INTRINSICS || SDL_AVX2_INTRINSICS
+
+#ifdef SDL_SSE4_1_INTRINSICS
+
+// 3 or 4 bpp -> 3 or 4 bpp with any 8-bit channel order
+static void SDL_TARGETING("sse4.1") BlitNtoNSwizzleSSE41(SDL_BlitInfo *info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip;
+    const int srcbpp = info->src_fmt->bytes_per_pixel;
+    const int dstbpp = info->dst_fmt->bytes_per_pixel;
+    const int minbpp = SDL_min(srcbpp, dstbpp);
+    // Each step loads and stores 16 bytes, so stop while that still fits in the row
+    const int min_left = (16 + minbpp - 1) / minbpp;
+    Uint8 shuffle[16];
+    Uint32 alpha, keep;
+    __m128i shuffle128, alpha128, keep128;
+
+    GetSwizzleShuffle(info, shuffle, &alpha, &keep);
+    shuffle128 = _mm_loadu_si128((const __m128i *)shuffle);
+    alpha128 = _mm_set1_epi32((int)alpha);
+    keep128 = _mm_set1_epi32((int)keep);
+
+    while (height--) {
+        int i = 0;
+
+        for (; width - i >= min_left; i += 4) {
+            __m128i pixels = _mm_loadu_si128((const __m128i *)src);
+            pixels = _mm_or_si128(_mm_shuffle_epi8(pixels, shuffle128), alpha128);
+            if (keep) {
+                pixels = _mm_or_si128(pixels, _mm_and_si128(_mm_loadu_si128((const __m128i *)dst), keep128));
+            }
+            _mm_storeu_si128((__m128i *)dst, pixels);
+            src += 4 * srcbpp;
+            dst += 4 * dstbpp;
+        }
+        BlitSwizzleTail(src, srcbpp, dst, dstbpp, width - i, shuffle128, alpha128, keep128);
+        src += (width - i) * srcbpp + srcskip;
+        dst += (width - i) * dstbpp + dstskip;
+    }
+}
+
+#if SDL_HAVE_BLIT_N_RGB565
+// RGB565 -> 8888, filling the alpha byte with 0xFF like the RGB565_*_LUT tables
+static void SDL_TARGETING("sse4.1") Blit_RGB565_8888SSE41(SDL_BlitInfo *info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip;
+    const SDL_PixelFormatDetails *dstfmt = info->dst_fmt;
+    const Uint32 fill = ~(dstfmt->Rmask | dstfmt->Gmask | dstfmt->Bmask);
+    const __m128i mask5 = _mm_set1_epi16(0x3E00);
+    const __m128i mask6 = _mm_set1_epi16(0x0FC0);
+    const __m128i scale5 = _mm_set1_epi16(RGB565_SCALE5);
+    const __m128i scale6 = _mm_set1_epi16(RGB565_SCALE6);
+    const __m128i fill128 = _mm_set1_epi16((short)0xFF00);
+    Uint8 shuffle[16];
+    __m128i shuffle128;
+
+    GetRGB565Shuffle(dstfmt, shuffle);
+    shuffle128 = _mm_loadu_si128((const __m128i *)shuffle);
+
+    while (height--) {
+        int i = 0;
+
+        for (; i + 8 <= width; i += 8) {
+            const __m128i pixels = _mm_loadu_si128((const __m128i *)src);
+            // Each channel is scaled from the top of a 16-bit lane, leaving 8 bits
+            const __m128i r = _mm_mulhi_epu16(_mm_and_si128(_mm_srli_epi16(pixels, 2), mask5), scale5);
+            const __m128i g = _mm_mulhi_epu16(_mm_and_si128(_mm_slli_epi16(pixels, 1), mask6), scale6);
+            const __m128i b = _mm_mulhi_epu16(_mm_and_si128(_mm_slli_epi16(pixels, 9), mask5), scale5);
+            const __m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+            const __m128i bf = _mm_or_si128(b, fill128);
+
+            _mm_storeu_si128((__m128i *)dst, _mm_shuffle_epi8(_mm_unpacklo_epi16(rg, bf), shuffle128));
+            _mm_storeu_si128((__m128i *)(dst + 16), _mm_shuffle_epi8(_mm_unpackhi_epi16(rg, bf), shuffle128));
+            src += 16;
+            dst += 32;
+        }
+        for (; i < width; ++i) {
+            const Uint32 pixel = *(const Uint16 *)src;
+            const Uint32 r = (pixel >> 11), g = (pixel >> 5) & 0x3F, b = pixel & 0x1F;
+            *(Uint32 *)dst = (((r * RGB565_SCALE5) >> 7) << dstfmt->Rshift) |
+                             (((g * RGB565_SCALE6) >> 10) << dstfmt->Gshift) |
+                             (((b * RGB565_SCALE5) >> 7) << dstfmt->Bshift) | fill;
+            src += 2;
+            dst += 4;
+        }
+        src += srcskip;
+        dst += dstskip;
+    }
+}
+#endif // SDL_HAVE_BLIT_N_RGB565
+
+// 8888 -> RGB565, truncating like Blit_XRGB8888_RGB565
+static void SDL_TARGETING("sse4.1") Blit_8888_RGB565SSE41(SDL_BlitInfo *info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip;
+    const SDL_PixelFormatDetails *srcfmt = info->src_fmt;
+    const __m128i rshift = _mm_cvtsi32_si128(srcfmt->Rshift + 3);
+    const __m128i gshift = _mm_cvtsi32_si128(srcfmt->Gshift + 2);
+    const __m128i bshift = _mm_cvtsi32_si128(srcfmt->Bshift + 3);
+    const __m128i mask5 = _mm_set1_epi32(0x1F);
+    const __m128i mask6 = _mm_set1_epi32(0x3F);
+
+    while (height--) {
+        int i = 0;
+
+        for (; i + 8 <= width; i += 8) {
+            __m128i p[2];
+            int k;
+
+            p[0] = _mm_loadu_si128((const __m128i *)src);
+            p[1] = _mm_loadu_si128((const __m128i *)(src + 16));
+            for (k = 0; k < 2; ++k) {
+                const __m128i r = _mm_and_si128(_mm_srl_epi32(p[k], rshift), mask5);
+                const __m128i g = _mm_and_si128(_mm_srl_epi32(p[k], gshift), mask6);
+                const __m128i b = _mm_and_si128(_mm_srl_epi32(p[k], bshift), mask5);
+                p[k] = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(r, 11), _mm_slli_epi32(g, 5)), b);
+            }
+            _mm_storeu_si128((__m128i *)dst, _mm_packus_epi32(p[0], p[1]));
+            src += 32;
+            dst += 16;
+        }
+        for (; i < width; ++i) {
+            const Uint32 pixel = *(const Uint32 *)src;
+            *(Uint16 *)dst = (Uint16)((((pixel >> (srcfmt->Rshift + 3)) & 0x1F) << 11) |
+                                      (((pixel >> (srcfmt->Gshift + 2)) & 0x3F) << 5) |
+                                      ((pixel >> (srcfmt->Bshift + 3)) & 0x1F));
+            src += 4;
+            dst += 2;
+        }
+        src += srcskip;
+        dst += dstskip;
+    }
+}
+
+#endif // SDL_SSE4_1_INTRINSICS
+
+#ifdef SDL_AVX2_INTRINSICS
+
+// 3 or 4 bpp -> 3 or 4 bpp with any 8-bit channel order, 8 pixels per step
+static void SDL_TARGETING("avx2") BlitNtoNSwizzleAVX2(SDL_BlitInfo *info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip;
+    const int srcbpp = info->src_fmt->bytes_per_pixel;
+    const int dstbpp = info->dst_fmt->bytes_per_pixel;
+    const int minbpp = SDL_min(srcbpp, dstbpp);
+    // The upper half loads and stores 16 bytes starting 4 pixels in
+    const int min_left = 4 + (16 + minbpp - 1) / minbpp;
+    Uint8 shuffle[16];
+    Uint32 alpha, keep;
+    __m128i shuffle128, alpha128, keep128;
+    __m256i shuffle256, alpha256, keep256;
+
+    GetSwizzleShuffle(info, shuffle, &alpha, &keep);
+    shuffle128 = _mm_loadu_si128((const __m128i *)shuffle);
+    alpha128 = _mm_set1_epi32((int)alpha);
+    keep128 = _mm_set1_epi32((int)keep);
+    shuffle256 = _mm256_broadcastsi128_si256(shuffle128);
+    alpha256 = _mm256_set1_epi32((int)alpha);
+    keep256 = _mm256_set1_epi32((int)keep);
+
+    while (height--) {
+        int i = 0;
+
+        if (srcbpp == 4 && dstbpp == 4) {
+            for (; i + 8 <= width; i += 8) {
+                __m256i pixels = _mm256_loadu_si256((const __m256i *)src);
+                pixels = _mm256_or_si256(_mm256_shuffle_epi8(pixels, shuffle256), alpha256);
+                if (keep) {
+                    pixels = _mm256_or_si256(pixels, _mm256_and_si256(_mm256_loadu_si256((const __m256i *)dst), keep256));
+                }
+                _mm256_storeu_si256((__m256i *)dst, pixels);
+                src += 32;
+                dst += 32;
+            }
+        } else {
+            for (; width - i >= min_left; i += 8) {
+                __m256i pixels = _mm256_inserti128_si256(
+                    _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)src)),
+                    _mm_loadu_si128((const __m128i *)(src + 4 * srcbpp)), 1);
+                pixels = _mm256_or_si256(_mm256_shuffle_epi8(pixels, shuffle256), alpha256);
+                if (keep) {
+                    // Only 4 bpp dst pixels keep a byte, so the 8 pixels are 32 contiguous bytes
+                    pixels = _mm256_or_si256(pixels, _mm256_and_si256(_mm256_loadu_si256((const __m256i *)dst), keep256));
+                }
+                _mm_storeu_si128((__m128i *)dst, _mm256_castsi256_si128(pixels));
+                _mm_storeu_si128((__m128i *)(dst + 4 * dstbpp), _mm256_extracti128_si256(pixels, 1));
+                src += 8 * srcbpp;
+                dst += 8 * dstbpp;
+            }
+        }
+        BlitSwizzleTail(src, srcbpp, dst, dstbpp, width - i, shuffle128, alpha128, keep128);
+        src += (width - i) * srcbpp + srcskip;
+        dst += (width - i) * dstbpp + dstskip;
+    }
+}
+
+#if SDL_HAVE_BLIT_N_RGB565
+// RGB565 -> 8888, filling the alpha byte with 0xFF like the RGB565_*_LUT tables
+static void SDL_TARGETING("avx2") Blit_RGB565_8888AVX2(SDL_BlitInfo *info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip;
+    const SDL_PixelFormatDetails *dstfmt = info->dst_fmt;
+    const Uint32 fill = ~(dstfmt->Rmask | dstfmt->Gmask | dstfmt->Bmask);
+    const __m256i mask5 = _mm256_set1_epi16(0x3E00);
+    const __m256i mask6 = _mm256_set1_epi16(0x0FC0);
+    const __m256i scale5 = _mm256_set1_epi16(RGB565_SCALE5);
+    const __m256i scale6 = _mm256_set1_epi16(RGB565_SCALE6);
+    const __m256i fill256 = _mm256_set1_epi16((short)0xFF00);
+    Uint8 shuffle[16];
+    __m256i shuffle256;
+
+    GetRGB565Shuffle(dstfmt, shuffle);
+    shuffle256 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)shuffle));
+
+    while (height--) {
+        int i = 0;
+
+        for (; i + 16 <= width; i += 16) {
+            const __m256i pixels = _mm256_loadu_si256((const __m256i *)src);
+            const __m256i r = _mm256_mulhi_epu16(_mm256_and_si256(_mm256_srli_epi16(pixels, 2), mask5), scale5);
+            const __m256i g = _mm256_mulhi_epu16(_mm256_and_si256(_mm256_slli_epi16(pixels, 1), mask6), scale6);
+            const __m256i b = _mm256_mulhi_epu16(_mm256_and_si256(_mm256_slli_epi16(pixels, 9), mask5), scale5);
+            const __m256i rg = _mm256_or_si256(r, _mm256_slli_epi16(g, 8));
+            const __m256i bf = _mm256_or_si256(b, fill256);
+            // The unpacks work within 128-bit lanes: lo holds pixels 0-3 and 8-11, hi 4-7 and 12-15
+            const __m256i lo = _mm256_shuffle_epi8(_mm256_unpacklo_epi16(rg, bf), shuffle256);
+            const __m256i hi = _mm256_shuffle_epi8(_mm256_unpackhi_epi16(rg, bf), shuffle256);
+
+            _mm256_storeu_si256((__m256i *)dst, _mm256_permute2x128_si256(lo, hi, 0x20));
+            _mm256_storeu_si256((__m256i *)(dst + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+            src += 32;
+            dst += 64;
+        }
+        for (; i < width; ++i) {
+            const Uint32 pixel = *(const Uint16 *)src;
+            const Uint32 r = (pixel >> 11), g = (pixel >> 5) & 0x3F, b = pixel & 0x1F;
+            *(Uint32 *)dst = (((r * RGB565_SCALE5) >> 7) << dstfmt->Rshift) |
+                             (((g * RGB565_SCALE6) >> 10) << dstfmt->Gshift) |
+                             (((b * RGB565_SCALE5) >> 7) << dstfmt->Bshift) | fill;
+            src += 2;
+            dst += 4;
+        }
+        src += srcskip;
+        dst += dstskip;
+    }
+}
+#endif // SDL_HAVE_BLIT_N_RGB565
+
+// 8888 -> RGB565, truncating like Blit_XRGB8888_RGB565
+static void SDL_TARGETING("avx2") Blit_8888_RGB565AVX2(SDL_BlitInfo *info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip;
+    const SDL_PixelFormatDetails *srcfmt = info->src_fmt;
+    const __m128i rshift = _mm_cvtsi32_si128(srcfmt->Rshift + 3);
+    const __m128i gshift = _mm_cvtsi32_si128(srcfmt->Gshift + 2);
+    const __m128i bshift = _mm_cvtsi32_si128(srcfmt->Bshift + 3);
+    const __m256i mask5 = _mm256_set1_epi32(0x1F);
+    const __m256i mask6 = _mm256_set1_epi32(0x3F);
+
+    while (height--) {
+        int i = 0;
+
+        for (; i + 16 <= width; i += 16) {
+            __m256i p[2];
+            int k;
+
+            p[0] = _mm256_loadu_si256((const __m256i *)src);
+            p[1] = _mm256_loadu_si256((const __m256i *)(src + 32));
+            for (k = 0; k < 2; ++k) {
+                const __m256i r = _mm256_and_si256(_mm256_srl_epi32(p[k], rshift), mask5);
+                const __m256i g = _mm256_and_si256(_mm256_srl_epi32(p[k], gshift), mask6);
+                const __m256i b = _mm256_and_si256(_mm256_srl_epi32(p[k], bshift), mask5);
+                p[k] = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(r, 11), _mm256_slli_epi32(g, 5)), b);
+            }
+            // packus works within 128-bit lanes, so put the quadwords back in pixel order
+            _mm256_storeu_si256((__m256i *)dst, _mm256_permute4x64_epi64(_mm256_packus_epi32(p[0], p[1]), 0xD8));
+            src += 64;
+            dst += 32;
+        }
+        for (; i < width; ++i) {
+            const Uint32 pixel = *(const Uint32 *)src;
+            *(Uint16 *)dst = (Uint16)((((pixel >> (srcfmt->Rshift + 3)) & 0x1F) << 11) |
+                                      (((pixel >> (srcfmt->Gshift + 2)) & 0x3F) << 5) |
+                                      ((pixel >> (srcfmt->Bshift + 3)) & 0x1F));
+            src += 4;
+            dst += 2;
+        }
+        src += srcskip;
+        dst += dstskip;
+    }
+}
+
+#endif // SDL_AVX2_INTRINSICS
+
 // Normal N to N optimized blitters
 #define NO_ALPHA   1
 #define SET_ALPHA  2
@@ -2830,6 +3262,14 @@ static const struct blit_table normal_blit_2[] = {
       BLIT_FEATURE_HAS_ARM_SIMD, Blit_RGB444_XRGB8888ARMSIMD, NO_ALPHA | COPY_ALPHA },
 #endif
 #if SDL_HAVE_BLIT_N_RGB565
+#ifdef SDL_AVX2_INTRINSICS
+    { 0x0000F800, 0x000007E0, 0x0000001F, 4, 0x00000000, 0x00000000, 0x00000000,
+      BLIT_FEATURE_HAS_AVX2, Blit_RGB565_8888AVX2, NO_ALPHA | COPY_ALPHA | SET_ALPHA },
+#endif
+#ifdef SDL_SSE4_1_INTRINSICS
+    { 0x0000F800, 0x000007E0, 0x0000001F, 4, 0x00000000, 0x00000000, 0x00000000,
+      BLIT_FEATURE_HAS_SSE41, Blit_RGB565_8888SSE41, NO_ALPHA | COPY_ALPHA | SET_ALPHA },
+#endif
     { 0x0000F800, 0x000007E0, 0x0000001F, 4, 0x00FF0000, 0x0000FF00, 0x000000FF,
       0, Blit_RGB565_ARGB8888, NO_ALPHA | COPY_ALPHA | SET_ALPHA },
     { 0x0000F800, 0x000007E0, 0x0000001F, 4, 0x000000FF, 0x0000FF00, 0x00FF0000,
@@ -2849,6 +3289,19 @@ static const struct blit_table normal_blit_2[] = {
 };
 
 static const struct blit_table normal_blit_3[] = {
+#ifdef SDL_AVX2_INTRINSICS
+    // 3->3 and 3->4 with any channel order
+    { 0x00000000, 0x00000000, 0x00000000, 4, 0x00000000, 0x00000000, 0x00000000,
+      BLIT_FEATURE_HAS_AVX2, BlitNtoNSwizzleAVX2, NO_ALPHA | SET_ALPHA },
+    { 0x00000000, 0x00000000, 0x00000000, 3, 0x00000000, 0x00000000, 0x00000000,
+      BLIT_FEATURE_HAS_AVX2, BlitNtoNSwizzleAVX2, NO_ALPHA },
+#endif
+#ifdef SDL_SSE4_1_INTRINSICS
+    { 0x00000000, 0x00000000, 0x00000000, 4, 0x00000000, 0x00000000, 0x00000000,
+      BLIT_FEATURE_HAS_SSE41, BlitNtoNSwizzleSSE41, NO_ALPHA | SET_ALPHA },
+    { 0x00000000, 0x00000000, 0x00000000, 3, 0x00000000, 0x00000000, 0x00000000,
+      BLIT_FEATURE_HAS_SSE41, BlitNtoNSwizzleSSE41, NO_ALPHA },
+#endif
     // 3->4 with same rgb triplet
     { 0x000000FF, 0x0000FF00, 0x00FF0000, 4, 0x000000FF, 0x0000FF00, 0x00FF0000,
       0, Blit_3or4_to_3or4__same_rgb,
@@ -2899,6 +3352,23 @@ static const struct blit_table normal_blit_4[] = {
 #ifdef SDL_ARM_SIMD_BLITTERS
     { 0x000000FF, 0x0000FF00, 0x00FF0000, 4, 0x00FF0000, 0x0000FF00, 0x000000FF,
       BLIT_FEATURE_HAS_ARM_SIMD, Blit_XBGR8888_XRGB8888ARMSIMD, NO_ALPHA | COPY_ALPHA },
+#endif
+#ifdef SDL_AVX2_INTRINSICS
+    // 4->3 and 4->4 with any channel order, 4->RGB565
+    { 0x00000000, 0x00000000, 0x00000000, 4, 0x00000000, 0x00000000, 0x00000000,
+      BLIT_FEATURE_HAS_AVX2, BlitNtoNSwizzleAVX2, NO_ALPHA | COPY_ALPHA | SET_ALPHA },
+    { 0x00000000, 0x00000000, 0x00000000, 3, 0x00000000, 0x00000000, 0x00000000,
+      BLIT_FEATURE_HAS_AVX2, BlitNtoNSwizzleAVX2, NO_ALPHA },
+    { 0x00000000, 0x00000000, 0x00000000, 2, 0x0000F800, 0x000007E0, 0x0000001F,
+      BLIT_FEATURE_HAS_AVX2, Blit_8888_RGB565AVX2, NO_ALPHA },
+#endif
+#ifdef SDL_SSE4_1_INTRINSICS
+    { 0x00000000, 0x00000000, 0x00000000, 4, 0x00000000, 0x00000000, 0x00000000,
+      BLIT_FEATURE_HAS_SSE41, BlitNtoNSwizzleSSE41, NO_ALPHA | COPY_ALPHA | SET_ALPHA },
+    { 0x00000000, 0x00000000, 0x00000000, 3, 0x00000000, 0x00000000, 0x00000000,
+      BLIT_FEATURE_HAS_SSE41, BlitNtoNSwizzleSSE41, NO_ALPHA },
+    { 0x00000000, 0x00000000, 0x00000000, 2, 0x0000F800, 0x000007E0, 0x0000001F,
+      BLIT_FEATURE_HAS_SSE41, Blit_8888_RGB565SSE41, NO_ALPHA },
 #endif
     // 4->3 with same rgb triplet
     { 0x000000FF, 0x0000FF00, 0x00FF0000, 3, 0x000000FF, 0x0000FF00, 0x00FF0000,
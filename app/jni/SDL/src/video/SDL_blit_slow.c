@@ -802,6 +802,727 @@ static void ApplyTonemap(SDL_TonemapContext *ctx, float *r, float *g, float *b)
     }
 }
 
+/* Table driven conversion for the common layouts handled by SDL_Blit_Slow_Float
+ *
+ * Packed sources are decoded through a table indexed by the channel value and float
+ * sources through an interpolated table over [0,1]. The destination transfer function
+ * is looked up by the exponent and top mantissa bits of the linear value, which keeps
+ * the relative error flat over the whole HDR range. The tables only depend on the
+ * formats, colorspaces and SDR white points, so they're cached on the blit map and
+ * the tonemap and color primaries are applied to rows of planar floats in between.
+ */
+#define FLOAT_LUT_CHUNK             256
+#define FLOAT_LUT_CURVE_SIZE        4096
+#define FLOAT_LUT_ENCODE_MIN_EXP    (-24)
+#define FLOAT_LUT_ENCODE_MAX_EXP    12
+#define FLOAT_LUT_ENCODE_BITS       5
+#define FLOAT_LUT_ENCODE_SIZE       (((FLOAT_LUT_ENCODE_MAX_EXP - FLOAT_LUT_ENCODE_MIN_EXP) << FLOAT_LUT_ENCODE_BITS) + 1)
+
+typedef enum
+{
+    FloatLUTLayout_Unsupported,
+    FloatLUTLayout_Packed8,
+    FloatLUTLayout_Packed10,
+    FloatLUTLayout_ArrayU16,
+    FloatLUTLayout_ArrayF16,
+    FloatLUTLayout_ArrayF32
+} FloatLUTLayout;
+
+typedef struct
+{
+    FloatLUTLayout layout;
+    int bpp;
+    int channel[4]; // RGBA bit shift for packed layouts or element index for arrays, -1 if missing
+} FloatLUTFormat;
+
+typedef struct
+{
+    FloatLUTFormat fmt;
+    SDL_TransferCharacteristics transfer;
+    float SDR_white_point;
+    float scale;
+    bool use_curve;
+    float table[1024];
+    float curve[FLOAT_LUT_CURVE_SIZE + 2];
+} FloatLUTDecoder;
+
+struct SDL_BlitFloatLUT
+{
+    SDL_PixelFormat src_format;
+    SDL_PixelFormat dst_format;
+    SDL_Colorspace src_colorspace;
+    SDL_Colorspace dst_colorspace;
+    float src_white_point;
+    float dst_white_point;
+    FloatLUTDecoder src;
+    FloatLUTDecoder dst;
+    bool use_encode_table;
+    float encode_scale;
+    float encode_min;
+    float encode_max;
+    float encode_zero;
+    float encode[FLOAT_LUT_ENCODE_SIZE + 1];
+};
+
+typedef struct
+{
+    bool tonemap_chrome;
+    float tonemap_a;
+    float tonemap_b;
+    const float *tonemap_matrix;
+    bool use_matrix;
+    float matrix[9]; // color primaries, linear tonemap and color modulation combined
+    bool modulate_alpha;
+    float alpha_scale;
+} FloatLUTTransform;
+
+static float FloatLUT_ToLinear(SDL_TransferCharacteristics transfer, float SDR_white_point, float v)
+{
+    switch (transfer) {
+    case SDL_TRANSFER_CHARACTERISTICS_SRGB:
+        return SDL_sRGBtoLinear(v);
+    case SDL_TRANSFER_CHARACTERISTICS_PQ:
+        return SDL_PQtoNits(v) / SDR_white_point;
+    case SDL_TRANSFER_CHARACTERISTICS_LINEAR:
+        return v / SDR_white_point;
+    default:
+        return v;
+    }
+}
+
+static float FloatLUT_FromLinear(SDL_TransferCharacteristics transfer, float SDR_white_point, float v)
+{
+    switch (transfer) {
+    case SDL_TRANSFER_CHARACTERISTICS_SRGB:
+        return SDL_sRGBfromLinear(v);
+    case SDL_TRANSFER_CHARACTERISTICS_PQ:
+        return SDL_PQfromNits(v * SDR_white_point);
+    case SDL_TRANSFER_CHARACTERISTICS_LINEAR:
+        return v * SDR_white_point;
+    default:
+        return v;
+    }
+}
+
+static bool FloatLUT_GetFormat(const SDL_PixelFormatDetails *fmt, FloatLUTFormat *lut_fmt)
+{
+    const SDL_PixelFormat format = fmt->format;
+
+    SDL_zerop(lut_fmt);
+    lut_fmt->bpp = fmt->bytes_per_pixel;
+
+    if (SDL_ISPIXELFORMAT_FOURCC(format) || SDL_ISPIXELFORMAT_INDEXED(format)) {
+        return false;
+    }
+
+    if (SDL_ISPIXELFORMAT_PACKED(format)) {
+        if (fmt->bytes_per_pixel != 4 || fmt->Rbits != fmt->Gbits || fmt->Rbits != fmt->Bbits) {
+            return false;
+        }
+        if (fmt->Rbits == 8 && (fmt->Abits == 0 || fmt->Abits == 8)) {
+            lut_fmt->layout = FloatLUTLayout_Packed8;
+        } else if (SDL_ISPIXELFORMAT_10BIT(format) && (fmt->Abits == 0 || fmt->Abits == 2)) {
+            lut_fmt->layout = FloatLUTLayout_Packed10;
+        } else {
+            return false;
+        }
+        lut_fmt->channel[0] = fmt->Rshift;
+        lut_fmt->channel[1] = fmt->Gshift;
+        lut_fmt->channel[2] = fmt->Bshift;
+        lut_fmt->channel[3] = fmt->Abits ? fmt->Ashift : -1;
+        return true;
+    }
+
+    if (SDL_ISPIXELFORMAT_ARRAY(format)) {
+        switch (SDL_PIXELTYPE(format)) {
+        case SDL_PIXELTYPE_ARRAYU16:
+            lut_fmt->layout = FloatLUTLayout_ArrayU16;
+            break;
+        case SDL_PIXELTYPE_ARRAYF16:
+            lut_fmt->layout = FloatLUTLayout_ArrayF16;
+            break;
+        case SDL_PIXELTYPE_ARRAYF32:
+            lut_fmt->layout = FloatLUTLayout_ArrayF32;
+            break;
+        default:
+            return false;
+        }
+        switch (SDL_PIXELORDER(format)) {
+        case SDL_ARRAYORDER_RGB:
+            lut_fmt->channel[0] = 0;
+            lut_fmt->channel[1] = 1;
+            lut_fmt->channel[2] = 2;
+            lut_fmt->channel[3] = -1;
+            break;
+        case SDL_ARRAYORDER_RGBA:
+            lut_fmt->channel[0] = 0;
+            lut_fmt->channel[1] = 1;
+            lut_fmt->channel[2] = 2;
+            lut_fmt->channel[3] = 3;
+            break;
+        case SDL_ARRAYORDER_ARGB:
+            lut_fmt->channel[0] = 1;
+            lut_fmt->channel[1] = 2;
+            lut_fmt->channel[2] = 3;
+            lut_fmt->channel[3] = 0;
+            break;
+        case SDL_ARRAYORDER_BGR:
+            lut_fmt->channel[0] = 2;
+            lut_fmt->channel[1] = 1;
+            lut_fmt->channel[2] = 0;
+            lut_fmt->channel[3] = -1;
+            break;
+        case SDL_ARRAYORDER_BGRA:
+            lut_fmt->channel[0] = 2;
+            lut_fmt->channel[1] = 1;
+            lut_fmt->channel[2] = 0;
+            lut_fmt->channel[3] = 3;
+            break;
+        case SDL_ARRAYORDER_ABGR:
+            lut_fmt->channel[0] = 3;
+            lut_fmt->channel[1] = 2;
+            lut_fmt->channel[2] = 1;
+            lut_fmt->channel[3] = 0;
+            break;
+        default:
+            lut_fmt->layout = FloatLUTLayout_Unsupported;
+            return false;
+        }
+        return true;
+    }
+    return false;
+}
+
+static void FloatLUT_InitDecoder(FloatLUTDecoder *dec, const FloatLUTFormat *fmt, SDL_Colorspace colorspace, float SDR_white_point)
+{
+    int i;
+
+    dec->fmt = *fmt;
+    dec->transfer = SDL_COLORSPACETRANSFER(colorspace);
+    dec->SDR_white_point = SDR_white_point;
+    dec->scale = 1.0f;
+    dec->use_curve = false;
+
+    switch (fmt->layout) {
+    case FloatLUTLayout_Packed8:
+        for (i = 0; i < 256; ++i) {
+            dec->table[i] = FloatLUT_ToLinear(dec->transfer, SDR_white_point, (float)i / 255.0f);
+        }
+        break;
+    case FloatLUTLayout_Packed10:
+        for (i = 0; i < 1024; ++i) {
+            dec->table[i] = FloatLUT_ToLinear(dec->transfer, SDR_white_point, (float)i / 1023.0f);
+        }
+        break;
+    default:
+        if (dec->transfer == SDL_TRANSFER_CHARACTERISTICS_SRGB ||
+            dec->transfer == SDL_TRANSFER_CHARACTERISTICS_PQ) {
+            for (i = 0; i <= FLOAT_LUT_CURVE_SIZE; ++i) {
+                dec->curve[i] = FloatLUT_ToLinear(dec->transfer, SDR_white_point, (float)i / FLOAT_LUT_CURVE_SIZE);
+            }
+            dec->curve[FLOAT_LUT_CURVE_SIZE + 1] = dec->curve[FLOAT_LUT_CURVE_SIZE];
+            dec->use_curve = true;
+        } else if (dec->transfer == SDL_TRANSFER_CHARACTERISTICS_LINEAR) {
+            dec->scale = 1.0f / SDR_white_point;
+        }
+        break;
+    }
+}
+
+static void FloatLUT_InitEncoder(SDL_BlitFloatLUT *lut, SDL_Colorspace colorspace, float SDR_white_point)
+{
+    const SDL_TransferCharacteristics transfer = SDL_COLORSPACETRANSFER(colorspace);
+    const int mask = (1 << FLOAT_LUT_ENCODE_BITS) - 1;
+    int i;
+
+    lut->use_encode_table = false;
+    lut->encode_scale = 1.0f;
+    lut->encode_min = SDL_scalbnf(1.0f, FLOAT_LUT_ENCODE_MIN_EXP);
+    lut->encode_max = SDL_scalbnf(1.0f, FLOAT_LUT_ENCODE_MAX_EXP);
+
+    switch (transfer) {
+    case SDL_TRANSFER_CHARACTERISTICS_SRGB:
+    case SDL_TRANSFER_CHARACTERISTICS_PQ:
+        for (i = 0; i < FLOAT_LUT_ENCODE_SIZE; ++i) {
+            const float mantissa = 1.0f + (float)(i & mask) / (mask + 1);
+            const float v = SDL_scalbnf(mantissa, FLOAT_LUT_ENCODE_MIN_EXP + (i >> FLOAT_LUT_ENCODE_BITS));
+            lut->encode[i] = FloatLUT_FromLinear(transfer, SDR_white_point, v);
+        }
+        lut->encode[FLOAT_LUT_ENCODE_SIZE] = lut->encode[FLOAT_LUT_ENCODE_SIZE - 1];
+        lut->encode_zero = FloatLUT_FromLinear(transfer, SDR_white_point, 0.0f);
+        lut->use_encode_table = true;
+        break;
+    case SDL_TRANSFER_CHARACTERISTICS_LINEAR:
+        lut->encode_scale = SDR_white_point;
+        break;
+    default:
+        break;
+    }
+}
+
+static bool FloatLUT_Update(SDL_BlitInfo *info, SDL_Colorspace src_colorspace, SDL_Colorspace dst_colorspace, float src_white_point, float dst_white_point)
+{
+    SDL_BlitFloatLUT *lut = info->float_lut;
+    FloatLUTFormat src_fmt, dst_fmt;
+
+    if (lut &&
+        lut->src_format == info->src_fmt->format &&
+        lut->dst_format == info->dst_fmt->format &&
+        lut->src_colorspace == src_colorspace &&
+        lut->dst_colorspace == dst_colorspace &&
+        lut->src_white_point == src_white_point &&
+        lut->dst_white_point == dst_white_point) {
+        return true;
+    }
+
+    if (!FloatLUT_GetFormat(info->src_fmt, &src_fmt) ||
+        !FloatLUT_GetFormat(info->dst_fmt, &dst_fmt)) {
+        return false;
+    }
+
+    // Float sRGB output isn't clamped, so out of range values need the exact curve
+    if (SDL_COLORSPACETRANSFER(dst_colorspace) == SDL_TRANSFER_CHARACTERISTICS_SRGB &&
+        (dst_fmt.layout == FloatLUTLayout_ArrayF16 || dst_fmt.layout == FloatLUTLayout_ArrayF32)) {
+        return false;
+    }
+
+    if (!lut) {
+        lut = (SDL_BlitFloatLUT *)SDL_malloc(sizeof(*lut));
+        if (!lut) {
+            return false;
+        }
+        info->float_lut = lut;
+    }
+    lut->src_format = info->src_fmt->format;
+    lut->dst_format = info->dst_fmt->format;
+    lut->src_colorspace = src_colorspace;
+    lut->dst_colorspace = dst_colorspace;
+    lut->src_white_point = src_white_point;
+    lut->dst_white_point = dst_white_point;
+    FloatLUT_InitDecoder(&lut->src, &src_fmt, src_colorspace, src_white_point);
+    FloatLUT_InitDecoder(&lut->dst, &dst_fmt, dst_colorspace, dst_white_point);
+    FloatLUT_InitEncoder(lut, dst_colorspace, dst_white_point);
+    return true;
+}
+
+static void FloatLUT_ToLinearRow(const FloatLUTDecoder *dec, float *v, int n)
+{
+    int i;
+
+    if (dec->use_curve) {
+        for (i = 0; i < n; ++i) {
+            const float x = v[i];
+            if (x >= 0.0f && x <= 1.0f) {
+                const float f = x * FLOAT_LUT_CURVE_SIZE;
+                const int index = (int)f;
+                v[i] = dec->curve[index] + (dec->curve[index + 1] - dec->curve[index]) * (f - (float)index);
+            } else {
+                v[i] = FloatLUT_ToLinear(dec->transfer, dec->SDR_white_point, x);
+            }
+        }
+    } else if (dec->scale != 1.0f) {
+        for (i = 0; i < n; ++i) {
+            v[i] *= dec->scale;
+        }
+    }
+}
+
+static void FloatLUT_FromLinearRow(const SDL_BlitFloatLUT *lut, float *v, int n)
+{
+    int i;
+
+    if (lut->use_encode_table) {
+        const float encode_min = lut->encode_min;
+        const float encode_max = lut->encode_max;
+        const float oo_encode_min = 1.0f / encode_min;
+        const Uint32 bias = (Uint32)(127 + FLOAT_LUT_ENCODE_MIN_EXP) << 23;
+        const int frac_bits = 23 - FLOAT_LUT_ENCODE_BITS;
+
+        for (i = 0; i < n; ++i) {
+            const float x = v[i];
+            if (x >= encode_max) {
+                v[i] = lut->encode[FLOAT_LUT_ENCODE_SIZE - 1];
+            } else if (x >= encode_min) {
+                Uint32 bits;
+                Uint32 index;
+                float frac;
+
+                SDL_memcpy(&bits, &x, sizeof(bits));
+                bits -= bias;
+                index = bits >> frac_bits;
+                frac = (float)(bits & ((1u << frac_bits) - 1)) * (1.0f / (float)(1u << frac_bits));
+                v[i] = lut->encode[index] + (lut->encode[index + 1] - lut->encode[index]) * frac;
+            } else if (x > 0.0f) {
+                v[i] = lut->encode_zero + (lut->encode[0] - lut->encode_zero) * (x * oo_encode_min);
+            } else {
+                v[i] = lut->encode_zero;
+            }
+        }
+    } else if (lut->encode_scale != 1.0f) {
+        for (i = 0; i < n; ++i) {
+            v[i] *= lut->encode_scale;
+        }
+    }
+}
+
+static void FloatLUT_ReadRow(const FloatLUTDecoder *dec, const Uint8 *row, Uint64 posx, Uint64 incx, int n,
+                             float *R, float *G, float *B, float *A)
+{
+    const int bpp = dec->fmt.bpp;
+    const int rc = dec->fmt.channel[0];
+    const int gc = dec->fmt.channel[1];
+    const int bc = dec->fmt.channel[2];
+    const int ac = dec->fmt.channel[3];
+    int i;
+
+    switch (dec->fmt.layout) {
+    case FloatLUTLayout_Packed8:
+    case FloatLUTLayout_Packed10:
+    {
+        const bool packed8 = (dec->fmt.layout == FloatLUTLayout_Packed8);
+        const Uint32 mask = packed8 ? 0xFF : 0x3FF;
+        const Uint32 amask = packed8 ? 0xFF : 0x3;
+        const float ascale = packed8 ? (1.0f / 255.0f) : (1.0f / 3.0f);
+
+        for (i = 0; i < n; ++i, posx += incx) {
+            const Uint32 pixel = *(const Uint32 *)(row + (posx >> 16) * 4);
+            R[i] = dec->table[(pixel >> rc) & mask];
+            G[i] = dec->table[(pixel >> gc) & mask];
+            B[i] = dec->table[(pixel >> bc) & mask];
+            A[i] = (ac >= 0) ? (float)((pixel >> ac) & amask) * ascale : 1.0f;
+        }
+        return;
+    }
+    case FloatLUTLayout_ArrayU16:
+        for (i = 0; i < n; ++i, posx += incx) {
+            const Uint16 *p = (const Uint16 *)(row + (posx >> 16) * bpp);
+            R[i] = (float)p[rc] / SDL_MAX_UINT16;
+            G[i] = (float)p[gc] / SDL_MAX_UINT16;
+            B[i] = (float)p[bc] / SDL_MAX_UINT16;
+            A[i] = (ac >= 0) ? (float)p[ac] / SDL_MAX_UINT16 : 1.0f;
+        }
+        break;
+    case FloatLUTLayout_ArrayF16:
+        for (i = 0; i < n; ++i, posx += incx) {
+            const Uint16 *p = (const Uint16 *)(row + (posx >> 16) * bpp);
+            R[i] = half_to_float(p[rc]);
+            G[i] = half_to_float(p[gc]);
+            B[i] = half_to_float(p[bc]);
+            A[i] = (ac >= 0) ? half_to_float(p[ac]) : 1.0f;
+        }
+        break;
+    case FloatLUTLayout_ArrayF32:
+        for (i = 0; i < n; ++i, posx += incx) {
+            const float *p = (const float *)(row + (posx >> 16) * bpp);
+            R[i] = p[rc];
+            G[i] = p[gc];
+            B[i] = p[bc];
+            A[i] = (ac >= 0) ? p[ac] : 1.0f;
+        }
+        break;
+    default:
+        // This should never happen, checked in FloatLUT_GetFormat()
+        SDL_assert(0);
+        return;
+    }
+
+    FloatLUT_ToLinearRow(dec, R, n);
+    FloatLUT_ToLinearRow(dec, G, n);
+    FloatLUT_ToLinearRow(dec, B, n);
+}
+
+static void FloatLUT_WriteRow(const SDL_BlitFloatLUT *lut, Uint8 *row, int n, float *R, float *G, float *B, const float *A)
+{
+    const FloatLUTFormat *fmt = &lut->dst.fmt;
+    const int bpp = fmt->bpp;
+    const int rc = fmt->channel[0];
+    const int gc = fmt->channel[1];
+    const int bc = fmt->channel[2];
+    const int ac = fmt->channel[3];
+    int i;
+
+    FloatLUT_FromLinearRow(lut, R, n);
+    FloatLUT_FromLinearRow(lut, G, n);
+    FloatLUT_FromLinearRow(lut, B, n);
+
+    switch (fmt->layout) {
+    case FloatLUTLayout_Packed8:
+        for (i = 0; i < n; ++i) {
+            Uint32 pixel = ((Uint32)(SDL_clamp(R[i], 0.0f, 1.0f) * 255.0f + 0.5f) << rc) |
+                           ((Uint32)(SDL_clamp(G[i], 0.0f, 1.0f) * 255.0f + 0.5f) << gc) |
+                           ((Uint32)(SDL_clamp(B[i], 0.0f, 1.0f) * 255.0f + 0.5f) << bc);
+            if (ac >= 0) {
+                pixel |= (Uint32)(SDL_clamp(A[i], 0.0f, 1.0f) * 255.0f + 0.5f) << ac;
+            }
+            ((Uint32 *)row)[i] = pixel;
+        }
+        break;
+    case FloatLUTLayout_Packed10:
+        for (i = 0; i < n; ++i) {
+            Uint32 pixel = ((Uint32)(SDL_clamp(R[i], 0.0f, 1.0f) * 1023.0f + 0.5f) << rc) |
+                           ((Uint32)(SDL_clamp(G[i], 0.0f, 1.0f) * 1023.0f + 0.5f) << gc) |
+                           ((Uint32)(SDL_clamp(B[i], 0.0f, 1.0f) * 1023.0f + 0.5f) << bc);
+            if (ac >= 0) {
+                pixel |= (Uint32)(SDL_clamp(A[i], 0.0f, 1.0f) * 3.0f + 0.5f) << ac;
+            } else {
+                // Opaque, the same as the slow path writes for the X formats
+                pixel |= 0xC0000000;
+            }
+            ((Uint32 *)row)[i] = pixel;
+        }
+        break;
+    case FloatLUTLayout_ArrayU16:
+        for (i = 0; i < n; ++i, row += bpp) {
+            Uint16 *p = (Uint16 *)row;
+            p[rc] = (Uint16)(SDL_clamp(R[i], 0.0f, 1.0f) * SDL_MAX_UINT16 + 0.5f);
+            p[gc] = (Uint16)(SDL_clamp(G[i], 0.0f, 1.0f) * SDL_MAX_UINT16 + 0.5f);
+            p[bc] = (Uint16)(SDL_clamp(B[i], 0.0f, 1.0f) * SDL_MAX_UINT16 + 0.5f);
+            if (ac >= 0) {
+                p[ac] = (Uint16)(SDL_clamp(A[i], 0.0f, 1.0f) * SDL_MAX_UINT16 + 0.5f);
+            }
+        }
+        break;
+    case FloatLUTLayout_ArrayF16:
+        for (i = 0; i < n; ++i, row += bpp) {
+            Uint16 *p = (Uint16 *)row;
+            p[rc] = float_to_half(R[i]);
+            p[gc] = float_to_half(G[i]);
+            p[bc] = float_to_half(B[i]);
+            if (ac >= 0) {
+                p[ac] = float_to_half(A[i]);
+            }
+        }
+        break;
+    case FloatLUTLayout_ArrayF32:
+        for (i = 0; i < n; ++i, row += bpp) {
+            float *p = (float *)row;
+            p[rc] = R[i];
+            p[gc] = G[i];
+            p[bc] = B[i];
+            if (ac >= 0) {
+                p[ac] = A[i];
+            }
+        }
+        break;
+    default:
+        // This should never happen, checked in FloatLUT_GetFormat()
+        SDL_assert(0);
+        break;
+    }
+}
+
+static void FloatLUT_TransformRow(const FloatLUTTransform *xform, float *R, float *G, float *B, float *A, int n)
+{
+    int i;
+
+    for (i = 0; i < n; ++i) {
+        float r = R[i];
+        float g = G[i];
+        float b = B[i];
+
+        if (xform->tonemap_chrome) {
+            float vmax;
+
+            if (xform->tonemap_matrix) {
+                SDL_ConvertColorPrimaries(&r, &g, &b, xform->tonemap_matrix);
+            }
+            vmax = SDL_max(r, SDL_max(g, b));
+            if (vmax > 0.0f) {
+                const float scale = (1.0f + xform->tonemap_a * vmax) / (1.0f + xform->tonemap_b * vmax);
+                r *= scale;
+                g *= scale;
+                b *= scale;
+            }
+        }
+        if (xform->use_matrix) {
+            SDL_ConvertColorPrimaries(&r, &g, &b, xform->matrix);
+        }
+        R[i] = r;
+        G[i] = g;
+        B[i] = b;
+    }
+    if (xform->modulate_alpha) {
+        for (i = 0; i < n; ++i) {
+            A[i] *= xform->alpha_scale;
+        }
+    }
+}
+
+#ifdef SDL_SSE_INTRINSICS
+static SDL_INLINE void SDL_TARGETING("sse") FloatLUT_MatrixSSE(const float *m, __m128 *r, __m128 *g, __m128 *b)
+{
+    const __m128 v0 = *r;
+    const __m128 v1 = *g;
+    const __m128 v2 = *b;
+
+    *r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[0]), v0), _mm_mul_ps(_mm_set1_ps(m[1]), v1)), _mm_mul_ps(_mm_set1_ps(m[2]), v2));
+    *g = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[3]), v0), _mm_mul_ps(_mm_set1_ps(m[4]), v1)), _mm_mul_ps(_mm_set1_ps(m[5]), v2));
+    *b = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[6]), v0), _mm_mul_ps(_mm_set1_ps(m[7]), v1)), _mm_mul_ps(_mm_set1_ps(m[8]), v2));
+}
+
+static void SDL_TARGETING("sse") FloatLUT_TransformRowSSE(const FloatLUTTransform *xform, float *R, float *G, float *B, float *A, int n)
+{
+    const __m128 tonemap_a = _mm_set1_ps(xform->tonemap_a);
+    const __m128 tonemap_b = _mm_set1_ps(xform->tonemap_b);
+    const __m128 alpha_scale = _mm_set1_ps(xform->alpha_scale);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    int i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        __m128 r = _mm_loadu_ps(&R[i]);
+        __m128 g = _mm_loadu_ps(&G[i]);
+        __m128 b = _mm_loadu_ps(&B[i]);
+
+        if (xform->tonemap_chrome) {
+            __m128 vmax, scale, mask;
+
+            if (xform->tonemap_matrix) {
+                FloatLUT_MatrixSSE(xform->tonemap_matrix, &r, &g, &b);
+            }
+            vmax = _mm_max_ps(r, _mm_max_ps(g, b));
+            scale = _mm_div_ps(_mm_add_ps(one, _mm_mul_ps(tonemap_a, vmax)),
+                               _mm_add_ps(one, _mm_mul_ps(tonemap_b, vmax)));
+            mask = _mm_cmpgt_ps(vmax, zero);
+            scale = _mm_or_ps(_mm_and_ps(mask, scale), _mm_andnot_ps(mask, one));
+            r = _mm_mul_ps(r, scale);
+            g = _mm_mul_ps(g, scale);
+            b = _mm_mul_ps(b, scale);
+        }
+        if (xform->use_matrix) {
+            FloatLUT_MatrixSSE(xform->matrix, &r, &g, &b);
+        }
+        _mm_storeu_ps(&R[i], r);
+        _mm_storeu_ps(&G[i], g);
+        _mm_storeu_ps(&B[i], b);
+        if (xform->modulate_alpha) {
+            _mm_storeu_ps(&A[i], _mm_mul_ps(_mm_loadu_ps(&A[i]), alpha_scale));
+        }
+    }
+    if (i < n) {
+        FloatLUT_TransformRow(xform, &R[i], &G[i], &B[i], &A[i], n - i);
+    }
+}
+#endif // SDL_SSE_INTRINSICS
+
+static void FloatLUT_BlendRow(float *sR, float *sG, float *sB, const float *sA, float *dR, float *dG, float *dB, float *dA, int n)
+{
+    int i;
+
+    for (i = 0; i < n; ++i) {
+        const float a = sA[i];
+        const float inv_a = 1.0f - a;
+        float r = sR[i];
+        float g = sG[i];
+        float b = sB[i];
+
+        if (a < 1.0f) {
+            r *= a;
+            g *= a;
+            b *= a;
+        }
+        dR[i] = r + inv_a * dR[i];
+        dG[i] = g + inv_a * dG[i];
+        dB[i] = b + inv_a * dB[i];
+        dA[i] = a + inv_a * dA[i];
+    }
+}
+
+/* Runs the blit through the cached tables if the formats and blend mode are supported.
+ * This matches SDL_Blit_Slow_Float within rounding of the table interpolation.
+ */
+static bool SDL_Blit_Float_LUT(SDL_BlitInfo *info, SDL_Colorspace src_colorspace, SDL_Colorspace dst_colorspace,
+                               float src_white_point, float dst_white_point,
+                               const SDL_TonemapContext *tonemap, const float *color_primaries_matrix)
+{
+    const int flags = info->flags;
+    const SDL_BlitFloatLUT *lut;
+    FloatLUTTransform xform;
+    void (*TransformRow)(const FloatLUTTransform *, float *, float *, float *, float *, int) = FloatLUT_TransformRow;
+    float modulate[3] = { 1.0f, 1.0f, 1.0f };
+    float tonemap_scale = 1.0f;
+    float sR[FLOAT_LUT_CHUNK], sG[FLOAT_LUT_CHUNK], sB[FLOAT_LUT_CHUNK], sA[FLOAT_LUT_CHUNK];
+    float dR[FLOAT_LUT_CHUNK], dG[FLOAT_LUT_CHUNK], dB[FLOAT_LUT_CHUNK], dA[FLOAT_LUT_CHUNK];
+    Uint64 posy, incy, incx;
+    int dst_bpp;
+    int y, i, j;
+
+    if (flags & (SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL)) {
+        return false;
+    }
+    if (!FloatLUT_Update(info, src_colorspace, dst_colorspace, src_white_point, dst_white_point)) {
+        return false;
+    }
+    lut = info->float_lut;
+    dst_bpp = lut->dst.fmt.bpp;
+
+    SDL_zero(xform);
+    if (tonemap->op == SDL_TONEMAP_LINEAR) {
+        tonemap_scale = tonemap->data.linear.scale;
+    } else if (tonemap->op == SDL_TONEMAP_CHROME) {
+        xform.tonemap_chrome = true;
+        xform.tonemap_a = tonemap->data.chrome.a;
+        xform.tonemap_b = tonemap->data.chrome.b;
+        xform.tonemap_matrix = tonemap->data.chrome.color_primaries_matrix;
+    }
+    if (flags & SDL_COPY_MODULATE_COLOR) {
+        modulate[0] = (float)info->r / 255.0f;
+        modulate[1] = (float)info->g / 255.0f;
+        modulate[2] = (float)info->b / 255.0f;
+    }
+    if (flags & SDL_COPY_MODULATE_ALPHA) {
+        xform.modulate_alpha = true;
+        xform.alpha_scale = (float)info->a / 255.0f;
+    }
+    for (i = 0; i < 3; ++i) {
+        for (j = 0; j < 3; ++j) {
+            float m = color_primaries_matrix ? color_primaries_matrix[i * 3 + j] : (i == j ? 1.0f : 0.0f);
+            xform.matrix[i * 3 + j] = m * tonemap_scale * modulate[i];
+        }
+    }
+    xform.use_matrix = (color_primaries_matrix || tonemap_scale != 1.0f ||
+                        modulate[0] != 1.0f || modulate[1] != 1.0f || modulate[2] != 1.0f);
+
+#ifdef SDL_SSE_INTRINSICS
+    if (SDL_HasSSE()) {
+        TransformRow = FloatLUT_TransformRowSSE;
+    }
+#endif
+
+    incy = ((Uint64)info->src_h << 16) / info->dst_h;
+    incx = ((Uint64)info->src_w << 16) / info->dst_w;
+    posy = incy / 2; // start at the middle of pixel
+
+    for (y = 0; y < info->dst_h; ++y) {
+        const Uint8 *src = info->src + (posy >> 16) * info->src_pitch;
+        Uint8 *dst = info->dst + (size_t)y * info->dst_pitch;
+        Uint64 posx = incx / 2; // start at the middle of pixel
+        int x, n;
+
+        for (x = 0; x < info->dst_w; x += n) {
+            n = SDL_min(info->dst_w - x, FLOAT_LUT_CHUNK);
+
+            FloatLUT_ReadRow(&lut->src, src, posx, incx, n, sR, sG, sB, sA);
+            posx += incx * n;
+
+            if (xform.tonemap_chrome || xform.use_matrix || xform.modulate_alpha) {
+                TransformRow(&xform, sR, sG, sB, sA, n);
+            }
+
+            if (flags & SDL_COPY_BLEND) {
+                FloatLUT_ReadRow(&lut->dst, dst, 0, (Uint64)1 << 16, n, dR, dG, dB, dA);
+                FloatLUT_BlendRow(sR, sG, sB, sA, dR, dG, dB, dA, n);
+                FloatLUT_WriteRow(lut, dst, n, dR, dG, dB, dA);
+            } else {
+                FloatLUT_WriteRow(lut, dst, n, sR, sG, sB, sA);
+            }
+            dst += n * dst_bpp;
+        }
+        posy += incy;
+    }
+    return true;
+}
+
 /* The SECOND TRUE BLITTER
  * This one is even slower than the first, but also handles large pixel formats and colorspace conversion
  */
@@ -886,6 +1607,10 @@ void SDL_Blit_Slow_Float(SDL_BlitInfo *info)
         color_primaries_matrix = SDL_GetColorPrimariesConversionMatrix(src_primaries, dst_primaries);
     }
 
+    if (SDL_Blit_Float_LUT(info, src_colorspace, dst_colorspace, src_white_point, dst_white_point, &tonemap, color_primaries_matrix)) {
+        return;
+    }
+
     src_access = GetPixelAccessMethod(src_fmt->format);
     dst_access = GetPixelAccessMethod(dst_fmt->format);
     if (dst_access == SlowBlitPixelAccess_Index8) {
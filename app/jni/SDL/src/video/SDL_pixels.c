@@ -1452,6 +1452,7 @@ void SDL_InvalidateMap(SDL_BlitMap *map)
         SDL_DestroyHashTable(map->info.palette_map);
         map->info.palette_map = NULL;
     }
+    // The float_lut is kept, it's checked against the blit parameters before use
 }
 
 bool SDL_MapSurface(SDL_Surface *src, SDL_Surface *dst)
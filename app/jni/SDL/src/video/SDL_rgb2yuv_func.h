@@ -0,0 +1,309 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2024 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/* SIMD RGB to YUV conversion, included by SDL_yuv.c once per instruction set.
+
+   You need to define the following macros before including this file:
+    RGB2YUV_FUNCTION_NAME
+    RGB2YUV_TARGET       the SDL_TARGETING() string
+    RGB2YUV_256          1 for 8 pixels per vector with AVX2, 0 for 4 pixels per vector with SSE4.1
+
+   The arithmetic is the same single precision math, in the same order, as
+   SDL_ConvertPixels_ARGB8888_to_YUV_Rows(), so the output is identical.
+*/
+
+#if RGB2YUV_256
+#define VI                  __m256i
+#define VF                  __m256
+#define V_PIXELS            8
+#define V_LOAD_RGB(p)       (bpp == 4 ? _mm256_loadu_si256((const __m256i *)(p)) : \
+                             _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(p))), _mm_loadu_si128((const __m128i *)((p) + 12)), 1))
+#define V_MASK(m)           _mm256_broadcastsi128_si256(m)
+#define V_SHUFFLE_EPI8      _mm256_shuffle_epi8
+#define V_SET1_PS           _mm256_set1_ps
+#define V_SET1_EPI32        _mm256_set1_epi32
+#define V_CVTEPI32_PS       _mm256_cvtepi32_ps
+#define V_CVTTPS_EPI32      _mm256_cvttps_epi32
+#define V_MUL_PS            _mm256_mul_ps
+#define V_ADD_PS            _mm256_add_ps
+#define V_ADD_EPI32         _mm256_add_epi32
+#define V_SRLI_EPI32        _mm256_srli_epi32
+#define V_AND               _mm256_and_si256
+#define V_HADD_EPI32(a, b)  _mm256_permute4x64_epi64(_mm256_hadd_epi32(a, b), 0xD8)
+#define V_TO_EPI16(a)       _mm_packus_epi32(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1))
+#define V_TO_EPI8(a, b)     _mm_packus_epi16(V_TO_EPI16(a), V_TO_EPI16(b))
+#define STORE_V(p, x)       _mm_storel_epi64((__m128i *)(p), x)
+#define STORE_2V(p, x)      _mm_storeu_si128((__m128i *)(p), x)
+#define STORE_4V(p, a, b)   _mm_storeu_si128((__m128i *)(p), _mm_unpacklo_epi8(a, b)); \
+                            _mm_storeu_si128((__m128i *)(p) + 1, _mm_unpackhi_epi8(a, b))
+#else
+#define VI                  __m128i
+#define VF                  __m128
+#define V_PIXELS            4
+#define V_LOAD_RGB(p)       _mm_loadu_si128((const __m128i *)(p))
+#define V_MASK(m)           (m)
+#define V_SHUFFLE_EPI8      _mm_shuffle_epi8
+#define V_SET1_PS           _mm_set1_ps
+#define V_SET1_EPI32        _mm_set1_epi32
+#define V_CVTEPI32_PS       _mm_cvtepi32_ps
+#define V_CVTTPS_EPI32      _mm_cvttps_epi32
+#define V_MUL_PS            _mm_mul_ps
+#define V_ADD_PS            _mm_add_ps
+#define V_ADD_EPI32         _mm_add_epi32
+#define V_SRLI_EPI32        _mm_srli_epi32
+#define V_AND               _mm_and_si128
+#define V_HADD_EPI32(a, b)  _mm_hadd_epi32(a, b)
+#define V_TO_EPI8(a, b)     _mm_packus_epi16(_mm_packus_epi32(a, b), _mm_setzero_si128())
+#define STORE_V(p, x)       { const Uint32 word = (Uint32)_mm_cvtsi128_si32(x); SDL_memcpy(p, &word, sizeof(word)); }
+#define STORE_2V(p, x)      _mm_storel_epi64((__m128i *)(p), x)
+#define STORE_4V(p, a, b)   _mm_storeu_si128((__m128i *)(p), _mm_unpacklo_epi8(a, b))
+#endif
+
+// Split V_PIXELS pixels into one 32-bit lane per pixel for each channel
+#define LOAD_RGB(p, R, G, B)              \
+    {                                     \
+        const VI px = V_LOAD_RGB(p);      \
+        R = V_SHUFFLE_EPI8(px, shuffle_r); \
+        G = V_SHUFFLE_EPI8(px, shuffle_g); \
+        B = V_SHUFFLE_EPI8(px, shuffle_b); \
+    }
+
+// (Uint8)((int)(f[0] * r + f[1] * g + f[2] * b + 0.5f) + offset), as in MAKE_Y/MAKE_U/MAKE_V
+#define MAKE_COMPONENT(R, G, B, F0, F1, F2, OFFSET)                                                     \
+    V_AND(V_ADD_EPI32(V_CVTTPS_EPI32(V_ADD_PS(V_ADD_PS(V_ADD_PS(V_MUL_PS(F0, V_CVTEPI32_PS(R)),      \
+                                                               V_MUL_PS(F1, V_CVTEPI32_PS(G))),     \
+                                                      V_MUL_PS(F2, V_CVTEPI32_PS(B))),              \
+                                             half)),                                                \
+                      OFFSET),                                                                      \
+          mask_ff)
+
+#define MAKE_Y(R, G, B) MAKE_COMPONENT(R, G, B, y0, y1, y2, y_offset)
+#define MAKE_U(R, G, B) MAKE_COMPONENT(R, G, B, u0, u1, u2, uv_offset)
+#define MAKE_V(R, G, B) MAKE_COMPONENT(R, G, B, v0, v1, v2, uv_offset)
+
+static bool SDL_TARGETING(RGB2YUV_TARGET) RGB2YUV_FUNCTION_NAME(int width, int height, int row, int rows, SDL_PixelFormat src_format, const void *src, int src_pitch, SDL_PixelFormat dst_format, void *dst, int dst_pitch, YCbCrType yuv_type)
+{
+    const struct RGB2YUVFactors *cvt = &RGB2YUVFactorTables[yuv_type];
+    const Uint8 *curr_row;
+    int bpp, r_offset, g_offset, b_offset;
+    int simd_width;
+    int i, j, x;
+    __m128i shuffle;
+    VI shuffle_r, shuffle_g, shuffle_b;
+    VI mask_ff, y_offset, uv_offset;
+    VF y0, y1, y2, u0, u1, u2, v0, v1, v2, half;
+
+    if (!GetRGB8Layout(src_format, &bpp, &r_offset, &g_offset, &b_offset)) {
+        return false;
+    }
+
+    // One pshufb mask per channel, moving byte `offset` of each pixel to the bottom of a 32-bit lane
+    {
+        Uint8 masks[3][16];
+        const int offsets[3] = { r_offset, g_offset, b_offset };
+
+        SDL_memset(masks, 0x80, sizeof(masks));
+        for (i = 0; i < 3; ++i) {
+            for (j = 0; j < 4; ++j) {
+                masks[i][j * 4] = (Uint8)(j * bpp + offsets[i]);
+            }
+        }
+        shuffle = _mm_loadu_si128((const __m128i *)masks[0]);
+        shuffle_r = V_MASK(shuffle);
+        shuffle = _mm_loadu_si128((const __m128i *)masks[1]);
+        shuffle_g = V_MASK(shuffle);
+        shuffle = _mm_loadu_si128((const __m128i *)masks[2]);
+        shuffle_b = V_MASK(shuffle);
+    }
+    y0 = V_SET1_PS(cvt->y[0]);
+    y1 = V_SET1_PS(cvt->y[1]);
+    y2 = V_SET1_PS(cvt->y[2]);
+    u0 = V_SET1_PS(cvt->u[0]);
+    u1 = V_SET1_PS(cvt->u[1]);
+    u2 = V_SET1_PS(cvt->u[2]);
+    v0 = V_SET1_PS(cvt->v[0]);
+    v1 = V_SET1_PS(cvt->v[1]);
+    v2 = V_SET1_PS(cvt->v[2]);
+    half = V_SET1_PS(0.5f);
+    mask_ff = V_SET1_EPI32(0xFF);
+    y_offset = V_SET1_EPI32(cvt->y_offset);
+    uv_offset = V_SET1_EPI32(128);
+
+    // 24-bit pixels are loaded 16 bytes at a time, so keep the last 2 pixels of each row away from the vector loads
+    simd_width = (bpp == 3) ? width - 2 : width;
+
+    curr_row = (const Uint8 *)src + row * src_pitch;
+
+    switch (dst_format) {
+    case SDL_PIXELFORMAT_YV12:
+    case SDL_PIXELFORMAT_IYUV:
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+    {
+        const int interleaved = (dst_format == SDL_PIXELFORMAT_NV12 || dst_format == SDL_PIXELFORMAT_NV21);
+        const int uv_step = interleaved ? 2 : 1;
+        Uint8 *plane_y;
+        Uint8 *plane_u;
+        Uint8 *plane_v;
+        Uint32 y_stride, uv_stride;
+
+        if (!GetYUVPlanes(width, height, dst_format, dst, dst_pitch,
+                          (const Uint8 **)&plane_y, (const Uint8 **)&plane_u, (const Uint8 **)&plane_v,
+                          &y_stride, &uv_stride)) {
+            return false;
+        }
+        plane_y += row * y_stride;
+        plane_u += (row / 2) * uv_stride;
+        plane_v += (row / 2) * uv_stride;
+
+        for (j = 0; j < rows; j += 2) {
+            const Uint8 *next_row = (j + 1 < rows) ? curr_row + src_pitch : NULL;
+            Uint8 *y_row = plane_y;
+            Uint8 *y_next_row = plane_y + y_stride;
+
+            for (x = 0; x + 2 * V_PIXELS <= simd_width; x += 2 * V_PIXELS) {
+                VI ra, ga, ba, rb, gb, bb, r, g, b, u, v;
+                __m128i u8, v8;
+
+                LOAD_RGB(curr_row + x * bpp, ra, ga, ba);
+                LOAD_RGB(curr_row + (x + V_PIXELS) * bpp, rb, gb, bb);
+                STORE_2V(y_row + x, V_TO_EPI8(MAKE_Y(ra, ga, ba), MAKE_Y(rb, gb, bb)));
+                r = V_HADD_EPI32(ra, rb);
+                g = V_HADD_EPI32(ga, gb);
+                b = V_HADD_EPI32(ba, bb);
+
+                if (next_row) {
+                    LOAD_RGB(next_row + x * bpp, ra, ga, ba);
+                    LOAD_RGB(next_row + (x + V_PIXELS) * bpp, rb, gb, bb);
+                    STORE_2V(y_next_row + x, V_TO_EPI8(MAKE_Y(ra, ga, ba), MAKE_Y(rb, gb, bb)));
+                    r = V_SRLI_EPI32(V_ADD_EPI32(r, V_HADD_EPI32(ra, rb)), 2);
+                    g = V_SRLI_EPI32(V_ADD_EPI32(g, V_HADD_EPI32(ga, gb)), 2);
+                    b = V_SRLI_EPI32(V_ADD_EPI32(b, V_HADD_EPI32(ba, bb)), 2);
+                } else {
+                    r = V_SRLI_EPI32(r, 1);
+                    g = V_SRLI_EPI32(g, 1);
+                    b = V_SRLI_EPI32(b, 1);
+                }
+
+                u = MAKE_U(r, g, b);
+                v = MAKE_V(r, g, b);
+                u8 = V_TO_EPI8(u, u);
+                v8 = V_TO_EPI8(v, v);
+                if (!interleaved) {
+                    STORE_V(plane_u + x / 2, u8);
+                    STORE_V(plane_v + x / 2, v8);
+                } else if (dst_format == SDL_PIXELFORMAT_NV12) {
+                    STORE_2V(plane_u + x, _mm_unpacklo_epi8(u8, v8));
+                } else {
+                    STORE_2V(plane_v + x, _mm_unpacklo_epi8(v8, u8));
+                }
+            }
+
+            RGB8ToYUVPlanarTail(cvt, bpp, r_offset, g_offset, b_offset, curr_row, next_row, x, width,
+                                y_row, next_row ? y_next_row : NULL, plane_u, plane_v, uv_step);
+
+            curr_row += 2 * src_pitch;
+            plane_y += 2 * y_stride;
+            plane_u += uv_stride;
+            plane_v += uv_stride;
+        }
+    } break;
+
+    case SDL_PIXELFORMAT_YUY2:
+    case SDL_PIXELFORMAT_UYVY:
+    case SDL_PIXELFORMAT_YVYU:
+    {
+        Uint8 *plane = (Uint8 *)dst + row * dst_pitch;
+
+        if (dst_pitch < 4 * ((width + 1) / 2)) {
+            return SDL_SetError("Destination pitch is too small, expected at least %d\n", 4 * ((width + 1) / 2));
+        }
+
+        for (j = 0; j < rows; j++) {
+            for (x = 0; x + 2 * V_PIXELS <= simd_width; x += 2 * V_PIXELS) {
+                VI ra, ga, ba, rb, gb, bb, r, g, b, u, v;
+                __m128i y8, u8, v8;
+
+                LOAD_RGB(curr_row + x * bpp, ra, ga, ba);
+                LOAD_RGB(curr_row + (x + V_PIXELS) * bpp, rb, gb, bb);
+                y8 = V_TO_EPI8(MAKE_Y(ra, ga, ba), MAKE_Y(rb, gb, bb));
+                r = V_SRLI_EPI32(V_HADD_EPI32(ra, rb), 1);
+                g = V_SRLI_EPI32(V_HADD_EPI32(ga, gb), 1);
+                b = V_SRLI_EPI32(V_HADD_EPI32(ba, bb), 1);
+                u = MAKE_U(r, g, b);
+                v = MAKE_V(r, g, b);
+                u8 = V_TO_EPI8(u, u);
+                v8 = V_TO_EPI8(v, v);
+
+                if (dst_format == SDL_PIXELFORMAT_YUY2) {
+                    // Y U Y1 V
+                    STORE_4V(plane + x * 2, y8, _mm_unpacklo_epi8(u8, v8));
+                } else if (dst_format == SDL_PIXELFORMAT_UYVY) {
+                    // U Y V Y1
+                    STORE_4V(plane + x * 2, _mm_unpacklo_epi8(u8, v8), y8);
+                } else {
+                    // Y V Y1 U
+                    STORE_4V(plane + x * 2, y8, _mm_unpacklo_epi8(v8, u8));
+                }
+            }
+
+            RGB8ToYUVPackedTail(cvt, bpp, r_offset, g_offset, b_offset, curr_row, x, width, plane, dst_format);
+
+            curr_row += src_pitch;
+            plane += dst_pitch;
+        }
+    } break;
+
+    default:
+        return false;
+    }
+    return true;
+}
+
+#undef RGB2YUV_FUNCTION_NAME
+#undef RGB2YUV_TARGET
+#undef RGB2YUV_256
+#undef VI
+#undef VF
+#undef V_PIXELS
+#undef V_LOAD_RGB
+#undef V_MASK
+#undef V_SHUFFLE_EPI8
+#undef V_SET1_PS
+#undef V_SET1_EPI32
+#undef V_CVTEPI32_PS
+#undef V_CVTTPS_EPI32
+#undef V_MUL_PS
+#undef V_ADD_PS
+#undef V_ADD_EPI32
+#undef V_SRLI_EPI32
+#undef V_AND
+#undef V_HADD_EPI32
+#undef V_TO_EPI16
+#undef V_TO_EPI8
+#undef STORE_V
+#undef STORE_2V
+#undef STORE_4V
+#undef LOAD_RGB
+#undef MAKE_COMPONENT
+#undef MAKE_Y
+#undef MAKE_U
+#undef MAKE_V
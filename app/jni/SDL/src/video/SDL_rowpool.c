@@ -0,0 +1,210 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2024 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_internal.h"
+
+#include "SDL_rowpool_c.h"
+
+// The most threads a single conversion is split across
+#define SDL_ROWPOOL_MAX_THREADS 16
+
+// Conversions smaller than this many pixels are not worth waking the workers for
+#define SDL_ROWPOOL_MIN_PIXELS (256 * 256)
+
+// Bands shorter than this many rows are not worth a thread
+#define SDL_ROWPOOL_MIN_BAND_ROWS 16
+
+typedef struct SDL_RowPoolJob
+{
+    SDL_RowPoolFunc func;
+    void *userdata;
+    int height;
+    int band_rows;
+    int num_bands;
+    SDL_AtomicInt next_band;
+} SDL_RowPoolJob;
+
+typedef struct SDL_RowPool
+{
+    SDL_AtomicInt busy;        // set by the thread that owns `job`, also while a band re-enters the pool
+    SDL_Semaphore *work;       // signaled once per worker that should join the current job
+    SDL_Semaphore *done;       // signaled by each worker when it runs out of bands
+    SDL_AtomicInt running;
+    SDL_Thread *threads[SDL_ROWPOOL_MAX_THREADS - 1];
+    int num_threads;
+    SDL_RowPoolJob job;
+} SDL_RowPool;
+
+static SDL_SpinLock SDL_row_pool_spinlock;
+static SDL_RowPool *SDL_row_pool;
+
+static void SDL_RunRowPoolBands(SDL_RowPoolJob *job)
+{
+    int band;
+
+    while ((band = SDL_AddAtomicInt(&job->next_band, 1)) < job->num_bands) {
+        const int row = band * job->band_rows;
+        job->func(job->userdata, row, SDL_min(job->band_rows, job->height - row));
+    }
+}
+
+static int SDLCALL SDL_RowPoolThread(void *data)
+{
+    SDL_RowPool *pool = (SDL_RowPool *)data;
+
+    for (;;) {
+        SDL_WaitSemaphore(pool->work);
+        if (!SDL_GetAtomicInt(&pool->running)) {
+            break;
+        }
+        SDL_RunRowPoolBands(&pool->job);
+        SDL_SignalSemaphore(pool->done);
+    }
+    return 0;
+}
+
+static SDL_RowPool *SDL_GetRowPool(void)
+{
+    SDL_RowPool *pool;
+
+    SDL_LockSpinlock(&SDL_row_pool_spinlock);
+    pool = SDL_row_pool;
+    if (!pool) {
+        pool = (SDL_RowPool *)SDL_calloc(1, sizeof(*pool));
+        if (pool) {
+            pool->work = SDL_CreateSemaphore(0);
+            pool->done = SDL_CreateSemaphore(0);
+            if (!pool->work || !pool->done) {
+                SDL_DestroySemaphore(pool->work);
+                SDL_DestroySemaphore(pool->done);
+                SDL_free(pool);
+                pool = NULL;
+            } else {
+                SDL_SetAtomicInt(&pool->running, 1);
+                SDL_row_pool = pool;
+            }
+        }
+    }
+    SDL_UnlockSpinlock(&SDL_row_pool_spinlock);
+
+    return pool;
+}
+
+int SDL_GetRowPoolThreadCount(const char *hint, int width, int height)
+{
+    const char *value;
+    int threads;
+
+    if ((Sint64)width * height < SDL_ROWPOOL_MIN_PIXELS) {
+        return 1;
+    }
+
+    value = SDL_GetHint(hint);
+    if (!value || !*value) {
+        return 1;
+    }
+    if (SDL_strcasecmp(value, "auto") == 0) {
+        threads = SDL_GetNumLogicalCPUCores();
+    } else {
+        threads = SDL_atoi(value);
+    }
+    threads = SDL_min(threads, height / SDL_ROWPOOL_MIN_BAND_ROWS);
+    return SDL_clamp(threads, 1, SDL_ROWPOOL_MAX_THREADS);
+}
+
+void SDL_RunRowPool(int height, int alignment, int threads, SDL_RowPoolFunc func, void *userdata)
+{
+    SDL_RowPool *pool = NULL;
+    int band_rows, num_bands, helpers, i;
+
+    // Split the rows evenly, rounding each band up to the chroma subsampling
+    threads = SDL_clamp(threads, 1, SDL_ROWPOOL_MAX_THREADS);
+    band_rows = (height + threads - 1) / threads;
+    band_rows = ((band_rows + alignment - 1) / alignment) * alignment;
+    num_bands = band_rows > 0 ? (height + band_rows - 1) / band_rows : 0;
+
+    if (num_bands > 1) {
+        pool = SDL_GetRowPool();
+    }
+    // Another job is using the pool, possibly a band of it on this very thread: run this one on the calling thread
+    if (pool && !SDL_CompareAndSwapAtomicInt(&pool->busy, 0, 1)) {
+        pool = NULL;
+    }
+    if (!pool) {
+        func(userdata, 0, height);
+        return;
+    }
+
+    // Start any workers this job needs that haven't been created yet
+    helpers = num_bands - 1;
+    while (pool->num_threads < helpers) {
+        char name[16];
+        SDL_snprintf(name, sizeof(name), "SDLRowPool%d", pool->num_threads);
+        pool->threads[pool->num_threads] = SDL_CreateThread(SDL_RowPoolThread, name, pool);
+        if (!pool->threads[pool->num_threads]) {
+            break;
+        }
+        ++pool->num_threads;
+    }
+    helpers = SDL_min(helpers, pool->num_threads);
+
+    pool->job.func = func;
+    pool->job.userdata = userdata;
+    pool->job.height = height;
+    pool->job.band_rows = band_rows;
+    pool->job.num_bands = num_bands;
+    SDL_SetAtomicInt(&pool->job.next_band, 0);
+
+    for (i = 0; i < helpers; ++i) {
+        SDL_SignalSemaphore(pool->work);
+    }
+    SDL_RunRowPoolBands(&pool->job);
+    for (i = 0; i < helpers; ++i) {
+        SDL_WaitSemaphore(pool->done);
+    }
+
+    SDL_SetAtomicInt(&pool->busy, 0);
+}
+
+void SDL_QuitRowPool(void)
+{
+    SDL_RowPool *pool;
+    int i;
+
+    SDL_LockSpinlock(&SDL_row_pool_spinlock);
+    pool = SDL_row_pool;
+    SDL_row_pool = NULL;
+    SDL_UnlockSpinlock(&SDL_row_pool_spinlock);
+
+    if (!pool) {
+        return;
+    }
+
+    SDL_SetAtomicInt(&pool->running, 0);
+    for (i = 0; i < pool->num_threads; ++i) {
+        SDL_SignalSemaphore(pool->work);
+    }
+    for (i = 0; i < pool->num_threads; ++i) {
+        SDL_WaitThread(pool->threads[i], NULL);
+    }
+    SDL_DestroySemaphore(pool->work);
+    SDL_DestroySemaphore(pool->done);
+    SDL_free(pool);
+}
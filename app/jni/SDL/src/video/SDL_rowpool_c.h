@@ -0,0 +1,42 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2024 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef SDL_rowpool_c_h_
+#define SDL_rowpool_c_h_
+
+#include "SDL_internal.h"
+
+// A persistent pool of worker threads used to split pixel conversions into row bands
+
+// Process `rows` rows starting at `row`; bands never overlap, so no locking is needed
+typedef void (SDLCALL *SDL_RowPoolFunc)(void *userdata, int row, int rows);
+
+// Get the number of threads `hint` asks for at this size, 1 if the work should stay on the calling thread
+extern int SDL_GetRowPoolThreadCount(const char *hint, int width, int height);
+
+/* Split `height` rows into bands starting on a multiple of `alignment` and run them on up to `threads` threads,
+ * including the calling thread. This returns once every band has been processed.
+ */
+extern void SDL_RunRowPool(int height, int alignment, int threads, SDL_RowPoolFunc func, void *userdata);
+
+extern void SDL_QuitRowPool(void);
+
+#endif // SDL_rowpool_c_h_
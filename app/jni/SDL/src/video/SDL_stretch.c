@@ -825,6 +825,559 @@ static bool scale_mat_NEON(const Uint32 *src, int src_w, int src_h, int src_pitc
 }
 #endif
 
+/* Separable resampling for large reductions.
+   The bilinear filter above only reads the 2x2 source pixels nearest each destination pixel, so once an
+   image shrinks by half or more it skips source pixels and fine detail aliases. This filters each axis
+   with a box (area-averaging) or Lanczos-3 kernel widened to cover every source pixel: vertically first,
+   into one row of 16-bit samples with RESAMPLE_ROW_BITS fractional bits, then horizontally back to 8 bits.
+   Samples are treated as independent bytes, so this handles every 8888 format and single 8-bit planes. */
+
+#define RESAMPLE_WEIGHT_BITS 14
+#define RESAMPLE_WEIGHT_ONE  (1 << RESAMPLE_WEIGHT_BITS)
+#define RESAMPLE_ROW_BITS    6
+#define RESAMPLE_ROW_SHIFT   (RESAMPLE_WEIGHT_BITS - RESAMPLE_ROW_BITS)
+#define RESAMPLE_OUT_SHIFT   (RESAMPLE_WEIGHT_BITS + RESAMPLE_ROW_BITS)
+#define RESAMPLE_LANCZOS_LOBES 3
+#define RESAMPLE_CACHE_SIZE  8
+
+// Two adjacent weights packed for _mm_madd_epi16(), the first in the low half
+#define RESAMPLE_PAIR(w0, w1) ((int)(((Uint32)(Uint16)(w1) << 16) | (Uint16)(w0)))
+
+typedef struct SDL_ResampleAxis
+{
+    SDL_StretchFilter filter;
+    int src_len;
+    int dst_len;
+    int align;       // taps is padded to a multiple of this for the SIMD row kernels
+    int taps;        // weights stored per destination sample, zero past `count`
+    int *start;      // first source sample for each destination sample
+    int *count;      // source samples each destination sample actually reads
+    Sint16 *weights; // dst_len * taps weights, each destination sample's summing to RESAMPLE_WEIGHT_ONE
+    void *scratch;   // working memory of a stretch along this axis, kept for the next one while nobody holds it
+    int refcount;
+    bool cached;
+} SDL_ResampleAxis;
+
+static SDL_SpinLock SDL_resample_lock;
+static SDL_ResampleAxis *SDL_resample_cache[RESAMPLE_CACHE_SIZE];
+static int SDL_resample_evict;
+
+static void DestroyResampleAxis(SDL_ResampleAxis *axis)
+{
+    if (axis) {
+        SDL_free(axis->start);
+        SDL_free(axis->count);
+        SDL_free(axis->weights);
+        SDL_free(axis->scratch);
+        SDL_free(axis);
+    }
+}
+
+static double LanczosKernel(double x)
+{
+    double a, b;
+
+    if (x == 0.0) {
+        return 1.0;
+    }
+    if (x <= -RESAMPLE_LANCZOS_LOBES || x >= RESAMPLE_LANCZOS_LOBES) {
+        return 0.0;
+    }
+    a = SDL_PI_D * x;
+    b = a / RESAMPLE_LANCZOS_LOBES;
+    return (SDL_sin(a) / a) * (SDL_sin(b) / b);
+}
+
+static SDL_ResampleAxis *CreateResampleAxis(SDL_StretchFilter filter, int src_len, int dst_len, int align)
+{
+    const double ratio = (double)src_len / dst_len;
+    const double scale = SDL_max(ratio, 1.0);
+    double support;
+    SDL_ResampleAxis *axis;
+    double *w;
+    int max_taps, i, k;
+
+    if (filter == SDL_STRETCH_FILTER_LANCZOS) {
+        support = RESAMPLE_LANCZOS_LOBES * scale;
+    } else if (ratio >= 1.0) {
+        support = ratio / 2.0;
+    } else {
+        support = 1.0; // enlarging this axis, so area averaging is plain bilinear
+    }
+    max_taps = (int)SDL_ceil(2.0 * support) + 3;
+    max_taps = ((max_taps + align - 1) / align) * align;
+
+    axis = (SDL_ResampleAxis *)SDL_calloc(1, sizeof(*axis));
+    if (!axis) {
+        return NULL;
+    }
+    axis->filter = filter;
+    axis->src_len = src_len;
+    axis->dst_len = dst_len;
+    axis->align = align;
+    axis->taps = max_taps;
+    axis->start = (int *)SDL_malloc(dst_len * sizeof(int));
+    axis->count = (int *)SDL_malloc(dst_len * sizeof(int));
+    axis->weights = (Sint16 *)SDL_calloc((size_t)dst_len * max_taps, sizeof(Sint16));
+    w = (double *)SDL_malloc(max_taps * sizeof(double));
+    if (!axis->start || !axis->count || !axis->weights || !w) {
+        DestroyResampleAxis(axis);
+        SDL_free(w);
+        return NULL;
+    }
+
+    for (i = 0; i < dst_len; ++i) {
+        // sample centers lined up between source and destination
+        const double center = (i + 0.5) * ratio - 0.5;
+        const int lo = (int)SDL_floor(center - support);
+        const int hi = (int)SDL_ceil(center + support);
+        Sint16 *q = axis->weights + (size_t)i * max_taps;
+        double total = 0.0;
+        int first = SDL_clamp(lo, 0, src_len - 1);
+        int last = SDL_clamp(hi, 0, src_len - 1);
+        int sum = 0, heaviest = 0, count = 1;
+
+        SDL_assert(last - first < max_taps);
+        SDL_memset(w, 0, max_taps * sizeof(double));
+
+        // taps past either edge are folded into the edge sample
+        for (k = lo; k <= hi; ++k) {
+            double weight;
+
+            if (filter == SDL_STRETCH_FILTER_LANCZOS) {
+                weight = LanczosKernel((k - center) / scale);
+            } else if (ratio >= 1.0) {
+                const double left = SDL_max(i * ratio, (double)k);
+                const double right = SDL_min((i + 1) * ratio, (double)(k + 1));
+                weight = SDL_max(right - left, 0.0);
+            } else {
+                weight = SDL_max(1.0 - SDL_fabs(k - center), 0.0);
+            }
+            w[SDL_clamp(k, 0, src_len - 1) - first] += weight;
+            total += weight;
+        }
+
+        // skip the samples at either end of the window that don't contribute
+        while (last > first && w[last - first] == 0.0) {
+            --last;
+        }
+        for (k = 0; first < last && w[k] == 0.0; ++k) {
+            ++first;
+        }
+        if (k > 0) {
+            SDL_memmove(w, w + k, (last - first + 1) * sizeof(double));
+        }
+
+        // quantize, handing the rounding error to the heaviest tap so the weights sum to exactly one
+        for (k = 0; k <= last - first; ++k) {
+            q[k] = (Sint16)SDL_floor(w[k] / total * RESAMPLE_WEIGHT_ONE + 0.5);
+            sum += q[k];
+            if (q[k] > q[heaviest]) {
+                heaviest = k;
+            }
+        }
+        q[heaviest] = (Sint16)(q[heaviest] + (RESAMPLE_WEIGHT_ONE - sum));
+
+        for (k = 0; k <= last - first; ++k) {
+            if (q[k] != 0) {
+                count = k + 1;
+            }
+        }
+        axis->start[i] = first;
+        axis->count[i] = count;
+    }
+
+    SDL_free(w);
+    return axis;
+}
+
+// Get the coefficients for one axis, reusing them while the same sizes keep being scaled
+static SDL_ResampleAxis *AcquireResampleAxis(SDL_StretchFilter filter, int src_len, int dst_len, int align)
+{
+    SDL_ResampleAxis *axis, *evicted = NULL;
+    int i;
+
+    SDL_LockSpinlock(&SDL_resample_lock);
+    for (i = 0; i < RESAMPLE_CACHE_SIZE; ++i) {
+        axis = SDL_resample_cache[i];
+        if (axis && axis->filter == filter && axis->src_len == src_len && axis->dst_len == dst_len && axis->align == align) {
+            ++axis->refcount;
+            SDL_UnlockSpinlock(&SDL_resample_lock);
+            return axis;
+        }
+    }
+    SDL_UnlockSpinlock(&SDL_resample_lock);
+
+    axis = CreateResampleAxis(filter, src_len, dst_len, align);
+    if (!axis) {
+        return NULL;
+    }
+    axis->refcount = 1;
+
+    // take an empty slot, or else the oldest one nobody is using
+    SDL_LockSpinlock(&SDL_resample_lock);
+    for (i = 0; i < RESAMPLE_CACHE_SIZE; ++i) {
+        if (!SDL_resample_cache[i]) {
+            break;
+        }
+    }
+    if (i == RESAMPLE_CACHE_SIZE) {
+        for (i = 0; i < RESAMPLE_CACHE_SIZE; ++i) {
+            const int slot = (SDL_resample_evict + i) % RESAMPLE_CACHE_SIZE;
+            if (SDL_resample_cache[slot]->refcount == 0) {
+                evicted = SDL_resample_cache[slot];
+                SDL_resample_evict = (slot + 1) % RESAMPLE_CACHE_SIZE;
+                i = slot;
+                break;
+            }
+        }
+    }
+    if (i < RESAMPLE_CACHE_SIZE) {
+        SDL_resample_cache[i] = axis;
+        axis->cached = true;
+    }
+    SDL_UnlockSpinlock(&SDL_resample_lock);
+
+    DestroyResampleAxis(evicted);
+    return axis;
+}
+
+static void ReleaseResampleAxis(SDL_ResampleAxis *axis)
+{
+    bool destroy;
+
+    if (!axis) {
+        return;
+    }
+    SDL_LockSpinlock(&SDL_resample_lock);
+    --axis->refcount;
+    destroy = !axis->cached;
+    SDL_UnlockSpinlock(&SDL_resample_lock);
+
+    if (destroy) {
+        DestroyResampleAxis(axis);
+    }
+}
+
+// Take the working memory kept by the axis, or allocate zeroed memory if another stretch holds it
+static void *ClaimResampleScratch(SDL_ResampleAxis *axis, size_t size)
+{
+    void *scratch;
+
+    SDL_LockSpinlock(&SDL_resample_lock);
+    scratch = axis->scratch;
+    axis->scratch = NULL;
+    SDL_UnlockSpinlock(&SDL_resample_lock);
+
+    if (!scratch) {
+        scratch = SDL_calloc(1, size);
+    }
+    return scratch;
+}
+
+static void ReturnResampleScratch(SDL_ResampleAxis *axis, void *scratch)
+{
+    SDL_LockSpinlock(&SDL_resample_lock);
+    if (!axis->scratch && axis->cached) {
+        axis->scratch = scratch;
+        scratch = NULL;
+    }
+    SDL_UnlockSpinlock(&SDL_resample_lock);
+
+    SDL_free(scratch);
+}
+
+void SDL_QuitSoftStretch(void)
+{
+    int i;
+
+    SDL_LockSpinlock(&SDL_resample_lock);
+    for (i = 0; i < RESAMPLE_CACHE_SIZE; ++i) {
+        if (SDL_resample_cache[i]) {
+            SDL_assert(SDL_resample_cache[i]->refcount == 0);
+            DestroyResampleAxis(SDL_resample_cache[i]);
+            SDL_resample_cache[i] = NULL;
+        }
+    }
+    SDL_resample_evict = 0;
+    SDL_UnlockSpinlock(&SDL_resample_lock);
+}
+
+// Sum `count` source rows into `out`, len samples each
+typedef void (*SDL_ResampleColumnsFunc)(const Uint8 *const *rows, const Sint16 *weights, int count, int len, Sint16 *out);
+
+// Filter the vertically filtered row horizontally into one destination row
+typedef void (*SDL_ResampleRowFunc)(const Sint16 *row, const SDL_ResampleAxis *axis, Uint8 *dst);
+
+static SDL_INLINE Uint8 RESAMPLE_CLAMP(Sint32 sum)
+{
+    sum >>= RESAMPLE_OUT_SHIFT;
+    return (Uint8)SDL_clamp(sum, 0, 255);
+}
+
+static void ResampleColumns(const Uint8 *const *rows, const Sint16 *weights, int count, int len, Sint16 *out)
+{
+    int i, k;
+
+    for (i = 0; i < len; ++i) {
+        Sint32 sum = 1 << (RESAMPLE_ROW_SHIFT - 1);
+        for (k = 0; k < count; ++k) {
+            sum += weights[k] * rows[k][i];
+        }
+        out[i] = (Sint16)(sum >> RESAMPLE_ROW_SHIFT);
+    }
+}
+
+static void ResampleRow1(const Sint16 *row, const SDL_ResampleAxis *axis, Uint8 *dst)
+{
+    int x, k;
+
+    for (x = 0; x < axis->dst_len; ++x) {
+        const Sint16 *s = row + axis->start[x];
+        const Sint16 *w = axis->weights + (size_t)x * axis->taps;
+        Sint32 sum = 1 << (RESAMPLE_OUT_SHIFT - 1);
+        for (k = 0; k < axis->count[x]; ++k) {
+            sum += w[k] * s[k];
+        }
+        dst[x] = RESAMPLE_CLAMP(sum);
+    }
+}
+
+static void ResampleRow4(const Sint16 *row, const SDL_ResampleAxis *axis, Uint8 *dst)
+{
+    int x, k;
+
+    for (x = 0; x < axis->dst_len; ++x) {
+        const Sint16 *s = row + axis->start[x] * 4;
+        const Sint16 *w = axis->weights + (size_t)x * axis->taps;
+        Sint32 sum0 = 1 << (RESAMPLE_OUT_SHIFT - 1);
+        Sint32 sum1 = sum0, sum2 = sum0, sum3 = sum0;
+        for (k = 0; k < axis->count[x]; ++k, s += 4) {
+            sum0 += w[k] * s[0];
+            sum1 += w[k] * s[1];
+            sum2 += w[k] * s[2];
+            sum3 += w[k] * s[3];
+        }
+        dst[0] = RESAMPLE_CLAMP(sum0);
+        dst[1] = RESAMPLE_CLAMP(sum1);
+        dst[2] = RESAMPLE_CLAMP(sum2);
+        dst[3] = RESAMPLE_CLAMP(sum3);
+        dst += 4;
+    }
+}
+
+#ifdef SDL_SSE2_INTRINSICS
+
+static void SDL_TARGETING("sse2") ResampleColumns_SSE2(const Uint8 *const *rows, const Sint16 *weights, int count, int len, Sint16 *out)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi32(1 << (RESAMPLE_ROW_SHIFT - 1));
+    int i, k;
+
+    // two source rows at a time: interleave their bytes so each madd applies both weights
+    for (i = 0; i + 16 <= len; i += 16) {
+        __m128i acc0 = round, acc1 = round, acc2 = round, acc3 = round;
+        for (k = 0; k < count; k += 2) {
+            const __m128i a = _mm_loadu_si128((const __m128i *)(rows[k] + i));
+            const __m128i b = (k + 1 < count) ? _mm_loadu_si128((const __m128i *)(rows[k + 1] + i)) : zero;
+            const __m128i w = _mm_set1_epi32(RESAMPLE_PAIR(weights[k], (k + 1 < count) ? weights[k + 1] : 0));
+            const __m128i lo = _mm_unpacklo_epi8(a, b);
+            const __m128i hi = _mm_unpackhi_epi8(a, b);
+            acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(_mm_unpacklo_epi8(lo, zero), w));
+            acc1 = _mm_add_epi32(acc1, _mm_madd_epi16(_mm_unpackhi_epi8(lo, zero), w));
+            acc2 = _mm_add_epi32(acc2, _mm_madd_epi16(_mm_unpacklo_epi8(hi, zero), w));
+            acc3 = _mm_add_epi32(acc3, _mm_madd_epi16(_mm_unpackhi_epi8(hi, zero), w));
+        }
+        acc0 = _mm_srai_epi32(acc0, RESAMPLE_ROW_SHIFT);
+        acc1 = _mm_srai_epi32(acc1, RESAMPLE_ROW_SHIFT);
+        acc2 = _mm_srai_epi32(acc2, RESAMPLE_ROW_SHIFT);
+        acc3 = _mm_srai_epi32(acc3, RESAMPLE_ROW_SHIFT);
+        _mm_storeu_si128((__m128i *)(out + i), _mm_packs_epi32(acc0, acc1));
+        _mm_storeu_si128((__m128i *)(out + i + 8), _mm_packs_epi32(acc2, acc3));
+    }
+
+    for (; i < len; ++i) {
+        Sint32 sum = 1 << (RESAMPLE_ROW_SHIFT - 1);
+        for (k = 0; k < count; ++k) {
+            sum += weights[k] * rows[k][i];
+        }
+        out[i] = (Sint16)(sum >> RESAMPLE_ROW_SHIFT);
+    }
+}
+
+static void SDL_TARGETING("sse2") ResampleRow1_SSE2(const Sint16 *row, const SDL_ResampleAxis *axis, Uint8 *dst)
+{
+    int x, k;
+
+    // taps is a multiple of 8, and the row has that much readable padding
+    for (x = 0; x < axis->dst_len; ++x) {
+        const Sint16 *s = row + axis->start[x];
+        const Sint16 *w = axis->weights + (size_t)x * axis->taps;
+        __m128i acc = _mm_setzero_si128();
+        for (k = 0; k < axis->count[x]; k += 8) {
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(s + k)), _mm_loadu_si128((const __m128i *)(w + k))));
+        }
+        acc = _mm_add_epi32(acc, _mm_srli_si128(acc, 8));
+        acc = _mm_add_epi32(acc, _mm_srli_si128(acc, 4));
+        dst[x] = RESAMPLE_CLAMP(_mm_cvtsi128_si32(acc) + (1 << (RESAMPLE_OUT_SHIFT - 1)));
+    }
+}
+
+static void SDL_TARGETING("sse2") ResampleRow4_SSE2(const Sint16 *row, const SDL_ResampleAxis *axis, Uint8 *dst)
+{
+    const __m128i round = _mm_set1_epi32(1 << (RESAMPLE_OUT_SHIFT - 1));
+    int x, k;
+
+    // two pixels at a time: interleave their channels so each madd applies both weights
+    for (x = 0; x < axis->dst_len; ++x) {
+        const Sint16 *s = row + axis->start[x] * 4;
+        const Sint16 *w = axis->weights + (size_t)x * axis->taps;
+        __m128i acc = round;
+        for (k = 0; k < axis->count[x]; k += 2) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(s + k * 4));
+            v = _mm_unpacklo_epi16(v, _mm_srli_si128(v, 8));
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(v, _mm_set1_epi32(RESAMPLE_PAIR(w[k], w[k + 1]))));
+        }
+        acc = _mm_srai_epi32(acc, RESAMPLE_OUT_SHIFT);
+        acc = _mm_packs_epi32(acc, acc);
+        acc = _mm_packus_epi16(acc, acc);
+        *(Uint32 *)(dst + x * 4) = (Uint32)_mm_cvtsi128_si32(acc);
+    }
+}
+
+#endif // SDL_SSE2_INTRINSICS
+
+#ifdef SDL_AVX2_INTRINSICS
+
+static SDL_INLINE int hasAVX2(void)
+{
+    static int val = -1;
+    if (val != -1) {
+        return val;
+    }
+    val = SDL_HasAVX2();
+    return val;
+}
+
+static void SDL_TARGETING("avx2") ResampleColumns_AVX2(const Uint8 *const *rows, const Sint16 *weights, int count, int len, Sint16 *out)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i round = _mm256_set1_epi32(1 << (RESAMPLE_ROW_SHIFT - 1));
+    int i, k;
+
+    for (i = 0; i + 32 <= len; i += 32) {
+        __m256i acc0 = round, acc1 = round, acc2 = round, acc3 = round;
+        __m256i p01, p23;
+        for (k = 0; k < count; k += 2) {
+            const __m256i a = _mm256_loadu_si256((const __m256i *)(rows[k] + i));
+            const __m256i b = (k + 1 < count) ? _mm256_loadu_si256((const __m256i *)(rows[k + 1] + i)) : zero;
+            const __m256i w = _mm256_set1_epi32(RESAMPLE_PAIR(weights[k], (k + 1 < count) ? weights[k + 1] : 0));
+            const __m256i lo = _mm256_unpacklo_epi8(a, b);
+            const __m256i hi = _mm256_unpackhi_epi8(a, b);
+            acc0 = _mm256_add_epi32(acc0, _mm256_madd_epi16(_mm256_unpacklo_epi8(lo, zero), w));
+            acc1 = _mm256_add_epi32(acc1, _mm256_madd_epi16(_mm256_unpackhi_epi8(lo, zero), w));
+            acc2 = _mm256_add_epi32(acc2, _mm256_madd_epi16(_mm256_unpacklo_epi8(hi, zero), w));
+            acc3 = _mm256_add_epi32(acc3, _mm256_madd_epi16(_mm256_unpackhi_epi8(hi, zero), w));
+        }
+        // the unpacks work within 128-bit lanes, so the low lanes hold samples 0-15 and the high lanes 16-31
+        p01 = _mm256_packs_epi32(_mm256_srai_epi32(acc0, RESAMPLE_ROW_SHIFT), _mm256_srai_epi32(acc1, RESAMPLE_ROW_SHIFT));
+        p23 = _mm256_packs_epi32(_mm256_srai_epi32(acc2, RESAMPLE_ROW_SHIFT), _mm256_srai_epi32(acc3, RESAMPLE_ROW_SHIFT));
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_permute2x128_si256(p01, p23, 0x20));
+        _mm256_storeu_si256((__m256i *)(out + i + 16), _mm256_permute2x128_si256(p01, p23, 0x31));
+    }
+
+    for (; i < len; ++i) {
+        Sint32 sum = 1 << (RESAMPLE_ROW_SHIFT - 1);
+        for (k = 0; k < count; ++k) {
+            sum += weights[k] * rows[k][i];
+        }
+        out[i] = (Sint16)(sum >> RESAMPLE_ROW_SHIFT);
+    }
+}
+
+#endif // SDL_AVX2_INTRINSICS
+
+bool SDL_SoftStretchSamples(const Uint8 *src, int src_w, int src_h, int src_pitch, Uint8 *dst, int dst_w, int dst_h, int dst_pitch, int channels, SDL_StretchFilter filter)
+{
+    SDL_ResampleColumnsFunc columns = ResampleColumns;
+    SDL_ResampleRowFunc filter_row = (channels == 1) ? ResampleRow1 : ResampleRow4;
+    const int align = (channels == 1) ? 8 : 2;
+    SDL_ResampleAxis *xaxis, *yaxis;
+    const Uint8 **rows;
+    Sint16 *row;
+    int y, k;
+
+    SDL_assert(channels == 1 || channels == 4);
+
+    xaxis = AcquireResampleAxis(filter, src_w, dst_w, align);
+    yaxis = AcquireResampleAxis(filter, src_h, dst_h, 1);
+    if (!xaxis || !yaxis) {
+        ReleaseResampleAxis(xaxis);
+        ReleaseResampleAxis(yaxis);
+        return false;
+    }
+    // the padded taps of the last destination pixels may read past the end of the row, so it's zero-filled beyond that,
+    // and stays so when the row is reused since only the first src_w samples are ever written
+    row = (Sint16 *)ClaimResampleScratch(xaxis, (size_t)(src_w + xaxis->taps) * channels * sizeof(Sint16));
+    rows = (const Uint8 **)ClaimResampleScratch(yaxis, yaxis->taps * sizeof(*rows));
+    if (!row || !rows) {
+        SDL_free(row);
+        SDL_free(rows);
+        ReleaseResampleAxis(xaxis);
+        ReleaseResampleAxis(yaxis);
+        return false;
+    }
+
+#ifdef SDL_SSE2_INTRINSICS
+    if (hasSSE2()) {
+        columns = ResampleColumns_SSE2;
+        filter_row = (channels == 1) ? ResampleRow1_SSE2 : ResampleRow4_SSE2;
+    }
+#endif
+#ifdef SDL_AVX2_INTRINSICS
+    // the vertical pass does nearly all the work when shrinking, so the horizontal one stays on SSE2
+    if (hasAVX2()) {
+        columns = ResampleColumns_AVX2;
+    }
+#endif
+
+    for (y = 0; y < dst_h; ++y) {
+        const int count = yaxis->count[y];
+        for (k = 0; k < count; ++k) {
+            rows[k] = src + (size_t)(yaxis->start[y] + k) * src_pitch;
+        }
+        columns(rows, yaxis->weights + (size_t)y * yaxis->taps, count, src_w * channels, row);
+        filter_row(row, xaxis, dst + (size_t)y * dst_pitch);
+    }
+
+    ReturnResampleScratch(xaxis, row);
+    ReturnResampleScratch(yaxis, rows);
+    ReleaseResampleAxis(xaxis);
+    ReleaseResampleAxis(yaxis);
+    return true;
+}
+
+// Get the filter to shrink with instead of bilinear, false to keep bilinear
+static bool GetDownscaleFilter(int src_w, int src_h, int dst_w, int dst_h, SDL_StretchFilter *filter)
+{
+    const char *hint;
+
+    if (src_w < 2 * dst_w && src_h < 2 * dst_h) {
+        return false;
+    }
+
+    hint = SDL_GetHint(SDL_HINT_SURFACE_DOWNSCALE_FILTER);
+    if (hint && SDL_strcasecmp(hint, "bilinear") == 0) {
+        return false;
+    }
+    if (hint && SDL_strcasecmp(hint, "lanczos") == 0) {
+        *filter = SDL_STRETCH_FILTER_LANCZOS;
+    } else {
+        *filter = SDL_STRETCH_FILTER_AREA;
+    }
+    return true;
+}
+
 bool SDL_LowerSoftStretchLinear(SDL_Surface *s, const SDL_Rect *srcrect, SDL_Surface *d, const SDL_Rect *dstrect)
 {
     bool result = false;
@@ -836,6 +1389,12 @@ bool SDL_LowerSoftStretchLinear(SDL_Surface *s, const SDL_Rect *srcrect, SDL_Sur
     int dst_pitch = d->pitch;
     Uint32 *src = (Uint32 *)((Uint8 *)s->pixels + srcrect->x * 4 + srcrect->y * src_pitch);
     Uint32 *dst = (Uint32 *)((Uint8 *)d->pixels + dstrect->x * 4 + dstrect->y * dst_pitch);
+    SDL_StretchFilter filter;
+
+    // keep the bilinear path below if the filter tables can't be allocated
+    if (GetDownscaleFilter(src_w, src_h, dst_w, dst_h, &filter)) {
+        result = SDL_SoftStretchSamples((const Uint8 *)src, src_w, src_h, src_pitch, (Uint8 *)dst, dst_w, dst_h, dst_pitch, 4, filter);
+    }
 
 #ifdef SDL_NEON_INTRINSICS
     if (!result && hasNEON()) {
@@ -2949,6 +2949,10 @@ void SDL_DestroySurface(SDL_Surface *surface)
     SDL_DestroyProperties(surface->props);
 
     SDL_InvalidateMap(&surface->map);
+    if (surface->map.info.float_lut) {
+        SDL_free(surface->map.info.float_lut);
+        surface->map.info.float_lut = NULL;
+    }
 
     while (surface->locked > 0) {
         SDL_UnlockSurface(surface);
@@ -90,4 +90,15 @@ extern float SDL_GetSurfaceHDRHeadroom(SDL_Surface *surface, SDL_Colorspace colo
 extern SDL_Surface *SDL_GetSurfaceImage(SDL_Surface *surface, float display_scale);
 extern bool SDL_SoftStretch(SDL_Surface *src, const SDL_Rect *srcrect, SDL_Surface *dst, const SDL_Rect *dstrect, SDL_ScaleMode scaleMode);
 
+// Separable filters used when shrinking, see SDL_HINT_SURFACE_DOWNSCALE_FILTER
+typedef enum SDL_StretchFilter
+{
+    SDL_STRETCH_FILTER_AREA,
+    SDL_STRETCH_FILTER_LANCZOS
+} SDL_StretchFilter;
+
+// Resample 8-bit samples with 1 or 4 interleaved channels, using coefficient tables cached per size pair
+extern bool SDL_SoftStretchSamples(const Uint8 *src, int src_w, int src_h, int src_pitch, Uint8 *dst, int dst_w, int dst_h, int dst_pitch, int channels, SDL_StretchFilter filter);
+extern void SDL_QuitSoftStretch(void);
+
 #endif // SDL_surface_c_h_
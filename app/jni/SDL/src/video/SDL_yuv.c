@@ -22,6 +22,7 @@
 
 #include "SDL_pixels_c.h"
 #include "SDL_yuv_c.h"
+#include "SDL_rowpool_c.h"
 
 #include "yuv2rgb/yuv_rgb.h"
 
@@ -300,6 +301,125 @@ static bool GetYUVPlanes(int width, int height, SDL_PixelFormat format, const vo
     return true;
 }
 
+#ifdef SDL_AVX2_INTRINSICS
+static bool SDL_TARGETING("avx2") yuv_rgb_avx2(
+    SDL_PixelFormat src_format, SDL_PixelFormat dst_format,
+    Uint32 width, Uint32 height,
+    const Uint8 *y, const Uint8 *u, const Uint8 *v, Uint32 y_stride, Uint32 uv_stride,
+    Uint8 *rgb, Uint32 rgb_stride,
+    YCbCrType yuv_type)
+{
+    if (!SDL_HasAVX2()) {
+        return false;
+    }
+
+    if (src_format == SDL_PIXELFORMAT_YV12 ||
+        src_format == SDL_PIXELFORMAT_IYUV) {
+
+        switch (dst_format) {
+        case SDL_PIXELFORMAT_RGB565:
+            yuv420_rgb565_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_RGB24:
+            yuv420_rgb24_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_RGBX8888:
+        case SDL_PIXELFORMAT_RGBA8888:
+            yuv420_rgba_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_BGRX8888:
+        case SDL_PIXELFORMAT_BGRA8888:
+            yuv420_bgra_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_XRGB8888:
+        case SDL_PIXELFORMAT_ARGB8888:
+            yuv420_argb_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_XBGR8888:
+        case SDL_PIXELFORMAT_ABGR8888:
+            yuv420_abgr_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        default:
+            break;
+        }
+    }
+
+    if (src_format == SDL_PIXELFORMAT_YUY2 ||
+        src_format == SDL_PIXELFORMAT_UYVY ||
+        src_format == SDL_PIXELFORMAT_YVYU) {
+
+        switch (dst_format) {
+        case SDL_PIXELFORMAT_RGB565:
+            yuv422_rgb565_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_RGB24:
+            yuv422_rgb24_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_RGBX8888:
+        case SDL_PIXELFORMAT_RGBA8888:
+            yuv422_rgba_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_BGRX8888:
+        case SDL_PIXELFORMAT_BGRA8888:
+            yuv422_bgra_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_XRGB8888:
+        case SDL_PIXELFORMAT_ARGB8888:
+            yuv422_argb_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_XBGR8888:
+        case SDL_PIXELFORMAT_ABGR8888:
+            yuv422_abgr_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        default:
+            break;
+        }
+    }
+
+    if (src_format == SDL_PIXELFORMAT_NV12 ||
+        src_format == SDL_PIXELFORMAT_NV21) {
+
+        switch (dst_format) {
+        case SDL_PIXELFORMAT_RGB565:
+            yuvnv12_rgb565_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_RGB24:
+            yuvnv12_rgb24_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_RGBX8888:
+        case SDL_PIXELFORMAT_RGBA8888:
+            yuvnv12_rgba_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_BGRX8888:
+        case SDL_PIXELFORMAT_BGRA8888:
+            yuvnv12_bgra_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_XRGB8888:
+        case SDL_PIXELFORMAT_ARGB8888:
+            yuvnv12_argb_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_XBGR8888:
+        case SDL_PIXELFORMAT_ABGR8888:
+            yuvnv12_abgr_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        default:
+            break;
+        }
+    }
+    return false;
+}
+#else
+static bool yuv_rgb_avx2(
+    SDL_PixelFormat src_format, SDL_PixelFormat dst_format,
+    Uint32 width, Uint32 height,
+    const Uint8 *y, const Uint8 *u, const Uint8 *v, Uint32 y_stride, Uint32 uv_stride,
+    Uint8 *rgb, Uint32 rgb_stride,
+    YCbCrType yuv_type)
+{
+    return false;
+}
+#endif
+
 #ifdef SDL_SSE2_INTRINSICS
 static bool SDL_TARGETING("sse2") yuv_rgb_sse(
     SDL_PixelFormat src_format, SDL_PixelFormat dst_format,
@@ -584,6 +704,61 @@ static bool yuv_rgb_std(
     return false;
 }
 
+// Try each YUV to RGB implementation in turn, fastest first
+static bool yuv_rgb_rows(
+    SDL_PixelFormat src_format, SDL_PixelFormat dst_format,
+    Uint32 width, Uint32 height,
+    const Uint8 *y, const Uint8 *u, const Uint8 *v, Uint32 y_stride, Uint32 uv_stride,
+    Uint8 *rgb, Uint32 rgb_stride,
+    YCbCrType yuv_type)
+{
+    if (yuv_rgb_avx2(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type)) {
+        return true;
+    }
+
+    if (yuv_rgb_sse(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type)) {
+        return true;
+    }
+
+    if (yuv_rgb_lsx(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type)) {
+        return true;
+    }
+
+    if (yuv_rgb_std(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type)) {
+        return true;
+    }
+    return false;
+}
+
+// A planar YUV to RGB conversion shared by the row pool threads
+typedef struct
+{
+    SDL_PixelFormat src_format;
+    SDL_PixelFormat dst_format;
+    Uint32 width;
+    const Uint8 *y;
+    const Uint8 *u;
+    const Uint8 *v;
+    Uint32 y_stride;
+    Uint32 uv_stride;
+    Uint8 *rgb;
+    Uint32 rgb_stride;
+    YCbCrType yuv_type;
+    SDL_AtomicInt handled;  // whether a kernel supports this format pair; the same for every band
+} YUVToRGBRows;
+
+static void SDLCALL YUVToRGBRowsFunc(void *userdata, int row, int rows)
+{
+    YUVToRGBRows *job = (YUVToRGBRows *)userdata;
+    const size_t uv_offset = (size_t)(row / 2) * job->uv_stride;
+
+    if (yuv_rgb_rows(job->src_format, job->dst_format, job->width, rows,
+                     job->y + (size_t)row * job->y_stride, job->u + uv_offset, job->v + uv_offset, job->y_stride, job->uv_stride,
+                     job->rgb + (size_t)row * job->rgb_stride, job->rgb_stride, job->yuv_type)) {
+        SDL_SetAtomicInt(&job->handled, 1);
+    }
+}
+
 bool SDL_ConvertPixels_YUV_to_RGB(int width, int height,
                                   SDL_PixelFormat src_format, SDL_Colorspace src_colorspace, SDL_PropertiesID src_properties, const void *src, int src_pitch,
                                   SDL_PixelFormat dst_format, SDL_Colorspace dst_colorspace, SDL_PropertiesID dst_properties, void *dst, int dst_pitch)
@@ -593,6 +768,7 @@ bool SDL_ConvertPixels_YUV_to_RGB(int width, int height,
     const Uint8 *v = NULL;
     Uint32 y_stride = 0;
     Uint32 uv_stride = 0;
+    int threads;
 
     if (!GetYUVPlanes(width, height, src_format, src, src_pitch, &y, &u, &v, &y_stride, &uv_stride)) {
         return false;
@@ -605,15 +781,31 @@ bool SDL_ConvertPixels_YUV_to_RGB(int width, int height,
             return false;
         }
 
-        if (yuv_rgb_sse(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, (Uint8 *)dst, dst_pitch, yuv_type)) {
-            return true;
-        }
-
-        if (yuv_rgb_lsx(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, (Uint8 *)dst, dst_pitch, yuv_type)) {
-            return true;
-        }
-
-        if (yuv_rgb_std(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, (Uint8 *)dst, dst_pitch, yuv_type)) {
+        /* The SIMD kernels convert the last row of each call to packed formats with the C fallback,
+         * so only the planar formats can be split into bands without changing the output.
+         */
+        threads = SDL_GetRowPoolThreadCount(SDL_HINT_YUV_CONVERSION_THREADS, width, height);
+        if (threads > 1 && IsPlanar2x2Format(src_format)) {
+            YUVToRGBRows rows;
+
+            rows.src_format = src_format;
+            rows.dst_format = dst_format;
+            rows.width = width;
+            rows.y = y;
+            rows.u = u;
+            rows.v = v;
+            rows.y_stride = y_stride;
+            rows.uv_stride = uv_stride;
+            rows.rgb = (Uint8 *)dst;
+            rows.rgb_stride = dst_pitch;
+            rows.yuv_type = yuv_type;
+            SDL_SetAtomicInt(&rows.handled, 0);
+
+            SDL_RunRowPool(height, 2, threads, YUVToRGBRowsFunc, &rows);
+            if (SDL_GetAtomicInt(&rows.handled)) {
+                return true;
+            }
+        } else if (yuv_rgb_rows(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, (Uint8 *)dst, dst_pitch, yuv_type)) {
             return true;
         }
     }
@@ -707,11 +899,12 @@ static struct RGB2YUVFactors RGB2YUVFactorTables[] = {
     },
 };
 
-static bool SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void *src, int src_pitch, SDL_PixelFormat dst_format, void *dst, int dst_pitch, YCbCrType yuv_type)
+// Convert `rows` rows starting at `row` (a multiple of 2) of an image `height` rows high
+static bool SDL_ConvertPixels_ARGB8888_to_YUV_Rows(int width, int height, int row, int rows, const void *src, int src_pitch, SDL_PixelFormat dst_format, void *dst, int dst_pitch, YCbCrType yuv_type)
 {
     const int src_pitch_x_2 = src_pitch * 2;
-    const int height_half = height / 2;
-    const int height_remainder = (height & 0x1);
+    const int height_half = rows / 2;
+    const int height_remainder = (rows & 0x1);
     const int width_half = width / 2;
     const int width_remainder = (width & 0x1);
     int i, j;
@@ -789,10 +982,17 @@ static bool SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void
         plane_interleaved_uv = (plane_y + height * y_stride);
         y_skip = (y_stride - width);
 
+        // Skip to the first row of the band
+        plane_y += row * y_stride;
+        plane_u += (row / 2) * uv_stride;
+        plane_v += (row / 2) * uv_stride;
+        plane_interleaved_uv += (row / 2) * uv_stride;
+        src = (const Uint8 *)src + row * src_pitch;
+
         curr_row = (const Uint8 *)src;
 
         // Write Y plane
-        for (j = 0; j < height; j++) {
+        for (j = 0; j < rows; j++) {
             for (i = 0; i < width; i++) {
                 const Uint32 p1 = ((const Uint32 *)curr_row)[i];
                 const Uint32 r = (p1 & 0x00ff0000) >> 16;
@@ -906,8 +1106,8 @@ static bool SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void
     case SDL_PIXELFORMAT_UYVY:
     case SDL_PIXELFORMAT_YVYU:
     {
-        const Uint8 *curr_row = (const Uint8 *)src;
-        Uint8 *plane = (Uint8 *)dst;
+        const Uint8 *curr_row = (const Uint8 *)src + row * src_pitch;
+        Uint8 *plane = (Uint8 *)dst + row * dst_pitch;
         const int row_size = (4 * ((width + 1) / 2));
         int plane_skip;
 
@@ -918,7 +1118,7 @@ static bool SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void
 
         // Write YUV plane, packed
         if (dst_format == SDL_PIXELFORMAT_YUY2) {
-            for (j = 0; j < height; j++) {
+            for (j = 0; j < rows; j++) {
                 for (i = 0; i < width_half; i++) {
                     READ_TWO_RGB_PIXELS;
                     // Y U Y1 V
@@ -939,7 +1139,7 @@ static bool SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void
                 curr_row += src_pitch;
             }
         } else if (dst_format == SDL_PIXELFORMAT_UYVY) {
-            for (j = 0; j < height; j++) {
+            for (j = 0; j < rows; j++) {
                 for (i = 0; i < width_half; i++) {
                     READ_TWO_RGB_PIXELS;
                     // U Y V Y1
@@ -960,7 +1160,7 @@ static bool SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void
                 curr_row += src_pitch;
             }
         } else if (dst_format == SDL_PIXELFORMAT_YVYU) {
-            for (j = 0; j < height; j++) {
+            for (j = 0; j < rows; j++) {
                 for (i = 0; i < width_half; i++) {
                     READ_TWO_RGB_PIXELS;
                     // Y V Y1 U
@@ -998,6 +1198,257 @@ static bool SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void
     return true;
 }
 
+// Get the size and byte offsets of the channels of the 8-bit RGB formats the SIMD encoders read directly
+static bool GetRGB8Layout(SDL_PixelFormat format, int *bpp, int *r_offset, int *g_offset, int *b_offset)
+{
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+    switch (format) {
+    case SDL_PIXELFORMAT_XRGB8888:
+    case SDL_PIXELFORMAT_ARGB8888:
+        *bpp = 4;
+        *r_offset = 2;
+        *g_offset = 1;
+        *b_offset = 0;
+        return true;
+    case SDL_PIXELFORMAT_XBGR8888:
+    case SDL_PIXELFORMAT_ABGR8888:
+        *bpp = 4;
+        *r_offset = 0;
+        *g_offset = 1;
+        *b_offset = 2;
+        return true;
+    case SDL_PIXELFORMAT_RGBX8888:
+    case SDL_PIXELFORMAT_RGBA8888:
+        *bpp = 4;
+        *r_offset = 3;
+        *g_offset = 2;
+        *b_offset = 1;
+        return true;
+    case SDL_PIXELFORMAT_BGRX8888:
+    case SDL_PIXELFORMAT_BGRA8888:
+        *bpp = 4;
+        *r_offset = 1;
+        *g_offset = 2;
+        *b_offset = 3;
+        return true;
+    case SDL_PIXELFORMAT_RGB24:
+        *bpp = 3;
+        *r_offset = 0;
+        *g_offset = 1;
+        *b_offset = 2;
+        return true;
+    case SDL_PIXELFORMAT_BGR24:
+        *bpp = 3;
+        *r_offset = 2;
+        *g_offset = 1;
+        *b_offset = 0;
+        return true;
+    default:
+        break;
+    }
+#endif
+    return false;
+}
+
+static Uint8 MakeYUVComponent(const float factors[3], int offset, Uint32 r, Uint32 g, Uint32 b)
+{
+    return (Uint8)((int)(factors[0] * r + factors[1] * g + factors[2] * b + 0.5f) + offset);
+}
+
+// Convert the columns from `x` to the end of a pair of rows the SIMD loop didn't cover; next_row is NULL on an odd last row
+static void RGB8ToYUVPlanarTail(const struct RGB2YUVFactors *cvt, int bpp, int r_offset, int g_offset, int b_offset,
+                                const Uint8 *curr_row, const Uint8 *next_row, int x, int width,
+                                Uint8 *y_row, Uint8 *y_next_row, Uint8 *plane_u, Uint8 *plane_v, int uv_step)
+{
+    for (; x < width; x += 2) {
+        const Uint8 *p = curr_row + x * bpp;
+        Uint32 r = p[r_offset], g = p[g_offset], b = p[b_offset];
+        int shift = 0;
+
+        y_row[x] = MakeYUVComponent(cvt->y, cvt->y_offset, r, g, b);
+        if (x + 1 < width) {
+            p += bpp;
+            y_row[x + 1] = MakeYUVComponent(cvt->y, cvt->y_offset, p[r_offset], p[g_offset], p[b_offset]);
+            r += p[r_offset];
+            g += p[g_offset];
+            b += p[b_offset];
+            ++shift;
+        }
+        if (next_row) {
+            p = next_row + x * bpp;
+            y_next_row[x] = MakeYUVComponent(cvt->y, cvt->y_offset, p[r_offset], p[g_offset], p[b_offset]);
+            r += p[r_offset];
+            g += p[g_offset];
+            b += p[b_offset];
+            if (x + 1 < width) {
+                p += bpp;
+                y_next_row[x + 1] = MakeYUVComponent(cvt->y, cvt->y_offset, p[r_offset], p[g_offset], p[b_offset]);
+                r += p[r_offset];
+                g += p[g_offset];
+                b += p[b_offset];
+            }
+            ++shift;
+        }
+        r >>= shift;
+        g >>= shift;
+        b >>= shift;
+        plane_u[(x / 2) * uv_step] = MakeYUVComponent(cvt->u, 128, r, g, b);
+        plane_v[(x / 2) * uv_step] = MakeYUVComponent(cvt->v, 128, r, g, b);
+    }
+}
+
+// Convert the columns from `x` to the end of a row the SIMD loop didn't cover
+static void RGB8ToYUVPackedTail(const struct RGB2YUVFactors *cvt, int bpp, int r_offset, int g_offset, int b_offset,
+                                const Uint8 *curr_row, int x, int width, Uint8 *plane, SDL_PixelFormat dst_format)
+{
+    for (; x < width; x += 2) {
+        const Uint8 *p = curr_row + x * bpp;
+        const Uint32 r = p[r_offset], g = p[g_offset], b = p[b_offset];
+        const Uint8 Y = MakeYUVComponent(cvt->y, cvt->y_offset, r, g, b);
+        Uint8 Y1 = Y, U, V;
+        Uint8 *out = plane + x * 2;
+
+        if (x + 1 < width) {
+            const Uint32 r1 = p[bpp + r_offset], g1 = p[bpp + g_offset], b1 = p[bpp + b_offset];
+            Y1 = MakeYUVComponent(cvt->y, cvt->y_offset, r1, g1, b1);
+            U = MakeYUVComponent(cvt->u, 128, (r + r1) / 2, (g + g1) / 2, (b + b1) / 2);
+            V = MakeYUVComponent(cvt->v, 128, (r + r1) / 2, (g + g1) / 2, (b + b1) / 2);
+        } else {
+            U = MakeYUVComponent(cvt->u, 128, r, g, b);
+            V = MakeYUVComponent(cvt->v, 128, r, g, b);
+        }
+
+        if (dst_format == SDL_PIXELFORMAT_YUY2) {
+            out[0] = Y;
+            out[1] = U;
+            out[2] = Y1;
+            out[3] = V;
+        } else if (dst_format == SDL_PIXELFORMAT_UYVY) {
+            out[0] = U;
+            out[1] = Y;
+            out[2] = V;
+            out[3] = Y1;
+        } else {
+            out[0] = Y;
+            out[1] = V;
+            out[2] = Y1;
+            out[3] = U;
+        }
+    }
+}
+
+#ifdef SDL_AVX2_INTRINSICS
+#define RGB2YUV_FUNCTION_NAME SDL_ConvertPixels_RGB8_to_YUV_Rows_AVX2
+#define RGB2YUV_TARGET "avx2"
+#define RGB2YUV_256 1
+#include "SDL_rgb2yuv_func.h"
+#endif
+
+#ifdef SDL_SSE4_1_INTRINSICS
+#define RGB2YUV_FUNCTION_NAME SDL_ConvertPixels_RGB8_to_YUV_Rows_SSE41
+#define RGB2YUV_TARGET "sse4.1"
+#define RGB2YUV_256 0
+#include "SDL_rgb2yuv_func.h"
+#endif
+
+// Whether a SIMD encoder can convert straight from src_format to dst_format on this CPU
+static bool HasRGB8ToYUVSIMD(SDL_PixelFormat src_format, SDL_PixelFormat dst_format)
+{
+    int bpp, r_offset, g_offset, b_offset;
+
+    if (!GetRGB8Layout(src_format, &bpp, &r_offset, &g_offset, &b_offset)) {
+        return false;
+    }
+    if (!(IsPlanar2x2Format(dst_format) && dst_format != SDL_PIXELFORMAT_P010) && !IsPacked4Format(dst_format)) {
+        return false;
+    }
+#ifdef SDL_AVX2_INTRINSICS
+    if (SDL_HasAVX2()) {
+        return true;
+    }
+#endif
+#ifdef SDL_SSE4_1_INTRINSICS
+    if (SDL_HasSSE41()) {
+        return true;
+    }
+#endif
+    return false;
+}
+
+static bool SDL_ConvertPixels_RGB8_to_YUV_Rows(int width, int height, int row, int rows, SDL_PixelFormat src_format, const void *src, int src_pitch, SDL_PixelFormat dst_format, void *dst, int dst_pitch, YCbCrType yuv_type)
+{
+    if (!HasRGB8ToYUVSIMD(src_format, dst_format)) {
+        // Only ARGB8888 sources get here without SIMD support
+        return SDL_ConvertPixels_ARGB8888_to_YUV_Rows(width, height, row, rows, src, src_pitch, dst_format, dst, dst_pitch, yuv_type);
+    }
+#ifdef SDL_AVX2_INTRINSICS
+    if (SDL_HasAVX2()) {
+        return SDL_ConvertPixels_RGB8_to_YUV_Rows_AVX2(width, height, row, rows, src_format, src, src_pitch, dst_format, dst, dst_pitch, yuv_type);
+    }
+#endif
+#ifdef SDL_SSE4_1_INTRINSICS
+    if (SDL_HasSSE41()) {
+        return SDL_ConvertPixels_RGB8_to_YUV_Rows_SSE41(width, height, row, rows, src_format, src, src_pitch, dst_format, dst, dst_pitch, yuv_type);
+    }
+#endif
+    return false;
+}
+
+// An 8-bit RGB to YUV conversion shared by the row pool threads
+typedef struct
+{
+    int width;
+    int height;
+    SDL_PixelFormat src_format;
+    const void *src;
+    int src_pitch;
+    SDL_PixelFormat dst_format;
+    void *dst;
+    int dst_pitch;
+    YCbCrType yuv_type;
+} RGB8ToYUVRows;
+
+static void SDLCALL RGB8ToYUVRowsFunc(void *userdata, int row, int rows)
+{
+    RGB8ToYUVRows *job = (RGB8ToYUVRows *)userdata;
+
+    SDL_ConvertPixels_RGB8_to_YUV_Rows(job->width, job->height, row, rows, job->src_format, job->src, job->src_pitch, job->dst_format, job->dst, job->dst_pitch, job->yuv_type);
+}
+
+/* Convert from ARGB8888, or from any format GetRGB8Layout() knows if HasRGB8ToYUVSIMD() says so,
+ * using the SIMD encoders when the CPU has them.
+ */
+static bool SDL_ConvertPixels_RGB8_to_YUV(int width, int height, SDL_PixelFormat src_format, const void *src, int src_pitch, SDL_PixelFormat dst_format, void *dst, int dst_pitch, YCbCrType yuv_type)
+{
+    const int threads = SDL_GetRowPoolThreadCount(SDL_HINT_YUV_CONVERSION_THREADS, width, height);
+
+    // Errors can't be reported from the pool threads, so only formats that can't fail are split into bands
+    if (threads > 1 &&
+        ((IsPlanar2x2Format(dst_format) && dst_format != SDL_PIXELFORMAT_P010) ||
+         (IsPacked4Format(dst_format) && dst_pitch >= 4 * ((width + 1) / 2)))) {
+        RGB8ToYUVRows rows;
+
+        rows.width = width;
+        rows.height = height;
+        rows.src_format = src_format;
+        rows.src = src;
+        rows.src_pitch = src_pitch;
+        rows.dst_format = dst_format;
+        rows.dst = dst;
+        rows.dst_pitch = dst_pitch;
+        rows.yuv_type = yuv_type;
+
+        SDL_RunRowPool(height, 2, threads, RGB8ToYUVRowsFunc, &rows);
+        return true;
+    }
+    return SDL_ConvertPixels_RGB8_to_YUV_Rows(width, height, 0, height, src_format, src, src_pitch, dst_format, dst, dst_pitch, yuv_type);
+}
+
+static bool SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void *src, int src_pitch, SDL_PixelFormat dst_format, void *dst, int dst_pitch, YCbCrType yuv_type)
+{
+    return SDL_ConvertPixels_RGB8_to_YUV(width, height, SDL_PIXELFORMAT_ARGB8888, src, src_pitch, dst_format, dst, dst_pitch, yuv_type);
+}
+
 static bool SDL_ConvertPixels_XBGR2101010_to_P010(int width, int height, const void *src, int src_pitch, SDL_PixelFormat dst_format, void *dst, int dst_pitch, YCbCrType yuv_type)
 {
     const int src_pitch_x_2 = src_pitch * 2;
@@ -1148,6 +1599,15 @@ bool SDL_ConvertPixels_RGB_to_YUV(int width, int height,
     }
 #endif
 
+    /* 8-bit RGB to FOURCC with the SIMD encoders, without an intermediate ARGB8888 copy.
+     * Other formats are only read directly when converting them to ARGB8888 wouldn't change the colors.
+     */
+    if (HasRGB8ToYUVSIMD(src_format, dst_format) &&
+        SDL_COLORSPACEPRIMARIES(src_colorspace) == SDL_COLORSPACEPRIMARIES(dst_colorspace) &&
+        (src_format == SDL_PIXELFORMAT_ARGB8888 || src_colorspace == dst_colorspace)) {
+        return SDL_ConvertPixels_RGB8_to_YUV(width, height, src_format, src, src_pitch, dst_format, dst, dst_pitch, yuv_type);
+    }
+
     // ARGB8888 to FOURCC
     if (src_format == SDL_PIXELFORMAT_ARGB8888 &&
         SDL_COLORSPACEPRIMARIES(src_colorspace) == SDL_COLORSPACEPRIMARIES(dst_colorspace)) {
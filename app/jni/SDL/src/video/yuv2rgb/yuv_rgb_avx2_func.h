@@ -0,0 +1,481 @@
+// Copyright 2016 Adrien Descamps
+// Distributed under BSD 3-Clause License
+
+/* You need to define the following macros before including this file:
+	AVX2_FUNCTION_NAME
+	STD_FUNCTION_NAME
+	YUV_FORMAT
+	RGB_FORMAT
+*/
+
+/* This is the 256-bit version of yuv_rgb_sse_func.h: it processes the same
+ * 32 pixels x 2 lines blocks with the same 16-bit fixed point arithmetic, so
+ * its output is identical to the SSE2 and standard versions.
+ * AVX2 instructions work within 128-bit lanes; the permutes below put the
+ * samples back in memory order where the lanes would otherwise mix them.
+ */
+
+#define LOAD_SI256 _mm256_loadu_si256
+#define SAVE_SI256 _mm256_storeu_si256
+#define SAVE_SI128 _mm_storeu_si128
+
+#define UV2RGB_32(U,V,R1,G1,B1,R2,G2,B2) \
+	r_tmp = _mm256_mullo_epi16(V, _mm256_set1_epi16(param->v_r_factor)); \
+	g_tmp = _mm256_add_epi16( \
+		_mm256_mullo_epi16(U, _mm256_set1_epi16(param->u_g_factor)), \
+		_mm256_mullo_epi16(V, _mm256_set1_epi16(param->v_g_factor))); \
+	b_tmp = _mm256_mullo_epi16(U, _mm256_set1_epi16(param->u_b_factor)); \
+	/* chroma samples 0-3 and 8-11 to lane 0, 4-7 and 12-15 to lane 1 */ \
+	r_tmp = _mm256_permute4x64_epi64(r_tmp, 0xD8); \
+	g_tmp = _mm256_permute4x64_epi64(g_tmp, 0xD8); \
+	b_tmp = _mm256_permute4x64_epi64(b_tmp, 0xD8); \
+	/* each chroma sample covers two pixels: pixels 0-15, then 16-31 */ \
+	R1 = _mm256_unpacklo_epi16(r_tmp, r_tmp); \
+	G1 = _mm256_unpacklo_epi16(g_tmp, g_tmp); \
+	B1 = _mm256_unpacklo_epi16(b_tmp, b_tmp); \
+	R2 = _mm256_unpackhi_epi16(r_tmp, r_tmp); \
+	G2 = _mm256_unpackhi_epi16(g_tmp, g_tmp); \
+	B2 = _mm256_unpackhi_epi16(b_tmp, b_tmp); \
+
+#define ADD_Y2RGB_32(Y1,Y2,R1,G1,B1,R2,G2,B2) \
+	Y1 = _mm256_mullo_epi16(_mm256_sub_epi16(Y1, _mm256_set1_epi16(param->y_shift)), _mm256_set1_epi16(param->y_factor)); \
+	Y2 = _mm256_mullo_epi16(_mm256_sub_epi16(Y2, _mm256_set1_epi16(param->y_shift)), _mm256_set1_epi16(param->y_factor)); \
+	\
+	R1 = _mm256_srai_epi16(_mm256_add_epi16(R1, Y1), PRECISION); \
+	G1 = _mm256_srai_epi16(_mm256_add_epi16(G1, Y1), PRECISION); \
+	B1 = _mm256_srai_epi16(_mm256_add_epi16(B1, Y1), PRECISION); \
+	R2 = _mm256_srai_epi16(_mm256_add_epi16(R2, Y2), PRECISION); \
+	G2 = _mm256_srai_epi16(_mm256_add_epi16(G2, Y2), PRECISION); \
+	B2 = _mm256_srai_epi16(_mm256_add_epi16(B2, Y2), PRECISION); \
+
+/* Saturate pixels 0-15 and 16-31 to 8 bits, in memory order */
+#define PACKUS_32(X1, X2) \
+	_mm256_permute4x64_epi64(_mm256_packus_epi16(X1, X2), 0xD8)
+
+#define PACK_RGB565_32(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4) \
+{ \
+	__m128i red_mask, tmp1, tmp2, tmp3, tmp4; \
+\
+	red_mask = _mm_set1_epi16((unsigned short)0xF800); \
+	RGB1 = _mm_and_si128(_mm_unpacklo_epi8(_mm_setzero_si128(), R1), red_mask); \
+	RGB2 = _mm_and_si128(_mm_unpackhi_epi8(_mm_setzero_si128(), R1), red_mask); \
+	RGB3 = _mm_and_si128(_mm_unpacklo_epi8(_mm_setzero_si128(), R2), red_mask); \
+	RGB4 = _mm_and_si128(_mm_unpackhi_epi8(_mm_setzero_si128(), R2), red_mask); \
+	tmp1 = _mm_slli_epi16(_mm_srli_epi16(_mm_unpacklo_epi8(G1, _mm_setzero_si128()), 2), 5); \
+	tmp2 = _mm_slli_epi16(_mm_srli_epi16(_mm_unpackhi_epi8(G1, _mm_setzero_si128()), 2), 5); \
+	tmp3 = _mm_slli_epi16(_mm_srli_epi16(_mm_unpacklo_epi8(G2, _mm_setzero_si128()), 2), 5); \
+	tmp4 = _mm_slli_epi16(_mm_srli_epi16(_mm_unpackhi_epi8(G2, _mm_setzero_si128()), 2), 5); \
+	RGB1 = _mm_or_si128(RGB1, tmp1); \
+	RGB2 = _mm_or_si128(RGB2, tmp2); \
+	RGB3 = _mm_or_si128(RGB3, tmp3); \
+	RGB4 = _mm_or_si128(RGB4, tmp4); \
+	tmp1 = _mm_srli_epi16(_mm_unpacklo_epi8(B1, _mm_setzero_si128()), 3); \
+	tmp2 = _mm_srli_epi16(_mm_unpackhi_epi8(B1, _mm_setzero_si128()), 3); \
+	tmp3 = _mm_srli_epi16(_mm_unpacklo_epi8(B2, _mm_setzero_si128()), 3); \
+	tmp4 = _mm_srli_epi16(_mm_unpackhi_epi8(B2, _mm_setzero_si128()), 3); \
+	RGB1 = _mm_or_si128(RGB1, tmp1); \
+	RGB2 = _mm_or_si128(RGB2, tmp2); \
+	RGB3 = _mm_or_si128(RGB3, tmp3); \
+	RGB4 = _mm_or_si128(RGB4, tmp4); \
+}
+
+#define PACK_RGB24_32_STEP1(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+RGB1 = _mm_packus_epi16(_mm_and_si128(R1,_mm_set1_epi16(0xFF)), _mm_and_si128(R2,_mm_set1_epi16(0xFF))); \
+RGB2 = _mm_packus_epi16(_mm_and_si128(G1,_mm_set1_epi16(0xFF)), _mm_and_si128(G2,_mm_set1_epi16(0xFF))); \
+RGB3 = _mm_packus_epi16(_mm_and_si128(B1,_mm_set1_epi16(0xFF)), _mm_and_si128(B2,_mm_set1_epi16(0xFF))); \
+RGB4 = _mm_packus_epi16(_mm_srli_epi16(R1,8), _mm_srli_epi16(R2,8)); \
+RGB5 = _mm_packus_epi16(_mm_srli_epi16(G1,8), _mm_srli_epi16(G2,8)); \
+RGB6 = _mm_packus_epi16(_mm_srli_epi16(B1,8), _mm_srli_epi16(B2,8)); \
+
+#define PACK_RGB24_32_STEP2(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+R1 = _mm_packus_epi16(_mm_and_si128(RGB1,_mm_set1_epi16(0xFF)), _mm_and_si128(RGB2,_mm_set1_epi16(0xFF))); \
+R2 = _mm_packus_epi16(_mm_and_si128(RGB3,_mm_set1_epi16(0xFF)), _mm_and_si128(RGB4,_mm_set1_epi16(0xFF))); \
+G1 = _mm_packus_epi16(_mm_and_si128(RGB5,_mm_set1_epi16(0xFF)), _mm_and_si128(RGB6,_mm_set1_epi16(0xFF))); \
+G2 = _mm_packus_epi16(_mm_srli_epi16(RGB1,8), _mm_srli_epi16(RGB2,8)); \
+B1 = _mm_packus_epi16(_mm_srli_epi16(RGB3,8), _mm_srli_epi16(RGB4,8)); \
+B2 = _mm_packus_epi16(_mm_srli_epi16(RGB5,8), _mm_srli_epi16(RGB6,8)); \
+
+#define PACK_RGB24_32(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+PACK_RGB24_32_STEP1(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+PACK_RGB24_32_STEP2(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+PACK_RGB24_32_STEP1(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+PACK_RGB24_32_STEP2(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+PACK_RGB24_32_STEP1(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+
+/* Interleave 32 pixels into four registers of 8 pixels each, in memory order */
+#define PACK_RGBA_32(C1, C2, C3, C4, RGB1, RGB2, RGB3, RGB4) \
+{ \
+	__m256i lo_12, hi_12, lo_34, hi_34, tmp1, tmp2, tmp3, tmp4; \
+\
+	lo_12 = _mm256_unpacklo_epi8( C1, C2 ); \
+	hi_12 = _mm256_unpackhi_epi8( C1, C2 ); \
+	lo_34 = _mm256_unpacklo_epi8( C3, C4 ); \
+	hi_34 = _mm256_unpackhi_epi8( C3, C4 ); \
+	tmp1 = _mm256_unpacklo_epi16( lo_12, lo_34 ); /* pixels 0-3, 16-19 */ \
+	tmp2 = _mm256_unpackhi_epi16( lo_12, lo_34 ); /* pixels 4-7, 20-23 */ \
+	tmp3 = _mm256_unpacklo_epi16( hi_12, hi_34 ); /* pixels 8-11, 24-27 */ \
+	tmp4 = _mm256_unpackhi_epi16( hi_12, hi_34 ); /* pixels 12-15, 28-31 */ \
+	RGB1 = _mm256_permute2x128_si256( tmp1, tmp2, 0x20 ); \
+	RGB2 = _mm256_permute2x128_si256( tmp3, tmp4, 0x20 ); \
+	RGB3 = _mm256_permute2x128_si256( tmp1, tmp2, 0x31 ); \
+	RGB4 = _mm256_permute2x128_si256( tmp3, tmp4, 0x31 ); \
+}
+
+#if RGB_FORMAT == RGB_FORMAT_RGB565 || RGB_FORMAT == RGB_FORMAT_RGB24
+
+/* The narrow formats are packed 16 pixels at a time, as in the SSE2 version */
+#define SPLIT_LINES \
+	__m128i r_8_11 = _mm256_castsi256_si128(r_8_1), r_8_12 = _mm256_extracti128_si256(r_8_1, 1); \
+	__m128i g_8_11 = _mm256_castsi256_si128(g_8_1), g_8_12 = _mm256_extracti128_si256(g_8_1, 1); \
+	__m128i b_8_11 = _mm256_castsi256_si128(b_8_1), b_8_12 = _mm256_extracti128_si256(b_8_1, 1); \
+	__m128i r_8_21 = _mm256_castsi256_si128(r_8_2), r_8_22 = _mm256_extracti128_si256(r_8_2, 1); \
+	__m128i g_8_21 = _mm256_castsi256_si128(g_8_2), g_8_22 = _mm256_extracti128_si256(g_8_2, 1); \
+	__m128i b_8_21 = _mm256_castsi256_si128(b_8_2), b_8_22 = _mm256_extracti128_si256(b_8_2, 1); \
+
+#endif
+
+#if RGB_FORMAT == RGB_FORMAT_RGB565
+
+#define PACK_PIXEL \
+	__m128i rgb_1, rgb_2, rgb_3, rgb_4, rgb_5, rgb_6, rgb_7, rgb_8; \
+	SPLIT_LINES \
+	\
+	PACK_RGB565_32(r_8_11, r_8_12, g_8_11, g_8_12, b_8_11, b_8_12, rgb_1, rgb_2, rgb_3, rgb_4) \
+	\
+	PACK_RGB565_32(r_8_21, r_8_22, g_8_21, g_8_22, b_8_21, b_8_22, rgb_5, rgb_6, rgb_7, rgb_8) \
+
+#elif RGB_FORMAT == RGB_FORMAT_RGB24
+
+#define PACK_PIXEL \
+	__m128i rgb_1, rgb_2, rgb_3, rgb_4, rgb_5, rgb_6; \
+	__m128i rgb_7, rgb_8, rgb_9, rgb_10, rgb_11, rgb_12; \
+	SPLIT_LINES \
+	\
+	PACK_RGB24_32(r_8_11, r_8_12, g_8_11, g_8_12, b_8_11, b_8_12, rgb_1, rgb_2, rgb_3, rgb_4, rgb_5, rgb_6) \
+	\
+	PACK_RGB24_32(r_8_21, r_8_22, g_8_21, g_8_22, b_8_21, b_8_22, rgb_7, rgb_8, rgb_9, rgb_10, rgb_11, rgb_12) \
+
+#elif RGB_FORMAT == RGB_FORMAT_RGBA
+
+#define PACK_PIXEL \
+	__m256i rgb_1, rgb_2, rgb_3, rgb_4, rgb_5, rgb_6, rgb_7, rgb_8; \
+	__m256i a = _mm256_set1_epi8((char)0xFF); \
+	\
+	PACK_RGBA_32(a, b_8_1, g_8_1, r_8_1, rgb_1, rgb_2, rgb_3, rgb_4) \
+	\
+	PACK_RGBA_32(a, b_8_2, g_8_2, r_8_2, rgb_5, rgb_6, rgb_7, rgb_8) \
+
+#elif RGB_FORMAT == RGB_FORMAT_BGRA
+
+#define PACK_PIXEL \
+	__m256i rgb_1, rgb_2, rgb_3, rgb_4, rgb_5, rgb_6, rgb_7, rgb_8; \
+	__m256i a = _mm256_set1_epi8((char)0xFF); \
+	\
+	PACK_RGBA_32(a, r_8_1, g_8_1, b_8_1, rgb_1, rgb_2, rgb_3, rgb_4) \
+	\
+	PACK_RGBA_32(a, r_8_2, g_8_2, b_8_2, rgb_5, rgb_6, rgb_7, rgb_8) \
+
+#elif RGB_FORMAT == RGB_FORMAT_ARGB
+
+#define PACK_PIXEL \
+	__m256i rgb_1, rgb_2, rgb_3, rgb_4, rgb_5, rgb_6, rgb_7, rgb_8; \
+	__m256i a = _mm256_set1_epi8((char)0xFF); \
+	\
+	PACK_RGBA_32(b_8_1, g_8_1, r_8_1, a, rgb_1, rgb_2, rgb_3, rgb_4) \
+	\
+	PACK_RGBA_32(b_8_2, g_8_2, r_8_2, a, rgb_5, rgb_6, rgb_7, rgb_8) \
+
+#elif RGB_FORMAT == RGB_FORMAT_ABGR
+
+#define PACK_PIXEL \
+	__m256i rgb_1, rgb_2, rgb_3, rgb_4, rgb_5, rgb_6, rgb_7, rgb_8; \
+	__m256i a = _mm256_set1_epi8((char)0xFF); \
+	\
+	PACK_RGBA_32(r_8_1, g_8_1, b_8_1, a, rgb_1, rgb_2, rgb_3, rgb_4) \
+	\
+	PACK_RGBA_32(r_8_2, g_8_2, b_8_2, a, rgb_5, rgb_6, rgb_7, rgb_8) \
+
+#else
+#error PACK_PIXEL unimplemented
+#endif
+
+#if RGB_FORMAT == RGB_FORMAT_RGB565
+
+#define SAVE_LINE1 \
+	SAVE_SI128((__m128i*)(rgb_ptr1), rgb_1); \
+	SAVE_SI128((__m128i*)(rgb_ptr1+16), rgb_2); \
+	SAVE_SI128((__m128i*)(rgb_ptr1+32), rgb_3); \
+	SAVE_SI128((__m128i*)(rgb_ptr1+48), rgb_4); \
+
+#define SAVE_LINE2 \
+	SAVE_SI128((__m128i*)(rgb_ptr2), rgb_5); \
+	SAVE_SI128((__m128i*)(rgb_ptr2+16), rgb_6); \
+	SAVE_SI128((__m128i*)(rgb_ptr2+32), rgb_7); \
+	SAVE_SI128((__m128i*)(rgb_ptr2+48), rgb_8); \
+
+#elif RGB_FORMAT == RGB_FORMAT_RGB24
+
+#define SAVE_LINE1 \
+	SAVE_SI128((__m128i*)(rgb_ptr1), rgb_1); \
+	SAVE_SI128((__m128i*)(rgb_ptr1+16), rgb_2); \
+	SAVE_SI128((__m128i*)(rgb_ptr1+32), rgb_3); \
+	SAVE_SI128((__m128i*)(rgb_ptr1+48), rgb_4); \
+	SAVE_SI128((__m128i*)(rgb_ptr1+64), rgb_5); \
+	SAVE_SI128((__m128i*)(rgb_ptr1+80), rgb_6); \
+
+#define SAVE_LINE2 \
+	SAVE_SI128((__m128i*)(rgb_ptr2), rgb_7); \
+	SAVE_SI128((__m128i*)(rgb_ptr2+16), rgb_8); \
+	SAVE_SI128((__m128i*)(rgb_ptr2+32), rgb_9); \
+	SAVE_SI128((__m128i*)(rgb_ptr2+48), rgb_10); \
+	SAVE_SI128((__m128i*)(rgb_ptr2+64), rgb_11); \
+	SAVE_SI128((__m128i*)(rgb_ptr2+80), rgb_12); \
+
+#elif RGB_FORMAT == RGB_FORMAT_RGBA || RGB_FORMAT == RGB_FORMAT_BGRA || \
+      RGB_FORMAT == RGB_FORMAT_ARGB || RGB_FORMAT == RGB_FORMAT_ABGR
+
+#define SAVE_LINE1 \
+	SAVE_SI256((__m256i*)(rgb_ptr1), rgb_1); \
+	SAVE_SI256((__m256i*)(rgb_ptr1+32), rgb_2); \
+	SAVE_SI256((__m256i*)(rgb_ptr1+64), rgb_3); \
+	SAVE_SI256((__m256i*)(rgb_ptr1+96), rgb_4); \
+
+#define SAVE_LINE2 \
+	SAVE_SI256((__m256i*)(rgb_ptr2), rgb_5); \
+	SAVE_SI256((__m256i*)(rgb_ptr2+32), rgb_6); \
+	SAVE_SI256((__m256i*)(rgb_ptr2+64), rgb_7); \
+	SAVE_SI256((__m256i*)(rgb_ptr2+96), rgb_8); \
+
+#else
+#error SAVE_LINE unimplemented
+#endif
+
+/* READ_Y reads 32 luma samples into y_16_1 (pixels 0-15) and y_16_2 (pixels 16-31),
+ * READ_UV reads 16 chroma samples into u_16 and v_16, all as 16-bit values.
+ */
+#if YUV_FORMAT == YUV_FORMAT_420
+
+#define READ_Y(y_ptr) \
+	y_16_1 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(y_ptr))); \
+	y_16_2 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(y_ptr+16))); \
+
+#define READ_UV	\
+	u_16 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(u_ptr))); \
+	v_16 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(v_ptr))); \
+
+#elif YUV_FORMAT == YUV_FORMAT_422
+
+#define READ_Y(y_ptr) \
+	y_16_1 = _mm256_and_si256(LOAD_SI256((const __m256i*)(y_ptr)), _mm256_set1_epi16(0xFF)); \
+	y_16_2 = _mm256_and_si256(LOAD_SI256((const __m256i*)(y_ptr+32)), _mm256_set1_epi16(0xFF)); \
+
+#define READ_UV	\
+{ \
+	__m256i u1, u2, v1, v2; \
+	u1 = _mm256_and_si256(LOAD_SI256((const __m256i*)(u_ptr)), _mm256_set1_epi32(0xFF)); \
+	u2 = _mm256_and_si256(LOAD_SI256((const __m256i*)(u_ptr+32)), _mm256_set1_epi32(0xFF)); \
+	u_16 = _mm256_permute4x64_epi64(_mm256_packs_epi32(u1, u2), 0xD8); \
+	v1 = _mm256_and_si256(LOAD_SI256((const __m256i*)(v_ptr)), _mm256_set1_epi32(0xFF)); \
+	v2 = _mm256_and_si256(LOAD_SI256((const __m256i*)(v_ptr+32)), _mm256_set1_epi32(0xFF)); \
+	v_16 = _mm256_permute4x64_epi64(_mm256_packs_epi32(v1, v2), 0xD8); \
+}
+
+#elif YUV_FORMAT == YUV_FORMAT_NV12
+
+#define READ_Y(y_ptr) \
+	y_16_1 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(y_ptr))); \
+	y_16_2 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(y_ptr+16))); \
+
+#define READ_UV	\
+	u_16 = _mm256_and_si256(LOAD_SI256((const __m256i*)(u_ptr)), _mm256_set1_epi16(0xFF)); \
+	v_16 = _mm256_and_si256(LOAD_SI256((const __m256i*)(v_ptr)), _mm256_set1_epi16(0xFF)); \
+
+#else
+#error READ_UV unimplemented
+#endif
+
+#define YUV2RGB_32 \
+	__m256i r_tmp, g_tmp, b_tmp; \
+	__m256i r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2; \
+	__m256i r_uv_16_1, g_uv_16_1, b_uv_16_1, r_uv_16_2, g_uv_16_2, b_uv_16_2; \
+	__m256i y_16_1, y_16_2; \
+	__m256i u_16, v_16; \
+	__m256i r_8_1, g_8_1, b_8_1, r_8_2, g_8_2, b_8_2; \
+	\
+	READ_UV \
+	u_16 = _mm256_add_epi16(u_16, _mm256_set1_epi16(-128)); \
+	v_16 = _mm256_add_epi16(v_16, _mm256_set1_epi16(-128)); \
+	\
+	UV2RGB_32(u_16, v_16, r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2) \
+	r_uv_16_1=r_16_1; g_uv_16_1=g_16_1; b_uv_16_1=b_16_1; \
+	r_uv_16_2=r_16_2; g_uv_16_2=g_16_2; b_uv_16_2=b_16_2; \
+	\
+	/* process 32 pixels of first line */\
+	READ_Y(y_ptr1) \
+	ADD_Y2RGB_32(y_16_1, y_16_2, r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2) \
+	\
+	r_8_1 = PACKUS_32(r_16_1, r_16_2); \
+	g_8_1 = PACKUS_32(g_16_1, g_16_2); \
+	b_8_1 = PACKUS_32(b_16_1, b_16_2); \
+	\
+	/* process 32 pixels of second line */\
+	r_16_1=r_uv_16_1; g_16_1=g_uv_16_1; b_16_1=b_uv_16_1; \
+	r_16_2=r_uv_16_2; g_16_2=g_uv_16_2; b_16_2=b_uv_16_2; \
+	\
+	READ_Y(y_ptr2) \
+	ADD_Y2RGB_32(y_16_1, y_16_2, r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2) \
+	\
+	r_8_2 = PACKUS_32(r_16_1, r_16_2); \
+	g_8_2 = PACKUS_32(g_16_1, g_16_2); \
+	b_8_2 = PACKUS_32(b_16_1, b_16_2); \
+	\
+
+
+void SDL_TARGETING("avx2") AVX2_FUNCTION_NAME(uint32_t width, uint32_t height,
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride,
+	uint8_t *RGB, uint32_t RGB_stride,
+	YCbCrType yuv_type)
+{
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+#if YUV_FORMAT == YUV_FORMAT_420
+	const int y_pixel_stride = 1;
+	const int uv_pixel_stride = 1;
+	const int uv_x_sample_interval = 2;
+	const int uv_y_sample_interval = 2;
+#elif YUV_FORMAT == YUV_FORMAT_422
+	const int y_pixel_stride = 2;
+	const int uv_pixel_stride = 4;
+	const int uv_x_sample_interval = 2;
+	const int uv_y_sample_interval = 1;
+#elif YUV_FORMAT == YUV_FORMAT_NV12
+	const int y_pixel_stride = 1;
+	const int uv_pixel_stride = 2;
+	const int uv_x_sample_interval = 2;
+	const int uv_y_sample_interval = 2;
+#endif
+#if RGB_FORMAT == RGB_FORMAT_RGB565
+	const int rgb_pixel_stride = 2;
+#elif RGB_FORMAT == RGB_FORMAT_RGB24
+	const int rgb_pixel_stride = 3;
+#elif RGB_FORMAT == RGB_FORMAT_RGBA || RGB_FORMAT == RGB_FORMAT_BGRA || \
+      RGB_FORMAT == RGB_FORMAT_ARGB || RGB_FORMAT == RGB_FORMAT_ABGR
+	const int rgb_pixel_stride = 4;
+#else
+#error Unknown RGB pixel size
+#endif
+
+#if YUV_FORMAT == YUV_FORMAT_NV12
+	/* For NV12 formats (where U/V are interleaved)
+	 * READ_UV does an invalid read access at the very last pixel.
+	 * As a workaround. Make sure not to decode the last column using assembly but with STD fallback path.
+	 * see https://github.com/libsdl-org/SDL/issues/4841
+	 */
+	const int fix_read_nv12 = ((width & 31) == 0);
+#else
+	const int fix_read_nv12 = 0;
+#endif
+
+#if YUV_FORMAT == YUV_FORMAT_422
+	/* Avoid invalid read on last line */
+	const int fix_read_422 = 1;
+#else
+	const int fix_read_422 = 0;
+#endif
+
+
+	if (width >= 32) {
+		uint32_t xpos, ypos;
+		for(ypos=0; ypos<(height-(uv_y_sample_interval-1)) - fix_read_422; ypos+=uv_y_sample_interval)
+		{
+			const uint8_t *y_ptr1=Y+ypos*Y_stride,
+				*y_ptr2=Y+(ypos+1)*Y_stride,
+				*u_ptr=U+(ypos/uv_y_sample_interval)*UV_stride,
+				*v_ptr=V+(ypos/uv_y_sample_interval)*UV_stride;
+
+			uint8_t *rgb_ptr1=RGB+ypos*RGB_stride,
+				*rgb_ptr2=RGB+(ypos+1)*RGB_stride;
+
+			for(xpos=0; xpos<(width-31) - fix_read_nv12; xpos+=32)
+			{
+				YUV2RGB_32
+				{
+					PACK_PIXEL
+					SAVE_LINE1
+					if (uv_y_sample_interval > 1)
+					{
+						SAVE_LINE2
+					}
+				}
+
+				y_ptr1+=32*y_pixel_stride;
+				y_ptr2+=32*y_pixel_stride;
+				u_ptr+=32*uv_pixel_stride/uv_x_sample_interval;
+				v_ptr+=32*uv_pixel_stride/uv_x_sample_interval;
+				rgb_ptr1+=32*rgb_pixel_stride;
+				rgb_ptr2+=32*rgb_pixel_stride;
+			}
+		}
+
+		if (fix_read_422) {
+			const uint8_t *y_ptr=Y+ypos*Y_stride,
+				*u_ptr=U+(ypos/uv_y_sample_interval)*UV_stride,
+				*v_ptr=V+(ypos/uv_y_sample_interval)*UV_stride;
+			uint8_t *rgb_ptr=RGB+ypos*RGB_stride;
+			STD_FUNCTION_NAME(width, 1, y_ptr, u_ptr, v_ptr, Y_stride, UV_stride, rgb_ptr, RGB_stride, yuv_type);
+			ypos += uv_y_sample_interval;
+		}
+
+		/* Catch the last line, if needed */
+		if (uv_y_sample_interval == 2 && ypos == (height-1))
+		{
+			const uint8_t *y_ptr=Y+ypos*Y_stride,
+				*u_ptr=U+(ypos/uv_y_sample_interval)*UV_stride,
+				*v_ptr=V+(ypos/uv_y_sample_interval)*UV_stride;
+
+			uint8_t *rgb_ptr=RGB+ypos*RGB_stride;
+
+			STD_FUNCTION_NAME(width, 1, y_ptr, u_ptr, v_ptr, Y_stride, UV_stride, rgb_ptr, RGB_stride, yuv_type);
+		}
+	}
+
+	/* Catch the right column, if needed */
+	{
+		uint32_t converted = (width & ~31);
+		if (fix_read_nv12) {
+			converted -= 32;
+		}
+		if (converted != width)
+		{
+			const uint8_t *y_ptr=Y+converted*y_pixel_stride,
+				*u_ptr=U+converted*uv_pixel_stride/uv_x_sample_interval,
+				*v_ptr=V+converted*uv_pixel_stride/uv_x_sample_interval;
+
+			uint8_t *rgb_ptr=RGB+converted*rgb_pixel_stride;
+
+			STD_FUNCTION_NAME(width-converted, height, y_ptr, u_ptr, v_ptr, Y_stride, UV_stride, rgb_ptr, RGB_stride, yuv_type);
+		}
+	}
+}
+
+#undef AVX2_FUNCTION_NAME
+#undef STD_FUNCTION_NAME
+#undef YUV_FORMAT
+#undef RGB_FORMAT
+#undef LOAD_SI256
+#undef SAVE_SI256
+#undef SAVE_SI128
+#undef UV2RGB_32
+#undef ADD_Y2RGB_32
+#undef PACKUS_32
+#undef PACK_RGB565_32
+#undef PACK_RGB24_32_STEP1
+#undef PACK_RGB24_32_STEP2
+#undef PACK_RGB24_32
+#undef PACK_RGBA_32
+#undef SPLIT_LINES
+#undef PACK_PIXEL
+#undef SAVE_LINE1
+#undef SAVE_LINE2
+#undef READ_Y
+#undef READ_UV
+#undef YUV2RGB_32
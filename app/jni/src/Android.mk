@@ -6,7 +6,19 @@ LOCAL_MODULE := main
 
 # Add your application source files here...
 LOCAL_SRC_FILES := \
-    camera.c
+    camera.c \
+    camera_config.c \
+    common.c \
+    compositor.c \
+    frame.c \
+    image.c \
+    latency.c \
+    mailbox.c \
+    pacer.c \
+    pipeline.c \
+    replay.c \
+    stages.c \
+    texture_pool.c
 
 SDL_PATH := ../SDL  # SDL
 
@@ -36,407 +36,452 @@
 #define SDL_MAIN_USE_CALLBACKS 1  /* use the callbacks instead of main() */
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_main.h>
+#ifdef __ANDROID__
 #include <jni.h>
+#endif
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
+#include <time.h>
+
+#include "camera_config.h"
+#include "common.h"
+#include "compositor.h"
+#include "latency.h"
+#include "pacer.h"
+#include "pipeline.h"
+#include "replay.h"
+#include "stages.h"
 
-#define LOG_MESSAGE(message) SDL_Log("Thread ID: %lu, %s", SDL_GetCurrentThreadID(), message)
 #define VIDEO_WIDTH 320
 #define VIDEO_HEIGHT 280
-
-// Define a struct for handling image data and related properties
-typedef struct image_s
-{
-    SDL_Texture* texture; // SDL texture representation of the image for rendering in SDL
-    SDL_Mutex *mutex;     // Mutex for thread-safe access to the image data
-    uint8_t* data;        // Pointer to the raw image data (pixel information)
-    size_t length;        // Size of the image data in bytes
-    int width;            // Width of the image in pixels
-    int height;           // Height of the image in pixels
-    float videoRatio;     // Aspect ratio of the image, used for scaling
-    bool new;             // Flag to indicate if this is a new image (e.g., if it has been updated)
-} cImage;
+#define VIDEO_FPS_MIN 15         // Frame rate range requested from the camera
+#define VIDEO_FPS_MAX 30
+#define VIDEO_LENS LENS_FACING_FRONT
+#define VIDEO_FORMAT CAMERA_FORMAT_YUV_420_888
+#define VIDEO_QUEUE_DEPTH 0      // Frames the camera may queue, 0 to keep only the latest one
+#define VIDEO_STREAMS 1
+#define VIDEO_LAYOUT LAYOUT_PICTURE_IN_PICTURE
+#define VIDEO_EVENT_DRIVEN true  // Redraw only when a new frame, resize or orientation change arrives
+#define VIDEO_MAX_FPS 0.0f       // Cap on the present rate, 0 for none
+#define VIDEO_LATENCY_OVERLAY true // Draw the capture-to-present latency bars on screen
+#define VIDEO_LATENCY_CSV "latency.csv" // Latency report file in the app preferences folder, NULL for none
+#define VIDEO_PIPELINE false     // Run the frames of stream 0 through the native processing stages
+#define VIDEO_RECORD NULL        // Recording of the camera frames in the app preferences folder, NULL for none
 
 
 static SDL_Window *window = NULL;
 static SDL_Renderer *renderer = NULL;
-static int mWidth = 0;
-static int mHeight = 0;
-static cImage* image = NULL;
+static cCompositor* compositor = NULL;
+static cPacer* pacer = NULL;
+static cLatency* latency = NULL;
+static cPipeline* pipeline = NULL;
+static cRecorder* recorder = NULL;
+static cReplay* replay = NULL;
+static cCameraNegotiator* negotiator = NULL;
+static SDL_AtomicU32 cameraEvent;    // Event type handing camera requests from Java threads to the main thread
+static SDL_AtomicInt thermalStatus;  // Latest thermal state reported by Java
+
+// Codes of `cameraEvent`, the negotiator is only ever touched by the main thread
+enum
+{
+    CAMERA_EVENT_THERMAL,  // The thermal state changed
+    CAMERA_EVENT_START     // The camera permission was granted
+};
 static int mOrientation = 270;
 static SDL_FRect screenRect;
 
 /**
- * @brief Frees dynamically allocated memory using a specified free function.
+ * @brief Retrieves the dimensions of the render output and sets them in an SDL_FRect structure.
  *
- * This function takes a pointer to memory and a custom free function,
- * calls the free function to deallocate the memory, and then sets the
- * pointer to NULL to avoid dangling pointers.
+ * This function fetches the current render output size of the window and assigns it to an
+ * `SDL_FRect` structure, representing the screen rectangle. If successful, it initializes
+ * the rectangle's x and y coordinates to 0, with width and height matching the window size.
  *
- * @param mem      Pointer to the memory that needs to be freed.
- * @param freeFunc Function pointer to the specific free function to
- *                 deallocate the memory.
+ * @param window_rect Pointer to an `SDL_FRect` structure where the window dimensions will be stored.
+ * @return `true` if the render output size is successfully retrieved and assigned; `false` otherwise.
  */
-void free_memory(void** mem, void (*freeFunc)(void*))
+static bool getScreenRect(SDL_FRect* window_rect)
 {
-    freeFunc(*mem);  // Call the specified free function to release the memory
-    *mem = NULL;
+    // Variables to store the window width and height
+    int width, height;
+
+    // Retrieve the render output size; log an error if retrieval fails
+    if (!SDL_GetRenderOutputSize(renderer, &width, &height))
+    {
+        LOG_MESSAGE(SDL_GetError());  // Log the SDL error message on failure
+        return false;                 // Return false to indicate failure
+    }
+
+    // Initialize the SDL_FRect structure to represent the entire window's size
+    window_rect->x = 0.0f;          // Set x to 0.0 (left edge of the window)
+    window_rect->y = 0.0f;          // Set y to 0.0 (top edge of the window)
+    window_rect->w = (float)width;  // Assign the window's width as a float
+    window_rect->h = (float)height; // Assign the window's height as a float
+
+    return true;  // Return true to indicate success
 }
 
+
 /**
- * @brief Destroys a `cImage` object by freeing all dynamically allocated
- *        resources within the structure and then freeing the structure itself.
+ * @brief Retrieves the current display orientation and sets the appropriate
+ *        rotation angle for the application.
  *
- * This function checks each member of the `cImage` struct to ensure it is
- * not NULL before attempting to free it, to avoid double-free errors.
- * After freeing each resource, it frees the `cImage` structure itself.
+ * This function obtains the display ID for the active window and fetches the
+ * current display orientation. It sets the rotation angle based on the display
+ * orientation, which allows the application to adjust to the display's layout.
  *
- * @param me Pointer to the `cImage` structure to be destroyed and freed.
+ * @param orientation Pointer to an integer where the rotation angle will be stored:
+ *                    0, 90, 180, or 270 degrees based on orientation.
+ * @return `true` if the orientation was successfully retrieved and set; `false` otherwise.
  */
-void cImage_Destroy(cImage* me)
+bool getOrientation(int* orientation)
 {
-    // Check if the cImage pointer itself is NULL; if so, exit function early
-    if (me == NULL)
-    {
-        return;
-    }
+    bool ret = false;  // Default return value, assuming failure
 
-    // Free the raw image data if it exists
-    if (me->data != NULL)
+    // Get the display ID for the current window
+    SDL_DisplayID windowDisplayID = SDL_GetDisplayForWindow(window);
+    if (windowDisplayID == 0)  // Check if retrieving display ID failed
     {
-        free_memory((void **) &me->data, free);
+        LOG_MESSAGE(SDL_GetError());  // Log SDL error message on failure
+        goto EXIT;                    // Exit on failure
     }
 
-    // Free the mutex if it exists, using SDL_DestroyMutex as the free function
-    if (me->mutex != NULL)
+    // Get the current orientation of the specified display
+    SDL_DisplayOrientation currOrientation = SDL_GetCurrentDisplayOrientation(windowDisplayID);
+
+    // Default orientation set to 270 degrees (portrait)
+    *orientation = 270;
+
+    // Adjust orientation based on the current display orientation
+    switch (currOrientation)
     {
-        free_memory((void **) &me->mutex, (void (*)(void *)) SDL_DestroyMutex);
+        case SDL_ORIENTATION_UNKNOWN:
+        case SDL_ORIENTATION_LANDSCAPE:
+            *orientation = 180;  // Set to 180 degrees for landscape
+            break;
+        case SDL_ORIENTATION_LANDSCAPE_FLIPPED:
+            *orientation = 0;    // Set to 0 degrees for landscape flipped
+            break;
+        case SDL_ORIENTATION_PORTRAIT:
+            *orientation = 270;  // Portrait orientation, keep at 270 degrees
+            break;
+        case SDL_ORIENTATION_PORTRAIT_FLIPPED:
+            *orientation = 90;   // Set to 90 degrees for portrait flipped
+            break;
     }
 
-    // Free the texture if it exists, using SDL_DestroyTexture as the free function
-    if (me->texture != NULL)
+    ret = true;  // Indicate successful orientation retrieval and assignment
+
+    EXIT:
+    return ret;  // Return the result (true if successful, false otherwise)
+}
+
+/**
+ * @brief Creates the latency statistics, with their CSV report if enabled.
+ *
+ * The CSV file is written to the application preferences folder, which is
+ * private to the application on Android.
+ *
+ * @return `true` if the statistics are created, `false` otherwise.
+ */
+static bool initLatency(void)
+{
+    char* csvPath = NULL;
+
+    if (VIDEO_LATENCY_CSV != NULL)
     {
-        free_memory((void **) &me->texture, (void (*)(void *)) SDL_DestroyTexture);
+        char* prefPath = SDL_GetPrefPath("example", "cameraxsdl3");
+        if (prefPath != NULL)
+        {
+            SDL_asprintf(&csvPath, "%s%s", prefPath, VIDEO_LATENCY_CSV);
+            SDL_free(prefPath);
+        }
+        else
+        {
+            LOG_MESSAGE(SDL_GetError());  // Run without the CSV report
+        }
     }
 
-    // Finally, free the cImage structure itself
-    free_memory((void **) &me, free);
+    bool ret = cLatency_New(&latency, csvPath);
+    SDL_free(csvPath);
+    return ret;
 }
 
 /**
- * @brief Allocates and initializes a new `cImage` structure.
- *
- * This function allocates memory for a `cImage` structure and initializes
- * its mutex. If any allocation or initialization fails, it logs an error
- * message and cleans up by calling `cImage_Destroy`.
+ * @brief Wakes the render loop up when the pipeline publishes a frame.
  *
- * @param addressImage Double pointer to a `cImage*` which will point to the
- *                     newly allocated `cImage` structure if successful.
- * @return `true` if the allocation and initialization succeed, `false` otherwise.
+ * @param userdata Pointer to the `cPacer`.
  */
-bool cImage_New(cImage** addressImage)
+static void SDLCALL pipelinePublished(void* userdata)
 {
-    bool ret = false;  // Variable to store the return value (default to false)
+    cPacer_NotifyFrame(userdata);
+}
 
-    // Allocate memory for the cImage struct and initialize all fields to zero
-    *addressImage = calloc(1, sizeof(cImage));
+/**
+ * @brief Creates the processing pipeline of stream 0 and starts its worker.
+ *
+ * The stages below are examples; any `cStage` can be appended in their place.
+ *
+ * @return `true` if the pipeline is running, `false` otherwise.
+ */
+static bool initPipeline(void)
+{
+    cStage* stage = NULL;
 
-    // Check if memory allocation was successful
-    if (*addressImage == NULL)
+    if (!cPipeline_New(&pipeline, cCompositor_GetImage(compositor, 0), pipelinePublished, pacer))
     {
-        LOG_MESSAGE(strerror(errno));  // Log the error message if allocation failed
-        goto EXIT;                     // Jump to cleanup on failure
+        return false;
     }
 
-    // Create a mutex for the cImage instance
-    (*addressImage)->mutex = SDL_CreateMutex();
-    if ((*addressImage)->mutex == NULL)
+    // Reduce the sensor noise, then gather the luma histogram of the result
+    if (!cStage_NewDenoise(&stage, 2) || !cPipeline_AddStage(pipeline, stage))
     {
-        LOG_MESSAGE(SDL_GetError());  // Log the error if mutex creation failed
-        goto EXIT;                    // Jump to cleanup on failure
+        return false;
+    }
+    if (!cStage_NewLumaHistogram(&stage) || !cPipeline_AddStage(pipeline, stage))
+    {
+        return false;
     }
 
-    // If everything is successful, return true
-    return true;
-
-    EXIT:
-    cImage_Destroy(*addressImage);  // Clean up allocated resources on failure
-    return false;
+    return cPipeline_Start(pipeline);
 }
 
 /**
- * @brief Updates the texture of a `cImage` object if necessary.
+ * @brief Tells the camera negotiator how large stream 0 is shown.
  *
- * This function locks the `cImage`'s mutex to ensure thread-safe access, checks
- * if the texture dimensions match the current width and height, and updates or
- * recreates the texture as needed. If the image data is new, it updates the texture
- * with the latest data.
- *
- * @param me Pointer to the `cImage` structure whose texture is to be updated.
- * @return `true` if the texture is successfully updated, `false` if an error occurs.
+ * Called after every layout change so that the camera never captures more
+ * pixels than the screen can display. A failed reconfiguration is only logged;
+ * the camera keeps its previous configuration.
  */
-bool cImage_TextureUpdate(cImage* me)
+static void updateCameraView(void)
 {
-    bool ret = false;  // Default return value, assuming failure
-
-    SDL_LockMutex(me->mutex);  // Lock mutex to ensure thread-safe access to `cImage`
+    const SDL_FRect* cell = &compositor->streams[0].cell;
 
-    // Check if the current texture dimensions differ from the desired width and height
-    if (mWidth != me->width || mHeight != me->height)
+    if (!cCameraNegotiator_SetView(negotiator, (int) cell->w, (int) cell->h))
     {
-        // Delete the existing texture if it exists, then create a new one
-        if (me->texture != NULL)
-        {
-            free_memory((void **) me->texture, (void (*)(void *)) SDL_DestroyTexture);
-        }
+        LOG_MESSAGE("Could not reconfigure the camera for the new layout");
+    }
+}
 
-        // Create a new texture with updated width and height
-        me->texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_NV12, SDL_TEXTUREACCESS_STREAMING,
-                                        me->width, me->height);
-        if (me->texture == NULL)  // Check for texture creation failure
-        {
-            LOG_MESSAGE(SDL_GetError());  // Log error message if texture creation fails
-            goto EXIT;                    // Exit on failure
-        }
+/**
+ * @brief Ingests a YUV_420_888 frame of a stream; shared by the JNI bridge and the replay.
+ *
+ * The frame is recorded if a recording is running, then stored for the render
+ * loop, through the processing pipeline for stream 0 when it is enabled.
+ *
+ * @param userdata Index of the compositor stream receiving the frame, cast to a pointer.
+ * @return `true` if the frame was stored, `false` otherwise.
+ */
+static bool ingestFrame(void* userdata,
+                        const uint8_t* yPlane, const uint8_t* uPlane, const uint8_t* vPlane,
+                        int yRowStride, int uvRowStride, int uvPixelStride,
+                        int width, int height, Uint64 captureTicks)
+{
+    int stream = (int) (intptr_t) userdata;
 
-        // Update cached dimensions and calculate the aspect ratio
-        mWidth = me->width;
-        mHeight = me->height;
-        me->videoRatio = (float)me->width / (float)me->height;
+    // Find the image of the stream the frame belongs to
+    cImage* image = cCompositor_GetImage(compositor, stream);
+    if (image == NULL)
+    {
+        LOG_MESSAGE("Received a frame for an unknown stream");
+        return false;
     }
 
-    // If image data length is non-zero, update the texture with new data if available
-    if (me->length != 0)
+    // Keep a copy of the first stream for later replay
+    if (recorder != NULL && stream == 0)
     {
-        if (me->new)  // Check if the image data is marked as new
-        {
-            // Update the texture with the new data
-            if (!SDL_UpdateTexture(me->texture, NULL, me->data, me->width))
-            {
-                LOG_MESSAGE(SDL_GetError());  // Log error if texture update fails
-                goto EXIT;                    // Exit on failure
-            }
-            me->new = false;  // Reset the new flag after updating
-        }
+        cRecorder_WritePlanes(recorder, yPlane, uPlane, vPlane,
+                              yRowStride, uvRowStride, uvPixelStride, width, height, captureTicks);
     }
 
-    ret = true;  // Set return value to true to indicate success
+    // Frames of stream 0 go through the processing pipeline, which wakes the render loop up itself
+    if (pipeline != NULL && stream == 0)
+    {
+        return cPipeline_WritePlanes(pipeline, yPlane, uPlane, vPlane,
+                                     yRowStride, uvRowStride, uvPixelStride, width, height, captureTicks);
+    }
 
-    EXIT:
-    SDL_UnlockMutex(me->mutex);  // Unlock the mutex before returning
-    return ret;
+    // Store the frame, then wake the render loop up
+    if (!cImage_WritePlanes(image, yPlane, uPlane, vPlane,
+                            yRowStride, uvRowStride, uvPixelStride, width, height, captureTicks))
+    {
+        return false;
+    }
+    cPacer_NotifyFrame(pacer);
+    return true;
 }
 
 /**
- * @brief Retrieves the dimensions of the render output and sets them in an SDL_FRect structure.
- *
- * This function fetches the current render output size of the window and assigns it to an
- * `SDL_FRect` structure, representing the screen rectangle. If successful, it initializes
- * the rectangle's x and y coordinates to 0, with width and height matching the window size.
+ * @brief Creates the recording of the camera frames if `VIDEO_RECORD` is set.
  *
- * @param window_rect Pointer to an `SDL_FRect` structure where the window dimensions will be stored.
- * @return `true` if the render output size is successfully retrieved and assigned; `false` otherwise.
+ * @return `true` if the recording is running or disabled, `false` otherwise.
  */
-static bool getScreenRect(SDL_FRect* window_rect)
+static bool initRecorder(void)
 {
-    // Variables to store the window width and height
-    int width, height;
+    const char* name = VIDEO_RECORD;  // File name, NULL when recording is disabled
+    if (name == NULL)
+    {
+        return true;
+    }
 
-    // Retrieve the render output size; log an error if retrieval fails
-    if (!SDL_GetRenderOutputSize(renderer, &width, &height))
+    char* prefPath = SDL_GetPrefPath("example", "cameraxsdl3");
+    if (prefPath == NULL)
     {
-        LOG_MESSAGE(SDL_GetError());  // Log the SDL error message on failure
-        return false;                 // Return false to indicate failure
+        LOG_MESSAGE(SDL_GetError());
+        return false;
     }
 
-    // Initialize the SDL_FRect structure to represent the entire window's size
-    window_rect->x = 0.0f;          // Set x to 0.0 (left edge of the window)
-    window_rect->y = 0.0f;          // Set y to 0.0 (top edge of the window)
-    window_rect->w = (float)width;  // Assign the window's width as a float
-    window_rect->h = (float)height; // Assign the window's height as a float
+    char* path = NULL;
+    SDL_asprintf(&path, "%s%s", prefPath, name);
+    SDL_free(prefPath);
 
-    return true;  // Return true to indicate success
+    bool ret = (path != NULL) && cRecorder_New(&recorder, path);
+    SDL_free(path);
+    return ret;
 }
 
-
+#ifndef __ANDROID__
 /**
- * @brief Calculates and sets the dimensions and position of a rectangle to fit
- *        within a display rectangle while maintaining aspect ratio.
+ * @brief Replays a recording into stream 0 in place of the camera.
  *
- * This function centers a target rectangle within a given display rectangle
- * and adjusts its dimensions based on the aspect ratio and rotation.
- * For portrait orientations, it swaps width and height adjustments.
+ * Usage: `main <recording> [--max-speed] [--loop]`. Without `--max-speed` the
+ * frames keep their recorded pace; without `--loop` the application quits once
+ * the last frame has been presented, reporting the ingest throughput.
  *
- * @param rect       Pointer to the `SDL_FRect` where the calculated rectangle will be stored.
- * @param displayRect Pointer to the `SDL_FRect` defining the display area.
- * @param rotation   Rotation angle (90, 180, 270) to adjust width and height orientation.
- * @param videoRatio Aspect ratio of the video, used to maintain consistent scaling.
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ * @return `true` if the replay is running, `false` otherwise.
  */
-static void calculateRect(SDL_FRect* rect, const SDL_FRect* displayRect,
-                          int rotation, float videoRatio)
+static bool initReplay(int argc, char* argv[])
 {
-    // Find the center point of the display rectangle
-    SDL_FPoint mid;
-    mid.x = displayRect->x + (displayRect->w / 2);
-    mid.y = displayRect->y + (displayRect->h / 2);
+    const char* path = NULL;
+    bool realtime = true;
+    bool loop = false;
 
-    // Initialize width and height based on the display rectangle's dimensions
-    float adjustedWidth = displayRect->w;
-    float adjustedHeight = displayRect->h;
-
-    // Adjust dimensions to maintain the aspect ratio, with orientation consideration
-    if (rotation == 90 || rotation == 270)
+    for (int i = 1; i < argc; ++i)
     {
-        // For portrait orientation, adjust width based on video aspect ratio
-        if (adjustedHeight > adjustedWidth * videoRatio)
-        {
-            adjustedWidth = adjustedHeight / videoRatio;
-        }
-        else
+        if (SDL_strcmp(argv[i], "--max-speed") == 0)
         {
-            adjustedHeight = adjustedWidth * videoRatio;
+            realtime = false;
         }
-    }
-    else
-    {
-        // For landscape orientation, adjust height based on video aspect ratio
-        if (adjustedWidth > adjustedHeight * videoRatio)
+        else if (SDL_strcmp(argv[i], "--loop") == 0)
         {
-            adjustedHeight = adjustedWidth / videoRatio;
+            loop = true;
         }
         else
         {
-            adjustedWidth = adjustedHeight * videoRatio;
+            path = argv[i];
         }
     }
 
-    // Set the final width and height of `rect` based on rotation requirements
-    if (rotation == 90 || rotation == 270)
+    if (path == NULL)
     {
-        rect->w = adjustedHeight;  // Swap width and height for portrait orientation
-        rect->h = adjustedWidth;
-    }
-    else
-    {
-        rect->w = adjustedWidth;
-        rect->h = adjustedHeight;
+        SDL_Log("Usage: %s <recording> [--max-speed] [--loop]", argc > 0 ? argv[0] : "main");
+        return false;
     }
 
-    // Center the rectangle within the display rectangle
-    rect->x = mid.x - (rect->w / 2);
-    rect->y = mid.y - (rect->h / 2);
+    return cReplay_New(&replay, path, realtime, loop, ingestFrame, (void*) (intptr_t) 0) &&
+           cReplay_Start(replay);
 }
+#endif
 
+#ifdef __ANDROID__
 /**
- * @brief Retrieves the current display orientation and sets the appropriate
- *        rotation angle for the application.
+ * @brief Converts a camera sensor time stamp to the `SDL_GetTicksNS` clock.
  *
- * This function obtains the display ID for the active window and fetches the
- * current display orientation. It sets the rotation angle based on the display
- * orientation, which allows the application to adjust to the display's layout.
+ * Depending on the device, `ImageProxy` time stamps are either on the
+ * `CLOCK_BOOTTIME` or on the `CLOCK_MONOTONIC` clock. Both clocks are sampled
+ * and the one giving a plausible frame age (positive and below one second) is
+ * used to express the capture time on the SDL clock.
  *
- * @param orientation Pointer to an integer where the rotation angle will be stored:
- *                    0, 90, 180, or 270 degrees based on orientation.
- * @return `true` if the orientation was successfully retrieved and set; `false` otherwise.
+ * @param timestamp Sensor time stamp of the frame in nanoseconds.
+ * @return Capture time on the `SDL_GetTicksNS` clock, or 0 if it cannot be determined.
  */
-bool getOrientation(int* orientation)
+static Uint64 rebaseCaptureTimestamp(jlong timestamp)
 {
-    bool ret = false;  // Default return value, assuming failure
+    struct timespec boot, mono;
+    Uint64 now = SDL_GetTicksNS();
 
-    // Get the display ID for the current window
-    SDL_DisplayID windowDisplayID = SDL_GetDisplayForWindow(window);
-    if (windowDisplayID == 0)  // Check if retrieving display ID failed
+    if (timestamp <= 0 ||
+        clock_gettime(CLOCK_BOOTTIME, &boot) != 0 ||
+        clock_gettime(CLOCK_MONOTONIC, &mono) != 0)
     {
-        LOG_MESSAGE(SDL_GetError());  // Log SDL error message on failure
-        goto EXIT;                    // Exit on failure
+        return 0;
     }
 
-    // Get the current orientation of the specified display
-    SDL_DisplayOrientation currOrientation = SDL_GetCurrentDisplayOrientation(windowDisplayID);
-
-    // Default orientation set to 270 degrees (portrait)
-    *orientation = 270;
+    // Age of the frame according to each clock
+    Sint64 bootAge = (Sint64) boot.tv_sec * SDL_NS_PER_SECOND + boot.tv_nsec - timestamp;
+    Sint64 monoAge = (Sint64) mono.tv_sec * SDL_NS_PER_SECOND + mono.tv_nsec - timestamp;
 
-    // Adjust orientation based on the current display orientation
-    switch (currOrientation)
+    // Keep the smallest non-negative age
+    Sint64 age = -1;
+    if (bootAge >= 0)
     {
-        case SDL_ORIENTATION_UNKNOWN:
-        case SDL_ORIENTATION_LANDSCAPE:
-            *orientation = 180;  // Set to 180 degrees for landscape
-            break;
-        case SDL_ORIENTATION_LANDSCAPE_FLIPPED:
-            *orientation = 0;    // Set to 0 degrees for landscape flipped
-            break;
-        case SDL_ORIENTATION_PORTRAIT:
-            *orientation = 270;  // Portrait orientation, keep at 270 degrees
-            break;
-        case SDL_ORIENTATION_PORTRAIT_FLIPPED:
-            *orientation = 90;   // Set to 90 degrees for portrait flipped
-            break;
+        age = bootAge;
+    }
+    if (monoAge >= 0 && (age < 0 || monoAge < age))
+    {
+        age = monoAge;
     }
 
-    ret = true;  // Indicate successful orientation retrieval and assignment
-
-    EXIT:
-    return ret;  // Return the result (true if successful, false otherwise)
+    if (age < 0 || age >= (Sint64) SDL_NS_PER_SECOND || (Uint64) age > now)
+    {
+        return 0;
+    }
+    return now - (Uint64) age;
 }
 
 /**
- * @brief Renders the texture of a `cImage` object within a specified parent rectangle,
- *        applying the specified orientation and scaling.
+ * @brief Applies a camera configuration by calling the Java activity.
  *
- * This function updates the texture of the `cImage` object if needed, calculates
- * the rendering rectangle, and renders the texture to the screen with rotation and
- * vertical flipping. It logs any errors encountered during rendering.
+ * This is the JNI side of the camera negotiation: the `configureCamera` method
+ * of the activity (re)binds the CameraX analysis use case with the given
+ * parameters.
  *
- * @param me Pointer to the `cImage` object containing the texture to render.
- * @param parentRect Pointer to an `SDL_FRect` defining the display area for rendering.
- * @param orientation Integer specifying the rotation angle (0, 90, 180, or 270).
- * @return `true` if the texture is successfully rendered, `false` if an error occurs.
+ * @param userdata Pointer to user data passed to the function (unused here).
+ * @param config Configuration to apply.
+ * @return `true` if the Java method was called, `false` otherwise.
  */
-bool cImage_Render(cImage* me, SDL_FRect* parentRect, int orientation)
+static bool JavaConfigureCamera(void* userdata, const cCameraConfig* config)
 {
-    bool ret = false;  // Default return value, assuming failure
+    JNIEnv *env = SDL_GetAndroidJNIEnv();  // Get the JNI environment
+    jobject activity = (jobject) SDL_GetAndroidActivity();  // Get the current Android activity
 
-    // Update the texture of the cImage object; exit if update fails
-    if (!cImage_TextureUpdate(me))
-    {
-        goto EXIT;
-    }
+    // Get the Java class for the activity
+    jclass activityClass = (*env)->GetObjectClass(env, activity);
 
-    // Calculate the rendering rectangle based on the parent rectangle and orientation
-    SDL_FRect rect;
-    calculateRect(&rect, parentRect, orientation, me->videoRatio);
+    // Find the method ID for the configureCamera method, which takes seven integers as parameters
+    jmethodID configureMethod = (*env)->GetMethodID(env, activityClass, "configureCamera", "(IIIIIII)V");
+    (*env)->DeleteLocalRef(env, activityClass);
 
-    if (me->texture != NULL)
+    if (configureMethod == NULL)  // Check if the method ID was successfully retrieved
     {
-        // Render the texture with rotation and vertical flipping
-        if (!SDL_RenderTextureRotated(renderer,
-                                      me->texture,
-                                      NULL,
-                                      &rect,
-                                      orientation,
-                                      0,
-                                      SDL_FLIP_VERTICAL))
-        {
-            LOG_MESSAGE(SDL_GetError());  // Log error message if rendering fails
-            goto EXIT;                    // Exit on failure
-        }
+        SDL_Log("Could not find configureCamera method");  // Log an error if the method is not found
+        (*env)->DeleteLocalRef(env, activity);
+        return false;
     }
 
-    ret = true;  // Set return value to true to indicate success
+    // Call the Java configureCamera method with the negotiated parameters
+    (*env)->CallVoidMethod(env, activity, configureMethod,
+                           config->width, config->height, config->minFps, config->maxFps,
+                           (jint) config->lensFacing, (jint) config->format, config->queueDepth);
+    (*env)->DeleteLocalRef(env, activity);
 
-    EXIT:
-    return ret;  // Return the result (true if successful, false otherwise)
+    if ((*env)->ExceptionCheck(env))
+    {
+        (*env)->ExceptionClear(env);
+        return false;
+    }
+    return true;
 }
 
 /**
- * @brief Starts the camera on an Android device by calling a Java method
- *        if permission is granted.
+ * @brief Asks the main thread to start the camera once the permission is granted.
  *
- * This function checks if the required permission has been granted. If so, it
- * retrieves the Android activity and calls the `startCameraX` Java method with
- * specified width and height parameters.
+ * This runs on the Android UI thread, so the negotiator is left to the main
+ * thread, which starts it with the current negotiation; later layout or
+ * thermal changes reconfigure it through `JavaConfigureCamera`.
  *
  * @param userdata Pointer to user data passed to the function (unused here).
  * @param permission String representing the permission required (unused here).
@@ -446,25 +491,32 @@ static void JavaStartCamera(void *userdata, const char *permission, bool granted
 {
     if (granted)  // Proceed only if the permission was granted
     {
-        JNIEnv *env = SDL_GetAndroidJNIEnv();  // Get the JNI environment
-        jobject activity = (jobject) SDL_GetAndroidActivity();  // Get the current Android activity
-
-        // Get the Java class for the activity
-        jclass activityClass = (*env)->GetObjectClass(env, activity);
-
-        // Find the method ID for the startCameraX method, which takes two integers as parameters
-        jmethodID startCameraMethod = (*env)->GetMethodID(env, activityClass, "startCameraX", "(II)V");
-
-        if (startCameraMethod == NULL)  // Check if the method ID was successfully retrieved
+        SDL_Event event;
+        SDL_zero(event);
+        event.type = SDL_GetAtomicU32(&cameraEvent);
+        event.user.code = CAMERA_EVENT_START;
+        if (!SDL_PushEvent(&event))
         {
-            SDL_Log("Could not find startCameraX method");  // Log an error if the method is not found
-            return;  // Exit the function if method ID is not found
+            LOG_MESSAGE(SDL_GetError());
         }
-
-        // Call the Java startCameraX method with video width and height parameters
-        (*env)->CallVoidMethod(env, activity, startCameraMethod, VIDEO_WIDTH, VIDEO_HEIGHT);
     }
 }
+#else
+/**
+ * @brief Stands in for the Java bridge where there is no camera.
+ *
+ * The negotiator logs every configuration it applies, which is all that can
+ * be observed here.
+ *
+ * @param userdata Pointer to user data passed to the function (unused here).
+ * @param config Configuration to apply (unused here).
+ * @return Always `true`.
+ */
+static bool StubConfigureCamera(void* userdata, const cCameraConfig* config)
+{
+    return true;
+}
+#endif
 
 
 /**
@@ -476,19 +528,12 @@ static void JavaStartCamera(void *userdata, const char *permission, bool granted
  * creates the window and renderer, and sets up image and orientation resources.
  *
  * @param appstate Pointer to an application-specific state (unused here).
- * @param argc Argument count (unused here).
- * @param argv Argument vector (unused here).
+ * @param argc Argument count; used by the replay outside of Android.
+ * @param argv Argument vector; used by the replay outside of Android.
  * @return `SDL_APP_CONTINUE` if initialization is successful; `SDL_APP_FAILURE` otherwise.
  */
 SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
 {
-    // Request Android camera permission, attaching JavaStartCamera as the callback
-    if (!SDL_RequestAndroidPermission("android.permission.CAMERA", JavaStartCamera, NULL))
-    {
-        LOG_MESSAGE(SDL_GetError());  // Log error if permission request fails
-        goto EXIT;                    // Exit if permission request fails
-    }
-
     // Initialize SDL with video subsystem
     if (!SDL_Init(SDL_INIT_VIDEO))
     {
@@ -496,17 +541,58 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
         goto EXIT;                    // Exit if initialization fails
     }
 
-    // Initialize a new cImage structure for handling camera textures
-    if (!cImage_New(&image))
+    // Create an SDL window and renderer for displaying the camera feed
+    if (!SDL_CreateWindowAndRenderer("CameraXSDL3", VIDEO_WIDTH, VIDEO_HEIGHT, SDL_WINDOW_RESIZABLE, &window, &renderer))
+    {
+        LOG_MESSAGE(SDL_GetError());  // Log error if window or renderer creation fails
+        goto EXIT;                    // Exit if creation fails
+    }
+
+    // Initialize the latency statistics, reported to the log and to a CSV file
+    if (!initLatency())
     {
         goto EXIT;
     }
 
-    // Create an SDL window and renderer for displaying the camera feed
-    if (!SDL_CreateWindowAndRenderer("CameraXSDL3", 0, 0, SDL_WINDOW_RESIZABLE, &window, &renderer))
+    // Initialize the render loop pacing, woken up by the frame producers
+    if (!cPacer_New(&pacer, VIDEO_EVENT_DRIVEN, VIDEO_MAX_FPS))
     {
-        LOG_MESSAGE(SDL_GetError());  // Log error if window or renderer creation fails
-        goto EXIT;                    // Exit if creation fails
+        goto EXIT;
+    }
+
+    // Initialize the camera configuration; the camera itself starts once allowed
+    cCameraConfig requested = {
+        .width = VIDEO_WIDTH,
+        .height = VIDEO_HEIGHT,
+        .minFps = VIDEO_FPS_MIN,
+        .maxFps = VIDEO_FPS_MAX,
+        .lensFacing = VIDEO_LENS,
+        .format = VIDEO_FORMAT,
+        .queueDepth = VIDEO_QUEUE_DEPTH
+    };
+#ifdef __ANDROID__
+    if (!cCameraNegotiator_New(&negotiator, &requested, JavaConfigureCamera, NULL))
+#else
+    if (!cCameraNegotiator_New(&negotiator, &requested, StubConfigureCamera, NULL))
+#endif
+    {
+        goto EXIT;
+    }
+    cCameraNegotiator_SetThermalStatus(negotiator, (cThermalStatus) SDL_GetAtomicInt(&thermalStatus));
+
+    // Register the event Java permission and thermal notifications are forwarded with
+    Uint32 eventType = SDL_RegisterEvents(1);
+    if (eventType == 0)
+    {
+        LOG_MESSAGE(SDL_GetError());
+        goto EXIT;
+    }
+    SDL_SetAtomicU32(&cameraEvent, eventType);
+
+    // Initialize the compositor and the images of its camera streams
+    if (!cCompositor_New(&compositor, renderer, VIDEO_STREAMS, VIDEO_LAYOUT))
+    {
+        goto EXIT;
     }
 
     // Get the initial screen orientation and set it in mOrientation
@@ -521,6 +607,38 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
         goto EXIT;
     }
 
+    // Lay the streams out on the screen, and size the camera frames after them
+    cCompositor_Resize(compositor, &screenRect, mOrientation);
+    updateCameraView();
+
+    // Start the processing pipeline in front of stream 0 if enabled
+    if (VIDEO_PIPELINE && !initPipeline())
+    {
+        goto EXIT;
+    }
+
+    // Record the camera frames if enabled
+    if (!initRecorder())
+    {
+        goto EXIT;
+    }
+
+#ifdef __ANDROID__
+    // Request Android camera permission, attaching JavaStartCamera as the callback
+    if (!SDL_RequestAndroidPermission("android.permission.CAMERA", JavaStartCamera, NULL))
+    {
+        LOG_MESSAGE(SDL_GetError());  // Log error if permission request fails
+        goto EXIT;                    // Exit if permission request fails
+    }
+#else
+    // Without a camera, the frames come from a recording
+    cCameraNegotiator_Start(negotiator);
+    if (!initReplay(argc, argv))
+    {
+        goto EXIT;
+    }
+#endif
+
     return SDL_APP_CONTINUE;  // Return success if all initializations complete
 
     EXIT:
@@ -547,6 +665,9 @@ SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event)
         return SDL_APP_SUCCESS;  // End the program, reporting success to the OS
     }
 
+    // Let the pacer know whether the screen must be redrawn
+    cPacer_HandleEvent(pacer, event);
+
     // Check if the event is a window resize
     if (event->type == SDL_EVENT_WINDOW_RESIZED)
     {
@@ -561,6 +682,26 @@ SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event)
         {
             goto EXIT;
         }
+
+        // Recompute the stream layout; this is the only place it changes
+        cCompositor_Resize(compositor, &screenRect, mOrientation);
+        updateCameraView();
+    }
+
+    if (event->type == SDL_GetAtomicU32(&cameraEvent))
+    {
+        // Start the camera once the permission was granted
+        if (event->user.code == CAMERA_EVENT_START && !cCameraNegotiator_Start(negotiator))
+        {
+            LOG_MESSAGE("Could not start the camera");
+        }
+
+        // Renegotiate the camera configuration when the thermal state changed
+        if (event->user.code == CAMERA_EVENT_THERMAL &&
+            !cCameraNegotiator_SetThermalStatus(negotiator, (cThermalStatus) SDL_GetAtomicInt(&thermalStatus)))
+        {
+            LOG_MESSAGE("Could not reconfigure the camera for the thermal state");
+        }
     }
 
     return SDL_APP_CONTINUE;  // Continue running the program
@@ -571,17 +712,35 @@ SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event)
 
 /**
  * @brief Runs the main rendering loop for each frame, clearing the screen,
- *        rendering the image, and presenting the result.
+ *        rendering the streams, and presenting the result.
  *
  * This function is the core of the program, responsible for rendering content
- * each frame. It clears the renderer, calls the `cImage_Render` function to
- * display the image, and then presents the rendered content to the screen.
+ * each frame. It asks the pacer whether anything changed since the last present
+ * and, if not, sleeps until an event arrives instead of re-presenting the same
+ * frame. Otherwise it clears the renderer, calls the `cCompositor_Render`
+ * function to display every stream, and then presents the rendered content.
  *
  * @param appstate Pointer to an application-specific state (unused here).
- * @return `SDL_APP_CONTINUE` if the frame renders successfully; `SDL_APP_FAILURE` if an error occurs.
+ * @return `SDL_APP_CONTINUE` if the frame renders successfully; `SDL_APP_SUCCESS` once the last frame of
+ *         a finished replay has been presented; `SDL_APP_FAILURE` if an error occurs.
  */
 SDL_AppResult SDL_AppIterate(void *appstate)
 {
+    // Once a replay is over, its last frame has been stored and announced to the pacer,
+    // so the program can end as soon as the pacer has nothing left to draw
+    bool replayOver = replay != NULL && cReplay_IsFinished(replay) &&
+                      (pipeline == NULL || cPipeline_IsIdle(pipeline));
+    if (replayOver && cPacer_IsIdle(pacer))
+    {
+        return SDL_APP_SUCCESS;
+    }
+
+    // Skip this iteration when there is nothing new to show
+    if (!cPacer_ShouldRender(pacer))
+    {
+        return SDL_APP_CONTINUE;
+    }
+
     // Clear the renderer to prepare for a new frame
     if (!SDL_RenderClear(renderer))
     {
@@ -589,47 +748,104 @@ SDL_AppResult SDL_AppIterate(void *appstate)
         return SDL_APP_FAILURE;       // Return failure on error
     }
 
-    // Render the cImage object within the specified screen rectangle and orientation
-    if (!cImage_Render(image, &screenRect, mOrientation))
+    // Render every stream in its layout rectangle, in a single pass
+    if (!cCompositor_Render(compositor))
     {
-        return SDL_APP_FAILURE;  // Return failure if rendering the image fails
+        return SDL_APP_FAILURE;  // Return failure if rendering the streams fails
+    }
+
+    // Draw the latency percentiles over the streams
+    if (VIDEO_LATENCY_OVERLAY && !cLatency_RenderOverlay(latency, renderer, 8.0f, 8.0f))
+    {
+        return SDL_APP_FAILURE;  // Return failure if drawing the overlay fails
     }
 
     // Present the rendered frame to the screen
+    Uint64 presentStart = SDL_GetTicksNS();
     if (!SDL_RenderPresent(renderer))
     {
         LOG_MESSAGE(SDL_GetError());  // Log error if presenting the renderer fails
         return SDL_APP_FAILURE;       // Return failure on error
     }
+    Uint64 presentEnd = SDL_GetTicksNS();
+    cPacer_Presented(pacer);
+
+    // Account for the latency of every frame shown for the first time
+    for (int i = 0; i < compositor->count; ++i)
+    {
+        cImage* image = cCompositor_GetImage(compositor, i);
+        if (image->timingPending)
+        {
+            cLatency_Record(latency, &image->timing, presentStart, presentEnd);
+            image->timingPending = false;
+        }
+    }
+    cLatency_Report(latency, false);
 
-    return SDL_APP_CONTINUE;  // Continue running the program if rendering succeeds
+    // End a finished replay right after presenting its last frame
+    return (replayOver && cPacer_IsIdle(pacer)) ? SDL_APP_SUCCESS : SDL_APP_CONTINUE;
 }
 
 /**
  * @brief Cleans up resources and performs any necessary shutdown tasks.
  *
  * This function is called once at program shutdown to clean up resources
- * associated with the application. It specifically destroys the `cImage`
- * object, while SDL handles window and renderer cleanup automatically.
+ * associated with the application. It specifically destroys the compositor
+ * and its `cImage` objects, while SDL handles window and renderer cleanup automatically.
  *
  * @param appstate Pointer to an application-specific state (unused here).
  * @param result SDL_AppResult indicating the program's exit status.
  */
 void SDL_AppQuit(void *appstate, SDL_AppResult result)
 {
-    // Destroy the cImage object and free associated resources
-    cImage_Destroy(image);
+    // Stop the replay first, reporting the ingest throughput
+    if (replay != NULL && cReplay_IsFinished(replay) && replay->endTicks > replay->startTicks)
+    {
+        SDL_Log("Replayed %" SDL_PRIu64 " frames at %.1f fps", replay->frames,
+                (double) replay->frames * SDL_NS_PER_SECOND / (double) (replay->endTicks - replay->startTicks));
+    }
+    cReplay_Destroy(replay);
+
+    // Stop the processing pipeline before the image it publishes into
+    cPipeline_Destroy(pipeline);
+
+    // Close the recording
+    cRecorder_Destroy(recorder);
+
+    // Release the camera configuration
+    cCameraNegotiator_Destroy(negotiator);
+
+    // Destroy the compositor, its images and their associated resources
+    cCompositor_Destroy(compositor);
+
+    // Report the frames presented since the last periodic report, then release
+    // the latency statistics, closing the CSV report
+    if (latency != NULL)
+    {
+        cLatency_Report(latency, true);
+        cLatency_Destroy(latency);
+    }
+
+    // Report the pacing counters, then release the pacer
+    if (pacer != NULL)
+    {
+        SDL_Log("Frames presented: %" SDL_PRIu64 ", skipped: %d",
+                pacer->presented, SDL_GetAtomicInt(&pacer->skipped));
+        cPacer_Destroy(pacer);
+    }
 
     // Note: SDL automatically cleans up the window and renderer on exit.
 }
 
+#ifdef __ANDROID__
 /**
  * @brief Processes YUV image data from Java and updates the `cImage` structure.
  *
  * This function is called from Java to process YUV image data for the `cImage`
- * object. It locks the image mutex, resizes the data buffer if necessary, copies
- * the new YUV data, and sets image properties. If memory allocation fails, it
- * logs an error and exits.
+ * object. It resizes the producer's mailbox slot if necessary, copies the new
+ * YUV data into it, and publishes it to the render loop. When the processing
+ * pipeline is enabled, the frame goes through it instead. If memory allocation
+ * fails, it logs an error and drops the frame.
  *
  * @param env Pointer to the JNI environment.
  * @param thiz Reference to the Java object calling this function.
@@ -642,42 +858,224 @@ Java_com_example_cameraxsdl3_CameraXsdl3Activity_processYUVImage(JNIEnv *env, jo
                                                                  jint width,
                                                                  jint height)
 {
-    // Lock the image mutex to ensure thread-safe access
-    SDL_LockMutex(image->mutex);
+    // The byte array entry point always feeds the first stream
+    cImage* image = cCompositor_GetImage(compositor, 0);
+    if (image == NULL)
+    {
+        return;
+    }
 
-    // Get the length of the YUV data byte array from Java
+    // Reject arrays too short for the NV12 planes their size implies, before any offset is derived from it
     jsize data_len = (*env)->GetArrayLength(env, yuv_data);
-
-    // Check if the data buffer needs resizing based on new data length
-    if (data_len > image->length)
+    if (width <= 0 || height <= 0 ||
+        data_len < (jlong) width * height + (jlong) ((width + 1) / 2) * 2 * ((height + 1) / 2))
     {
-        // Update the stored length to match the new data length
-        image->length = data_len;
+        LOG_MESSAGE("processYUVImage received an array smaller than its frame");
+        return;
+    }
 
-        // Free the existing data buffer if it exists
-        if (image->data != NULL)
+    // The pipeline is the only producer of its image: hand the planes over to it instead
+    if (pipeline != NULL)
+    {
+        // Pinned only for the copy into the pipeline input, which never blocks
+        uint8_t* data = (*env)->GetPrimitiveArrayCritical(env, yuv_data, NULL);
+        if (data == NULL)
         {
-            free(image->data);
-            image->data = NULL;
+            return;
         }
+        const uint8_t* uvPlane = data + (size_t) width * height;
+        cPipeline_WritePlanes(pipeline, data, uvPlane, uvPlane + 1,
+                              width, (width + 1) / 2 * 2, 2, width, height, 0);
+        (*env)->ReleasePrimitiveArrayCritical(env, yuv_data, data, JNI_ABORT);
+        return;
+    }
 
-        // Allocate a new buffer for the YUV data
-        image->data = calloc(data_len, sizeof(*image->data));
-        if (image->data == NULL)  // Check for memory allocation failure
-        {
-            LOG_MESSAGE(strerror(errno));  // Log error if allocation fails
-            goto EXIT;                     // Exit if memory allocation fails
-        }
+    Uint64 ingestStart = SDL_GetTicksNS();
+
+    // Write into the slot owned by the producer; the render loop never reads it
+    cFrame* frame = cMailbox_BeginWrite(image->mailbox);
+
+    // Grow the data buffer if the new frame does not fit
+    if (!cFrame_Reserve(frame, data_len))
+    {
+        return;
     }
 
-    // Copy the YUV data from Java byte array to the allocated image data buffer
-    (*env)->GetByteArrayRegion(env, yuv_data, 0, data_len, (jbyte*) image->data);
+    // Copy the YUV data from Java byte array to the frame data buffer
+    (*env)->GetByteArrayRegion(env, yuv_data, 0, data_len, (jbyte*) frame->data);
+
+    // The byte array holds tightly packed planes, with interleaved U/V chroma
+    frame->format = SDL_PIXELFORMAT_NV12;
+    frame->colorspace = SDL_COLORSPACE_YUV_DEFAULT;
+    frame->offsets[0] = 0;
+    frame->offsets[1] = (size_t) width * height;
+    frame->pitches[0] = width;
+    frame->pitches[1] = (width + 1) / 2 * 2;
+
+    // Set frame properties and hand the frame over to the render loop
+    frame->width = width;
+    frame->height = height;
+    SDL_zero(frame->timing);  // The capture time is not known on this path
+    frame->timing.ingestStart = ingestStart;
+    frame->timing.ingestEnd = SDL_GetTicksNS();
+    cMailbox_Publish(image->mailbox);
+
+    // Wake the render loop up
+    cPacer_NotifyFrame(pacer);
+}
 
-    // Set image properties and mark the image data as new
-    image->new = true;
-    image->width = width;
-    image->height = height;
+/**
+ * @brief Processes a YUV_420_888 frame from Java without any intermediate copy.
+ *
+ * This function is called from Java with the direct `ByteBuffer`s of the
+ * `ImageProxy` planes. The plane memory is accessed in place through
+ * `GetDirectBufferAddress` and copied once, stride-aware, into the `cImage`
+ * buffer used for the texture upload. No Java array is allocated per frame and
+ * no `GetByteArrayRegion` copy takes place.
+ *
+ * @param env Pointer to the JNI environment.
+ * @param thiz Reference to the Java object calling this function.
+ * @param stream Index of the compositor stream receiving the frame.
+ * @param y_buffer Direct byte buffer holding the luma plane.
+ * @param u_buffer Direct byte buffer holding the U (Cb) plane.
+ * @param v_buffer Direct byte buffer holding the V (Cr) plane.
+ * @param y_row_stride Distance in bytes between two luma rows.
+ * @param uv_row_stride Distance in bytes between two chroma rows.
+ * @param uv_pixel_stride Distance in bytes between two chroma samples of a row.
+ * @param width Integer representing the width of the YUV image.
+ * @param height Integer representing the height of the YUV image.
+ * @param timestamp_ns Sensor time stamp of the frame, as reported by `ImageProxy`.
+ */
+JNIEXPORT void JNICALL
+Java_com_example_cameraxsdl3_CameraXsdl3Activity_processYUVPlanes(JNIEnv *env, jobject thiz,
+                                                                  jint stream,
+                                                                  jobject y_buffer,
+                                                                  jobject u_buffer,
+                                                                  jobject v_buffer,
+                                                                  jint y_row_stride,
+                                                                  jint uv_row_stride,
+                                                                  jint uv_pixel_stride,
+                                                                  jint width,
+                                                                  jint height,
+                                                                  jlong timestamp_ns)
+{
+    // Resolve the native addresses of the plane buffers
+    const uint8_t* yPlane = (*env)->GetDirectBufferAddress(env, y_buffer);
+    const uint8_t* uPlane = (*env)->GetDirectBufferAddress(env, u_buffer);
+    const uint8_t* vPlane = (*env)->GetDirectBufferAddress(env, v_buffer);
+    if (yPlane == NULL || uPlane == NULL || vPlane == NULL)
+    {
+        LOG_MESSAGE("processYUVPlanes requires direct byte buffers");
+        return;
+    }
 
-    EXIT:
-    SDL_UnlockMutex(image->mutex);  // Unlock the mutex before returning
+    if (width <= 0 || height <= 0)
+    {
+        return;
+    }
+
+    // Make sure the strides do not make us read past the end of any plane
+    int chromaWidth = (width + 1) / 2;
+    int chromaHeight = (height + 1) / 2;
+    jlong yNeeded = (jlong) (height - 1) * y_row_stride + width;
+    jlong uvNeeded = (jlong) (chromaHeight - 1) * uv_row_stride + (jlong) (chromaWidth - 1) * uv_pixel_stride + 1;
+    if ((*env)->GetDirectBufferCapacity(env, y_buffer) < yNeeded ||
+        (*env)->GetDirectBufferCapacity(env, u_buffer) < uvNeeded ||
+        (*env)->GetDirectBufferCapacity(env, v_buffer) < uvNeeded)
+    {
+        LOG_MESSAGE("processYUVPlanes received planes smaller than their strides");
+        return;
+    }
+
+    // Hand the frame to the ingest path shared with the replay
+    ingestFrame((void*) (intptr_t) stream, yPlane, uPlane, vPlane,
+                y_row_stride, uv_row_stride, uv_pixel_stride, width, height,
+                rebaseCaptureTimestamp(timestamp_ns));
+}
+
+/**
+ * @brief Processes an RGBA_8888 frame from Java without any intermediate copy.
+ *
+ * Used when the camera is configured with `CAMERA_FORMAT_RGBA_8888`. The pixels
+ * are read in place from the direct `ByteBuffer` and copied once into the image
+ * mailbox; packed frames skip the YUV processing stages and the recorder, but
+ * still go through the pipeline worker of stream 0 when it is enabled.
+ *
+ * @param env Pointer to the JNI environment.
+ * @param thiz Reference to the Java object calling this function.
+ * @param stream Index of the compositor stream receiving the frame.
+ * @param buffer Direct byte buffer holding the pixels.
+ * @param row_stride Distance in bytes between two rows.
+ * @param width Integer representing the width of the image.
+ * @param height Integer representing the height of the image.
+ * @param timestamp_ns Sensor time stamp of the frame, as reported by `ImageProxy`.
+ */
+JNIEXPORT void JNICALL
+Java_com_example_cameraxsdl3_CameraXsdl3Activity_processRGBAImage(JNIEnv *env, jobject thiz,
+                                                                  jint stream,
+                                                                  jobject buffer,
+                                                                  jint row_stride,
+                                                                  jint width,
+                                                                  jint height,
+                                                                  jlong timestamp_ns)
+{
+    // Find the image of the stream the frame belongs to
+    cImage* image = cCompositor_GetImage(compositor, stream);
+    if (image == NULL || width <= 0 || height <= 0)
+    {
+        return;
+    }
+
+    // Resolve the native address of the pixels and check their extent
+    const uint8_t* pixels = (*env)->GetDirectBufferAddress(env, buffer);
+    if (pixels == NULL ||
+        row_stride < width * 4 ||
+        (*env)->GetDirectBufferCapacity(env, buffer) < (jlong) (height - 1) * row_stride + (jlong) width * 4)
+    {
+        LOG_MESSAGE("processRGBAImage received an invalid buffer");
+        return;
+    }
+
+    // The pipeline worker is the only producer of stream 0 and wakes the render loop up itself
+    if (pipeline != NULL && stream == 0)
+    {
+        cPipeline_WritePacked(pipeline, pixels, row_stride, SDL_PIXELFORMAT_RGBA32, width, height,
+                              rebaseCaptureTimestamp(timestamp_ns));
+        return;
+    }
+
+    // Store the frame, then wake the render loop up
+    if (cImage_WritePacked(image, pixels, row_stride, SDL_PIXELFORMAT_RGBA32, width, height,
+                           rebaseCaptureTimestamp(timestamp_ns)))
+    {
+        cPacer_NotifyFrame(pacer);
+    }
+}
+
+/**
+ * @brief Receives the thermal state of the device from Java.
+ *
+ * Called on the Android main thread by the `PowerManager` listener; the state
+ * is handed over to the SDL main thread, which renegotiates the camera.
+ *
+ * @param env Pointer to the JNI environment.
+ * @param thiz Reference to the Java object calling this function.
+ * @param status One of the `PowerManager.THERMAL_STATUS_*` values.
+ */
+JNIEXPORT void JNICALL
+Java_com_example_cameraxsdl3_CameraXsdl3Activity_onThermalStatusChanged(JNIEnv *env, jobject thiz, jint status)
+{
+    SDL_SetAtomicInt(&thermalStatus, status);
+
+    // Wake the main thread up if the application is running
+    Uint32 eventType = SDL_GetAtomicU32(&cameraEvent);
+    if (eventType != 0)
+    {
+        SDL_Event event;
+        SDL_zero(event);
+        event.type = eventType;
+        event.user.code = CAMERA_EVENT_THERMAL;
+        SDL_PushEvent(&event);
+    }
 }
+#endif
@@ -0,0 +1,186 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Native camera configuration and its negotiation against the display and thermal budget.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "camera_config.h"
+#include "common.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+/**
+ * @brief Gives the size reduction and the frame rate cap for a thermal state.
+ *
+ * @param thermal Thermal state of the device.
+ * @param scale Pointer receiving the factor applied to the frame width and height.
+ * @param fpsCap Pointer receiving the highest frame rate allowed, 0 for none.
+ */
+static void getThermalLimits(cThermalStatus thermal, float* scale, int* fpsCap)
+{
+    switch (thermal)
+    {
+        case THERMAL_STATUS_NONE:
+        case THERMAL_STATUS_LIGHT:
+            *scale = 1.0f;
+            *fpsCap = 0;
+            break;
+        case THERMAL_STATUS_MODERATE:
+            *scale = 0.75f;
+            *fpsCap = 30;
+            break;
+        case THERMAL_STATUS_SEVERE:
+            *scale = 0.5f;
+            *fpsCap = 20;
+            break;
+        default:
+            *scale = 0.35f;
+            *fpsCap = 15;
+            break;
+    }
+}
+
+void cCameraConfig_Negotiate(const cCameraConfig* requested, const cCameraBudget* budget, cCameraConfig* result)
+{
+    float scale;
+    int fpsCap;
+
+    *result = *requested;
+    getThermalLimits(budget->thermal, &scale, &fpsCap);
+
+    // Capture no more pixels than the view can show
+    if (budget->viewWidth > 0 && budget->viewHeight > 0)
+    {
+        float fitLong = (float) SDL_max(budget->viewWidth, budget->viewHeight) /
+                        (float) SDL_max(requested->width, requested->height);
+        float fitShort = (float) SDL_min(budget->viewWidth, budget->viewHeight) /
+                         (float) SDL_min(requested->width, requested->height);
+        scale *= SDL_min(SDL_min(fitLong, fitShort), 1.0f);
+    }
+
+    // Scale the width, keep the aspect ratio, and stay on even sizes for the chroma planes
+    int width = SDL_max((int) ((float) requested->width * scale), SDL_min(CAMERA_MIN_WIDTH, requested->width));
+    result->width = SDL_max(width & ~1, 2);
+    result->height = SDL_max((int) ((Sint64) result->width * requested->height / requested->width) & ~1, 2);
+
+    // Lower the frame rate under thermal pressure
+    if (fpsCap > 0)
+    {
+        result->maxFps = SDL_min(requested->maxFps, fpsCap);
+        result->minFps = SDL_min(requested->minFps, result->maxFps);
+    }
+
+    // Queued frames only add work and latency when the device is throttling
+    if (budget->thermal >= THERMAL_STATUS_SEVERE)
+    {
+        result->queueDepth = 0;
+    }
+}
+
+bool cCameraConfig_NeedsRebind(const cCameraConfig* current, const cCameraConfig* next)
+{
+    if (current->lensFacing != next->lensFacing || current->format != next->format ||
+        current->minFps != next->minFps || current->maxFps != next->maxFps ||
+        current->queueDepth != next->queueDepth)
+    {
+        return true;
+    }
+
+    // Ignore size changes too small to be worth restarting the camera
+    float currentArea = (float) current->width * (float) current->height;
+    float nextArea = (float) next->width * (float) next->height;
+    return nextArea > currentArea * CAMERA_REBIND_AREA_RATIO ||
+           nextArea * CAMERA_REBIND_AREA_RATIO < currentArea;
+}
+
+/**
+ * @brief Negotiates the configuration again and applies it if it is worth it.
+ *
+ * @param me Pointer to the `cCameraNegotiator`.
+ * @param force `true` to apply the configuration even if it did not change.
+ * @return `false` if the configuration had to be applied and could not be, `true` otherwise.
+ */
+static bool renegotiate(cCameraNegotiator* me, bool force)
+{
+    cCameraConfig next;
+
+    if (!me->started)
+    {
+        return true;  // The camera is configured once started
+    }
+
+    cCameraConfig_Negotiate(&me->requested, &me->budget, &next);
+    if (!force && !cCameraConfig_NeedsRebind(&me->current, &next))
+    {
+        return true;
+    }
+
+    SDL_Log("Camera configuration: %dx%d, %d-%d fps, lens %d, format %d, queue %d",
+            next.width, next.height, next.minFps, next.maxFps, next.lensFacing, next.format, next.queueDepth);
+    if (!me->apply(me->userdata, &next))
+    {
+        return false;
+    }
+
+    me->current = next;
+    me->rebinds++;
+    return true;
+}
+
+bool cCameraNegotiator_New(cCameraNegotiator** addressNegotiator, const cCameraConfig* requested,
+                           cCameraApply apply, void* userdata)
+{
+    // Allocate memory for the negotiator and initialize all fields to zero
+    *addressNegotiator = calloc(1, sizeof(cCameraNegotiator));
+    if (*addressNegotiator == NULL)
+    {
+        LOG_MESSAGE(strerror(errno));  // Log the error message if allocation failed
+        return false;
+    }
+
+    (*addressNegotiator)->requested = *requested;
+    (*addressNegotiator)->budget.thermal = THERMAL_STATUS_NONE;
+    (*addressNegotiator)->apply = apply;
+    (*addressNegotiator)->userdata = userdata;
+    return true;
+}
+
+void cCameraNegotiator_Destroy(cCameraNegotiator* me)
+{
+    // Check if the negotiator pointer itself is NULL; if so, exit function early
+    if (me == NULL)
+    {
+        return;
+    }
+
+    free_memory((void **) &me, free);
+}
+
+bool cCameraNegotiator_Start(cCameraNegotiator* me)
+{
+    me->started = true;
+    return renegotiate(me, true);
+}
+
+bool cCameraNegotiator_SetView(cCameraNegotiator* me, int width, int height)
+{
+    me->budget.viewWidth = width;
+    me->budget.viewHeight = height;
+    return renegotiate(me, false);
+}
+
+bool cCameraNegotiator_SetThermalStatus(cCameraNegotiator* me, cThermalStatus thermal)
+{
+    me->budget.thermal = thermal;
+    return renegotiate(me, false);
+}
@@ -0,0 +1,169 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Native camera configuration: the application states what it would like to
+ * capture (size, frame rate range, lens, output format and queue depth), and
+ * the negotiator derives what is actually worth capturing from the area the
+ * stream is shown in and the thermal state of the device. The result is only
+ * handed to the camera, through a bridge function, when it differs enough from
+ * the current configuration to justify rebinding the camera.
+ *
+ * The decision logic does not depend on JNI; on Android the bridge calls the
+ * activity, elsewhere any function with the same signature can stand in for it.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#ifndef CAMERAXSDL3_CAMERA_CONFIG_H
+#define CAMERAXSDL3_CAMERA_CONFIG_H
+
+#include <SDL3/SDL.h>
+
+#define CAMERA_MIN_WIDTH 160            // Smallest width ever requested from the camera
+#define CAMERA_REBIND_AREA_RATIO 1.25f  // Size change, in pixel count, below which the camera is left alone
+
+// Camera to open; the values match CameraX `CameraSelector.LENS_FACING_*`
+typedef enum
+{
+    LENS_FACING_FRONT = 0,
+    LENS_FACING_BACK = 1
+} cLensFacing;
+
+// Pixel format delivered by the camera; the values match CameraX `ImageAnalysis.OUTPUT_IMAGE_FORMAT_*`
+typedef enum
+{
+    CAMERA_FORMAT_YUV_420_888 = 1,
+    CAMERA_FORMAT_RGBA_8888 = 2
+} cCameraFormat;
+
+// Thermal state of the device; the values match Android `PowerManager.THERMAL_STATUS_*`
+typedef enum
+{
+    THERMAL_STATUS_NONE = 0,
+    THERMAL_STATUS_LIGHT,
+    THERMAL_STATUS_MODERATE,
+    THERMAL_STATUS_SEVERE,
+    THERMAL_STATUS_CRITICAL,
+    THERMAL_STATUS_EMERGENCY,
+    THERMAL_STATUS_SHUTDOWN
+} cThermalStatus;
+
+// Camera configuration
+typedef struct camera_config_s
+{
+    int width;                // Target width of the frames in pixels
+    int height;               // Target height of the frames in pixels
+    int minFps;               // Lower bound of the frame rate range
+    int maxFps;               // Upper bound of the frame rate range
+    cLensFacing lensFacing;   // Camera to open
+    cCameraFormat format;     // Pixel format of the frames
+    int queueDepth;           // Frames the camera may queue; 0 keeps only the latest frame
+} cCameraConfig;
+
+// Limits the camera configuration is negotiated against
+typedef struct camera_budget_s
+{
+    int viewWidth;            // Width of the area the stream is shown in, 0 if unknown
+    int viewHeight;           // Height of the area the stream is shown in, 0 if unknown
+    cThermalStatus thermal;   // Current thermal state of the device
+} cCameraBudget;
+
+/**
+ * Applies a configuration to the camera (e.g. through JNI on Android).
+ * Returns `false` if the camera could not be reconfigured.
+ */
+typedef bool (*cCameraApply)(void* userdata, const cCameraConfig* config);
+
+// Requested configuration, budget and configuration in use
+typedef struct camera_negotiator_s
+{
+    cCameraConfig requested;  // What the application asked for
+    cCameraBudget budget;     // Current limits
+    cCameraConfig current;    // Configuration last applied to the camera
+    bool started;             // Whether the camera may be configured (e.g. permission granted)
+    cCameraApply apply;       // Bridge to the camera
+    void* userdata;           // Argument of `apply`
+    int rebinds;              // Number of configurations applied
+} cCameraNegotiator;
+
+/**
+ * @brief Derives the configuration to use from a request and a budget.
+ *
+ * The frame size keeps the requested aspect ratio and never exceeds what the
+ * view can show, comparing long sides with long sides since the sensor and the
+ * screen may be rotated relative to each other. Thermal pressure scales the
+ * size further down, caps the frame rate and disables frame queueing.
+ *
+ * @param requested Configuration asked for by the application.
+ * @param budget Current limits.
+ * @param result Configuration to use.
+ */
+void cCameraConfig_Negotiate(const cCameraConfig* requested, const cCameraBudget* budget, cCameraConfig* result);
+
+/**
+ * @brief Tells whether switching between two configurations is worth rebinding the camera.
+ *
+ * Any change other than the size requires it; size changes only do when the
+ * pixel count changes by more than `CAMERA_REBIND_AREA_RATIO`, so that small
+ * window adjustments do not restart the camera.
+ *
+ * @param current Configuration in use.
+ * @param next Newly negotiated configuration.
+ * @return `true` if the camera should be reconfigured, `false` otherwise.
+ */
+bool cCameraConfig_NeedsRebind(const cCameraConfig* current, const cCameraConfig* next);
+
+/**
+ * @brief Allocates a `cCameraNegotiator`; the camera is not configured until started.
+ *
+ * @param addressNegotiator Double pointer to a `cCameraNegotiator*` which will point
+ *                          to the newly allocated negotiator if successful.
+ * @param requested Configuration asked for by the application.
+ * @param apply Function applying a configuration to the camera.
+ * @param userdata Argument passed to `apply`.
+ * @return `true` if the allocation succeeds, `false` otherwise.
+ */
+bool cCameraNegotiator_New(cCameraNegotiator** addressNegotiator, const cCameraConfig* requested,
+                           cCameraApply apply, void* userdata);
+
+/**
+ * @brief Frees a `cCameraNegotiator`.
+ *
+ * @param me Pointer to the `cCameraNegotiator` to destroy; may be NULL.
+ */
+void cCameraNegotiator_Destroy(cCameraNegotiator* me);
+
+/**
+ * @brief Allows the camera to be configured and applies the current negotiation.
+ *
+ * @param me Pointer to the `cCameraNegotiator`.
+ * @return `true` if the configuration was applied, `false` otherwise.
+ */
+bool cCameraNegotiator_Start(cCameraNegotiator* me);
+
+/**
+ * @brief Updates the size of the area the stream is shown in and renegotiates.
+ *
+ * @param me Pointer to the `cCameraNegotiator`.
+ * @param width Width of the view in pixels.
+ * @param height Height of the view in pixels.
+ * @return `false` if a needed reconfiguration failed, `true` otherwise.
+ */
+bool cCameraNegotiator_SetView(cCameraNegotiator* me, int width, int height);
+
+/**
+ * @brief Updates the thermal state of the device and renegotiates.
+ *
+ * @param me Pointer to the `cCameraNegotiator`.
+ * @param thermal New thermal state.
+ * @return `false` if a needed reconfiguration failed, `true` otherwise.
+ */
+bool cCameraNegotiator_SetThermalStatus(cCameraNegotiator* me, cThermalStatus thermal);
+
+#endif // CAMERAXSDL3_CAMERA_CONFIG_H
@@ -0,0 +1,22 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Helpers shared by the native sources of the application: logging and
+ * resource release.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "common.h"
+
+void free_memory(void** mem, void (*freeFunc)(void*))
+{
+    freeFunc(*mem);  // Call the specified free function to release the memory
+    *mem = NULL;
+}
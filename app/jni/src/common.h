@@ -0,0 +1,36 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Helpers shared by the native sources of the application: logging and
+ * resource release.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#ifndef CAMERAXSDL3_COMMON_H
+#define CAMERAXSDL3_COMMON_H
+
+#include <SDL3/SDL.h>
+
+#define LOG_MESSAGE(message) SDL_Log("Thread ID: %lu, %s", SDL_GetCurrentThreadID(), message)
+
+/**
+ * @brief Frees dynamically allocated memory using a specified free function.
+ *
+ * This function takes a pointer to memory and a custom free function,
+ * calls the free function to deallocate the memory, and then sets the
+ * pointer to NULL to avoid dangling pointers.
+ *
+ * @param mem      Pointer to the memory that needs to be freed.
+ * @param freeFunc Function pointer to the specific free function to
+ *                 deallocate the memory.
+ */
+void free_memory(void** mem, void (*freeFunc)(void*));
+
+#endif // CAMERAXSDL3_COMMON_H
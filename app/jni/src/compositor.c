@@ -0,0 +1,331 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Multi-stream compositor: several camera or image streams, each with its own
+ * mailbox, texture and layout rectangle, drawn together in a single render pass.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "compositor.h"
+#include "common.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#define PIP_SCALE  0.25f  // Size of a picture in picture inset relative to the screen
+#define PIP_MARGIN 16.0f  // Gap in pixels between insets and the screen edges
+
+/**
+ * @brief Calculates and sets the dimensions and position of a rectangle to fit
+ *        within a display rectangle while maintaining aspect ratio.
+ *
+ * This function centers a target rectangle within a given display rectangle
+ * and adjusts its dimensions based on the aspect ratio and rotation.
+ * For portrait orientations, it swaps width and height adjustments.
+ *
+ * @param rect       Pointer to the `SDL_FRect` where the calculated rectangle will be stored.
+ * @param displayRect Pointer to the `SDL_FRect` defining the display area.
+ * @param rotation   Rotation angle (90, 180, 270) to adjust width and height orientation.
+ * @param videoRatio Aspect ratio of the video, used to maintain consistent scaling.
+ */
+static void calculateRect(SDL_FRect* rect, const SDL_FRect* displayRect,
+                          int rotation, float videoRatio)
+{
+    // Find the center point of the display rectangle
+    SDL_FPoint mid;
+    mid.x = displayRect->x + (displayRect->w / 2);
+    mid.y = displayRect->y + (displayRect->h / 2);
+
+    // Initialize width and height based on the display rectangle's dimensions
+    float adjustedWidth = displayRect->w;
+    float adjustedHeight = displayRect->h;
+
+    // Adjust dimensions to maintain the aspect ratio, with orientation consideration
+    if (rotation == 90 || rotation == 270)
+    {
+        // For portrait orientation, adjust width based on video aspect ratio
+        if (adjustedHeight > adjustedWidth * videoRatio)
+        {
+            adjustedWidth = adjustedHeight / videoRatio;
+        }
+        else
+        {
+            adjustedHeight = adjustedWidth * videoRatio;
+        }
+    }
+    else
+    {
+        // For landscape orientation, adjust height based on video aspect ratio
+        if (adjustedWidth > adjustedHeight * videoRatio)
+        {
+            adjustedHeight = adjustedWidth / videoRatio;
+        }
+        else
+        {
+            adjustedWidth = adjustedHeight * videoRatio;
+        }
+    }
+
+    // Set the final width and height of `rect` based on rotation requirements
+    if (rotation == 90 || rotation == 270)
+    {
+        rect->w = adjustedHeight;  // Swap width and height for portrait orientation
+        rect->h = adjustedWidth;
+    }
+    else
+    {
+        rect->w = adjustedWidth;
+        rect->h = adjustedHeight;
+    }
+
+    // Center the rectangle within the display rectangle
+    rect->x = mid.x - (rect->w / 2);
+    rect->y = mid.y - (rect->h / 2);
+}
+
+/**
+ * @brief Assigns a cell to every stream according to the current layout.
+ *
+ * The texture rectangles are invalidated so they get recomputed inside their
+ * new cell on the next render.
+ *
+ * @param me Pointer to the `cCompositor` to lay out.
+ */
+static void cCompositor_Layout(cCompositor* me)
+{
+    const SDL_FRect* screen = &me->screen;
+
+    for (int i = 0; i < me->count; ++i)
+    {
+        cStream* stream = &me->streams[i];
+        stream->visible = true;
+        stream->layer = 0;
+        stream->rectRatio = 0.0f;  // Force the texture rectangle to be recomputed
+
+        switch (me->mode)
+        {
+            case LAYOUT_SINGLE:
+            {
+                // Only the first stream is shown, over the whole screen
+                stream->cell = *screen;
+                stream->visible = (i == 0);
+                break;
+            }
+
+            case LAYOUT_GRID:
+            {
+                // As square a grid as possible, filled row by row
+                int columns = (int) SDL_ceilf(SDL_sqrtf((float) me->count));
+                int rows = (me->count + columns - 1) / columns;
+                stream->cell.w = screen->w / (float) columns;
+                stream->cell.h = screen->h / (float) rows;
+                stream->cell.x = screen->x + (float) (i % columns) * stream->cell.w;
+                stream->cell.y = screen->y + (float) (i / columns) * stream->cell.h;
+                break;
+            }
+
+            case LAYOUT_PICTURE_IN_PICTURE:
+            {
+                if (i == 0)
+                {
+                    // Main stream over the whole screen
+                    stream->cell = *screen;
+                }
+                else
+                {
+                    // Insets stacked upwards from the bottom right corner, above the main stream
+                    stream->cell.w = screen->w * PIP_SCALE;
+                    stream->cell.h = screen->h * PIP_SCALE;
+                    stream->cell.x = screen->x + screen->w - stream->cell.w - PIP_MARGIN;
+                    stream->cell.y = screen->y + screen->h - (float) i * (stream->cell.h + PIP_MARGIN);
+                    stream->layer = 1;
+                }
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Orders two streams by layer, then by creation order.
+ *
+ * Used with `SDL_qsort` to build the draw order of the compositor. Every stream
+ * owns its texture, so there are no shared textures to group; streams of the
+ * same layer keep their creation order, as `SDL_qsort` is not stable.
+ *
+ * @param a Pointer to the first `cStream*`.
+ * @param b Pointer to the second `cStream*`.
+ * @return A negative, zero or positive value as `a` sorts before, with or after `b`.
+ */
+static int SDLCALL compareStreams(const void* a, const void* b)
+{
+    const cStream* left = *(const cStream* const*) a;
+    const cStream* right = *(const cStream* const*) b;
+
+    if (left->layer != right->layer)
+    {
+        return (left->layer < right->layer) ? -1 : 1;
+    }
+
+    // Streams live in an array, in creation order
+    if (left != right)
+    {
+        return (left < right) ? -1 : 1;
+    }
+    return 0;
+}
+
+bool cCompositor_New(cCompositor** addressCompositor, SDL_Renderer* renderer, int count, cLayoutMode mode)
+{
+    // Allocate memory for the compositor and initialize all fields to zero
+    *addressCompositor = calloc(1, sizeof(cCompositor));
+    if (*addressCompositor == NULL)
+    {
+        LOG_MESSAGE(strerror(errno));  // Log the error message if allocation failed
+        goto EXIT;
+    }
+
+    if (count < 1 || count > COMPOSITOR_MAX_STREAMS)
+    {
+        LOG_MESSAGE("Invalid number of compositor streams");
+        goto EXIT;
+    }
+
+    (*addressCompositor)->renderer = renderer;
+    (*addressCompositor)->mode = mode;
+
+    // Create the image of every stream
+    for (int i = 0; i < count; ++i)
+    {
+        if (!cImage_New(&(*addressCompositor)->streams[i].image, renderer))
+        {
+            goto EXIT;
+        }
+        (*addressCompositor)->count++;
+    }
+
+    return true;
+
+    EXIT:
+    cCompositor_Destroy(*addressCompositor);  // Clean up allocated resources on failure
+    *addressCompositor = NULL;
+    return false;
+}
+
+void cCompositor_Destroy(cCompositor* me)
+{
+    // Check if the compositor pointer itself is NULL; if so, exit function early
+    if (me == NULL)
+    {
+        return;
+    }
+
+    // Destroy the image of every stream
+    for (int i = 0; i < me->count; ++i)
+    {
+        cImage_Destroy(me->streams[i].image);
+        me->streams[i].image = NULL;
+    }
+
+    // Finally, free the compositor structure itself
+    free_memory((void **) &me, free);
+}
+
+cImage* cCompositor_GetImage(cCompositor* me, int index)
+{
+    if (me == NULL || index < 0 || index >= me->count)
+    {
+        return NULL;
+    }
+    return me->streams[index].image;
+}
+
+void cCompositor_SetLayout(cCompositor* me, cLayoutMode mode)
+{
+    me->mode = mode;
+    cCompositor_Layout(me);
+}
+
+void cCompositor_Resize(cCompositor* me, const SDL_FRect* screen, int orientation)
+{
+    me->screen = *screen;
+    me->orientation = orientation;
+    cCompositor_Layout(me);
+}
+
+bool cCompositor_Render(cCompositor* me)
+{
+    bool ret = false;  // Default return value, assuming failure
+    int drawCount = 0;
+
+    for (int i = 0; i < me->count; ++i)
+    {
+        cStream* stream = &me->streams[i];
+        if (!stream->visible)
+        {
+            continue;
+        }
+
+        // Upload the newest frame of the stream, if any
+        if (!cImage_TextureUpdate(stream->image))
+        {
+            goto EXIT;
+        }
+        if (stream->image->texture == NULL)
+        {
+            continue;  // Nothing received yet
+        }
+
+        // Recompute the texture rectangle only when the video aspect ratio changed
+        if (stream->rectRatio != stream->image->videoRatio)
+        {
+            calculateRect(&stream->rect, &stream->cell, me->orientation, stream->image->videoRatio);
+            stream->rectRatio = stream->image->videoRatio;
+        }
+
+        me->drawOrder[drawCount++] = stream;
+    }
+
+    SDL_qsort(me->drawOrder, drawCount, sizeof(*me->drawOrder), compareStreams);
+
+    for (int i = 0; i < drawCount; ++i)
+    {
+        cStream* stream = me->drawOrder[i];
+
+        // Keep the stream inside its cell, as the texture may overflow it to fill it
+        SDL_Rect clip = {
+            (int) stream->cell.x, (int) stream->cell.y,
+            (int) stream->cell.w, (int) stream->cell.h
+        };
+        bool clipped = (me->mode != LAYOUT_SINGLE);
+        if (clipped && !SDL_SetRenderClipRect(me->renderer, &clip))
+        {
+            LOG_MESSAGE(SDL_GetError());
+            goto EXIT;
+        }
+
+        if (!cImage_Render(stream->image, &stream->rect, me->orientation))
+        {
+            goto EXIT;
+        }
+
+        if (clipped && !SDL_SetRenderClipRect(me->renderer, NULL))
+        {
+            LOG_MESSAGE(SDL_GetError());
+            goto EXIT;
+        }
+    }
+
+    ret = true;  // Set return value to true to indicate success
+
+    EXIT:
+    return ret;
+}
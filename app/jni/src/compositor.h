@@ -0,0 +1,117 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Multi-stream compositor: several camera or image streams, each with its own
+ * mailbox, texture and layout rectangle, drawn together in a single render pass.
+ * The layout engine places the streams full screen, in a grid, or as picture in
+ * picture, and only recomputes their rectangles when the screen is resized or a
+ * stream changes aspect ratio.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#ifndef CAMERAXSDL3_COMPOSITOR_H
+#define CAMERAXSDL3_COMPOSITOR_H
+
+#include <SDL3/SDL.h>
+
+#include "image.h"
+
+#define COMPOSITOR_MAX_STREAMS 8
+
+// How the streams are placed on screen
+typedef enum layout_mode_e
+{
+    LAYOUT_SINGLE,              // Only the first stream, full screen
+    LAYOUT_GRID,                // All streams in a grid of equal cells
+    LAYOUT_PICTURE_IN_PICTURE   // First stream full screen, the others as insets on top
+} cLayoutMode;
+
+// A stream of the compositor and where it is drawn
+typedef struct stream_s
+{
+    cImage* image;        // Image receiving the frames of the stream
+    SDL_FRect cell;       // Area assigned to the stream by the layout
+    SDL_FRect rect;       // Destination of the texture inside `cell`, before rotation
+    float rectRatio;      // Video aspect ratio `rect` was computed for
+    int layer;            // Stacking order, higher layers are drawn last
+    bool visible;         // Whether the layout shows the stream at all
+} cStream;
+
+// Set of streams sharing one renderer
+typedef struct compositor_s
+{
+    SDL_Renderer* renderer;   // Renderer every stream is drawn with
+    cStream streams[COMPOSITOR_MAX_STREAMS]; // The streams, in creation order
+    cStream* drawOrder[COMPOSITOR_MAX_STREAMS]; // Visible streams sorted by layer, then creation order
+    int count;                // Number of streams
+    cLayoutMode mode;         // Current layout
+    SDL_FRect screen;         // Area the layout is computed for
+    int orientation;          // Rotation applied to every stream (0, 90, 180, or 270)
+} cCompositor;
+
+/**
+ * @brief Allocates a `cCompositor` with `count` empty streams.
+ *
+ * @param addressCompositor Double pointer to a `cCompositor*` which will point to
+ *                          the newly allocated compositor if successful.
+ * @param renderer Renderer the streams are drawn with.
+ * @param count Number of streams, between 1 and COMPOSITOR_MAX_STREAMS.
+ * @param mode Initial layout of the streams.
+ * @return `true` if the allocation and initialization succeed, `false` otherwise.
+ */
+bool cCompositor_New(cCompositor** addressCompositor, SDL_Renderer* renderer, int count, cLayoutMode mode);
+
+/**
+ * @brief Destroys a `cCompositor` and the images of all its streams.
+ *
+ * @param me Pointer to the `cCompositor` to destroy; may be NULL.
+ */
+void cCompositor_Destroy(cCompositor* me);
+
+/**
+ * @brief Returns the image fed by a stream producer.
+ *
+ * @param me Pointer to the `cCompositor`.
+ * @param index Index of the stream.
+ * @return The image of the stream, or NULL if `index` is out of range.
+ */
+cImage* cCompositor_GetImage(cCompositor* me, int index);
+
+/**
+ * @brief Changes the layout and recomputes the stream rectangles.
+ *
+ * @param me Pointer to the `cCompositor`.
+ * @param mode New layout of the streams.
+ */
+void cCompositor_SetLayout(cCompositor* me, cLayoutMode mode);
+
+/**
+ * @brief Recomputes the stream rectangles for a new screen area or orientation.
+ *
+ * Meant to be called on `SDL_EVENT_WINDOW_RESIZED`, not every frame.
+ *
+ * @param me Pointer to the `cCompositor`.
+ * @param screen Area available to the streams.
+ * @param orientation Rotation applied to every stream (0, 90, 180, or 270).
+ */
+void cCompositor_Resize(cCompositor* me, const SDL_FRect* screen, int orientation);
+
+/**
+ * @brief Uploads the newest frame of every stream and draws all visible streams.
+ *
+ * Only the rectangles of streams whose aspect ratio changed are recomputed. The
+ * draws are issued by layer, and within a layer in creation order.
+ *
+ * @param me Pointer to the `cCompositor`.
+ * @return `true` if every stream is rendered, `false` if an error occurs.
+ */
+bool cCompositor_Render(cCompositor* me);
+
+#endif // CAMERAXSDL3_COMPOSITOR_H
@@ -0,0 +1,316 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * YUV frames: a grow-only buffer holding the planes of a frame together with
+ * their layout, and lightweight views used to hand the planes to processing code.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "frame.h"
+#include "common.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+bool cFrame_Reserve(cFrame* me, size_t length)
+{
+    // Nothing to do if the current buffer is already large enough
+    if (length <= me->length)
+    {
+        return true;
+    }
+
+    // Free the existing data buffer if it exists
+    if (me->data != NULL)
+    {
+        free_memory((void **) &me->data, free);
+    }
+    me->length = 0;
+
+    // Allocate a new buffer for the frame data
+    me->data = calloc(length, sizeof(*me->data));
+    if (me->data == NULL)  // Check for memory allocation failure
+    {
+        LOG_MESSAGE(strerror(errno));  // Log error if allocation fails
+        return false;
+    }
+
+    me->length = length;
+    return true;
+}
+
+/**
+ * @brief Classifies the memory layout of the chroma planes of a YUV_420_888 frame.
+ *
+ * YUV_420_888 only guarantees three planes with arbitrary strides, but devices
+ * almost always deliver one of three well-known layouts underneath:
+ * - semi-planar NV12: pixel stride 2 and the V plane starts one byte after the U plane,
+ * - semi-planar NV21: pixel stride 2 and the U plane starts one byte after the V plane,
+ * - planar I420: pixel stride 1 with separate U and V planes.
+ * Recognizing them lets the frame be uploaded as-is with its real pitches.
+ *
+ * @param uPlane Pointer to the first byte of the U (Cb) plane.
+ * @param vPlane Pointer to the first byte of the V (Cr) plane.
+ * @param uvPixelStride Distance in bytes between two chroma samples of a row.
+ * @return `SDL_PIXELFORMAT_NV12`, `SDL_PIXELFORMAT_NV21` or `SDL_PIXELFORMAT_IYUV`
+ *         for the recognized layouts, `SDL_PIXELFORMAT_UNKNOWN` otherwise.
+ */
+static SDL_PixelFormat classifyYUVLayout(const uint8_t* uPlane, const uint8_t* vPlane, int uvPixelStride)
+{
+    if (uvPixelStride == 2)
+    {
+        // Overlapping interleaved chroma, the first sample tells the order
+        if (vPlane == uPlane + 1)
+        {
+            return SDL_PIXELFORMAT_NV12;
+        }
+        if (uPlane == vPlane + 1)
+        {
+            return SDL_PIXELFORMAT_NV21;
+        }
+    }
+    else if (uvPixelStride == 1)
+    {
+        // Fully planar chroma
+        return SDL_PIXELFORMAT_IYUV;
+    }
+
+    // Anything else (e.g. interleaved samples in separate buffers) needs repacking
+    return SDL_PIXELFORMAT_UNKNOWN;
+}
+
+bool cFrame_WritePlanes(cFrame* frame,
+                        const uint8_t* yPlane, const uint8_t* uPlane, const uint8_t* vPlane,
+                        int yRowStride, int uvRowStride, int uvPixelStride,
+                        int width, int height, Uint64 captureTicks)
+{
+    bool ret = false;  // Default return value, assuming failure
+    Uint64 ingestStart = SDL_GetTicksNS();
+
+    int chromaWidth = (width + 1) / 2;
+    int chromaHeight = (height + 1) / 2;
+    SDL_PixelFormat format = classifyYUVLayout(uPlane, vPlane, uvPixelStride);
+
+    // Number of bytes spanned by each plane, from its first sample to its last one
+    size_t lumaSpan = (size_t) (height - 1) * yRowStride + width;
+    size_t chromaSpan = (size_t) (chromaHeight - 1) * uvRowStride + (size_t) (chromaWidth - 1) * uvPixelStride + 1;
+
+    switch (format)
+    {
+        case SDL_PIXELFORMAT_NV12:
+        case SDL_PIXELFORMAT_NV21:
+        {
+            // The interleaved plane starts at whichever of U and V comes first
+            // and ends one byte past the last sample of the other one
+            const uint8_t* uvPlane = (format == SDL_PIXELFORMAT_NV12) ? uPlane : vPlane;
+            size_t uvSpan = chromaSpan + 1;
+
+            if (!cFrame_Reserve(frame, lumaSpan + uvSpan))
+            {
+                goto EXIT;
+            }
+            memcpy(frame->data, yPlane, lumaSpan);
+            memcpy(frame->data + lumaSpan, uvPlane, uvSpan);
+
+            frame->offsets[0] = 0;
+            frame->offsets[1] = lumaSpan;
+            frame->pitches[0] = yRowStride;
+            frame->pitches[1] = uvRowStride;
+            break;
+        }
+
+        case SDL_PIXELFORMAT_IYUV:
+        {
+            if (!cFrame_Reserve(frame, lumaSpan + chromaSpan * 2))
+            {
+                goto EXIT;
+            }
+            memcpy(frame->data, yPlane, lumaSpan);
+            memcpy(frame->data + lumaSpan, uPlane, chromaSpan);
+            memcpy(frame->data + lumaSpan + chromaSpan, vPlane, chromaSpan);
+
+            frame->offsets[0] = 0;
+            frame->offsets[1] = lumaSpan;
+            frame->offsets[2] = lumaSpan + chromaSpan;
+            frame->pitches[0] = yRowStride;
+            frame->pitches[1] = uvRowStride;
+            frame->pitches[2] = uvRowStride;
+            break;
+        }
+
+        default:
+        {
+            // Unknown layout: repack into tightly packed NV12
+            size_t lumaSize = (size_t) width * height;
+            if (!cFrame_Reserve(frame, lumaSize + (size_t) chromaWidth * 2 * chromaHeight))
+            {
+                goto EXIT;
+            }
+
+            // Copy the luma rows, dropping any row padding
+            uint8_t* dst = frame->data;
+            for (int row = 0; row < height; ++row)
+            {
+                memcpy(dst, yPlane + (size_t) row * yRowStride, width);
+                dst += width;
+            }
+
+            // Interleave the chroma samples as U/V pairs
+            for (int row = 0; row < chromaHeight; ++row)
+            {
+                const uint8_t* u = uPlane + (size_t) row * uvRowStride;
+                const uint8_t* v = vPlane + (size_t) row * uvRowStride;
+                for (int col = 0; col < chromaWidth; ++col)
+                {
+                    dst[col * 2] = u[col * uvPixelStride];
+                    dst[col * 2 + 1] = v[col * uvPixelStride];
+                }
+                dst += chromaWidth * 2;
+            }
+
+            format = SDL_PIXELFORMAT_NV12;
+            frame->offsets[0] = 0;
+            frame->offsets[1] = lumaSize;
+            frame->pitches[0] = width;
+            frame->pitches[1] = chromaWidth * 2;
+            break;
+        }
+    }
+
+    // Set frame properties
+    frame->format = format;
+    frame->colorspace = SDL_COLORSPACE_YUV_DEFAULT;
+    frame->width = width;
+    frame->height = height;
+    SDL_zero(frame->timing);
+    frame->timing.capture = captureTicks;
+    frame->timing.ingestStart = ingestStart;
+    frame->timing.ingestEnd = SDL_GetTicksNS();
+
+    ret = true;  // Set return value to true to indicate success
+
+    EXIT:
+    return ret;
+}
+
+bool cFrame_WritePacked(cFrame* frame, const uint8_t* pixels, int rowStride,
+                        SDL_PixelFormat format, int width, int height, Uint64 captureTicks)
+{
+    Uint64 ingestStart = SDL_GetTicksNS();
+
+    // Copy the whole image at once, keeping the camera row pitch
+    size_t span = (size_t) (height - 1) * rowStride + (size_t) width * SDL_BYTESPERPIXEL(format);
+    if (!cFrame_Reserve(frame, span))
+    {
+        return false;
+    }
+    memcpy(frame->data, pixels, span);
+
+    // Set frame properties
+    frame->format = format;
+    frame->colorspace = SDL_COLORSPACE_SRGB;
+    frame->offsets[0] = frame->offsets[1] = frame->offsets[2] = 0;
+    frame->pitches[0] = rowStride;
+    frame->pitches[1] = frame->pitches[2] = 0;
+    frame->width = width;
+    frame->height = height;
+    SDL_zero(frame->timing);
+    frame->timing.capture = captureTicks;
+    frame->timing.ingestStart = ingestStart;
+    frame->timing.ingestEnd = SDL_GetTicksNS();
+    return true;
+}
+
+bool cFrame_Allocate(cFrame* frame, SDL_PixelFormat format, int width, int height)
+{
+    int chromaWidth = (width + 1) / 2;
+    int chromaHeight = (height + 1) / 2;
+    size_t lumaSize = (size_t) width * height;
+    size_t chromaSize = (size_t) chromaWidth * chromaHeight;
+
+    if (!cFrame_Reserve(frame, lumaSize + chromaSize * 2))
+    {
+        return false;
+    }
+
+    frame->format = format;
+    frame->width = width;
+    frame->height = height;
+    frame->offsets[0] = 0;
+    frame->offsets[1] = lumaSize;
+    frame->pitches[0] = width;
+
+    if (format == SDL_PIXELFORMAT_IYUV)
+    {
+        // Separate U and V planes
+        frame->offsets[2] = lumaSize + chromaSize;
+        frame->pitches[1] = chromaWidth;
+        frame->pitches[2] = chromaWidth;
+    }
+    else
+    {
+        // One interleaved chroma plane
+        frame->offsets[2] = 0;
+        frame->pitches[1] = chromaWidth * 2;
+        frame->pitches[2] = 0;
+    }
+
+    return true;
+}
+
+void cFrame_GetView(cFrame* frame, cYUVView* view)
+{
+    view->format = frame->format;
+    view->width = frame->width;
+    view->height = frame->height;
+    view->planes[0] = frame->data + frame->offsets[0];
+    view->planes[1] = frame->data + frame->offsets[1];
+    view->pitches[0] = frame->pitches[0];
+    view->pitches[1] = frame->pitches[1];
+
+    if (frame->format == SDL_PIXELFORMAT_IYUV)
+    {
+        view->planes[2] = frame->data + frame->offsets[2];
+        view->pitches[2] = frame->pitches[2];
+    }
+    else
+    {
+        view->planes[2] = NULL;
+        view->pitches[2] = 0;
+    }
+}
+
+bool cFrame_CopyView(cFrame* frame, const cYUVView* view)
+{
+    if (!cFrame_Allocate(frame, view->format, view->width, view->height))
+    {
+        return false;
+    }
+
+    cYUVView target;
+    cFrame_GetView(frame, &target);
+
+    // Bytes per row and number of rows of every plane
+    int chromaHeight = (view->height + 1) / 2;
+    int planeCount = (view->format == SDL_PIXELFORMAT_IYUV) ? 3 : 2;
+    for (int plane = 0; plane < planeCount; ++plane)
+    {
+        int rows = (plane == 0) ? view->height : chromaHeight;
+        int bytes = target.pitches[plane];
+        for (int row = 0; row < rows; ++row)
+        {
+            memcpy(target.planes[plane] + (size_t) row * target.pitches[plane],
+                   view->planes[plane] + (size_t) row * view->pitches[plane], bytes);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,135 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * YUV frames: a grow-only buffer holding the planes of a frame together with
+ * their layout, and lightweight views used to hand the planes to processing code.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#ifndef CAMERAXSDL3_FRAME_H
+#define CAMERAXSDL3_FRAME_H
+
+#include <SDL3/SDL.h>
+
+#include "latency.h"
+
+// A YUV frame and the buffer holding its planes
+typedef struct frame_s
+{
+    uint8_t* data;        // Pointer to the raw image data (pixel information)
+    size_t length;        // Size of the allocated data buffer in bytes
+    SDL_PixelFormat format; // Layout of the planes: NV12, NV21, IYUV, or a packed RGB format
+    SDL_Colorspace colorspace; // Colorspace of the pixel data
+    size_t offsets[3];    // Offset of each plane from the start of `data`
+    int pitches[3];       // Row pitch of each plane in bytes, padding included
+    int width;            // Width of the image in pixels
+    int height;           // Height of the image in pixels
+    cFrameTiming timing;  // Time stamps gathered along the frame path
+} cFrame;
+
+// Planes of a YUV frame, without ownership
+typedef struct yuv_view_s
+{
+    SDL_PixelFormat format; // NV12, NV21 or IYUV
+    int width;            // Width of the image in pixels
+    int height;           // Height of the image in pixels
+    uint8_t* planes[3];   // Luma plane, then the chroma plane(s); unused entries are NULL
+    int pitches[3];       // Row pitch of each plane in bytes
+} cYUVView;
+
+/**
+ * @brief Makes sure the frame data buffer can hold at least `length` bytes.
+ *
+ * The buffer only ever grows, so once the largest frame size has been seen no
+ * further allocation happens on the ingest path.
+ *
+ * @param me Pointer to the `cFrame` owning the buffer.
+ * @param length Number of bytes the buffer must be able to hold.
+ * @return `true` if the buffer is large enough, `false` if the allocation failed.
+ */
+bool cFrame_Reserve(cFrame* me, size_t length);
+
+/**
+ * @brief Copies the planes of a YUV_420_888 frame into a `cFrame`.
+ *
+ * The planes are read in place (e.g. straight from the direct `ByteBuffer`s of an
+ * `ImageProxy`) and written once into the frame buffer.
+ *
+ * When the layout is recognized as semi-planar NV12/NV21 or planar I420, each
+ * plane is copied with a single `memcpy`, padding included, and the frame keeps
+ * the camera's row pitches so the texture upload can consume it directly.
+ * Unrecognized layouts fall back to a row-by-row repack into tightly packed NV12.
+ *
+ * @param frame Pointer to the `cFrame` receiving the planes.
+ * @param yPlane Pointer to the first byte of the luma plane.
+ * @param uPlane Pointer to the first byte of the U (Cb) plane.
+ * @param vPlane Pointer to the first byte of the V (Cr) plane.
+ * @param yRowStride Distance in bytes between two luma rows.
+ * @param uvRowStride Distance in bytes between two chroma rows.
+ * @param uvPixelStride Distance in bytes between two chroma samples of a row.
+ * @param width Width of the frame in pixels.
+ * @param height Height of the frame in pixels.
+ * @param captureTicks Capture time of the frame on the `SDL_GetTicksNS` clock, or 0 if unknown.
+ * @return `true` if the frame was stored, `false` if an error occurs.
+ */
+bool cFrame_WritePlanes(cFrame* frame,
+                        const uint8_t* yPlane, const uint8_t* uPlane, const uint8_t* vPlane,
+                        int yRowStride, int uvRowStride, int uvPixelStride,
+                        int width, int height, Uint64 captureTicks);
+
+/**
+ * @brief Copies a packed RGB frame (e.g. CameraX RGBA_8888 output) into a `cFrame`.
+ *
+ * The image is copied with a single `memcpy`, keeping its row pitch. Packed
+ * frames are uploaded as they are; they cannot go through the YUV stages.
+ *
+ * @param frame Pointer to the `cFrame` receiving the image.
+ * @param pixels Pointer to the first pixel.
+ * @param rowStride Distance in bytes between two rows.
+ * @param format Packed pixel format of the image, e.g. `SDL_PIXELFORMAT_RGBA32`.
+ * @param width Width of the frame in pixels.
+ * @param height Height of the frame in pixels.
+ * @param captureTicks Capture time of the frame on the `SDL_GetTicksNS` clock, or 0 if unknown.
+ * @return `true` if the frame was stored, `false` if an error occurs.
+ */
+bool cFrame_WritePacked(cFrame* frame, const uint8_t* pixels, int rowStride,
+                        SDL_PixelFormat format, int width, int height, Uint64 captureTicks);
+
+/**
+ * @brief Gives a `cFrame` a tightly packed layout for the given format and size.
+ *
+ * The buffer is grown if needed; its previous content is not preserved.
+ *
+ * @param frame Pointer to the `cFrame` to lay out.
+ * @param format NV12, NV21 or IYUV.
+ * @param width Width of the frame in pixels.
+ * @param height Height of the frame in pixels.
+ * @return `true` if the frame buffer is large enough, `false` if the allocation failed.
+ */
+bool cFrame_Allocate(cFrame* frame, SDL_PixelFormat format, int width, int height);
+
+/**
+ * @brief Describes the planes of a `cFrame` as a `cYUVView`.
+ *
+ * @param frame Pointer to the `cFrame`.
+ * @param view Pointer to the `cYUVView` to fill.
+ */
+void cFrame_GetView(cFrame* frame, cYUVView* view);
+
+/**
+ * @brief Copies the planes described by a view into a tightly packed `cFrame`.
+ *
+ * @param frame Pointer to the `cFrame` receiving the planes.
+ * @param view Pointer to the `cYUVView` to copy.
+ * @return `true` if the planes were copied, `false` if the allocation failed.
+ */
+bool cFrame_CopyView(cFrame* frame, const cYUVView* view);
+
+#endif // CAMERAXSDL3_FRAME_H
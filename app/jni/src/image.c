@@ -0,0 +1,216 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Camera image handling: frames written by the producer into a lock-free mailbox,
+ * uploaded into a pooled streaming texture on the render thread, and drawn with
+ * orientation adjustments.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "image.h"
+#include "common.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+void cImage_Destroy(cImage* me)
+{
+    // Check if the cImage pointer itself is NULL; if so, exit function early
+    if (me == NULL)
+    {
+        return;
+    }
+
+    // Free the frame mailbox and its buffers if it exists
+    if (me->mailbox != NULL)
+    {
+        cMailbox_Destroy(me->mailbox);
+        me->mailbox = NULL;
+    }
+
+    // Free the texture pool, which owns the current texture, if it exists
+    if (me->texturePool != NULL)
+    {
+        cTexturePool_Destroy(me->texturePool);
+        me->texturePool = NULL;
+        me->texture = NULL;
+    }
+
+    // Finally, free the cImage structure itself
+    free_memory((void **) &me, free);
+}
+
+bool cImage_New(cImage** addressImage, SDL_Renderer* renderer)
+{
+    // Allocate memory for the cImage struct and initialize all fields to zero
+    *addressImage = calloc(1, sizeof(cImage));
+
+    // Check if memory allocation was successful
+    if (*addressImage == NULL)
+    {
+        LOG_MESSAGE(strerror(errno));  // Log the error message if allocation failed
+        goto EXIT;                     // Jump to cleanup on failure
+    }
+
+    (*addressImage)->renderer = renderer;
+
+    // Create the mailbox shared between the frame producer and the render loop
+    if (!cMailbox_New(&(*addressImage)->mailbox))
+    {
+        goto EXIT;                    // Jump to cleanup on failure
+    }
+
+    // Create the pool holding the textures of this image
+    if (!cTexturePool_New(&(*addressImage)->texturePool, renderer))
+    {
+        goto EXIT;                    // Jump to cleanup on failure
+    }
+
+    // If everything is successful, return true
+    return true;
+
+    EXIT:
+    cImage_Destroy(*addressImage);  // Clean up allocated resources on failure
+    return false;
+}
+
+bool cImage_WritePlanes(cImage* me,
+                        const uint8_t* yPlane, const uint8_t* uPlane, const uint8_t* vPlane,
+                        int yRowStride, int uvRowStride, int uvPixelStride,
+                        int width, int height, Uint64 captureTicks)
+{
+    // Write into the slot owned by the producer; the render loop never reads it
+    cFrame* frame = cMailbox_BeginWrite(me->mailbox);
+    if (!cFrame_WritePlanes(frame, yPlane, uPlane, vPlane,
+                            yRowStride, uvRowStride, uvPixelStride, width, height, captureTicks))
+    {
+        return false;
+    }
+
+    // Hand the frame over to the render loop
+    cMailbox_Publish(me->mailbox);
+    return true;
+}
+
+bool cImage_WritePacked(cImage* me, const uint8_t* pixels, int rowStride,
+                        SDL_PixelFormat format, int width, int height, Uint64 captureTicks)
+{
+    // Write into the slot owned by the producer, then hand it over to the render loop
+    cFrame* frame = cMailbox_BeginWrite(me->mailbox);
+    if (!cFrame_WritePacked(frame, pixels, rowStride, format, width, height, captureTicks))
+    {
+        return false;
+    }
+
+    cMailbox_Publish(me->mailbox);
+    return true;
+}
+
+bool cImage_TextureUpdate(cImage* me)
+{
+    bool ret = false;  // Default return value, assuming failure
+
+    // Take the newest complete frame, if any; this never waits for the producer
+    cFrame* frame = cMailbox_Acquire(me->mailbox);
+    if (frame == NULL)
+    {
+        ret = true;  // Nothing new to upload
+        goto EXIT;
+    }
+    frame->timing.acquired = SDL_GetTicksNS();
+
+    me->width = frame->width;
+    me->height = frame->height;
+
+    // Pick the texture matching the frame geometry and format; a texture used
+    // before (e.g. prior to a resolution change) is reused without reallocation
+    me->texture = cTexturePool_Acquire(me->texturePool, frame->width, frame->height,
+                                       frame->format, frame->colorspace);
+    if (me->texture == NULL)
+    {
+        goto EXIT;                    // Exit on failure
+    }
+    me->videoRatio = (float)me->width / (float)me->height;
+
+    // Update the texture with the new frame data, straight from its planes and pitches
+    const uint8_t* yPlane = frame->data + frame->offsets[0];
+    const uint8_t* uvPlane = frame->data + frame->offsets[1];
+    bool updated;
+    frame->timing.uploadStart = SDL_GetTicksNS();
+    if (frame->format == SDL_PIXELFORMAT_IYUV)
+    {
+        updated = SDL_UpdateYUVTexture(me->texture, NULL,
+                                       yPlane, frame->pitches[0],
+                                       uvPlane, frame->pitches[1],
+                                       frame->data + frame->offsets[2], frame->pitches[2]);
+    }
+    else if (frame->format == SDL_PIXELFORMAT_NV12 || frame->format == SDL_PIXELFORMAT_NV21)
+    {
+        updated = SDL_UpdateNVTexture(me->texture, NULL,
+                                      yPlane, frame->pitches[0],
+                                      uvPlane, frame->pitches[1]);
+    }
+    else
+    {
+        updated = SDL_UpdateTexture(me->texture, NULL, yPlane, frame->pitches[0]);  // Packed RGB
+    }
+
+    if (!updated)
+    {
+        LOG_MESSAGE(SDL_GetError());  // Log error if texture update fails
+        goto EXIT;                    // Exit on failure
+    }
+    frame->timing.uploadEnd = SDL_GetTicksNS();
+
+    // Keep the time stamps until the frame is presented
+    me->timing = frame->timing;
+    me->timingPending = true;
+
+    ret = true;  // Set return value to true to indicate success
+
+    EXIT:
+    return ret;
+}
+
+bool cImage_Render(cImage* me, const SDL_FRect* rect, int orientation)
+{
+    bool ret = false;  // Default return value, assuming failure
+
+    if (me->texture != NULL)
+    {
+        Uint64 drawStart = SDL_GetTicksNS();
+
+        // Render the texture with rotation and vertical flipping
+        if (!SDL_RenderTextureRotated(me->renderer,
+                                      me->texture,
+                                      NULL,
+                                      rect,
+                                      orientation,
+                                      0,
+                                      SDL_FLIP_VERTICAL))
+        {
+            LOG_MESSAGE(SDL_GetError());  // Log error message if rendering fails
+            goto EXIT;                    // Exit on failure
+        }
+
+        // Only the first draw of a newly uploaded frame is part of its latency
+        if (me->timingPending && me->timing.drawStart == 0)
+        {
+            me->timing.drawStart = drawStart;
+            me->timing.drawEnd = SDL_GetTicksNS();
+        }
+    }
+
+    ret = true;  // Set return value to true to indicate success
+
+    EXIT:
+    return ret;  // Return the result (true if successful, false otherwise)
+}
@@ -0,0 +1,140 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Camera image handling: frames written by the producer into a lock-free mailbox,
+ * uploaded into a pooled streaming texture on the render thread, and drawn with
+ * orientation adjustments.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#ifndef CAMERAXSDL3_IMAGE_H
+#define CAMERAXSDL3_IMAGE_H
+
+#include <SDL3/SDL.h>
+
+#include "mailbox.h"
+#include "texture_pool.h"
+
+// Define a struct for handling image data and related properties
+typedef struct image_s
+{
+    SDL_Renderer* renderer; // Renderer the image is drawn with
+    SDL_Texture* texture; // SDL texture representation of the image, owned by `texturePool`
+    cTexturePool* texturePool; // Textures previously used by this image, reused on format changes
+    cMailbox* mailbox;    // Lock-free triple buffer carrying frames from the producer
+    int width;            // Width of the image in pixels
+    int height;           // Height of the image in pixels
+    float videoRatio;     // Aspect ratio of the image, used for scaling
+    cFrameTiming timing;  // Time stamps of the frame currently in the texture
+    bool timingPending;   // Whether `timing` belongs to a frame not presented yet
+} cImage;
+
+/**
+ * @brief Allocates and initializes a new `cImage` structure.
+ *
+ * This function allocates memory for a `cImage` structure and initializes
+ * its frame mailbox and texture pool. All state lives in the structure, so
+ * several images may coexist on the same renderer. If any allocation or
+ * initialization fails, it logs an error message and cleans up by calling
+ * `cImage_Destroy`.
+ *
+ * @param addressImage Double pointer to a `cImage*` which will point to the
+ *                     newly allocated `cImage` structure if successful.
+ * @param renderer Renderer the image textures are created for and drawn with.
+ * @return `true` if the allocation and initialization succeed, `false` otherwise.
+ */
+bool cImage_New(cImage** addressImage, SDL_Renderer* renderer);
+
+/**
+ * @brief Destroys a `cImage` object by freeing all dynamically allocated
+ *        resources within the structure and then freeing the structure itself.
+ *
+ * This function checks each member of the `cImage` struct to ensure it is
+ * not NULL before attempting to free it, to avoid double-free errors.
+ * After freeing each resource, it frees the `cImage` structure itself.
+ *
+ * @param me Pointer to the `cImage` structure to be destroyed and freed.
+ */
+void cImage_Destroy(cImage* me);
+
+/**
+ * @brief Copies the planes of a YUV_420_888 frame into the `cImage` mailbox.
+ *
+ * The planes are read in place (e.g. straight from the direct `ByteBuffer`s of an
+ * `ImageProxy`) and written once into the producer slot of the mailbox, which is
+ * then published for `cImage_TextureUpdate` to upload. No lock is taken.
+ *
+ * See `cFrame_WritePlanes` for how the planes are laid out.
+ *
+ * @param me Pointer to the `cImage` structure receiving the frame.
+ * @param yPlane Pointer to the first byte of the luma plane.
+ * @param uPlane Pointer to the first byte of the U (Cb) plane.
+ * @param vPlane Pointer to the first byte of the V (Cr) plane.
+ * @param yRowStride Distance in bytes between two luma rows.
+ * @param uvRowStride Distance in bytes between two chroma rows.
+ * @param uvPixelStride Distance in bytes between two chroma samples of a row.
+ * @param width Width of the frame in pixels.
+ * @param height Height of the frame in pixels.
+ * @param captureTicks Capture time of the frame on the `SDL_GetTicksNS` clock, or 0 if unknown.
+ * @return `true` if the frame was stored, `false` if an error occurs.
+ */
+bool cImage_WritePlanes(cImage* me,
+                        const uint8_t* yPlane, const uint8_t* uPlane, const uint8_t* vPlane,
+                        int yRowStride, int uvRowStride, int uvPixelStride,
+                        int width, int height, Uint64 captureTicks);
+
+/**
+ * @brief Copies a packed RGB frame into the `cImage` mailbox.
+ *
+ * Same as `cImage_WritePlanes` for cameras delivering RGBA_8888 frames.
+ *
+ * @param me Pointer to the `cImage` receiving the frame.
+ * @param pixels Pointer to the first pixel.
+ * @param rowStride Distance in bytes between two rows.
+ * @param format Packed pixel format of the image, e.g. `SDL_PIXELFORMAT_RGBA32`.
+ * @param width Width of the frame in pixels.
+ * @param height Height of the frame in pixels.
+ * @param captureTicks Capture time of the frame on the `SDL_GetTicksNS` clock, or 0 if unknown.
+ * @return `true` if the frame was stored, `false` if an error occurs.
+ */
+bool cImage_WritePacked(cImage* me, const uint8_t* pixels, int rowStride,
+                        SDL_PixelFormat format, int width, int height, Uint64 captureTicks);
+
+/**
+ * @brief Updates the texture of a `cImage` object if necessary.
+ *
+ * This function takes the newest frame from the `cImage` mailbox without
+ * blocking and picks the texture matching its geometry, pixel format and
+ * colorspace from the image texture pool. The frame planes are then uploaded with
+ * their own pitches, so padded rows never need repacking. If no new frame was published
+ * since the last call, the texture is left untouched.
+ *
+ * @param me Pointer to the `cImage` structure whose texture is to be updated.
+ * @return `true` if the texture is successfully updated, `false` if an error occurs.
+ */
+bool cImage_TextureUpdate(cImage* me);
+
+/**
+ * @brief Renders the texture of a `cImage` object into a rectangle, applying the
+ *        specified orientation.
+ *
+ * This function renders the current texture of the `cImage` object, if any, with
+ * rotation and vertical flipping. It does not upload new frames; call
+ * `cImage_TextureUpdate` first. It logs any errors encountered during rendering.
+ *
+ * @param me Pointer to the `cImage` object containing the texture to render.
+ * @param rect Pointer to an `SDL_FRect` giving the destination of the texture
+ *             before rotation.
+ * @param orientation Integer specifying the rotation angle (0, 90, 180, or 270).
+ * @return `true` if the texture is successfully rendered, `false` if an error occurs.
+ */
+bool cImage_Render(cImage* me, const SDL_FRect* rect, int orientation);
+
+#endif // CAMERAXSDL3_IMAGE_H
@@ -0,0 +1,213 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Capture-to-present latency instrumentation with rolling p50/p95/p99 values.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "latency.h"
+#include "common.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+// Names of the stages, as used in the log and the CSV file
+static const char* stageNames[LATENCY_STAGE_COUNT] = {
+    "ingest", "queue", "upload", "draw", "present", "total"
+};
+
+/**
+ * @brief Adds a duration to the rolling window of a stage.
+ *
+ * Durations are only recorded when both time stamps are known and ordered.
+ *
+ * @param me Pointer to the `cLatency`.
+ * @param stage Stage the duration belongs to.
+ * @param start Start of the stage in ns.
+ * @param end End of the stage in ns.
+ */
+static void addSample(cLatency* me, cLatencyStage stage, Uint64 start, Uint64 end)
+{
+    if (start == 0 || end < start)
+    {
+        return;
+    }
+
+    me->samples[stage][me->next[stage]] = end - start;
+    me->next[stage] = (me->next[stage] + 1) % LATENCY_WINDOW;
+    if (me->count[stage] < LATENCY_WINDOW)
+    {
+        me->count[stage]++;
+    }
+}
+
+/**
+ * @brief Orders two durations, for use with `SDL_qsort`.
+ *
+ * @param a Pointer to the first `Uint64`.
+ * @param b Pointer to the second `Uint64`.
+ * @return A negative, zero or positive value as `a` is smaller, equal or larger than `b`.
+ */
+static int SDLCALL compareDurations(const void* a, const void* b)
+{
+    Uint64 left = *(const Uint64*) a;
+    Uint64 right = *(const Uint64*) b;
+    return (left < right) ? -1 : (left > right) ? 1 : 0;
+}
+
+bool cLatency_New(cLatency** addressLatency, const char* csvPath)
+{
+    // Allocate memory for the statistics and initialize all fields to zero
+    *addressLatency = calloc(1, sizeof(cLatency));
+    if (*addressLatency == NULL)
+    {
+        LOG_MESSAGE(strerror(errno));  // Log the error message if allocation failed
+        return false;
+    }
+
+    (*addressLatency)->lastReport = SDL_GetTicksNS();
+
+    // Open the CSV output and write its header; run without it on failure
+    if (csvPath != NULL)
+    {
+        (*addressLatency)->csv = SDL_IOFromFile(csvPath, "w");
+        if ((*addressLatency)->csv == NULL)
+        {
+            LOG_MESSAGE(SDL_GetError());
+        }
+        else
+        {
+            SDL_IOprintf((*addressLatency)->csv, "time_ms,stage,samples,p50_us,p95_us,p99_us\n");
+        }
+    }
+
+    return true;
+}
+
+void cLatency_Destroy(cLatency* me)
+{
+    // Check if the statistics pointer itself is NULL; if so, exit function early
+    if (me == NULL)
+    {
+        return;
+    }
+
+    // Flush and close the CSV output if it exists
+    if (me->csv != NULL)
+    {
+        SDL_CloseIO(me->csv);
+        me->csv = NULL;
+    }
+
+    free_memory((void **) &me, free);
+}
+
+void cLatency_Record(cLatency* me, const cFrameTiming* timing, Uint64 presentStart, Uint64 presentEnd)
+{
+    addSample(me, LATENCY_INGEST, timing->ingestStart, timing->ingestEnd);
+    addSample(me, LATENCY_QUEUE, timing->ingestEnd, timing->acquired);
+    addSample(me, LATENCY_UPLOAD, timing->uploadStart, timing->uploadEnd);
+    addSample(me, LATENCY_DRAW, timing->drawStart, timing->drawEnd);
+    addSample(me, LATENCY_PRESENT, presentStart, presentEnd);
+    addSample(me, LATENCY_TOTAL, timing->capture, presentEnd);
+}
+
+void cLatency_Report(cLatency* me, bool force)
+{
+    Uint64 now = SDL_GetTicksNS();
+    if (!force && now - me->lastReport < LATENCY_REPORT_INTERVAL)
+    {
+        return;
+    }
+    me->lastReport = now;
+
+    Uint64 sorted[LATENCY_WINDOW];
+    for (int stage = 0; stage < LATENCY_STAGE_COUNT; ++stage)
+    {
+        int count = me->count[stage];
+        if (count == 0)
+        {
+            continue;
+        }
+
+        // Percentiles of the rolling window
+        SDL_memcpy(sorted, me->samples[stage], count * sizeof(*sorted));
+        SDL_qsort(sorted, count, sizeof(*sorted), compareDurations);
+        me->percentiles[stage][0] = sorted[(count - 1) * 50 / 100];
+        me->percentiles[stage][1] = sorted[(count - 1) * 95 / 100];
+        me->percentiles[stage][2] = sorted[(count - 1) * 99 / 100];
+
+        SDL_Log("Latency %-7s n=%3d p50=%6.2f ms p95=%6.2f ms p99=%6.2f ms",
+                stageNames[stage], count,
+                me->percentiles[stage][0] / 1e6,
+                me->percentiles[stage][1] / 1e6,
+                me->percentiles[stage][2] / 1e6);
+
+        if (me->csv != NULL)
+        {
+            SDL_IOprintf(me->csv, "%" SDL_PRIu64 ",%s,%d,%" SDL_PRIu64 ",%" SDL_PRIu64 ",%" SDL_PRIu64 "\n",
+                         SDL_NS_TO_MS(now), stageNames[stage], count,
+                         SDL_NS_TO_US(me->percentiles[stage][0]),
+                         SDL_NS_TO_US(me->percentiles[stage][1]),
+                         SDL_NS_TO_US(me->percentiles[stage][2]));
+        }
+    }
+}
+
+bool cLatency_RenderOverlay(cLatency* me, SDL_Renderer* renderer, float x, float y)
+{
+    bool ret = false;  // Default return value, assuming failure
+
+    // Colors of the p99, p95 and p50 bars, drawn in that order
+    static const SDL_Color colors[3] = {
+        { 0x80, 0x20, 0x20, 0xFF }, { 0xE0, 0x80, 0x20, 0xFF }, { 0x40, 0xE0, 0x40, 0xFF }
+    };
+
+    Uint8 r, g, b, a;
+    if (!SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a))
+    {
+        LOG_MESSAGE(SDL_GetError());
+        goto EXIT;
+    }
+
+    for (int stage = 0; stage < LATENCY_STAGE_COUNT; ++stage)
+    {
+        for (int i = 2; i >= 0; --i)
+        {
+            SDL_FRect bar = {
+                x, y + (float) stage * LATENCY_OVERLAY_ROW,
+                (float) (me->percentiles[stage][i] / 1e6) * LATENCY_OVERLAY_PX_PER_MS,
+                LATENCY_OVERLAY_ROW - 2.0f
+            };
+            SDL_SetRenderDrawColor(renderer, colors[2 - i].r, colors[2 - i].g, colors[2 - i].b, colors[2 - i].a);
+            if (!SDL_RenderFillRect(renderer, &bar))
+            {
+                LOG_MESSAGE(SDL_GetError());
+                goto EXIT;
+            }
+        }
+    }
+
+    // Mark the length of a 60 Hz frame
+    float marker = x + (1000.0f / 60.0f) * LATENCY_OVERLAY_PX_PER_MS;
+    SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+    if (!SDL_RenderLine(renderer, marker, y, marker, y + LATENCY_STAGE_COUNT * LATENCY_OVERLAY_ROW))
+    {
+        LOG_MESSAGE(SDL_GetError());
+        goto EXIT;
+    }
+
+    ret = true;  // Set return value to true to indicate success
+
+    EXIT:
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);  // Restore the caller's draw color
+    return ret;
+}
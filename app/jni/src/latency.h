@@ -0,0 +1,119 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Capture-to-present latency instrumentation. Every frame carries the time
+ * stamps of the stages it went through, from the camera capture to the end of
+ * `SDL_RenderPresent`, all expressed on the `SDL_GetTicksNS` clock. The stage
+ * durations of the most recent frames are kept in rolling windows, from which
+ * p50/p95/p99 values are periodically logged, optionally appended to a CSV
+ * file, and drawn as an on-screen overlay.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#ifndef CAMERAXSDL3_LATENCY_H
+#define CAMERAXSDL3_LATENCY_H
+
+#include <SDL3/SDL.h>
+
+#define LATENCY_WINDOW 256                        // Number of samples kept per stage
+#define LATENCY_REPORT_INTERVAL SDL_NS_PER_SECOND // Time between two reports in ns
+#define LATENCY_OVERLAY_PX_PER_MS 8.0f            // Horizontal scale of the overlay bars
+#define LATENCY_OVERLAY_ROW 12.0f                 // Height of one overlay row
+
+// Measured stages of the frame path
+typedef enum latency_stage_e
+{
+    LATENCY_INGEST,       // Copy of the planes into the mailbox (JNI entry to publish)
+    LATENCY_QUEUE,        // Time spent in the mailbox until the render loop takes the frame
+    LATENCY_UPLOAD,       // Texture upload
+    LATENCY_DRAW,         // Draw call submission
+    LATENCY_PRESENT,      // SDL_RenderPresent
+    LATENCY_TOTAL,        // Camera capture to end of present
+    LATENCY_STAGE_COUNT
+} cLatencyStage;
+
+// Time stamps of one frame, in SDL_GetTicksNS nanoseconds; 0 when unknown
+typedef struct frame_timing_s
+{
+    Uint64 capture;       // Sensor capture, rebased onto the SDL clock
+    Uint64 ingestStart;   // Producer started copying the frame
+    Uint64 ingestEnd;     // Producer published the frame
+    Uint64 acquired;      // Render loop took the frame from the mailbox
+    Uint64 uploadStart;   // Texture upload started
+    Uint64 uploadEnd;     // Texture upload finished
+    Uint64 drawStart;     // Draw call started
+    Uint64 drawEnd;       // Draw call finished
+} cFrameTiming;
+
+// Rolling latency statistics
+typedef struct latency_s
+{
+    Uint64 samples[LATENCY_STAGE_COUNT][LATENCY_WINDOW]; // Most recent stage durations in ns
+    int next[LATENCY_STAGE_COUNT];   // Next sample to overwrite, per stage
+    int count[LATENCY_STAGE_COUNT];  // Number of valid samples, per stage
+    Uint64 percentiles[LATENCY_STAGE_COUNT][3]; // p50, p95 and p99 of the last report in ns
+    Uint64 lastReport;               // Time of the last report in ns
+    SDL_IOStream* csv;               // CSV output, NULL if disabled
+} cLatency;
+
+/**
+ * @brief Allocates and initializes a `cLatency`.
+ *
+ * @param addressLatency Double pointer to a `cLatency*` which will point to the
+ *                       newly allocated statistics if successful.
+ * @param csvPath Path of a CSV file the reports are appended to, or NULL.
+ * @return `true` if the allocation succeeds, `false` otherwise. Failing to open
+ *         the CSV file is logged but not fatal.
+ */
+bool cLatency_New(cLatency** addressLatency, const char* csvPath);
+
+/**
+ * @brief Closes the CSV file, if any, and frees a `cLatency`.
+ *
+ * @param me Pointer to the `cLatency` to destroy; may be NULL.
+ */
+void cLatency_Destroy(cLatency* me);
+
+/**
+ * @brief Records the stage durations of a presented frame.
+ *
+ * Stages whose time stamps are unknown are left out.
+ *
+ * @param me Pointer to the `cLatency`.
+ * @param timing Time stamps gathered along the frame path.
+ * @param presentStart Time `SDL_RenderPresent` was called.
+ * @param presentEnd Time `SDL_RenderPresent` returned.
+ */
+void cLatency_Record(cLatency* me, const cFrameTiming* timing, Uint64 presentStart, Uint64 presentEnd);
+
+/**
+ * @brief Refreshes the percentiles, logs them, and appends them to the CSV
+ *        file once every LATENCY_REPORT_INTERVAL.
+ *
+ * @param me Pointer to the `cLatency`.
+ * @param force `true` to report now, however recent the last report is.
+ */
+void cLatency_Report(cLatency* me, bool force);
+
+/**
+ * @brief Draws the last reported percentiles as horizontal bars.
+ *
+ * One row per stage, with the p99, p95 and p50 bars drawn on top of each other
+ * at LATENCY_OVERLAY_PX_PER_MS pixels per millisecond, and a marker at 16.7 ms.
+ *
+ * @param me Pointer to the `cLatency`.
+ * @param renderer Renderer to draw with.
+ * @param x Left edge of the overlay.
+ * @param y Top edge of the overlay.
+ * @return `true` if the overlay is drawn, `false` if an error occurs.
+ */
+bool cLatency_RenderOverlay(cLatency* me, SDL_Renderer* renderer, float x, float y);
+
+#endif // CAMERAXSDL3_LATENCY_H
@@ -0,0 +1,92 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Triple-buffered frame mailbox used to hand camera frames from the producer
+ * (the CameraX analyzer thread, through JNI) to the render loop without locks.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "mailbox.h"
+#include "common.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#define MAILBOX_INDEX_MASK 0x3  // Bits of `shared` holding the slot index
+#define MAILBOX_FRESH      0x4  // Set in `shared` while the slot holds an unread frame
+
+bool cMailbox_New(cMailbox** addressMailbox)
+{
+    // Allocate memory for the mailbox and initialize all slots to empty
+    *addressMailbox = calloc(1, sizeof(cMailbox));
+    if (*addressMailbox == NULL)
+    {
+        LOG_MESSAGE(strerror(errno));  // Log the error message if allocation failed
+        return false;
+    }
+
+    // Slot 0 belongs to the producer, slot 1 to the consumer, slot 2 is shared
+    (*addressMailbox)->back = 0;
+    (*addressMailbox)->front = 1;
+    SDL_SetAtomicInt(&(*addressMailbox)->shared, 2);
+
+    return true;
+}
+
+void cMailbox_Destroy(cMailbox* me)
+{
+    // Check if the mailbox pointer itself is NULL; if so, exit function early
+    if (me == NULL)
+    {
+        return;
+    }
+
+    // Free the data buffer of every slot
+    for (int i = 0; i < MAILBOX_SLOTS; ++i)
+    {
+        if (me->slots[i].data != NULL)
+        {
+            free_memory((void **) &me->slots[i].data, free);
+        }
+    }
+
+    // Finally, free the mailbox structure itself
+    free_memory((void **) &me, free);
+}
+
+cFrame* cMailbox_BeginWrite(cMailbox* me)
+{
+    return &me->slots[me->back];
+}
+
+void cMailbox_Publish(cMailbox* me)
+{
+    // Swap the freshly written back slot with the shared one; whatever was shared
+    // (consumed or not) becomes the next back slot
+    int previous = SDL_SetAtomicInt(&me->shared, me->back | MAILBOX_FRESH);
+    me->back = previous & MAILBOX_INDEX_MASK;
+}
+
+cFrame* cMailbox_Acquire(cMailbox* me)
+{
+    // Leave the current front slot alone when nothing new has been published
+    if ((SDL_GetAtomicInt(&me->shared) & MAILBOX_FRESH) == 0)
+    {
+        return NULL;
+    }
+
+    // Only the consumer clears the fresh flag, so the shared slot is still fresh
+    // here and swapping it with the front slot hands us the newest frame
+    int previous = SDL_SetAtomicInt(&me->shared, me->front);
+    me->front = previous & MAILBOX_INDEX_MASK;
+
+    return &me->slots[me->front];
+}
@@ -0,0 +1,91 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Triple-buffered frame mailbox used to hand camera frames from the producer
+ * (the CameraX analyzer thread, through JNI) to the render loop without locks.
+ *
+ * The mailbox owns three frame slots. At any time one slot belongs to the
+ * producer (the back slot), one to the consumer (the front slot), and the third
+ * one is shared. Publishing a frame atomically swaps the back slot with the
+ * shared one; acquiring swaps the front slot with the shared one, but only when
+ * the shared slot holds a frame that has not been consumed yet. Neither side
+ * ever waits for the other, the producer always writes into a slot nobody reads,
+ * and the consumer always gets the most recent complete frame.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#ifndef CAMERAXSDL3_MAILBOX_H
+#define CAMERAXSDL3_MAILBOX_H
+
+#include <SDL3/SDL.h>
+
+#include "frame.h"
+
+#define MAILBOX_SLOTS 3
+
+// Lock-free single-producer / single-consumer triple buffer
+typedef struct mailbox_s
+{
+    cFrame slots[MAILBOX_SLOTS]; // Frame storage, indexed by the slot indices below
+    SDL_AtomicInt shared;        // Index of the shared slot, plus MAILBOX_FRESH when unread
+    int back;                    // Slot owned by the producer
+    int front;                   // Slot owned by the consumer
+} cMailbox;
+
+/**
+ * @brief Allocates and initializes a new, empty `cMailbox`.
+ *
+ * @param addressMailbox Double pointer to a `cMailbox*` which will point to the
+ *                       newly allocated mailbox if successful.
+ * @return `true` if the allocation succeeds, `false` otherwise.
+ */
+bool cMailbox_New(cMailbox** addressMailbox);
+
+/**
+ * @brief Frees a `cMailbox` and the data buffers of all its slots.
+ *
+ * @param me Pointer to the `cMailbox` to destroy; may be NULL.
+ */
+void cMailbox_Destroy(cMailbox* me);
+
+/**
+ * @brief Returns the slot the producer may fill with the next frame.
+ *
+ * Producer side only. The returned slot is not visible to the consumer until
+ * `cMailbox_Publish` is called.
+ *
+ * @param me Pointer to the `cMailbox`.
+ * @return Pointer to the producer's back slot.
+ */
+cFrame* cMailbox_BeginWrite(cMailbox* me);
+
+/**
+ * @brief Publishes the frame written into the back slot.
+ *
+ * Producer side only. If the previously published frame has not been acquired
+ * yet it is dropped and its slot is recycled as the new back slot.
+ *
+ * @param me Pointer to the `cMailbox`.
+ */
+void cMailbox_Publish(cMailbox* me);
+
+/**
+ * @brief Takes ownership of the newest published frame, if any.
+ *
+ * Consumer side only. The returned frame stays valid and untouched by the
+ * producer until the next call to `cMailbox_Acquire`.
+ *
+ * @param me Pointer to the `cMailbox`.
+ * @return Pointer to the newest frame, or NULL if nothing was published since
+ *         the previous call.
+ */
+cFrame* cMailbox_Acquire(cMailbox* me);
+
+#endif // CAMERAXSDL3_MAILBOX_H
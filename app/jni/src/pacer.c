@@ -0,0 +1,158 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Event-driven frame pacing: the render loop only redraws when a new frame, a
+ * resize or an orientation change arrived.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "pacer.h"
+#include "common.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+bool cPacer_New(cPacer** addressPacer, bool eventDriven, float maxFps)
+{
+    // Allocate memory for the pacer and initialize all fields to zero
+    *addressPacer = calloc(1, sizeof(cPacer));
+    if (*addressPacer == NULL)
+    {
+        LOG_MESSAGE(strerror(errno));  // Log the error message if allocation failed
+        goto EXIT;
+    }
+
+    // Register the event posted by frame producers
+    (*addressPacer)->frameEvent = SDL_RegisterEvents(1);
+    if ((*addressPacer)->frameEvent == 0)
+    {
+        LOG_MESSAGE("Could not register the frame event");
+        goto EXIT;
+    }
+
+    (*addressPacer)->eventDriven = eventDriven;
+    (*addressPacer)->dirty = true;  // Always draw the first frame
+    if (maxFps > 0.0f)
+    {
+        (*addressPacer)->minInterval = (Uint64) (SDL_NS_PER_SECOND / maxFps);
+    }
+
+    return true;
+
+    EXIT:
+    cPacer_Destroy(*addressPacer);  // Clean up allocated resources on failure
+    *addressPacer = NULL;
+    return false;
+}
+
+void cPacer_Destroy(cPacer* me)
+{
+    // Check if the pacer pointer itself is NULL; if so, exit function early
+    if (me == NULL)
+    {
+        return;
+    }
+
+    free_memory((void **) &me, free);
+}
+
+void cPacer_NotifyFrame(cPacer* me)
+{
+    // Frames may arrive before the render loop is set up
+    if (me == NULL)
+    {
+        return;
+    }
+
+    // Only one frame event is queued at a time; a newer frame replaces the waiting one
+    if (!SDL_CompareAndSwapAtomicInt(&me->pending, 0, 1))
+    {
+        SDL_AddAtomicInt(&me->skipped, 1);
+        return;
+    }
+
+    SDL_Event event;
+    SDL_zero(event);
+    event.type = me->frameEvent;
+    event.user.timestamp = SDL_GetTicksNS();
+    if (!SDL_PushEvent(&event))
+    {
+        SDL_SetAtomicInt(&me->pending, 0);  // Let the next frame try again
+    }
+}
+
+void cPacer_HandleEvent(cPacer* me, const SDL_Event* event)
+{
+    if (event->type == me->frameEvent)
+    {
+        // Allow the producer to post again, then redraw with the newest frame
+        SDL_SetAtomicInt(&me->pending, 0);
+        me->dirty = true;
+
+        // A frame still waiting for the frame rate cap is superseded by this one
+        if (me->frameWaiting)
+        {
+            SDL_AddAtomicInt(&me->skipped, 1);
+        }
+        me->frameWaiting = true;
+        return;
+    }
+
+    switch (event->type)
+    {
+        case SDL_EVENT_WINDOW_RESIZED:
+        case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED:
+        case SDL_EVENT_WINDOW_EXPOSED:
+        case SDL_EVENT_DISPLAY_ORIENTATION:
+        case SDL_EVENT_DID_ENTER_FOREGROUND:
+        case SDL_EVENT_RENDER_TARGETS_RESET:
+        case SDL_EVENT_RENDER_DEVICE_RESET:
+            me->dirty = true;  // The screen content must be drawn again
+            break;
+        default:
+            break;
+    }
+}
+
+bool cPacer_ShouldRender(cPacer* me)
+{
+    Sint32 timeout = PACER_IDLE_TIMEOUT_MS;
+
+    if (!me->eventDriven || me->dirty)
+    {
+        // Honor the frame rate cap, if any
+        Uint64 now = SDL_GetTicksNS();
+        if (me->minInterval == 0 || now - me->lastPresent >= me->minInterval)
+        {
+            return true;
+        }
+
+        // Sleep until the cap elapses, waking up early for events
+        timeout = (Sint32) SDL_NS_TO_MS(me->minInterval - (now - me->lastPresent)) + 1;
+    }
+
+    // Nothing to draw yet: sleep until an event arrives; it is left in the queue
+    SDL_WaitEventTimeout(NULL, timeout);
+    return false;
+}
+
+bool cPacer_IsIdle(cPacer* me)
+{
+    return !me->dirty && SDL_GetAtomicInt(&me->pending) == 0;
+}
+
+void cPacer_Presented(cPacer* me)
+{
+    me->dirty = false;
+    me->frameWaiting = false;
+    me->lastPresent = SDL_GetTicksNS();
+    me->presented++;
+}
@@ -0,0 +1,109 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Event-driven frame pacing. Frame producers post a custom SDL event when they
+ * publish a new frame, and the render loop only redraws when such an event, a
+ * resize or an orientation change arrived. Between redraws the main thread
+ * sleeps in `SDL_WaitEventTimeout` instead of re-presenting identical frames.
+ * An optional frame rate cap spaces out presents, and pending frame events are
+ * coalesced so that the latest frame always wins.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#ifndef CAMERAXSDL3_PACER_H
+#define CAMERAXSDL3_PACER_H
+
+#include <SDL3/SDL.h>
+
+#define PACER_IDLE_TIMEOUT_MS 1000  // Longest sleep between two checks while idle
+
+// Render loop pacing state
+typedef struct pacer_s
+{
+    bool eventDriven;         // Redraw only when needed; otherwise redraw every iteration
+    Uint32 frameEvent;        // Custom event type posted by frame producers
+    SDL_AtomicInt pending;    // Non-zero while a frame event is queued and not yet handled
+    bool dirty;               // Whether the screen needs to be redrawn
+    bool frameWaiting;        // Whether a frame arrived since the last present
+    Uint64 minInterval;       // Shortest time between two presents in ns, 0 if uncapped
+    Uint64 lastPresent;       // Time of the last present in ns
+    Uint64 presented;         // Number of presented frames
+    SDL_AtomicInt skipped;    // Number of frames superseded by a newer one before being drawn
+} cPacer;
+
+/**
+ * @brief Allocates and initializes a `cPacer`.
+ *
+ * Registers the custom frame event, so SDL events must be initialized.
+ *
+ * @param addressPacer Double pointer to a `cPacer*` which will point to the newly
+ *                     allocated pacer if successful.
+ * @param eventDriven `true` to redraw only on new frames, resizes and orientation
+ *                    changes, `false` to redraw on every iteration.
+ * @param maxFps Highest present rate, or 0 for no cap.
+ * @return `true` if the allocation and initialization succeed, `false` otherwise.
+ */
+bool cPacer_New(cPacer** addressPacer, bool eventDriven, float maxFps);
+
+/**
+ * @brief Frees a `cPacer`.
+ *
+ * @param me Pointer to the `cPacer` to destroy; may be NULL.
+ */
+void cPacer_Destroy(cPacer* me);
+
+/**
+ * @brief Wakes the render loop up because a new frame was published.
+ *
+ * Safe to call from any thread, and with a NULL pacer. If a frame event is already queued, no new one
+ * is posted: the render loop will pick the newest frame anyway, and the frame
+ * that was waiting is counted as skipped.
+ *
+ * @param me Pointer to the `cPacer`.
+ */
+void cPacer_NotifyFrame(cPacer* me);
+
+/**
+ * @brief Updates the pacing state from an event received by `SDL_AppEvent`.
+ *
+ * @param me Pointer to the `cPacer`.
+ * @param event Event to inspect.
+ */
+void cPacer_HandleEvent(cPacer* me, const SDL_Event* event);
+
+/**
+ * @brief Decides whether the current iteration should render and present.
+ *
+ * When nothing needs to be redrawn, or the frame rate cap has not elapsed yet,
+ * this function sleeps until an event arrives or the cap elapses, and returns
+ * `false`. Events received meanwhile are handled on the next iteration.
+ *
+ * @param me Pointer to the `cPacer`.
+ * @return `true` if the caller should render and present now, `false` otherwise.
+ */
+bool cPacer_ShouldRender(cPacer* me);
+
+/**
+ * @brief Tells whether nothing is left to draw: no frame event is queued and
+ *        the screen is up to date.
+ *
+ * @param me Pointer to the `cPacer`.
+ * @return `true` if the last frame notified has been presented, `false` otherwise.
+ */
+bool cPacer_IsIdle(cPacer* me);
+
+/**
+ * @brief Records that a frame was presented.
+ *
+ * @param me Pointer to the `cPacer`.
+ */
+void cPacer_Presented(cPacer* me);
+
+#endif // CAMERAXSDL3_PACER_H
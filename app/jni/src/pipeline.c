@@ -0,0 +1,324 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Native frame-processing pipeline running between ingest and the render mailbox.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "pipeline.h"
+#include "common.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+/**
+ * @brief Updates the layout of a frame from a view pointing into its buffer.
+ *
+ * In-place stages may narrow the view (e.g. crop), so the final view is not
+ * necessarily the full frame it lives in.
+ *
+ * @param frame Pointer to the `cFrame` owning the memory the view points to.
+ * @param view Pointer to the `cYUVView` describing the planes.
+ */
+static void setFrameView(cFrame* frame, const cYUVView* view)
+{
+    frame->format = view->format;
+    frame->width = view->width;
+    frame->height = view->height;
+    for (int plane = 0; plane < 3; ++plane)
+    {
+        frame->offsets[plane] = (view->planes[plane] != NULL) ? (size_t) (view->planes[plane] - frame->data) : 0;
+        frame->pitches[plane] = view->pitches[plane];
+    }
+}
+
+/**
+ * @brief Runs a frame through every stage and publishes it to the output image.
+ *
+ * @param me Pointer to the `cPipeline`.
+ * @param input Frame taken from the input mailbox; in-place stages may modify it.
+ * @return `true` if the frame was published, `false` if a stage failed.
+ */
+static bool cPipeline_Process(cPipeline* me, cFrame* input)
+{
+    // Packed frames are not YUV: the stages are skipped and the frame is forwarded as is
+    if (!SDL_ISPIXELFORMAT_FOURCC(input->format))
+    {
+        cFrame* target = cMailbox_BeginWrite(me->output->mailbox);
+        if (!cFrame_WritePacked(target, input->data + input->offsets[0], input->pitches[0],
+                                input->format, input->width, input->height, 0))
+        {
+            return false;
+        }
+        target->timing = input->timing;
+        cMailbox_Publish(me->output->mailbox);
+        return true;
+    }
+
+    cYUVView view;
+    cFrame_GetView(input, &view);
+
+    // The last stage producing a new buffer writes into the render mailbox directly
+    int last = -1;
+    for (int i = 0; i < me->stageCount; ++i)
+    {
+        if (!me->stages[i]->inPlace)
+        {
+            last = i;
+        }
+    }
+
+    cFrame* target = cMailbox_BeginWrite(me->output->mailbox);
+
+    // Without such a stage, the frame is copied there first and processed in place
+    if (last < 0)
+    {
+        if (!cFrame_CopyView(target, &view))
+        {
+            return false;
+        }
+        cFrame_GetView(target, &view);
+    }
+
+    int scratch = 0;
+    for (int i = 0; i < me->stageCount; ++i)
+    {
+        cStage* stage = me->stages[i];
+
+        if (stage->inPlace)
+        {
+            if (!stage->process(stage, &view, NULL))
+            {
+                SDL_Log("Pipeline stage %s failed", stage->name);
+                return false;
+            }
+            continue;
+        }
+
+        // Let the stage describe its output, then give it a pooled buffer
+        SDL_PixelFormat format;
+        int width, height;
+        if (!stage->configure(stage, &view, &format, &width, &height))
+        {
+            SDL_Log("Pipeline stage %s rejected its input", stage->name);
+            return false;
+        }
+
+        cFrame* out = (i == last) ? target : &me->scratch[scratch];
+        scratch ^= 1;  // The next stage reads this buffer and writes the other one
+        if (!cFrame_Allocate(out, format, width, height))
+        {
+            return false;
+        }
+
+        cYUVView outView;
+        cFrame_GetView(out, &outView);
+        if (!stage->process(stage, &view, &outView))
+        {
+            SDL_Log("Pipeline stage %s failed", stage->name);
+            return false;
+        }
+        view = outView;
+    }
+
+    // Publish the processed frame with the properties of its source
+    setFrameView(target, &view);
+    target->colorspace = input->colorspace;
+    target->timing = input->timing;
+    cMailbox_Publish(me->output->mailbox);
+
+    return true;
+}
+
+/**
+ * @brief Worker thread: processes the newest input frame every time it is woken up.
+ *
+ * @param data Pointer to the `cPipeline`.
+ * @return Always 0.
+ */
+static int SDLCALL cPipeline_Run(void* data)
+{
+    cPipeline* me = data;
+
+    for (;;)
+    {
+        SDL_WaitSemaphore(me->wake);
+        if (!SDL_GetAtomicInt(&me->running))
+        {
+            break;
+        }
+
+        // Several wake-ups may share one frame; only the newest frame is processed
+        cFrame* frame = cMailbox_Acquire(me->input);
+        if (frame != NULL && cPipeline_Process(me, frame) && me->published != NULL)
+        {
+            me->published(me->publishedUserdata);
+        }
+
+        // The frame of this wake-up is out of the pipeline once its publication is announced
+        SDL_AddAtomicInt(&me->queued, -1);
+    }
+
+    return 0;
+}
+
+bool cPipeline_New(cPipeline** addressPipeline, cImage* output,
+                   cPipelinePublished published, void* userdata)
+{
+    // Allocate memory for the pipeline and initialize all fields to zero
+    *addressPipeline = calloc(1, sizeof(cPipeline));
+    if (*addressPipeline == NULL)
+    {
+        LOG_MESSAGE(strerror(errno));  // Log the error message if allocation failed
+        goto EXIT;
+    }
+
+    (*addressPipeline)->output = output;
+    (*addressPipeline)->published = published;
+    (*addressPipeline)->publishedUserdata = userdata;
+
+    // Create the mailbox between the producer and the worker
+    if (!cMailbox_New(&(*addressPipeline)->input))
+    {
+        goto EXIT;
+    }
+
+    // Create the semaphore the producer wakes the worker up with
+    (*addressPipeline)->wake = SDL_CreateSemaphore(0);
+    if ((*addressPipeline)->wake == NULL)
+    {
+        LOG_MESSAGE(SDL_GetError());
+        goto EXIT;
+    }
+
+    return true;
+
+    EXIT:
+    cPipeline_Destroy(*addressPipeline);  // Clean up allocated resources on failure
+    *addressPipeline = NULL;
+    return false;
+}
+
+void cPipeline_Destroy(cPipeline* me)
+{
+    // Check if the pipeline pointer itself is NULL; if so, exit function early
+    if (me == NULL)
+    {
+        return;
+    }
+
+    // Stop the worker thread and wait for it
+    if (me->thread != NULL)
+    {
+        SDL_SetAtomicInt(&me->running, 0);
+        SDL_SignalSemaphore(me->wake);
+        SDL_WaitThread(me->thread, NULL);
+        me->thread = NULL;
+    }
+
+    // Free the stages
+    for (int i = 0; i < me->stageCount; ++i)
+    {
+        me->stages[i]->destroy(me->stages[i]);
+        me->stages[i] = NULL;
+    }
+
+    if (me->wake != NULL)
+    {
+        SDL_DestroySemaphore(me->wake);
+        me->wake = NULL;
+    }
+
+    if (me->input != NULL)
+    {
+        cMailbox_Destroy(me->input);
+        me->input = NULL;
+    }
+
+    // Free the pooled intermediate buffers
+    for (int i = 0; i < 2; ++i)
+    {
+        if (me->scratch[i].data != NULL)
+        {
+            free_memory((void **) &me->scratch[i].data, free);
+        }
+    }
+
+    // Finally, free the pipeline structure itself
+    free_memory((void **) &me, free);
+}
+
+bool cPipeline_AddStage(cPipeline* me, cStage* stage)
+{
+    if (me->thread != NULL || me->stageCount == PIPELINE_MAX_STAGES)
+    {
+        LOG_MESSAGE("Cannot add a stage to this pipeline");
+        stage->destroy(stage);
+        return false;
+    }
+
+    me->stages[me->stageCount++] = stage;
+    return true;
+}
+
+bool cPipeline_Start(cPipeline* me)
+{
+    SDL_SetAtomicInt(&me->running, 1);
+    me->thread = SDL_CreateThread(cPipeline_Run, "FramePipeline", me);
+    if (me->thread == NULL)
+    {
+        LOG_MESSAGE(SDL_GetError());
+        SDL_SetAtomicInt(&me->running, 0);
+        return false;
+    }
+    return true;
+}
+
+bool cPipeline_WritePlanes(cPipeline* me,
+                           const uint8_t* yPlane, const uint8_t* uPlane, const uint8_t* vPlane,
+                           int yRowStride, int uvRowStride, int uvPixelStride,
+                           int width, int height, Uint64 captureTicks)
+{
+    // Write into the slot owned by the producer; the worker never reads it
+    cFrame* frame = cMailbox_BeginWrite(me->input);
+    if (!cFrame_WritePlanes(frame, yPlane, uPlane, vPlane,
+                            yRowStride, uvRowStride, uvPixelStride, width, height, captureTicks))
+    {
+        return false;
+    }
+
+    // Hand the frame over to the worker and wake it up
+    cMailbox_Publish(me->input);
+    SDL_AddAtomicInt(&me->queued, 1);
+    SDL_SignalSemaphore(me->wake);
+    return true;
+}
+
+bool cPipeline_WritePacked(cPipeline* me, const uint8_t* pixels, int rowStride,
+                           SDL_PixelFormat format, int width, int height, Uint64 captureTicks)
+{
+    // Same hand-over as the planar frames, so the worker stays the only writer of the output
+    cFrame* frame = cMailbox_BeginWrite(me->input);
+    if (!cFrame_WritePacked(frame, pixels, rowStride, format, width, height, captureTicks))
+    {
+        return false;
+    }
+
+    cMailbox_Publish(me->input);
+    SDL_AddAtomicInt(&me->queued, 1);
+    SDL_SignalSemaphore(me->wake);
+    return true;
+}
+
+bool cPipeline_IsIdle(cPipeline* me)
+{
+    return SDL_GetAtomicInt(&me->queued) == 0;
+}
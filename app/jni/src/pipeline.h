@@ -0,0 +1,173 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Native frame-processing pipeline running between ingest and the render
+ * mailbox. Frames written by the producer land in an input mailbox; a dedicated
+ * worker thread takes the newest one, runs it through an ordered list of stages,
+ * and publishes the result into the mailbox of a `cImage`. Computer vision and
+ * preprocessing work therefore runs neither on the camera executor nor on the
+ * render thread.
+ *
+ * Each stage receives a planar YUV view. Stages that work in place modify (or
+ * narrow) that view directly and need no output buffer; the others describe
+ * their output geometry and write into a buffer provided by the pipeline. These
+ * buffers come from a small pool, and the last stage producing a new buffer
+ * writes straight into the render mailbox slot.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#ifndef CAMERAXSDL3_PIPELINE_H
+#define CAMERAXSDL3_PIPELINE_H
+
+#include <SDL3/SDL.h>
+
+#include "frame.h"
+#include "image.h"
+#include "mailbox.h"
+
+#define PIPELINE_MAX_STAGES 8
+
+typedef struct stage_s cStage;
+
+// A processing step of the pipeline
+struct stage_s
+{
+    const char* name;     // Name of the stage, for logging
+    bool inPlace;         // Whether the stage works on its input view without an output buffer
+    void* userdata;       // Private state of the stage
+
+    /**
+     * Describes the output of a stage that does not work in place.
+     * Returns `false` if the input cannot be processed.
+     */
+    bool (*configure)(cStage* me, const cYUVView* in, SDL_PixelFormat* format, int* width, int* height);
+
+    /**
+     * Processes a frame. In-place stages get a NULL `out` and may modify both
+     * the planes and the geometry of `in`; the others write into `out`, which
+     * has the layout requested by `configure`. Returns `false` on failure.
+     */
+    bool (*process)(cStage* me, cYUVView* in, cYUVView* out);
+
+    /** Frees the stage and its private state. */
+    void (*destroy)(cStage* me);
+};
+
+// Called on the worker thread every time a processed frame is published
+typedef void (SDLCALL *cPipelinePublished)(void* userdata);
+
+// Stages, buffers and worker thread of a pipeline
+typedef struct pipeline_s
+{
+    cStage* stages[PIPELINE_MAX_STAGES]; // Stages, in processing order
+    int stageCount;           // Number of stages
+    cMailbox* input;          // Frames written by the producer, waiting for the worker
+    cImage* output;           // Image receiving the processed frames
+    cFrame scratch[2];        // Pooled intermediate buffers, used alternately by the stages
+    SDL_Semaphore* wake;      // Signaled by the producer for every published frame
+    SDL_AtomicInt queued;     // Frames written by the producer and not yet handled by the worker
+    SDL_AtomicInt running;    // Cleared to stop the worker thread
+    SDL_Thread* thread;       // Worker thread running the stages
+    cPipelinePublished published; // Notification of processed frames
+    void* publishedUserdata;  // Argument of `published`
+} cPipeline;
+
+/**
+ * @brief Allocates a `cPipeline` publishing into `output`, without stages.
+ *
+ * @param addressPipeline Double pointer to a `cPipeline*` which will point to the
+ *                        newly allocated pipeline if successful.
+ * @param output Image receiving the processed frames.
+ * @param published Function called after each published frame, or NULL.
+ * @param userdata Argument passed to `published`.
+ * @return `true` if the allocation and initialization succeed, `false` otherwise.
+ */
+bool cPipeline_New(cPipeline** addressPipeline, cImage* output,
+                   cPipelinePublished published, void* userdata);
+
+/**
+ * @brief Stops the worker thread and frees the pipeline and all its stages.
+ *
+ * @param me Pointer to the `cPipeline` to destroy; may be NULL.
+ */
+void cPipeline_Destroy(cPipeline* me);
+
+/**
+ * @brief Appends a stage to the pipeline, which takes ownership of it.
+ *
+ * Must be called before `cPipeline_Start`. The stage is destroyed on failure.
+ *
+ * @param me Pointer to the `cPipeline`.
+ * @param stage Stage to append.
+ * @return `true` if the stage was added, `false` if the pipeline is full or running.
+ */
+bool cPipeline_AddStage(cPipeline* me, cStage* stage);
+
+/**
+ * @brief Starts the worker thread.
+ *
+ * @param me Pointer to the `cPipeline`.
+ * @return `true` if the thread was started, `false` otherwise.
+ */
+bool cPipeline_Start(cPipeline* me);
+
+/**
+ * @brief Producer entry point: stores a YUV_420_888 frame for the worker.
+ *
+ * Same contract as `cImage_WritePlanes`, but the frame goes through the stages
+ * before reaching the render mailbox. Never blocks on the worker.
+ *
+ * @param me Pointer to the `cPipeline`.
+ * @param yPlane Pointer to the first byte of the luma plane.
+ * @param uPlane Pointer to the first byte of the U (Cb) plane.
+ * @param vPlane Pointer to the first byte of the V (Cr) plane.
+ * @param yRowStride Distance in bytes between two luma rows.
+ * @param uvRowStride Distance in bytes between two chroma rows.
+ * @param uvPixelStride Distance in bytes between two chroma samples of a row.
+ * @param width Width of the frame in pixels.
+ * @param height Height of the frame in pixels.
+ * @param captureTicks Capture time of the frame on the `SDL_GetTicksNS` clock, or 0 if unknown.
+ * @return `true` if the frame was stored, `false` if an error occurs.
+ */
+bool cPipeline_WritePlanes(cPipeline* me,
+                           const uint8_t* yPlane, const uint8_t* uPlane, const uint8_t* vPlane,
+                           int yRowStride, int uvRowStride, int uvPixelStride,
+                           int width, int height, Uint64 captureTicks);
+
+/**
+ * @brief Producer entry point: stores a packed frame for the worker.
+ *
+ * Same contract as `cImage_WritePacked`. Packed frames skip the stages, but
+ * still reach the render mailbox through the worker, which must remain its
+ * only producer.
+ *
+ * @param me Pointer to the `cPipeline`.
+ * @param pixels Pointer to the first pixel of the image.
+ * @param rowStride Distance in bytes between two rows.
+ * @param format Packed pixel format of the image.
+ * @param width Width of the frame in pixels.
+ * @param height Height of the frame in pixels.
+ * @param captureTicks Capture time of the frame on the `SDL_GetTicksNS` clock, or 0 if unknown.
+ * @return `true` if the frame was stored, `false` if an error occurs.
+ */
+bool cPipeline_WritePacked(cPipeline* me, const uint8_t* pixels, int rowStride,
+                           SDL_PixelFormat format, int width, int height, Uint64 captureTicks);
+
+/**
+ * @brief Tells whether every frame written so far has been processed and published.
+ *
+ * Safe to call from any thread.
+ *
+ * @param me Pointer to the `cPipeline`.
+ * @return `true` if the worker has nothing left to do, `false` otherwise.
+ */
+bool cPipeline_IsIdle(cPipeline* me);
+
+#endif // CAMERAXSDL3_PIPELINE_H
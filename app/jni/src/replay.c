@@ -0,0 +1,406 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Recording and replay of YUV camera streams.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "replay.h"
+#include "common.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#define REPLAY_MAX_SIZE 16384  // Largest width or height accepted from a file
+
+/**
+ * @brief Gives the number of rows and the bytes per row of each plane.
+ *
+ * @param format NV12, NV21 or IYUV.
+ * @param width Width of the frame in pixels.
+ * @param height Height of the frame in pixels.
+ * @param rows Array receiving the number of rows of each plane; 0 for unused planes.
+ * @param rowBytes Array receiving the number of meaningful bytes of each row.
+ */
+static void getPlaneSizes(SDL_PixelFormat format, int width, int height, int rows[3], int rowBytes[3])
+{
+    const int chromaWidth = (width + 1) / 2;
+    const int chromaHeight = (height + 1) / 2;
+
+    rows[0] = height;
+    rowBytes[0] = width;
+    if (format == SDL_PIXELFORMAT_IYUV)
+    {
+        rows[1] = rows[2] = chromaHeight;
+        rowBytes[1] = rowBytes[2] = chromaWidth;
+    }
+    else
+    {
+        rows[1] = chromaHeight;
+        rowBytes[1] = 2 * chromaWidth;  // Interleaved chroma samples
+        rows[2] = rowBytes[2] = 0;
+    }
+}
+
+bool cRecorder_New(cRecorder** addressRecorder, const char* path)
+{
+    // Allocate memory for the recorder and initialize all fields to zero
+    *addressRecorder = calloc(1, sizeof(cRecorder));
+    if (*addressRecorder == NULL)
+    {
+        LOG_MESSAGE(strerror(errno));  // Log the error message if allocation failed
+        goto EXIT;
+    }
+
+    // Create the file and write its header
+    (*addressRecorder)->stream = SDL_IOFromFile(path, "wb");
+    if ((*addressRecorder)->stream == NULL ||
+        !SDL_WriteU32LE((*addressRecorder)->stream, REPLAY_MAGIC) ||
+        !SDL_WriteU32LE((*addressRecorder)->stream, REPLAY_VERSION))
+    {
+        LOG_MESSAGE(SDL_GetError());
+        goto EXIT;
+    }
+
+    return true;
+
+    EXIT:
+    cRecorder_Destroy(*addressRecorder);  // Clean up allocated resources on failure
+    *addressRecorder = NULL;
+    return false;
+}
+
+void cRecorder_Destroy(cRecorder* me)
+{
+    // Check if the recorder pointer itself is NULL; if so, exit function early
+    if (me == NULL)
+    {
+        return;
+    }
+
+    // Flush and close the file
+    if (me->stream != NULL && !SDL_CloseIO(me->stream))
+    {
+        LOG_MESSAGE(SDL_GetError());
+    }
+    me->stream = NULL;
+
+    if (me->frame.data != NULL)
+    {
+        free_memory((void **) &me->frame.data, free);
+    }
+
+    // Finally, free the recorder structure itself
+    free_memory((void **) &me, free);
+}
+
+bool cRecorder_WritePlanes(cRecorder* me,
+                           const uint8_t* yPlane, const uint8_t* uPlane, const uint8_t* vPlane,
+                           int yRowStride, int uvRowStride, int uvPixelStride,
+                           int width, int height, Uint64 captureTicks)
+{
+    // Bring the frame to one of the layouts of the file format
+    if (!cFrame_WritePlanes(&me->frame, yPlane, uPlane, vPlane,
+                            yRowStride, uvRowStride, uvPixelStride, width, height, captureTicks))
+    {
+        return false;
+    }
+
+    cYUVView view;
+    int rows[3], rowBytes[3];
+    cFrame_GetView(&me->frame, &view);
+    getPlaneSizes(view.format, width, height, rows, rowBytes);
+
+    // Frame header: the rows are written without padding, so the pitches are the row sizes
+    bool ok = SDL_WriteU32LE(me->stream, (Uint32) view.format) &&
+              SDL_WriteU32LE(me->stream, (Uint32) width) &&
+              SDL_WriteU32LE(me->stream, (Uint32) height);
+    for (int plane = 0; plane < 3; ++plane)
+    {
+        ok = ok && SDL_WriteU32LE(me->stream, (Uint32) rowBytes[plane]);
+    }
+    ok = ok && SDL_WriteU64LE(me->stream, captureTicks != 0 ? captureTicks : SDL_GetTicksNS());
+
+    // Frame data
+    for (int plane = 0; ok && plane < 3; ++plane)
+    {
+        for (int row = 0; ok && row < rows[plane]; ++row)
+        {
+            ok = SDL_WriteIO(me->stream, view.planes[plane] + (size_t) row * view.pitches[plane],
+                             rowBytes[plane]) == (size_t) rowBytes[plane];
+        }
+    }
+
+    if (!ok)
+    {
+        LOG_MESSAGE(SDL_GetError());
+        return false;
+    }
+
+    me->frames++;
+    return true;
+}
+
+/**
+ * @brief Reads the next frame of the file into the replay frame.
+ *
+ * @param me Pointer to the `cReplay`.
+ * @param timestamp Pointer receiving the recorded time stamp of the frame.
+ * @param end Pointer set to `true` if the end of the file was reached instead.
+ * @return `true` if a frame was read, `false` at the end of the file or on error.
+ */
+static bool readFrame(cReplay* me, Uint64* timestamp, bool* end)
+{
+    Uint32 format, width, height, pitches[3];
+    cFrame* frame = &me->frame;
+
+    *end = false;
+
+    // The end of the file is only expected before a frame header
+    if (!SDL_ReadU32LE(me->stream, &format))
+    {
+        *end = (SDL_GetIOStatus(me->stream) == SDL_IO_STATUS_EOF);
+        if (!*end)
+        {
+            LOG_MESSAGE(SDL_GetError());
+        }
+        return false;
+    }
+
+    if (!SDL_ReadU32LE(me->stream, &width) ||
+        !SDL_ReadU32LE(me->stream, &height) ||
+        !SDL_ReadU32LE(me->stream, &pitches[0]) ||
+        !SDL_ReadU32LE(me->stream, &pitches[1]) ||
+        !SDL_ReadU32LE(me->stream, &pitches[2]) ||
+        !SDL_ReadU64LE(me->stream, timestamp))
+    {
+        LOG_MESSAGE("Truncated frame header in the recording");
+        return false;
+    }
+
+    // Check the header before trusting its sizes
+    int rows[3], rowBytes[3];
+    getPlaneSizes((SDL_PixelFormat) format, (int) width, (int) height, rows, rowBytes);
+    if ((format != SDL_PIXELFORMAT_NV12 && format != SDL_PIXELFORMAT_NV21 && format != SDL_PIXELFORMAT_IYUV) ||
+        width == 0 || height == 0 || width > REPLAY_MAX_SIZE || height > REPLAY_MAX_SIZE ||
+        pitches[0] < (Uint32) rowBytes[0] || pitches[1] < (Uint32) rowBytes[1] ||
+        pitches[2] < (Uint32) rowBytes[2] || pitches[0] > 4 * REPLAY_MAX_SIZE ||
+        pitches[1] > 4 * REPLAY_MAX_SIZE || pitches[2] > 4 * REPLAY_MAX_SIZE ||
+        (format == SDL_PIXELFORMAT_IYUV && pitches[1] != pitches[2]))
+    {
+        LOG_MESSAGE("Invalid frame header in the recording");
+        return false;
+    }
+
+    // Lay the planes out one after the other, with the pitches of the file
+    size_t length = 0;
+    for (int plane = 0; plane < 3; ++plane)
+    {
+        frame->offsets[plane] = length;
+        frame->pitches[plane] = (rows[plane] > 0) ? (int) pitches[plane] : 0;
+        length += (size_t) rows[plane] * frame->pitches[plane];
+    }
+    if (!cFrame_Reserve(frame, length))
+    {
+        return false;
+    }
+
+    if (SDL_ReadIO(me->stream, frame->data, length) != length)
+    {
+        LOG_MESSAGE("Truncated frame data in the recording");
+        return false;
+    }
+
+    frame->format = (SDL_PixelFormat) format;
+    frame->colorspace = SDL_COLORSPACE_YUV_DEFAULT;
+    frame->width = (int) width;
+    frame->height = (int) height;
+    return true;
+}
+
+/**
+ * @brief Hands the replay frame to the sink, as the camera would.
+ *
+ * @param me Pointer to the `cReplay`.
+ * @return The result of the sink.
+ */
+static bool deliverFrame(cReplay* me)
+{
+    const cFrame* frame = &me->frame;
+    const uint8_t* y = frame->data + frame->offsets[0];
+    const uint8_t* chroma = frame->data + frame->offsets[1];
+
+    // Describe the planes as YUV_420_888 with the strides matching the layout
+    switch (frame->format)
+    {
+        case SDL_PIXELFORMAT_NV12:
+            return me->sink(me->userdata, y, chroma, chroma + 1, frame->pitches[0], frame->pitches[1], 2,
+                            frame->width, frame->height, SDL_GetTicksNS());
+        case SDL_PIXELFORMAT_NV21:
+            return me->sink(me->userdata, y, chroma + 1, chroma, frame->pitches[0], frame->pitches[1], 2,
+                            frame->width, frame->height, SDL_GetTicksNS());
+        default:
+            return me->sink(me->userdata, y, chroma, frame->data + frame->offsets[2],
+                            frame->pitches[0], frame->pitches[1], 1,
+                            frame->width, frame->height, SDL_GetTicksNS());
+    }
+}
+
+/**
+ * @brief Replay thread: reads the frames and delivers them at the requested pace.
+ *
+ * @param data Pointer to the `cReplay`.
+ * @return Always 0.
+ */
+static int SDLCALL cReplay_Run(void* data)
+{
+    cReplay* me = data;
+    Uint64 firstTimestamp = 0;  // Recorded time of the first frame of the pass
+    Uint64 firstTicks = 0;      // Delivery time of the first frame of the pass
+    bool first = true;
+
+    while (SDL_GetAtomicInt(&me->running))
+    {
+        Uint64 timestamp;
+        bool end;
+
+        if (!readFrame(me, &timestamp, &end))
+        {
+            // Restart from the first frame, or stop
+            if (end && me->loop && me->frames > 0 && SDL_SeekIO(me->stream, me->firstFrame, SDL_IO_SEEK_SET) >= 0)
+            {
+                first = true;
+                continue;
+            }
+            break;
+        }
+
+        // Keep the recorded interval between this frame and the first one of the pass
+        Uint64 now = SDL_GetTicksNS();
+        if (first)
+        {
+            firstTimestamp = timestamp;
+            firstTicks = now;
+            first = false;
+        }
+        else if (me->realtime && timestamp > firstTimestamp)
+        {
+            Uint64 due = firstTicks + (timestamp - firstTimestamp);
+            if (due > now)
+            {
+                SDL_DelayNS(due - now);
+            }
+        }
+
+        if (me->frames == 0)
+        {
+            me->startTicks = SDL_GetTicksNS();
+        }
+        deliverFrame(me);
+        me->frames++;
+    }
+
+    me->endTicks = SDL_GetTicksNS();
+    SDL_SetAtomicInt(&me->finished, 1);
+    return 0;
+}
+
+bool cReplay_New(cReplay** addressReplay, const char* path, bool realtime, bool loop,
+                 cFrameSink sink, void* userdata)
+{
+    Uint32 magic, version;
+
+    // Allocate memory for the replay and initialize all fields to zero
+    *addressReplay = calloc(1, sizeof(cReplay));
+    if (*addressReplay == NULL)
+    {
+        LOG_MESSAGE(strerror(errno));  // Log the error message if allocation failed
+        goto EXIT;
+    }
+
+    (*addressReplay)->realtime = realtime;
+    (*addressReplay)->loop = loop;
+    (*addressReplay)->sink = sink;
+    (*addressReplay)->userdata = userdata;
+
+    // Open the file and check its header
+    (*addressReplay)->stream = SDL_IOFromFile(path, "rb");
+    if ((*addressReplay)->stream == NULL)
+    {
+        LOG_MESSAGE(SDL_GetError());
+        goto EXIT;
+    }
+
+    if (!SDL_ReadU32LE((*addressReplay)->stream, &magic) ||
+        !SDL_ReadU32LE((*addressReplay)->stream, &version) ||
+        magic != REPLAY_MAGIC || version != REPLAY_VERSION)
+    {
+        LOG_MESSAGE("Not a supported YUV recording");
+        goto EXIT;
+    }
+    (*addressReplay)->firstFrame = SDL_TellIO((*addressReplay)->stream);
+
+    return true;
+
+    EXIT:
+    cReplay_Destroy(*addressReplay);  // Clean up allocated resources on failure
+    *addressReplay = NULL;
+    return false;
+}
+
+void cReplay_Destroy(cReplay* me)
+{
+    // Check if the replay pointer itself is NULL; if so, exit function early
+    if (me == NULL)
+    {
+        return;
+    }
+
+    // Stop the replay thread and wait for it
+    if (me->thread != NULL)
+    {
+        SDL_SetAtomicInt(&me->running, 0);
+        SDL_WaitThread(me->thread, NULL);
+        me->thread = NULL;
+    }
+
+    if (me->stream != NULL)
+    {
+        SDL_CloseIO(me->stream);
+        me->stream = NULL;
+    }
+
+    if (me->frame.data != NULL)
+    {
+        free_memory((void **) &me->frame.data, free);
+    }
+
+    // Finally, free the replay structure itself
+    free_memory((void **) &me, free);
+}
+
+bool cReplay_Start(cReplay* me)
+{
+    SDL_SetAtomicInt(&me->running, 1);
+    me->thread = SDL_CreateThread(cReplay_Run, "FrameReplay", me);
+    if (me->thread == NULL)
+    {
+        LOG_MESSAGE(SDL_GetError());
+        SDL_SetAtomicInt(&me->running, 0);
+        return false;
+    }
+    return true;
+}
+
+bool cReplay_IsFinished(cReplay* me)
+{
+    return SDL_GetAtomicInt(&me->finished) != 0;
+}
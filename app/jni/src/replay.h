@@ -0,0 +1,142 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Recording and replay of YUV camera streams. A `cRecorder` dumps live frames
+ * to a file; a `cReplay` reads such a file through `SDL_IOStream` on its own
+ * thread and hands every frame to the same ingest function as the JNI bridge,
+ * either at the recorded pace or as fast as possible. This makes the ingest,
+ * upload and render path reproducible and measurable without a camera.
+ *
+ * File format (little endian):
+ * - File header: magic `REPLAY_MAGIC` and version `REPLAY_VERSION`, both Uint32.
+ * - Frame header: format (SDL_PixelFormat: NV12, NV21 or IYUV), width, height
+ *   and the three row pitches as Uint32, then the capture time stamp in
+ *   nanoseconds as Uint64.
+ * - Frame data: each plane in turn, `pitch` bytes per row, `height` rows for
+ *   the luma plane and `(height + 1) / 2` rows for the chroma plane(s).
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#ifndef CAMERAXSDL3_REPLAY_H
+#define CAMERAXSDL3_REPLAY_H
+
+#include <SDL3/SDL.h>
+
+#include "frame.h"
+
+#define REPLAY_MAGIC 0x56555943u  // "CYUV"
+#define REPLAY_VERSION 1u
+
+/**
+ * Receives the frames of a replay, with the arguments of `cImage_WritePlanes`.
+ * Returns `false` if the frame could not be stored.
+ */
+typedef bool (*cFrameSink)(void* userdata,
+                           const uint8_t* yPlane, const uint8_t* uPlane, const uint8_t* vPlane,
+                           int yRowStride, int uvRowStride, int uvPixelStride,
+                           int width, int height, Uint64 captureTicks);
+
+// File being written with live frames
+typedef struct recorder_s
+{
+    SDL_IOStream* stream; // Output file
+    cFrame frame;         // Frame normalized to NV12, NV21 or IYUV before being written
+    Uint64 frames;        // Number of frames written
+} cRecorder;
+
+// File being replayed and the thread feeding its frames
+typedef struct replay_s
+{
+    SDL_IOStream* stream; // Input file
+    Sint64 firstFrame;    // Offset of the first frame header, to loop
+    cFrame frame;         // Frame being replayed
+    bool realtime;        // Whether frames are delivered at their recorded pace
+    bool loop;            // Whether the file restarts at its end
+    cFrameSink sink;      // Ingest function receiving the frames
+    void* userdata;       // Argument of `sink`
+    SDL_Thread* thread;   // Thread reading and delivering the frames
+    SDL_AtomicInt running; // Cleared to stop the thread
+    SDL_AtomicInt finished; // Set once the last frame was delivered
+    Uint64 frames;        // Number of frames delivered
+    Uint64 startTicks;    // Time the first frame was delivered
+    Uint64 endTicks;      // Time the last frame was delivered
+} cReplay;
+
+/**
+ * @brief Creates a file to record frames into.
+ *
+ * @param addressRecorder Double pointer to a `cRecorder*` which will point to the
+ *                        newly allocated recorder if successful.
+ * @param path Path of the file to create.
+ * @return `true` if the file was created, `false` otherwise.
+ */
+bool cRecorder_New(cRecorder** addressRecorder, const char* path);
+
+/**
+ * @brief Closes the file and frees the `cRecorder`.
+ *
+ * @param me Pointer to the `cRecorder` to destroy; may be NULL.
+ */
+void cRecorder_Destroy(cRecorder* me);
+
+/**
+ * @brief Appends a YUV_420_888 frame to the recording.
+ *
+ * Takes the arguments of `cImage_WritePlanes`; the frame is stored without
+ * row padding. A capture time of 0 is replaced with the current time.
+ *
+ * @return `true` if the frame was written, `false` if an error occurs.
+ */
+bool cRecorder_WritePlanes(cRecorder* me,
+                           const uint8_t* yPlane, const uint8_t* uPlane, const uint8_t* vPlane,
+                           int yRowStride, int uvRowStride, int uvPixelStride,
+                           int width, int height, Uint64 captureTicks);
+
+/**
+ * @brief Opens a recording for replay; frames are delivered once started.
+ *
+ * @param addressReplay Double pointer to a `cReplay*` which will point to the
+ *                      newly allocated replay if successful.
+ * @param path Path of the recording.
+ * @param realtime `true` to keep the recorded intervals, `false` to deliver frames as fast as possible.
+ * @param loop `true` to restart from the first frame at the end of the file.
+ * @param sink Function receiving every frame.
+ * @param userdata Argument passed to `sink`.
+ * @return `true` if the file is a valid recording, `false` otherwise.
+ */
+bool cReplay_New(cReplay** addressReplay, const char* path, bool realtime, bool loop,
+                 cFrameSink sink, void* userdata);
+
+/**
+ * @brief Stops the replay thread, closes the file and frees the `cReplay`.
+ *
+ * @param me Pointer to the `cReplay` to destroy; may be NULL.
+ */
+void cReplay_Destroy(cReplay* me);
+
+/**
+ * @brief Starts the thread delivering the frames.
+ *
+ * @param me Pointer to the `cReplay`.
+ * @return `true` if the thread was started, `false` otherwise.
+ */
+bool cReplay_Start(cReplay* me);
+
+/**
+ * @brief Tells whether every frame of a non-looping replay has been delivered.
+ *
+ * Once it returns `true`, the `frames`, `startTicks` and `endTicks` fields can be read.
+ *
+ * @param me Pointer to the `cReplay`.
+ * @return `true` if the replay is over, `false` otherwise.
+ */
+bool cReplay_IsFinished(cReplay* me);
+
+#endif // CAMERAXSDL3_REPLAY_H
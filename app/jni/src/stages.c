@@ -0,0 +1,467 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Example stages for the frame-processing pipeline.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "stages.h"
+#include "common.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#define DENOISE_THRESHOLD 12  // Luma difference above which a pixel is considered moving
+
+// State of the luma histogram stage
+typedef struct
+{
+    Uint32 counts[HISTOGRAM_BINS];  // Histogram being computed by the worker
+    Uint32 bins[HISTOGRAM_BINS];    // Histogram of the last complete frame
+    SDL_Mutex* lock;                // Protects `bins`
+} cHistogramState;
+
+// State of the crop stage
+typedef struct
+{
+    SDL_Rect rect;                  // Area to keep
+} cCropState;
+
+// State of the downscale stage
+typedef struct
+{
+    int factor;                     // Integer reduction factor
+} cDownscaleState;
+
+// State of the denoise stage
+typedef struct
+{
+    int strength;                   // Weight of the history
+    uint8_t* history;               // Filtered luma of the previous frame
+    int width;                      // Width of `history`
+    int height;                     // Height of `history`
+} cDenoiseState;
+
+// State of the convert stage
+typedef struct
+{
+    SDL_PixelFormat format;         // Target layout
+} cConvertState;
+
+/**
+ * @brief Frees a stage whose state owns no other resource.
+ *
+ * @param me Pointer to the `cStage` to destroy.
+ */
+static void destroyStage(cStage* me)
+{
+    if (me->userdata != NULL)
+    {
+        free_memory((void **) &me->userdata, free);
+    }
+    free_memory((void **) &me, free);
+}
+
+/**
+ * @brief Allocates a stage and its zeroed state.
+ *
+ * @param addressStage Double pointer to a `cStage*` receiving the stage.
+ * @param name Name of the stage.
+ * @param inPlace Whether the stage works on its input view.
+ * @param stateSize Size of the private state in bytes.
+ * @return `true` if the allocation succeeds, `false` otherwise.
+ */
+static bool newStage(cStage** addressStage, const char* name, bool inPlace, size_t stateSize)
+{
+    *addressStage = calloc(1, sizeof(cStage));
+    if (*addressStage == NULL)
+    {
+        LOG_MESSAGE(strerror(errno));
+        return false;
+    }
+
+    (*addressStage)->userdata = calloc(1, stateSize);
+    if ((*addressStage)->userdata == NULL)
+    {
+        LOG_MESSAGE(strerror(errno));
+        destroyStage(*addressStage);
+        *addressStage = NULL;
+        return false;
+    }
+
+    (*addressStage)->name = name;
+    (*addressStage)->inPlace = inPlace;
+    (*addressStage)->destroy = destroyStage;
+    return true;
+}
+
+/**
+ * @brief Reads the chroma sample at chroma coordinates (`x`, `y`).
+ */
+static inline void readChroma(const cYUVView* view, int x, int y, uint8_t* u, uint8_t* v)
+{
+    const uint8_t* row;
+
+    switch (view->format)
+    {
+        case SDL_PIXELFORMAT_NV12:
+            row = view->planes[1] + (size_t) y * view->pitches[1] + 2 * x;
+            *u = row[0];
+            *v = row[1];
+            break;
+        case SDL_PIXELFORMAT_NV21:
+            row = view->planes[1] + (size_t) y * view->pitches[1] + 2 * x;
+            *v = row[0];
+            *u = row[1];
+            break;
+        default:
+            *u = view->planes[1][(size_t) y * view->pitches[1] + x];
+            *v = view->planes[2][(size_t) y * view->pitches[2] + x];
+            break;
+    }
+}
+
+/**
+ * @brief Writes the chroma sample at chroma coordinates (`x`, `y`).
+ */
+static inline void writeChroma(cYUVView* view, int x, int y, uint8_t u, uint8_t v)
+{
+    uint8_t* row;
+
+    switch (view->format)
+    {
+        case SDL_PIXELFORMAT_NV12:
+            row = view->planes[1] + (size_t) y * view->pitches[1] + 2 * x;
+            row[0] = u;
+            row[1] = v;
+            break;
+        case SDL_PIXELFORMAT_NV21:
+            row = view->planes[1] + (size_t) y * view->pitches[1] + 2 * x;
+            row[0] = v;
+            row[1] = u;
+            break;
+        default:
+            view->planes[1][(size_t) y * view->pitches[1] + x] = u;
+            view->planes[2][(size_t) y * view->pitches[2] + x] = v;
+            break;
+    }
+}
+
+/* Luma histogram */
+
+static void destroyHistogram(cStage* me)
+{
+    cHistogramState* state = me->userdata;
+    if (state->lock != NULL)
+    {
+        SDL_DestroyMutex(state->lock);
+    }
+    destroyStage(me);
+}
+
+static bool processHistogram(cStage* me, cYUVView* in, cYUVView* out)
+{
+    (void) out;
+    cHistogramState* state = me->userdata;
+
+    // Count without the lock, then publish the result at once
+    SDL_memset(state->counts, 0, sizeof(state->counts));
+    for (int y = 0; y < in->height; ++y)
+    {
+        const uint8_t* row = in->planes[0] + (size_t) y * in->pitches[0];
+        for (int x = 0; x < in->width; ++x)
+        {
+            state->counts[row[x]]++;
+        }
+    }
+
+    SDL_LockMutex(state->lock);
+    SDL_memcpy(state->bins, state->counts, sizeof(state->bins));
+    SDL_UnlockMutex(state->lock);
+    return true;
+}
+
+bool cStage_NewLumaHistogram(cStage** addressStage)
+{
+    if (!newStage(addressStage, "histogram", true, sizeof(cHistogramState)))
+    {
+        return false;
+    }
+
+    cHistogramState* state = (*addressStage)->userdata;
+    (*addressStage)->process = processHistogram;
+    (*addressStage)->destroy = destroyHistogram;
+
+    state->lock = SDL_CreateMutex();
+    if (state->lock == NULL)
+    {
+        LOG_MESSAGE(SDL_GetError());
+        destroyHistogram(*addressStage);
+        *addressStage = NULL;
+        return false;
+    }
+    return true;
+}
+
+void cStage_GetLumaHistogram(cStage* me, Uint32 bins[HISTOGRAM_BINS])
+{
+    cHistogramState* state = me->userdata;
+
+    SDL_LockMutex(state->lock);
+    SDL_memcpy(bins, state->bins, sizeof(state->bins));
+    SDL_UnlockMutex(state->lock);
+}
+
+/* Crop */
+
+static bool processCrop(cStage* me, cYUVView* in, cYUVView* out)
+{
+    (void) out;
+    const cCropState* state = me->userdata;
+
+    // Align on even coordinates so that the chroma planes follow the luma plane
+    int x = SDL_clamp(state->rect.x, 0, in->width) & ~1;
+    int y = SDL_clamp(state->rect.y, 0, in->height) & ~1;
+    int w = SDL_min(state->rect.w, in->width - x) & ~1;
+    int h = SDL_min(state->rect.h, in->height - y) & ~1;
+    if (w <= 0 || h <= 0)
+    {
+        return false;
+    }
+
+    // Move the plane pointers; no pixel is copied
+    in->planes[0] += (size_t) y * in->pitches[0] + x;
+    if (in->format == SDL_PIXELFORMAT_IYUV)
+    {
+        in->planes[1] += (size_t) (y / 2) * in->pitches[1] + x / 2;
+        in->planes[2] += (size_t) (y / 2) * in->pitches[2] + x / 2;
+    }
+    else
+    {
+        in->planes[1] += (size_t) (y / 2) * in->pitches[1] + x;  // Interleaved: 2 bytes per chroma sample
+    }
+    in->width = w;
+    in->height = h;
+    return true;
+}
+
+bool cStage_NewCrop(cStage** addressStage, SDL_Rect rect)
+{
+    if (!newStage(addressStage, "crop", true, sizeof(cCropState)))
+    {
+        return false;
+    }
+
+    ((cCropState*) (*addressStage)->userdata)->rect = rect;
+    (*addressStage)->process = processCrop;
+    return true;
+}
+
+/* Box downscale */
+
+static bool configureDownscale(cStage* me, const cYUVView* in, SDL_PixelFormat* format, int* width, int* height)
+{
+    const cDownscaleState* state = me->userdata;
+
+    *format = in->format;
+    *width = SDL_max(in->width / state->factor, 1);
+    *height = SDL_max(in->height / state->factor, 1);
+    return true;
+}
+
+static bool processDownscale(cStage* me, cYUVView* in, cYUVView* out)
+{
+    const int factor = ((const cDownscaleState*) me->userdata)->factor;
+    const int area = factor * factor;
+
+    // Luma: average of each factor x factor block, clamped to the edges of frames smaller than a block
+    for (int y = 0; y < out->height; ++y)
+    {
+        uint8_t* dst = out->planes[0] + (size_t) y * out->pitches[0];
+        for (int x = 0; x < out->width; ++x)
+        {
+            int sum = 0;
+            for (int j = 0; j < factor; ++j)
+            {
+                const uint8_t* src = in->planes[0] + (size_t) SDL_min(y * factor + j, in->height - 1) * in->pitches[0];
+                for (int i = 0; i < factor; ++i)
+                {
+                    sum += src[SDL_min(x * factor + i, in->width - 1)];
+                }
+            }
+            dst[x] = (uint8_t) ((sum + area / 2) / area);
+        }
+    }
+
+    // Chroma: same reduction on the subsampled planes, clamped to their edges
+    const int inChromaWidth = (in->width + 1) / 2;
+    const int inChromaHeight = (in->height + 1) / 2;
+    for (int y = 0; y < (out->height + 1) / 2; ++y)
+    {
+        for (int x = 0; x < (out->width + 1) / 2; ++x)
+        {
+            int sumU = 0, sumV = 0;
+            for (int j = 0; j < factor; ++j)
+            {
+                int sy = SDL_min(y * factor + j, inChromaHeight - 1);
+                for (int i = 0; i < factor; ++i)
+                {
+                    uint8_t u, v;
+                    readChroma(in, SDL_min(x * factor + i, inChromaWidth - 1), sy, &u, &v);
+                    sumU += u;
+                    sumV += v;
+                }
+            }
+            writeChroma(out, x, y, (uint8_t) ((sumU + area / 2) / area), (uint8_t) ((sumV + area / 2) / area));
+        }
+    }
+    return true;
+}
+
+bool cStage_NewDownscale(cStage** addressStage, int factor)
+{
+    if (factor < 2)
+    {
+        LOG_MESSAGE("Downscale factor must be at least 2");
+        *addressStage = NULL;
+        return false;
+    }
+
+    if (!newStage(addressStage, "downscale", false, sizeof(cDownscaleState)))
+    {
+        return false;
+    }
+
+    ((cDownscaleState*) (*addressStage)->userdata)->factor = factor;
+    (*addressStage)->configure = configureDownscale;
+    (*addressStage)->process = processDownscale;
+    return true;
+}
+
+/* Temporal denoise */
+
+static void destroyDenoise(cStage* me)
+{
+    cDenoiseState* state = me->userdata;
+    if (state->history != NULL)
+    {
+        free_memory((void **) &state->history, free);
+    }
+    destroyStage(me);
+}
+
+static bool processDenoise(cStage* me, cYUVView* in, cYUVView* out)
+{
+    (void) out;
+    cDenoiseState* state = me->userdata;
+    const int weight = state->strength;
+
+    // Restart from the current frame when the size changes
+    if (state->history == NULL || state->width != in->width || state->height != in->height)
+    {
+        uint8_t* history = realloc(state->history, (size_t) in->width * in->height);
+        if (history == NULL)
+        {
+            LOG_MESSAGE(strerror(errno));
+            return false;
+        }
+        state->history = history;
+        state->width = in->width;
+        state->height = in->height;
+        for (int y = 0; y < in->height; ++y)
+        {
+            SDL_memcpy(history + (size_t) y * in->width, in->planes[0] + (size_t) y * in->pitches[0], in->width);
+        }
+        return true;
+    }
+
+    for (int y = 0; y < in->height; ++y)
+    {
+        uint8_t* row = in->planes[0] + (size_t) y * in->pitches[0];
+        uint8_t* previous = state->history + (size_t) y * in->width;
+        for (int x = 0; x < in->width; ++x)
+        {
+            int difference = row[x] - previous[x];
+            if (difference > -DENOISE_THRESHOLD && difference < DENOISE_THRESHOLD)
+            {
+                row[x] = (uint8_t) ((previous[x] * weight + row[x] + weight / 2) / (weight + 1));
+            }
+            previous[x] = row[x];
+        }
+    }
+    return true;
+}
+
+bool cStage_NewDenoise(cStage** addressStage, int strength)
+{
+    if (!newStage(addressStage, "denoise", true, sizeof(cDenoiseState)))
+    {
+        return false;
+    }
+
+    ((cDenoiseState*) (*addressStage)->userdata)->strength = SDL_clamp(strength, 1, 3);
+    (*addressStage)->process = processDenoise;
+    (*addressStage)->destroy = destroyDenoise;
+    return true;
+}
+
+/* Layout conversion */
+
+static bool configureConvert(cStage* me, const cYUVView* in, SDL_PixelFormat* format, int* width, int* height)
+{
+    *format = ((const cConvertState*) me->userdata)->format;
+    *width = in->width;
+    *height = in->height;
+    return true;
+}
+
+static bool processConvert(cStage* me, cYUVView* in, cYUVView* out)
+{
+    (void) me;
+
+    // The luma plane is identical in every layout
+    for (int y = 0; y < in->height; ++y)
+    {
+        SDL_memcpy(out->planes[0] + (size_t) y * out->pitches[0],
+                   in->planes[0] + (size_t) y * in->pitches[0], in->width);
+    }
+
+    for (int y = 0; y < (in->height + 1) / 2; ++y)
+    {
+        for (int x = 0; x < (in->width + 1) / 2; ++x)
+        {
+            uint8_t u, v;
+            readChroma(in, x, y, &u, &v);
+            writeChroma(out, x, y, u, v);
+        }
+    }
+    return true;
+}
+
+bool cStage_NewConvert(cStage** addressStage, SDL_PixelFormat format)
+{
+    if (format != SDL_PIXELFORMAT_NV12 && format != SDL_PIXELFORMAT_NV21 && format != SDL_PIXELFORMAT_IYUV)
+    {
+        LOG_MESSAGE("Unsupported conversion format");
+        *addressStage = NULL;
+        return false;
+    }
+
+    if (!newStage(addressStage, "convert", false, sizeof(cConvertState)))
+    {
+        return false;
+    }
+
+    ((cConvertState*) (*addressStage)->userdata)->format = format;
+    (*addressStage)->configure = configureConvert;
+    (*addressStage)->process = processConvert;
+    return true;
+}
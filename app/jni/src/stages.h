@@ -0,0 +1,88 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Example stages for the frame-processing pipeline: luma histogram, crop,
+ * box downscale, temporal luma denoise and YUV layout conversion. Each
+ * constructor returns a `cStage` to hand over to `cPipeline_AddStage`.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#ifndef CAMERAXSDL3_STAGES_H
+#define CAMERAXSDL3_STAGES_H
+
+#include <SDL3/SDL.h>
+
+#include "pipeline.h"
+
+#define HISTOGRAM_BINS 256
+
+/**
+ * @brief Allocates a stage computing the luma histogram of every frame.
+ *
+ * The stage only reads the frame; the last histogram can be fetched from any
+ * thread with `cStage_GetLumaHistogram`.
+ *
+ * @param addressStage Double pointer to a `cStage*` receiving the stage.
+ * @return `true` if the allocation succeeds, `false` otherwise.
+ */
+bool cStage_NewLumaHistogram(cStage** addressStage);
+
+/**
+ * @brief Copies the histogram of the last frame seen by a luma histogram stage.
+ *
+ * @param me Stage created by `cStage_NewLumaHistogram`.
+ * @param bins Array receiving the number of pixels of each luma value.
+ */
+void cStage_GetLumaHistogram(cStage* me, Uint32 bins[HISTOGRAM_BINS]);
+
+/**
+ * @brief Allocates a stage cropping frames to a rectangle, without copying.
+ *
+ * The rectangle is aligned on even coordinates to keep the chroma planes
+ * aligned, and clamped to the frame.
+ *
+ * @param addressStage Double pointer to a `cStage*` receiving the stage.
+ * @param rect Area to keep, in pixels of the input frame.
+ * @return `true` if the allocation succeeds, `false` otherwise.
+ */
+bool cStage_NewCrop(cStage** addressStage, SDL_Rect rect);
+
+/**
+ * @brief Allocates a stage dividing the frame size with a box filter.
+ *
+ * @param addressStage Double pointer to a `cStage*` receiving the stage.
+ * @param factor Integer reduction factor, at least 2.
+ * @return `true` if the allocation succeeds, `false` otherwise.
+ */
+bool cStage_NewDownscale(cStage** addressStage, int factor);
+
+/**
+ * @brief Allocates a stage reducing luma noise with a temporal recursive filter.
+ *
+ * Pixels close to their filtered value of the previous frame are blended with
+ * it; pixels that changed more than a threshold are kept, which avoids trails
+ * on moving objects.
+ *
+ * @param addressStage Double pointer to a `cStage*` receiving the stage.
+ * @param strength Weight of the history, from 1 (light) to 3 (strong).
+ * @return `true` if the allocation succeeds, `false` otherwise.
+ */
+bool cStage_NewDenoise(cStage** addressStage, int strength);
+
+/**
+ * @brief Allocates a stage converting frames to another YUV 4:2:0 layout.
+ *
+ * @param addressStage Double pointer to a `cStage*` receiving the stage.
+ * @param format Target layout: NV12, NV21 or IYUV.
+ * @return `true` if the allocation succeeds, `false` otherwise.
+ */
+bool cStage_NewConvert(cStage** addressStage, SDL_PixelFormat format);
+
+#endif // CAMERAXSDL3_STAGES_H
@@ -0,0 +1,125 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Small least-recently-used pool of streaming textures, keyed by frame geometry,
+ * pixel format and colorspace.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "texture_pool.h"
+#include "common.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+bool cTexturePool_New(cTexturePool** addressPool, SDL_Renderer* renderer)
+{
+    // Allocate memory for the pool and initialize all entries to unused
+    *addressPool = calloc(1, sizeof(cTexturePool));
+    if (*addressPool == NULL)
+    {
+        LOG_MESSAGE(strerror(errno));  // Log the error message if allocation failed
+        return false;
+    }
+
+    (*addressPool)->renderer = renderer;
+    return true;
+}
+
+void cTexturePool_Destroy(cTexturePool* me)
+{
+    // Check if the pool pointer itself is NULL; if so, exit function early
+    if (me == NULL)
+    {
+        return;
+    }
+
+    // Free every pooled texture, using SDL_DestroyTexture as the free function
+    for (int i = 0; i < TEXTURE_POOL_SIZE; ++i)
+    {
+        if (me->entries[i].texture != NULL)
+        {
+            free_memory((void **) &me->entries[i].texture, (void (*)(void *)) SDL_DestroyTexture);
+        }
+    }
+
+    // Finally, free the pool structure itself
+    free_memory((void **) &me, free);
+}
+
+SDL_Texture* cTexturePool_Acquire(cTexturePool* me, int width, int height,
+                                  SDL_PixelFormat format, SDL_Colorspace colorspace)
+{
+    cTexturePoolEntry* victim = NULL;  // Entry to (re)fill if no texture matches
+
+    me->clock++;
+
+    for (int i = 0; i < TEXTURE_POOL_SIZE; ++i)
+    {
+        cTexturePoolEntry* entry = &me->entries[i];
+
+        // Reuse a texture created for the same key
+        if (entry->texture != NULL &&
+            entry->width == width && entry->height == height &&
+            entry->format == format && entry->colorspace == colorspace)
+        {
+            entry->lastUsed = me->clock;
+            me->hits++;
+            return entry->texture;
+        }
+
+        // Prefer an unused entry, then the least recently used one
+        if (victim == NULL ||
+            (victim->texture != NULL && (entry->texture == NULL || entry->lastUsed < victim->lastUsed)))
+        {
+            victim = entry;
+        }
+    }
+
+    // Evict the texture previously held by the selected entry
+    if (victim->texture != NULL)
+    {
+        free_memory((void **) &victim->texture, (void (*)(void *)) SDL_DestroyTexture);
+        me->evictions++;
+    }
+
+    // Create the new streaming texture, with an explicit colorspace if one was requested
+    SDL_PropertiesID props = SDL_CreateProperties();
+    if (props == 0)
+    {
+        LOG_MESSAGE(SDL_GetError());
+        return NULL;
+    }
+    SDL_SetNumberProperty(props, SDL_PROP_TEXTURE_CREATE_FORMAT_NUMBER, format);
+    SDL_SetNumberProperty(props, SDL_PROP_TEXTURE_CREATE_ACCESS_NUMBER, SDL_TEXTUREACCESS_STREAMING);
+    SDL_SetNumberProperty(props, SDL_PROP_TEXTURE_CREATE_WIDTH_NUMBER, width);
+    SDL_SetNumberProperty(props, SDL_PROP_TEXTURE_CREATE_HEIGHT_NUMBER, height);
+    if (colorspace != SDL_COLORSPACE_UNKNOWN)
+    {
+        SDL_SetNumberProperty(props, SDL_PROP_TEXTURE_CREATE_COLORSPACE_NUMBER, colorspace);
+    }
+    victim->texture = SDL_CreateTextureWithProperties(me->renderer, props);
+    SDL_DestroyProperties(props);
+
+    if (victim->texture == NULL)  // Check for texture creation failure
+    {
+        LOG_MESSAGE(SDL_GetError());  // Log error message if texture creation fails
+        return NULL;
+    }
+
+    victim->width = width;
+    victim->height = height;
+    victim->format = format;
+    victim->colorspace = colorspace;
+    victim->lastUsed = me->clock;
+
+    return victim->texture;
+}
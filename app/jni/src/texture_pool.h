@@ -0,0 +1,81 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Small least-recently-used pool of streaming textures, keyed by frame geometry,
+ * pixel format and colorspace. When the camera renegotiates its resolution or the
+ * application switches between cameras, the texture matching the new frames is
+ * usually still in the pool and can be reused without any reallocation.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#ifndef CAMERAXSDL3_TEXTURE_POOL_H
+#define CAMERAXSDL3_TEXTURE_POOL_H
+
+#include <SDL3/SDL.h>
+
+#define TEXTURE_POOL_SIZE 4
+
+// A pooled texture and the key it was created for
+typedef struct texture_pool_entry_s
+{
+    SDL_Texture* texture;     // Streaming texture, NULL if the entry is unused
+    int width;                // Width of the texture in pixels
+    int height;               // Height of the texture in pixels
+    SDL_PixelFormat format;   // Pixel format of the texture
+    SDL_Colorspace colorspace; // Colorspace requested at creation, SDL_COLORSPACE_UNKNOWN for the default
+    Uint64 lastUsed;          // Pool clock value of the last acquisition, used for LRU eviction
+} cTexturePoolEntry;
+
+// Per-renderer texture pool
+typedef struct texture_pool_s
+{
+    SDL_Renderer* renderer;   // Renderer owning every texture of the pool
+    cTexturePoolEntry entries[TEXTURE_POOL_SIZE]; // Pooled textures
+    Uint64 clock;             // Incremented on every acquisition
+    Uint64 hits;              // Acquisitions answered with a pooled texture
+    Uint64 evictions;         // Textures destroyed to make room for another key
+} cTexturePool;
+
+/**
+ * @brief Allocates and initializes an empty `cTexturePool` for a renderer.
+ *
+ * @param addressPool Double pointer to a `cTexturePool*` which will point to the
+ *                    newly allocated pool if successful.
+ * @param renderer Renderer used to create the pooled textures.
+ * @return `true` if the allocation succeeds, `false` otherwise.
+ */
+bool cTexturePool_New(cTexturePool** addressPool, SDL_Renderer* renderer);
+
+/**
+ * @brief Destroys every texture of the pool, then the pool itself.
+ *
+ * @param me Pointer to the `cTexturePool` to destroy; may be NULL.
+ */
+void cTexturePool_Destroy(cTexturePool* me);
+
+/**
+ * @brief Returns a streaming texture matching the requested key.
+ *
+ * A pooled texture with the same width, height, format and colorspace is
+ * returned as is. Otherwise a new texture is created in a free entry or, if
+ * the pool is full, in place of the least recently used one. The returned
+ * texture stays owned by the pool.
+ *
+ * @param me Pointer to the `cTexturePool`.
+ * @param width Width of the texture in pixels.
+ * @param height Height of the texture in pixels.
+ * @param format Pixel format of the texture.
+ * @param colorspace Colorspace of the texture, SDL_COLORSPACE_UNKNOWN for the default.
+ * @return The matching texture, or NULL if it could not be created.
+ */
+SDL_Texture* cTexturePool_Acquire(cTexturePool* me, int width, int height,
+                                  SDL_PixelFormat format, SDL_Colorspace colorspace);
+
+#endif // CAMERAXSDL3_TEXTURE_POOL_H
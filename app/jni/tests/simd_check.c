@@ -0,0 +1,149 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Compares the output of SDL routines across the SIMD levels of the CPU.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "simd_check.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// Argument the check is run again with, once per mask
+#define CASES_ARGUMENT "--cases"
+
+// Feature masks, from every kernel the CPU can run down to the plain C loops.
+// Features the CPU lacks are ignored, so the same list works on every platform.
+static const char* const masks[] = {
+    "all",
+    "-avx2",
+    "-avx2,-avx,-sse42,-sse41",
+    "-avx2,-avx,-sse42,-sse41,-sse3,-sse2,-sse,-mmx,-neon,-arm-simd,-lasx,-lsx"
+};
+
+void cSimdCheck_Report(const char* name, const void* data, size_t length)
+{
+    // FNV-1a is enough to tell two outputs apart
+    const Uint8* bytes = data;
+    Uint64 hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    printf("%s %016" SDL_PRIx64 "\n", name, hash);
+}
+
+/**
+ * @brief Runs the check again under a feature mask and collects its reports.
+ *
+ * @param program Path of the check.
+ * @param mask Value of `SDL_CPU_FEATURE_MASK` for the run.
+ * @return The reports, to free with `SDL_free`, or NULL if the run failed.
+ */
+static char* runCases(const char* program, const char* mask)
+{
+    char* output = NULL;
+    const char* args[] = { program, CASES_ARGUMENT, NULL };
+
+    SDL_Environment* environment = SDL_CreateEnvironment(true);
+    SDL_PropertiesID props = SDL_CreateProperties();
+    if (environment == NULL || props == 0 ||
+        !SDL_SetEnvironmentVariable(environment, SDL_HINT_CPU_FEATURE_MASK, mask, true))
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+    SDL_SetPointerProperty(props, SDL_PROP_PROCESS_CREATE_ARGS_POINTER, args);
+    SDL_SetPointerProperty(props, SDL_PROP_PROCESS_CREATE_ENVIRONMENT_POINTER, environment);
+    SDL_SetNumberProperty(props, SDL_PROP_PROCESS_CREATE_STDOUT_NUMBER, SDL_PROCESS_STDIO_APP);
+
+    SDL_Process* process = SDL_CreateProcessWithProperties(props);
+    if (process == NULL)
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+
+    int exitCode = -1;
+    output = SDL_ReadProcess(process, NULL, &exitCode);
+    SDL_DestroyProcess(process);
+    if (output == NULL || exitCode != 0)
+    {
+        SDL_Log("The run with %s=%s failed", SDL_HINT_CPU_FEATURE_MASK, mask);
+        SDL_free(output);
+        output = NULL;
+    }
+
+    EXIT:
+    SDL_DestroyProperties(props);
+    SDL_DestroyEnvironment(environment);
+    return output;
+}
+
+/**
+ * @brief Compares the reports of a run with those of the reference run.
+ *
+ * @param mask Feature mask of the run, for the log.
+ * @param reference Reports of the run with every feature enabled.
+ * @param reports Reports of the run to check.
+ * @return `true` if every case matches.
+ */
+static bool compareReports(const char* mask, const char* reference, const char* reports)
+{
+    bool same = true;
+
+    while (*reference != '\0' || *reports != '\0')
+    {
+        size_t referenceLength = strcspn(reference, "\n");
+        size_t length = strcspn(reports, "\n");
+        if (referenceLength != length || strncmp(reference, reports, length) != 0)
+        {
+            SDL_Log("%s: %.*s, expected %.*s", mask, (int) length, reports, (int) referenceLength, reference);
+            same = false;
+        }
+        reference += referenceLength + (reference[referenceLength] != '\0');
+        reports += length + (reports[length] != '\0');
+    }
+
+    return same;
+}
+
+int cSimdCheck_Main(int argc, char* argv[], cSimdCheckCases cases)
+{
+    // Child: compute the cases under the mask given by the parent
+    if (argc > 1 && strcmp(argv[1], CASES_ARGUMENT) == 0)
+    {
+        bool passed = cases();
+        SDL_Quit();
+        return passed ? 0 : 1;
+    }
+
+    bool passed = true;
+    char* reference = runCases(argv[0], masks[0]);
+    if (reference == NULL)
+    {
+        return 1;
+    }
+
+    for (size_t i = 1; i < SDL_arraysize(masks); ++i)
+    {
+        char* reports = runCases(argv[0], masks[i]);
+        if (reports == NULL || !compareReports(masks[i], reference, reports))
+        {
+            passed = false;
+        }
+        SDL_free(reports);
+    }
+
+    SDL_free(reference);
+    SDL_Quit();
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,51 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Compares the output of SDL routines across the SIMD levels of the CPU.
+ *
+ * SDL picks its kernels once per process, so a check runs itself again once
+ * per `SDL_CPU_FEATURE_MASK` value; every run reports a hash per case, and the
+ * parent fails if any of them differs from the run with every feature enabled.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#ifndef CAMERAXSDL3_SIMD_CHECK_H
+#define CAMERAXSDL3_SIMD_CHECK_H
+
+#include <SDL3/SDL.h>
+
+// Computes every case of a check, calling `cSimdCheck_Report` for each of them.
+// Returns `false` if a case failed outright, whatever the other runs report.
+typedef bool (*cSimdCheckCases)(void);
+
+/**
+ * @brief Entry point of a check.
+ *
+ * Without arguments, runs the program again under each CPU feature mask and
+ * compares the reports. With `--cases`, computes the cases under the mask the
+ * process was started with and prints their reports.
+ *
+ * @param argc Argument count given to `main`.
+ * @param argv Arguments given to `main`.
+ * @param cases Function computing the cases.
+ * @return Exit code for `main`: 0 if every run succeeded and reported the same output.
+ */
+int cSimdCheck_Main(int argc, char* argv[], cSimdCheckCases cases);
+
+/**
+ * @brief Reports the output of one case.
+ *
+ * @param name Name of the case, unique within the check.
+ * @param data Output bytes of the case.
+ * @param length Number of bytes in `data`.
+ */
+void cSimdCheck_Report(const char* name, const void* data, size_t length);
+
+#endif // CAMERAXSDL3_SIMD_CHECK_H
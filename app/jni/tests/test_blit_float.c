@@ -0,0 +1,184 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Checks the table driven HDR and colorspace blits against the per-pixel
+ * float path, and times both.
+ *
+ * Additive blits still take the per-pixel path, while blended ones take the
+ * tables. On a cleared destination both write the source times its alpha, so
+ * the same source is blitted both ways and the results compared.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include <SDL3/SDL.h>
+
+#define IMAGE_WIDTH 509
+#define IMAGE_HEIGHT 131
+#define MAX_CODE_ERROR 1       // Largest difference accepted on an integer channel
+#define MAX_FLOAT_ERROR 0.001f // Largest relative difference accepted on a float channel
+
+// Source and destination of each case, with the color and alpha modulation of the source
+static const struct
+{
+    SDL_PixelFormat srcFormat;
+    SDL_Colorspace srcColorspace;
+    SDL_PixelFormat dstFormat;
+    SDL_Colorspace dstColorspace;
+    Uint8 colorMod;
+    Uint8 alphaMod;
+} blits[] = {
+    { SDL_PIXELFORMAT_ARGB2101010, SDL_COLORSPACE_HDR10, SDL_PIXELFORMAT_XRGB8888, SDL_COLORSPACE_SRGB, 255, 255 },
+    { SDL_PIXELFORMAT_ARGB2101010, SDL_COLORSPACE_HDR10, SDL_PIXELFORMAT_ARGB8888, SDL_COLORSPACE_SRGB, 200, 180 },
+    { SDL_PIXELFORMAT_RGBA64_FLOAT, SDL_COLORSPACE_SRGB_LINEAR, SDL_PIXELFORMAT_ABGR8888, SDL_COLORSPACE_SRGB, 255, 255 },
+    { SDL_PIXELFORMAT_RGBA128_FLOAT, SDL_COLORSPACE_SRGB_LINEAR, SDL_PIXELFORMAT_XBGR2101010, SDL_COLORSPACE_HDR10, 255, 255 },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_COLORSPACE_SRGB, SDL_PIXELFORMAT_RGBA64_FLOAT, SDL_COLORSPACE_SRGB_LINEAR, 255, 255 },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_COLORSPACE_SRGB, SDL_PIXELFORMAT_ABGR2101010, SDL_COLORSPACE_HDR10, 128, 255 },
+    { SDL_PIXELFORMAT_RGBA64, SDL_COLORSPACE_SRGB, SDL_PIXELFORMAT_RGBA128_FLOAT, SDL_COLORSPACE_SRGB_LINEAR, 255, 255 }
+};
+
+/**
+ * @brief Fills an image with random pixels.
+ *
+ * Float images get colors up to 1.5, past the SDR white point.
+ */
+static void fillRandom(SDL_Surface* image)
+{
+    if (SDL_ISPIXELFORMAT_FLOAT(image->format))
+    {
+        for (int y = 0; y < image->h; ++y)
+        for (int x = 0; x < image->w; ++x)
+        {
+            SDL_WriteSurfacePixelFloat(image, x, y, SDL_randf() * 1.5f, SDL_randf() * 1.5f, SDL_randf() * 1.5f,
+                                       SDL_randf());
+        }
+        return;
+    }
+
+    for (int y = 0; y < image->h; ++y)
+    {
+        Uint8* row = (Uint8*) image->pixels + y * image->pitch;
+        for (int x = 0; x < image->w * SDL_BYTESPERPIXEL(image->format); ++x)
+        {
+            row[x] = (Uint8) SDL_rand(256);
+        }
+    }
+}
+
+/**
+ * @brief Largest difference between the color channels of two images.
+ *
+ * Packed 32-bit channels are compared in code values, float channels
+ * relative to their magnitude. Alpha is left out, as the two blend modes
+ * treat the destination alpha differently.
+ */
+static float colorError(const SDL_Surface* a, const SDL_Surface* b)
+{
+    const SDL_PixelFormatDetails* details = SDL_GetPixelFormatDetails(a->format);
+    float maxError = 0.0f;
+
+    for (int y = 0; y < a->h; ++y)
+    for (int x = 0; x < a->w; ++x)
+    {
+        if (SDL_ISPIXELFORMAT_FLOAT(a->format))
+        {
+            float ca[4], cb[4];
+            SDL_ReadSurfacePixelFloat((SDL_Surface*) a, x, y, &ca[0], &ca[1], &ca[2], &ca[3]);
+            SDL_ReadSurfacePixelFloat((SDL_Surface*) b, x, y, &cb[0], &cb[1], &cb[2], &cb[3]);
+            for (int c = 0; c < 3; ++c)
+            {
+                float scale = SDL_max(SDL_max(SDL_fabsf(ca[c]), SDL_fabsf(cb[c])), 1.0f / 1024.0f);
+                maxError = SDL_max(maxError, SDL_fabsf(ca[c] - cb[c]) / scale);
+            }
+        }
+        else
+        {
+            Uint32 pa = ((const Uint32*) ((const Uint8*) a->pixels + y * a->pitch))[x];
+            Uint32 pb = ((const Uint32*) ((const Uint8*) b->pixels + y * b->pitch))[x];
+            const Uint32 masks[3] = { details->Rmask, details->Gmask, details->Bmask };
+            const Uint8 shifts[3] = { details->Rshift, details->Gshift, details->Bshift };
+            for (int c = 0; c < 3; ++c)
+            {
+                int ca = (int) ((pa & masks[c]) >> shifts[c]);
+                int cb = (int) ((pb & masks[c]) >> shifts[c]);
+                maxError = SDL_max(maxError, (float) SDL_abs(ca - cb));
+            }
+        }
+    }
+
+    return maxError;
+}
+
+/**
+ * @brief Blits a source onto a cleared destination and times it.
+ */
+static bool blitTimed(SDL_Surface* src, SDL_BlendMode blendMode, SDL_Surface* dst, Uint64* elapsed)
+{
+    SDL_ClearSurface(dst, 0.0f, 0.0f, 0.0f, 0.0f);
+    SDL_SetSurfaceBlendMode(src, blendMode);
+
+    Uint64 start = SDL_GetTicksNS();
+    bool result = SDL_BlitSurface(src, NULL, dst, NULL);
+    *elapsed = SDL_GetTicksNS() - start;
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    bool passed = true;
+
+    SDL_srand(1);
+
+    for (size_t i = 0; i < SDL_arraysize(blits); ++i)
+    {
+        SDL_Surface* src = SDL_CreateSurface(IMAGE_WIDTH, IMAGE_HEIGHT, blits[i].srcFormat);
+        SDL_Surface* tables = SDL_CreateSurface(IMAGE_WIDTH, IMAGE_HEIGHT, blits[i].dstFormat);
+        SDL_Surface* perPixel = SDL_CreateSurface(IMAGE_WIDTH, IMAGE_HEIGHT, blits[i].dstFormat);
+        Uint64 tablesTime, perPixelTime;
+
+        if (src == NULL || tables == NULL || perPixel == NULL ||
+            !SDL_SetSurfaceColorspace(src, blits[i].srcColorspace) ||
+            !SDL_SetSurfaceColorspace(tables, blits[i].dstColorspace) ||
+            !SDL_SetSurfaceColorspace(perPixel, blits[i].dstColorspace))
+        {
+            SDL_Log("%s", SDL_GetError());
+            passed = false;
+            goto NEXT;
+        }
+        fillRandom(src);
+        SDL_SetSurfaceColorMod(src, blits[i].colorMod, blits[i].colorMod, 255);
+        SDL_SetSurfaceAlphaMod(src, blits[i].alphaMod);
+
+        if (!blitTimed(src, SDL_BLENDMODE_BLEND, tables, &tablesTime) ||
+            !blitTimed(src, SDL_BLENDMODE_ADD, perPixel, &perPixelTime))
+        {
+            SDL_Log("%s", SDL_GetError());
+            passed = false;
+            goto NEXT;
+        }
+
+        float error = colorError(tables, perPixel);
+        bool within = SDL_ISPIXELFORMAT_FLOAT(blits[i].dstFormat) ? error <= MAX_FLOAT_ERROR : error <= MAX_CODE_ERROR;
+        SDL_Log("%s -> %s: max error %g, tables %.2f ms, per-pixel %.2f ms%s",
+                SDL_GetPixelFormatName(blits[i].srcFormat), SDL_GetPixelFormatName(blits[i].dstFormat), error,
+                tablesTime / 1e6, perPixelTime / 1e6, within ? "" : ", out of tolerance");
+        passed = passed && within;
+
+        NEXT:
+        SDL_DestroySurface(src);
+        SDL_DestroySurface(tables);
+        SDL_DestroySurface(perPixel);
+    }
+
+    SDL_Quit();
+    return passed ? 0 : 1;
+}
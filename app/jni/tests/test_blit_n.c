@@ -0,0 +1,93 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Checks that the SIMD N to N blitters write exactly the same bytes as the
+ * scalar blitters, padding and row tails included.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "simd_check.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static const SDL_PixelFormat formats[] = {
+    SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_BGR24, SDL_PIXELFORMAT_RGB565,
+    SDL_PIXELFORMAT_XRGB8888, SDL_PIXELFORMAT_XBGR8888, SDL_PIXELFORMAT_RGBX8888, SDL_PIXELFORMAT_BGRX8888,
+    SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_BGRA8888
+};
+
+// Widths around the 4 and 8 pixel steps of the blitters, so every tail length is covered
+static const int widths[] = { 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 100, 641 };
+static const int heights[] = { 1, 3 };
+
+/**
+ * @brief Converts random images between every pair of formats.
+ *
+ * @return Always `true`, as failed conversions are reported as cases.
+ */
+static bool blitCases(void)
+{
+    SDL_srand(1);
+
+    for (size_t s = 0; s < SDL_arraysize(formats); ++s)
+    for (size_t d = 0; d < SDL_arraysize(formats); ++d)
+    for (size_t w = 0; w < SDL_arraysize(widths); ++w)
+    for (size_t h = 0; h < SDL_arraysize(heights); ++h)
+    {
+        int width = widths[w];
+        int height = heights[h];
+
+        if (s == d)
+        {
+            continue;
+        }
+
+        // Padded pitches, so that blitters reading or writing past a row show up.
+        // The padding is a multiple of 4 bytes, as the scalar 16 <-> 32 bpp
+        // blitters count their row skip in pixels.
+        int srcPitch = width * SDL_BYTESPERPIXEL(formats[s]) + 8;
+        size_t srcLength = (size_t) srcPitch * height;
+        int dstPitch = width * SDL_BYTESPERPIXEL(formats[d]) + 12;
+        size_t dstLength = (size_t) dstPitch * height;
+
+        Uint8* src = malloc(srcLength);
+        Uint8* dst = malloc(dstLength);
+        if (src == NULL || dst == NULL)
+        {
+            free(src);
+            free(dst);
+            continue;
+        }
+        for (size_t i = 0; i < srcLength; ++i)
+        {
+            src[i] = (Uint8) SDL_rand(256);
+        }
+        memset(dst, 0xAA, dstLength);
+
+        bool converted = SDL_ConvertPixels(width, height, formats[s], src, srcPitch, formats[d], dst, dstPitch);
+
+        char name[128];
+        SDL_snprintf(name, sizeof(name), "%s->%s/%dx%d%s",
+                     SDL_GetPixelFormatName(formats[s]), SDL_GetPixelFormatName(formats[d]),
+                     width, height, converted ? "" : "/failed");
+        cSimdCheck_Report(name, dst, dstLength);
+
+        free(src);
+        free(dst);
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    return cSimdCheck_Main(argc, argv, blitCases);
+}
@@ -0,0 +1,510 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Checks the blit usage counters of SDL_GetBlitStats(): each kind of blit
+ * reports the routine chosen for it, how often a surface was set up for it
+ * and how many blits and pixels it did, SDL_ResetBlitStats() zeroes the
+ * counters but keeps the choices, the pixel count survives a wrap of its
+ * 32-bit counter, and blits from several threads at once are all counted.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include <SDL3/SDL.h>
+
+#define SRC_WIDTH 61
+#define SRC_HEIGHT 37
+#define DST_WIDTH 80
+#define DST_HEIGHT 50
+#define BLITS 5                 // Blits of each case inside the destination
+#define CLIP_WIDTH 20           // Size left of the extra blit clipped by the destination
+#define CLIP_HEIGHT 10
+#define SCALED_WIDTH 97         // Destination size of the scaled blits
+#define SCALED_HEIGHT 71
+#define WRAP_SIZE 4096          // Side of the 8-bit images blitted until the pixel counter wraps
+#define WRAP_BLITS 300          // 300 * 4096 * 4096 pixels is past 2^32
+#define THREADS 4
+#define THREAD_BLITS 20000      // Blits of each thread
+#define THREAD_SIZE 16          // Side of the images blitted by the threads
+
+// Kind of blit of each case, with the routine SDL_CalculateBlit() must choose for it
+static const struct
+{
+    const char* name;
+    SDL_PixelFormat srcFormat;
+    SDL_Colorspace srcColorspace;
+    SDL_PixelFormat dstFormat;
+    SDL_Colorspace dstColorspace;
+    SDL_BlendMode blendMode;
+    bool colorMod;
+    bool alphaMod;
+    bool colorkey;
+    bool scaled;
+    SDL_BlitPath path;
+} cases[] = {
+    { "copy", SDL_PIXELFORMAT_XRGB8888, SDL_COLORSPACE_SRGB, SDL_PIXELFORMAT_XRGB8888, SDL_COLORSPACE_SRGB,
+      SDL_BLENDMODE_NONE, false, false, false, false, SDL_BLITPATH_COPY },
+    { "indexed", SDL_PIXELFORMAT_INDEX8, SDL_COLORSPACE_SRGB, SDL_PIXELFORMAT_XRGB8888, SDL_COLORSPACE_SRGB,
+      SDL_BLENDMODE_NONE, false, false, false, false, SDL_BLITPATH_INDEXED },
+    { "blend", SDL_PIXELFORMAT_ARGB8888, SDL_COLORSPACE_SRGB, SDL_PIXELFORMAT_XRGB8888, SDL_COLORSPACE_SRGB,
+      SDL_BLENDMODE_BLEND, false, false, false, false, SDL_BLITPATH_BLEND },
+    { "convert", SDL_PIXELFORMAT_XRGB8888, SDL_COLORSPACE_SRGB, SDL_PIXELFORMAT_RGB565, SDL_COLORSPACE_SRGB,
+      SDL_BLENDMODE_NONE, false, false, false, false, SDL_BLITPATH_CONVERT },
+    { "colorkey", SDL_PIXELFORMAT_XRGB8888, SDL_COLORSPACE_SRGB, SDL_PIXELFORMAT_XRGB8888, SDL_COLORSPACE_SRGB,
+      SDL_BLENDMODE_NONE, false, false, true, false, SDL_BLITPATH_CONVERT },
+    { "modulated", SDL_PIXELFORMAT_ARGB8888, SDL_COLORSPACE_SRGB, SDL_PIXELFORMAT_ABGR8888, SDL_COLORSPACE_SRGB,
+      SDL_BLENDMODE_BLEND, true, true, false, false, SDL_BLITPATH_GENERATED },
+    { "nearest", SDL_PIXELFORMAT_XRGB8888, SDL_COLORSPACE_SRGB, SDL_PIXELFORMAT_ARGB8888, SDL_COLORSPACE_SRGB,
+      SDL_BLENDMODE_NONE, false, false, false, true, SDL_BLITPATH_GENERATED },
+    { "10-bit", SDL_PIXELFORMAT_RGB565, SDL_COLORSPACE_SRGB, SDL_PIXELFORMAT_ARGB2101010, SDL_COLORSPACE_SRGB,
+      SDL_BLENDMODE_NONE, false, false, false, false, SDL_BLITPATH_SLOW },
+    { "64-bit", SDL_PIXELFORMAT_RGBA64, SDL_COLORSPACE_SRGB, SDL_PIXELFORMAT_XRGB8888, SDL_COLORSPACE_SRGB,
+      SDL_BLENDMODE_NONE, false, false, false, false, SDL_BLITPATH_SLOW_FLOAT },
+    { "colorspace", SDL_PIXELFORMAT_XRGB8888, SDL_COLORSPACE_SRGB, SDL_PIXELFORMAT_XRGB8888, SDL_COLORSPACE_SRGB_LINEAR,
+      SDL_BLENDMODE_NONE, false, false, false, false, SDL_BLITPATH_SLOW_FLOAT }
+};
+
+// Images of a thread blitting at the same time as the others
+typedef struct blitter_s
+{
+    SDL_Surface* src;
+    SDL_Surface* dst;
+    bool failed;
+} cBlitter;
+
+/**
+ * @brief Creates an image in a format and colorspace, with a gray palette if indexed.
+ *
+ * @return The image, or NULL on failure.
+ */
+static SDL_Surface* createImage(int width, int height, SDL_PixelFormat format, SDL_Colorspace colorspace)
+{
+    SDL_Surface* image = SDL_CreateSurface(width, height, format);
+    if (image == NULL)
+    {
+        return NULL;
+    }
+
+    if (SDL_ISPIXELFORMAT_INDEXED(format))
+    {
+        SDL_Palette* palette = SDL_CreateSurfacePalette(image);
+        if (palette == NULL)
+        {
+            SDL_DestroySurface(image);
+            return NULL;
+        }
+        for (int i = 0; i < palette->ncolors; ++i)
+        {
+            palette->colors[i].r = palette->colors[i].g = palette->colors[i].b = (Uint8) i;
+        }
+    }
+
+    if (!SDL_SetSurfaceColorspace(image, colorspace))
+    {
+        SDL_DestroySurface(image);
+        return NULL;
+    }
+    return image;
+}
+
+/**
+ * @brief Finds the counters of a kind of blit.
+ *
+ * @param stats Counters returned by SDL_GetBlitStats().
+ * @param index Case of the blit.
+ * @return The counters, or NULL if this kind of blit was never set up.
+ */
+static const SDL_BlitStats* findStats(SDL_BlitStats** stats, size_t index)
+{
+    for (int i = 0; stats[i] != NULL; ++i)
+    {
+        const SDL_BlitStats* entry = stats[i];
+        if (entry->src_format == cases[index].srcFormat && entry->dst_format == cases[index].dstFormat &&
+            entry->src_colorspace == cases[index].srcColorspace && entry->dst_colorspace == cases[index].dstColorspace &&
+            entry->blend_mode == cases[index].blendMode && entry->color_mod == cases[index].colorMod &&
+            entry->alpha_mod == cases[index].alphaMod && entry->colorkey == cases[index].colorkey &&
+            entry->scaled == cases[index].scaled)
+        {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Sums the blits of every kind counted so far.
+ */
+static Uint64 totalBlits(void)
+{
+    Uint64 total = 0;
+    SDL_BlitStats** stats = SDL_GetBlitStats(NULL);
+    for (int i = 0; stats != NULL && stats[i] != NULL; ++i)
+    {
+        total += stats[i]->blits;
+    }
+    SDL_free(stats);
+    return total;
+}
+
+/**
+ * @brief Blits the source of a case several times inside its destination, then once clipped by it.
+ *
+ * @return true if every blit succeeded.
+ */
+static bool blitCase(size_t index)
+{
+    bool passed = false;
+    int dstWidth = cases[index].scaled ? SCALED_WIDTH : DST_WIDTH;
+    int dstHeight = cases[index].scaled ? SCALED_HEIGHT : DST_HEIGHT;
+    SDL_Surface* src = createImage(SRC_WIDTH, SRC_HEIGHT, cases[index].srcFormat, cases[index].srcColorspace);
+    SDL_Surface* dst = createImage(dstWidth, dstHeight, cases[index].dstFormat, cases[index].dstColorspace);
+    if (src == NULL || dst == NULL ||
+        !SDL_SetSurfaceBlendMode(src, cases[index].blendMode) ||
+        (cases[index].colorMod && !SDL_SetSurfaceColorMod(src, 200, 150, 100)) ||
+        (cases[index].alphaMod && !SDL_SetSurfaceAlphaMod(src, 128)) ||
+        (cases[index].colorkey && !SDL_SetSurfaceColorKey(src, true, 0)))
+    {
+        SDL_Log("%s: %s", cases[index].name, SDL_GetError());
+        goto EXIT;
+    }
+
+    for (int i = 0; i < BLITS; ++i)
+    {
+        bool blitted;
+        if (cases[index].scaled)
+        {
+            SDL_Rect rect = { 2, 3, SCALED_WIDTH - 4, SCALED_HEIGHT - 6 };
+            blitted = SDL_BlitSurfaceScaled(src, NULL, dst, &rect, SDL_SCALEMODE_NEAREST);
+        }
+        else
+        {
+            SDL_Rect rect = { 5, 7, 0, 0 };
+            blitted = SDL_BlitSurface(src, NULL, dst, &rect);
+        }
+        if (!blitted)
+        {
+            SDL_Log("%s: %s", cases[index].name, SDL_GetError());
+            goto EXIT;
+        }
+    }
+
+    SDL_Rect clipped = { dstWidth - CLIP_WIDTH, dstHeight - CLIP_HEIGHT, 0, 0 };
+    if (!cases[index].scaled && !SDL_BlitSurface(src, NULL, dst, &clipped))
+    {
+        SDL_Log("%s: %s", cases[index].name, SDL_GetError());
+        goto EXIT;
+    }
+    passed = true;
+
+    EXIT:
+    SDL_DestroySurface(src);
+    SDL_DestroySurface(dst);
+    return passed;
+}
+
+/**
+ * @brief Blits every case once set up, and checks the routine and counters reported for each.
+ */
+static bool checkCases(void)
+{
+    bool passed = true;
+
+    SDL_ResetBlitStats();
+    for (size_t i = 0; i < SDL_arraysize(cases); ++i)
+    {
+        passed = blitCase(i) && passed;
+    }
+
+    SDL_BlitStats** stats = SDL_GetBlitStats(NULL);
+    if (stats == NULL)
+    {
+        SDL_Log("%s", SDL_GetError());
+        return false;
+    }
+
+    for (size_t i = 0; i < SDL_arraysize(cases); ++i)
+    {
+        const SDL_BlitStats* entry = findStats(stats, i);
+        if (entry == NULL)
+        {
+            SDL_Log("%-10s: not reported", cases[i].name);
+            passed = false;
+            continue;
+        }
+
+        Uint64 blits = cases[i].scaled ? BLITS : BLITS + 1;
+        Uint64 pixels = cases[i].scaled ? (Uint64) BLITS * (SCALED_WIDTH - 4) * (SCALED_HEIGHT - 6) :
+                                          (Uint64) BLITS * SRC_WIDTH * SRC_HEIGHT + CLIP_WIDTH * CLIP_HEIGHT;
+        bool ok = entry->path == cases[i].path && entry->maps == 1 && entry->blits == blits && entry->pixels == pixels;
+        SDL_Log("%-10s: path %d, %" SDL_PRIu64 " maps, %" SDL_PRIu64 " blits, %" SDL_PRIu64 " pixels%s",
+                cases[i].name, (int) entry->path, entry->maps, entry->blits, entry->pixels, ok ? "" : " FAILED");
+        passed = ok && passed;
+    }
+
+    SDL_free(stats);
+    return passed;
+}
+
+/**
+ * @brief Alternates the destination of a surface, and checks that each switch sets it up again.
+ *
+ * The last destination is blitted again after SDL_ResetBlitStats(), which
+ * must zero the counters but keep every kind of blit and its routine, and
+ * count that blit without a new set up.
+ */
+static bool checkMapsAndReset(void)
+{
+    bool passed = false;
+    SDL_BlitStats** before = NULL;
+    SDL_BlitStats** after = NULL;
+    SDL_Surface* src = createImage(SRC_WIDTH, SRC_HEIGHT, cases[0].srcFormat, cases[0].srcColorspace);
+    SDL_Surface* copy = createImage(DST_WIDTH, DST_HEIGHT, cases[0].dstFormat, cases[0].dstColorspace);
+    SDL_Surface* convert = createImage(DST_WIDTH, DST_HEIGHT, cases[3].dstFormat, cases[3].dstColorspace);
+    if (src == NULL || copy == NULL || convert == NULL)
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+
+    SDL_ResetBlitStats();
+    SDL_Surface* destinations[] = { copy, convert, copy, convert, copy };
+    for (size_t i = 0; i < SDL_arraysize(destinations); ++i)
+    {
+        if (!SDL_BlitSurface(src, NULL, destinations[i], NULL))
+        {
+            SDL_Log("%s", SDL_GetError());
+            goto EXIT;
+        }
+    }
+
+    int count = 0;
+    before = SDL_GetBlitStats(&count);
+    if (before == NULL)
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+    const SDL_BlitStats* copied = findStats(before, 0);
+    const SDL_BlitStats* converted = findStats(before, 3);
+    bool remapped = copied != NULL && converted != NULL && copied->maps == 3 && copied->blits == 3 &&
+                    converted->maps == 2 && converted->blits == 2;
+    SDL_Log("Alternated destinations: %" SDL_PRIu64 " and %" SDL_PRIu64 " maps%s",
+            copied ? copied->maps : 0, converted ? converted->maps : 0, remapped ? "" : " FAILED");
+
+    SDL_ResetBlitStats();
+    int resetCount = 0;
+    after = SDL_GetBlitStats(&resetCount);
+    if (after == NULL)
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+    bool reset = resetCount == count;
+    for (int i = 0; after[i] != NULL; ++i)
+    {
+        reset = reset && after[i]->maps == 0 && after[i]->blits == 0 && after[i]->pixels == 0;
+    }
+    for (size_t i = 0; i < SDL_arraysize(cases); ++i)
+    {
+        const SDL_BlitStats* entry = findStats(after, i);
+        reset = reset && entry != NULL && entry->path == cases[i].path;
+    }
+    SDL_free(after);
+
+    // The surface is still set up for this destination
+    if (!SDL_BlitSurface(src, NULL, copy, NULL))
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+    after = SDL_GetBlitStats(NULL);
+    copied = after ? findStats(after, 0) : NULL;
+    reset = reset && copied != NULL && copied->maps == 0 && copied->blits == 1 &&
+            copied->pixels == (Uint64) SRC_WIDTH * SRC_HEIGHT;
+    SDL_Log("Reset: %d of %d kinds of blit kept%s", resetCount, count, reset ? "" : " FAILED");
+
+    passed = remapped && reset;
+
+    EXIT:
+    SDL_free(before);
+    SDL_free(after);
+    SDL_DestroySurface(src);
+    SDL_DestroySurface(copy);
+    SDL_DestroySurface(convert);
+    return passed;
+}
+
+/**
+ * @brief Checks that blits stretched with linear filtering are left out of the counters.
+ */
+static bool checkLinear(void)
+{
+    bool passed = false;
+    SDL_Surface* src = createImage(SRC_WIDTH, SRC_HEIGHT, SDL_PIXELFORMAT_XRGB8888, SDL_COLORSPACE_SRGB);
+    SDL_Surface* dst = createImage(SCALED_WIDTH, SCALED_HEIGHT, SDL_PIXELFORMAT_XRGB8888, SDL_COLORSPACE_SRGB);
+    if (src == NULL || dst == NULL)
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+
+    Uint64 before = totalBlits();
+    for (int i = 0; i < BLITS; ++i)
+    {
+        if (!SDL_BlitSurfaceScaled(src, NULL, dst, NULL, SDL_SCALEMODE_LINEAR))
+        {
+            SDL_Log("%s", SDL_GetError());
+            goto EXIT;
+        }
+    }
+    Uint64 after = totalBlits();
+
+    SDL_Log("Linear scaling: %" SDL_PRIu64 " blits counted%s", after - before, after == before ? "" : " FAILED");
+    passed = after == before;
+
+    EXIT:
+    SDL_DestroySurface(src);
+    SDL_DestroySurface(dst);
+    return passed;
+}
+
+/**
+ * @brief Blits large 8-bit images until the pixels counted pass 2^32.
+ */
+static bool checkWrap(void)
+{
+    bool passed = false;
+    SDL_BlitStats** stats = NULL;
+    SDL_Surface* src = createImage(WRAP_SIZE, WRAP_SIZE, SDL_PIXELFORMAT_RGB332, SDL_COLORSPACE_SRGB);
+    SDL_Surface* dst = createImage(WRAP_SIZE, WRAP_SIZE, SDL_PIXELFORMAT_RGB332, SDL_COLORSPACE_SRGB);
+    if (src == NULL || dst == NULL)
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+
+    SDL_ResetBlitStats();
+    for (int i = 0; i < WRAP_BLITS; ++i)
+    {
+        if (!SDL_BlitSurface(src, NULL, dst, NULL))
+        {
+            SDL_Log("%s", SDL_GetError());
+            goto EXIT;
+        }
+    }
+
+    stats = SDL_GetBlitStats(NULL);
+    for (int i = 0; stats != NULL && stats[i] != NULL; ++i)
+    {
+        if (stats[i]->src_format == SDL_PIXELFORMAT_RGB332 && stats[i]->dst_format == SDL_PIXELFORMAT_RGB332)
+        {
+            Uint64 pixels = (Uint64) WRAP_BLITS * WRAP_SIZE * WRAP_SIZE;
+            passed = stats[i]->blits == WRAP_BLITS && stats[i]->pixels == pixels;
+            SDL_Log("Wrap: %" SDL_PRIu64 " pixels counted, %" SDL_PRIu64 " expected%s",
+                    stats[i]->pixels, pixels, passed ? "" : " FAILED");
+        }
+    }
+
+    EXIT:
+    SDL_free(stats);
+    SDL_DestroySurface(src);
+    SDL_DestroySurface(dst);
+    return passed;
+}
+
+/**
+ * @brief Thread blitting its own images, all of the same kind as the other threads.
+ */
+static int SDLCALL blit(void* data)
+{
+    cBlitter* me = data;
+    for (int i = 0; i < THREAD_BLITS; ++i)
+    {
+        if (!SDL_BlitSurface(me->src, NULL, me->dst, NULL))
+        {
+            me->failed = true;
+            break;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Lets several threads do the same kind of blit at once, and checks that none is lost.
+ */
+static bool checkThreads(void)
+{
+    bool passed = false;
+    bool failed = false;
+    SDL_BlitStats** stats = NULL;
+    SDL_Thread* threads[THREADS];
+    cBlitter blitters[THREADS];
+    SDL_zeroa(threads);
+    SDL_zeroa(blitters);
+
+    for (int i = 0; i < THREADS; ++i)
+    {
+        blitters[i].src = createImage(THREAD_SIZE, THREAD_SIZE, cases[2].srcFormat, cases[2].srcColorspace);
+        blitters[i].dst = createImage(THREAD_SIZE, THREAD_SIZE, cases[2].dstFormat, cases[2].dstColorspace);
+        if (blitters[i].src == NULL || blitters[i].dst == NULL ||
+            !SDL_SetSurfaceBlendMode(blitters[i].src, cases[2].blendMode))
+        {
+            SDL_Log("%s", SDL_GetError());
+            goto EXIT;
+        }
+    }
+
+    SDL_ResetBlitStats();
+    for (int i = 0; i < THREADS; ++i)
+    {
+        threads[i] = SDL_CreateThread(blit, "blitter", &blitters[i]);
+    }
+    for (int i = 0; i < THREADS; ++i)
+    {
+        SDL_WaitThread(threads[i], NULL);
+        failed = failed || threads[i] == NULL || blitters[i].failed;
+    }
+
+    stats = SDL_GetBlitStats(NULL);
+    const SDL_BlitStats* entry = stats ? findStats(stats, 2) : NULL;
+    if (failed || entry == NULL)
+    {
+        SDL_Log("%d threads: %s", THREADS, SDL_GetError());
+        goto EXIT;
+    }
+
+    Uint64 blits = (Uint64) THREADS * THREAD_BLITS;
+    passed = entry->maps == THREADS && entry->blits == blits && entry->pixels == blits * THREAD_SIZE * THREAD_SIZE;
+    SDL_Log("%d threads: %" SDL_PRIu64 " maps, %" SDL_PRIu64 " blits, %" SDL_PRIu64 " pixels%s",
+            THREADS, entry->maps, entry->blits, entry->pixels, passed ? "" : " FAILED");
+
+    EXIT:
+    SDL_free(stats);
+    for (int i = 0; i < THREADS; ++i)
+    {
+        SDL_DestroySurface(blitters[i].src);
+        SDL_DestroySurface(blitters[i].dst);
+    }
+    return passed;
+}
+
+int main(int argc, char* argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    bool passed = checkCases();
+    passed = checkMapsAndReset() && passed;
+    passed = checkLinear() && passed;
+    passed = checkWrap() && passed;
+    passed = checkThreads() && passed;
+
+    SDL_Quit();
+    return passed ? 0 : 1;
+}
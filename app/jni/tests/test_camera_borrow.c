@@ -0,0 +1,319 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Checks borrowed camera frames on the synthetic camera driver: they come in
+ * the native format and size with the pixels of the device buffers, the
+ * queue shrinks to leave the device a buffer to capture into, held frames
+ * keep their pixels, and SDL_ConvertCameraFrame() converts a frame once into
+ * what a copying camera would have delivered.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include <SDL3/SDL.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define REPLAY_FILE "test_camera_borrow.raw" // Raw frames written then replayed, in the working directory
+#define SPEC "NV12 64x48@0"   // Native spec, uncapped
+#define WIDTH 64
+#define HEIGHT 48
+#define FRAME_SIZE (WIDTH * HEIGHT * 3 / 2)
+#define REPLAY_FRAMES 3       // Distinct frames in the replayed file
+#define BUFFERS 4             // Buffers of the device
+#define BUFFERS_HINT "4"      // The same, as given to the driver
+#define HOLD_MS 100           // Time the frames are held
+#define CONVERTED_FRAMES 12   // Borrowed frames converted, each slot several times
+#define TIMEOUT_MS 5000       // Time after which a frame is given up on
+
+// Spec the app asks for when frames are converted
+static const SDL_CameraSpec converted = { SDL_PIXELFORMAT_XRGB8888, SDL_COLORSPACE_UNKNOWN, 32, 24, 0, 1 };
+
+/**
+ * @brief Opens the first camera, and waits for its approval.
+ *
+ * @param spec Requested spec, or NULL for the native one.
+ * @return The camera, or NULL on failure.
+ */
+static SDL_Camera* openCamera(const SDL_CameraSpec* spec, bool borrow)
+{
+    SDL_Camera* camera = NULL;
+    int count = 0;
+    SDL_CameraID* cameras = SDL_GetCameras(&count);
+    SDL_PropertiesID props = SDL_CreateProperties();
+    if (cameras == NULL || count == 0 || props == 0)
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+
+    SDL_SetPointerProperty(props, SDL_PROP_CAMERA_CREATE_SPEC_POINTER, (void*) spec);
+    SDL_SetBooleanProperty(props, SDL_PROP_CAMERA_CREATE_BORROW_FRAMES_BOOLEAN, borrow);
+    if ((camera = SDL_OpenCameraWithProperties(cameras[0], props)) == NULL)
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+    while (SDL_GetCameraPermissionState(camera) == 0)
+    {
+        SDL_Delay(1);
+    }
+    if (SDL_GetCameraPermissionState(camera) != 1)
+    {
+        SDL_Log("The synthetic camera was denied");
+        SDL_CloseCamera(camera);
+        camera = NULL;
+    }
+
+    EXIT:
+    SDL_DestroyProperties(props);
+    SDL_free(cameras);
+    return camera;
+}
+
+/**
+ * @brief Acquires a frame, waiting for one if needed.
+ *
+ * @param sequence Receives the sequence number of the frame.
+ * @return The frame, or NULL on time out.
+ */
+static SDL_Surface* acquireFrame(SDL_Camera* camera, Sint64* sequence)
+{
+    Uint64 end = SDL_GetTicks() + TIMEOUT_MS;
+    SDL_Surface* frame;
+    while ((frame = SDL_AcquireCameraFrame(camera, NULL)) == NULL && SDL_GetTicks() < end)
+    {
+        SDL_Delay(1);
+    }
+    if (frame != NULL)
+    {
+        *sequence = SDL_GetNumberProperty(SDL_GetSurfaceProperties(frame), SDL_PROP_CAMERA_FRAME_SEQUENCE_NUMBER, -1);
+    }
+    return frame;
+}
+
+/**
+ * @brief Checks that a borrowed frame is the device frame of its sequence number, untouched.
+ */
+static bool isDeviceFrame(const SDL_Surface* frame, Sint64 sequence, const Uint8* replay)
+{
+    return frame->format == SDL_PIXELFORMAT_NV12 && frame->w == WIDTH && frame->h == HEIGHT && frame->pitch == WIDTH &&
+           memcmp(frame->pixels, replay + (size_t) (sequence % REPLAY_FRAMES) * FRAME_SIZE, FRAME_SIZE) == 0;
+}
+
+/**
+ * @brief Borrows frames in the native spec, holding as many as the queue allows.
+ *
+ * The queue leaves one of the device buffers free, and frames the device
+ * captures meanwhile are dropped rather than written over the held ones.
+ */
+static bool checkHeldFrames(const Uint8* replay)
+{
+    bool passed = false;
+    SDL_Surface* frames[BUFFERS];
+    Sint64 sequences[BUFFERS];
+    int held = 0;
+    SDL_Camera* camera = openCamera(NULL, true);
+    if (camera == NULL)
+    {
+        return false;
+    }
+
+    SDL_PropertiesID props = SDL_GetCameraProperties(camera);
+    Sint64 capacity = SDL_GetNumberProperty(props, SDL_PROP_CAMERA_QUEUE_CAPACITY_NUMBER, -1);
+    for (; held < capacity && held < BUFFERS; ++held)
+    {
+        if ((frames[held] = acquireFrame(camera, &sequences[held])) == NULL)
+        {
+            SDL_Log("Frame %d never came", held);
+            goto EXIT;
+        }
+    }
+
+    // Nothing more comes while every slot is held, and the held frames keep their pixels
+    SDL_Delay(HOLD_MS);
+    SDL_Surface* extra = SDL_AcquireCameraFrame(camera, NULL);
+    int intact = 0;
+    for (int i = 0; i < held; ++i)
+    {
+        intact += isDeviceFrame(frames[i], sequences[i], replay) &&
+                  SDL_ConvertCameraFrame(camera, frames[i]) == frames[i];
+    }
+    Sint64 dropped = SDL_GetNumberProperty(SDL_GetCameraProperties(camera), SDL_PROP_CAMERA_FRAMES_DROPPED_NUMBER, -1);
+
+    // Released frames make room for new ones
+    Sint64 lastHeld = held > 0 ? sequences[held - 1] : -1;
+    for (; held > 0; --held)
+    {
+        SDL_ReleaseCameraFrame(camera, frames[held - 1]);
+    }
+    Sint64 sequence = -1;
+    SDL_Surface* next = acquireFrame(camera, &sequence);
+    bool resumed = next != NULL && sequence > lastHeld && isDeviceFrame(next, sequence, replay);
+    if (next != NULL)
+    {
+        SDL_ReleaseCameraFrame(camera, next);
+    }
+
+    SDL_Log("Borrowed: capacity %" SDL_PRIs64 " for %d buffers, %d of %" SDL_PRIs64 " held frames intact, "
+            "%s while held, %" SDL_PRIs64 " dropped, %s after release", capacity, BUFFERS, intact, capacity,
+            extra == NULL ? "none acquired" : "one acquired", dropped, resumed ? "resumed" : "stuck");
+    passed = capacity == BUFFERS - 1 && intact == capacity && extra == NULL && dropped > 0 && resumed;
+    if (extra != NULL)
+    {
+        SDL_ReleaseCameraFrame(camera, extra);
+    }
+
+    EXIT:
+    for (int i = 0; i < held; ++i)
+    {
+        SDL_ReleaseCameraFrame(camera, frames[i]);
+    }
+    SDL_CloseCamera(camera);
+    return passed;
+}
+
+/**
+ * @brief Borrows frames of another spec, and converts them on demand.
+ *
+ * The frames stay native, the camera reports the requested spec, and the
+ * conversion is made once per frame and matches what a camera copying its
+ * frames delivers for the same device frame.
+ */
+static bool checkConversion(void)
+{
+    bool passed = false;
+    SDL_Surface* copies[REPLAY_FRAMES] = { NULL };
+    SDL_Camera* camera = openCamera(&converted, false);
+    if (camera == NULL)
+    {
+        return false;
+    }
+
+    // Frames of the copying camera, one for each device frame
+    int found = 0;
+    Uint64 end = SDL_GetTicks() + TIMEOUT_MS;
+    while (found < REPLAY_FRAMES && SDL_GetTicks() < end)
+    {
+        Sint64 sequence = -1;
+        SDL_Surface* frame = acquireFrame(camera, &sequence);
+        if (frame == NULL)
+        {
+            break;
+        }
+        if (copies[sequence % REPLAY_FRAMES] == NULL)
+        {
+            copies[sequence % REPLAY_FRAMES] = SDL_DuplicateSurface(frame);
+            found += copies[sequence % REPLAY_FRAMES] != NULL;
+        }
+        SDL_ReleaseCameraFrame(camera, frame);
+    }
+    SDL_CloseCamera(camera);
+    if (found < REPLAY_FRAMES || (camera = openCamera(&converted, true)) == NULL)
+    {
+        SDL_Log("No reference frames");
+        camera = NULL;
+        goto EXIT;
+    }
+
+    // Slots are reused by later frames, whose conversions must not be the stale ones
+    SDL_CameraSpec spec;
+    SDL_Surface* frame = NULL;
+    int frames = 0;
+    int native = 0;
+    int cached = 0;
+    int same = 0;
+    Sint64 conversionNS = 0;
+    if (!SDL_GetCameraFormat(camera, &spec))
+    {
+        goto EXIT;
+    }
+    for (; frames < CONVERTED_FRAMES; ++frames)
+    {
+        Sint64 sequence = -1;
+        if ((frame = acquireFrame(camera, &sequence)) == NULL)
+        {
+            SDL_Log("Frame %d never came", frames);
+            goto EXIT;
+        }
+
+        SDL_Surface* first = SDL_ConvertCameraFrame(camera, frame);
+        conversionNS += SDL_GetNumberProperty(SDL_GetSurfaceProperties(frame),
+                                              SDL_PROP_CAMERA_FRAME_CONVERSION_NS_NUMBER, -1);
+        SDL_Surface* second = SDL_ConvertCameraFrame(camera, frame);
+        const SDL_Surface* copy = copies[sequence % REPLAY_FRAMES];
+        native += frame->format == SDL_PIXELFORMAT_NV12 && frame->w == WIDTH && frame->h == HEIGHT;
+        cached += first != NULL && first != frame && first == second;
+        same += first != NULL && first->format == copy->format && first->w == copy->w && first->h == copy->h &&
+                first->pitch == copy->pitch && memcmp(first->pixels, copy->pixels, (size_t) copy->pitch * copy->h) == 0;
+        SDL_ReleaseCameraFrame(camera, frame);
+    }
+
+    SDL_Log("Converted: camera reports %s %dx%d, %d of %d borrowed frames native, %d converted once, %d same as "
+            "the copied frames, %.3f ms per conversion", SDL_GetPixelFormatName(spec.format), spec.width, spec.height,
+            native, frames, cached, same, conversionNS / 1e6 / frames);
+    passed = spec.format == converted.format && spec.width == converted.width && spec.height == converted.height &&
+             native == frames && cached == frames && same == frames && conversionNS > 0;
+
+    // Only held frames of the camera can be converted
+    bool refused = SDL_ConvertCameraFrame(camera, frame) == NULL && SDL_ConvertCameraFrame(camera, copies[0]) == NULL;
+    SDL_Log("Released and foreign frames %s", refused ? "refused" : "converted");
+    passed = passed && refused;
+
+    EXIT:
+    SDL_CloseCamera(camera);
+    for (int i = 0; i < REPLAY_FRAMES; ++i)
+    {
+        SDL_DestroySurface(copies[i]);
+    }
+    return passed;
+}
+
+int main(int argc, char* argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    bool passed = false;
+    Uint8* replay = malloc(FRAME_SIZE * REPLAY_FRAMES);
+    SDL_IOStream* file = NULL;
+
+    SDL_srand(1);
+    for (size_t i = 0; replay != NULL && i < FRAME_SIZE * REPLAY_FRAMES; ++i)
+    {
+        replay[i] = (Uint8) SDL_rand(256);
+    }
+    bool written = replay != NULL && (file = SDL_IOFromFile(REPLAY_FILE, "wb")) != NULL &&
+                   SDL_WriteIO(file, replay, FRAME_SIZE * REPLAY_FRAMES) == FRAME_SIZE * REPLAY_FRAMES;
+    if ((file != NULL && !SDL_CloseIO(file)) || !written)
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+
+    SDL_SetHint(SDL_HINT_CAMERA_DRIVER, "synthetic");
+    SDL_SetHint(SDL_HINT_CAMERA_SYNTHETIC_SPECS, SPEC);
+    SDL_SetHint(SDL_HINT_CAMERA_SYNTHETIC_FILE, REPLAY_FILE);
+    SDL_SetHint(SDL_HINT_CAMERA_SYNTHETIC_BUFFERS, BUFFERS_HINT);
+    if (!SDL_Init(SDL_INIT_CAMERA))
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+
+    passed = checkHeldFrames(replay);
+    passed = checkConversion() && passed;
+
+    EXIT:
+    SDL_Quit();
+    SDL_RemovePath(REPLAY_FILE);
+    free(replay);
+    return passed ? 0 : 1;
+}
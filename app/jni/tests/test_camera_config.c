@@ -0,0 +1,251 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Checks the camera negotiation off-device: cCameraConfig_Negotiate against
+ * hand-computed configurations, cCameraConfig_NeedsRebind around its area
+ * threshold, and a cCameraNegotiator driven through view and thermal changes
+ * with a stub bridge standing in for the Java camera, failures included.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "camera_config.h"
+
+// What the application asks for in most cases
+#define REQUESTED { 1280, 720, 15, 60, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 }
+
+/*
+ * Negotiations: the view bounds the size first, thermal pressure scales it
+ * further down, then caps the frame rate, then disables queueing; the lens
+ * and the format are never traded away.
+ */
+static const struct
+{
+    const char* name;
+    cCameraConfig requested;
+    cCameraBudget budget;
+    cCameraConfig expected;
+} negotiations[] = {
+    { "no view, no pressure", REQUESTED, { 0, 0, THERMAL_STATUS_NONE },
+      { 1280, 720, 15, 60, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 } },
+    { "view of half the size", REQUESTED, { 640, 360, THERMAL_STATUS_LIGHT },
+      { 640, 360, 15, 60, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 } },
+    { "rotated view", REQUESTED, { 360, 640, THERMAL_STATUS_NONE },
+      { 640, 360, 15, 60, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 } },
+    { "view larger than requested", REQUESTED, { 1920, 1080, THERMAL_STATUS_NONE },
+      { 1280, 720, 15, 60, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 } },
+    { "square view, long sides bound", REQUESTED, { 1000, 1000, THERMAL_STATUS_NONE },
+      { 1000, 562, 15, 60, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 } },
+    { "tiny view, minimum width", REQUESTED, { 100, 100, THERMAL_STATUS_NONE },
+      { 160, 90, 15, 60, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 } },
+    { "odd request, even sizes", { 1279, 719, 15, 60, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 },
+      { 0, 0, THERMAL_STATUS_NONE },
+      { 1278, 718, 15, 60, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 } },
+    { "request below the minimum width", { 120, 90, 15, 30, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 1 },
+      { 50, 50, THERMAL_STATUS_NONE },
+      { 120, 90, 15, 30, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 1 } },
+    { "moderate: smaller, 30 fps", REQUESTED, { 0, 0, THERMAL_STATUS_MODERATE },
+      { 960, 540, 15, 30, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 } },
+    { "severe in a view: both scales, 20 fps, no queue", REQUESTED, { 640, 360, THERMAL_STATUS_SEVERE },
+      { 320, 180, 15, 20, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 0 } },
+    { "severe: minimum rate lowered to the cap", { 1280, 720, 24, 30, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 },
+      { 0, 0, THERMAL_STATUS_SEVERE },
+      { 640, 360, 20, 20, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 0 } },
+    { "critical: minimum width, 15 fps", { 400, 300, 15, 60, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 },
+      { 0, 0, THERMAL_STATUS_CRITICAL },
+      { 160, 120, 15, 15, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 0 } },
+    { "shutdown keeps the lens and format", { 1290, 720, 30, 30, LENS_FACING_BACK, CAMERA_FORMAT_RGBA_8888, 3 },
+      { 0, 0, THERMAL_STATUS_SHUTDOWN },
+      { 450, 250, 15, 15, LENS_FACING_BACK, CAMERA_FORMAT_RGBA_8888, 0 } }
+};
+
+// Switches from a 640x360 configuration, around the CAMERA_REBIND_AREA_RATIO threshold
+static const struct
+{
+    const char* name;
+    cCameraConfig next;
+    bool rebind;
+} rebinds[] = {
+    { "same configuration", { 640, 360, 15, 60, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 }, false },
+    { "area x1.20", { 700, 394, 15, 60, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 }, false },
+    { "area x1.25 exactly", { 800, 360, 15, 60, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 }, false },
+    { "area x1.30", { 730, 410, 15, 60, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 }, true },
+    { "area /1.20", { 584, 328, 15, 60, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 }, false },
+    { "area /1.30", { 560, 316, 15, 60, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 }, true },
+    { "maximum rate", { 640, 360, 15, 30, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 }, true },
+    { "minimum rate", { 640, 360, 20, 60, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 }, true },
+    { "lens", { 640, 360, 15, 60, LENS_FACING_BACK, CAMERA_FORMAT_YUV_420_888, 2 }, true },
+    { "format", { 640, 360, 15, 60, LENS_FACING_FRONT, CAMERA_FORMAT_RGBA_8888, 2 }, true },
+    { "queue depth", { 640, 360, 15, 60, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 0 }, true }
+};
+
+// Stub of the Java bridge, recording what the negotiator applies
+typedef struct bridge_s
+{
+    bool fail;                // Whether the camera refuses the next configurations
+    int calls;                // Configurations received, refused ones included
+    cCameraConfig last;       // Last configuration received
+} cBridge;
+
+/**
+ * @brief Stub bridge: records the configuration, then accepts or refuses it.
+ *
+ * @param userdata Pointer to the `cBridge`.
+ * @param config Configuration to apply.
+ * @return `false` if the bridge is set to fail, `true` otherwise.
+ */
+static bool stubConfigureCamera(void* userdata, const cCameraConfig* config)
+{
+    cBridge* bridge = userdata;
+    bridge->calls++;
+    bridge->last = *config;
+    return !bridge->fail;
+}
+
+/**
+ * @brief Compares two configurations field by field.
+ */
+static bool sameConfig(const cCameraConfig* a, const cCameraConfig* b)
+{
+    return a->width == b->width && a->height == b->height && a->minFps == b->minFps &&
+           a->maxFps == b->maxFps && a->lensFacing == b->lensFacing && a->format == b->format &&
+           a->queueDepth == b->queueDepth;
+}
+
+/**
+ * @brief Logs a configuration.
+ */
+static void logConfig(const char* prefix, const cCameraConfig* config)
+{
+    SDL_Log("  %s %dx%d, %d-%d fps, lens %d, format %d, queue %d", prefix, config->width, config->height,
+            config->minFps, config->maxFps, config->lensFacing, config->format, config->queueDepth);
+}
+
+/**
+ * @brief Drives a negotiator through view and thermal changes and checks every apply.
+ *
+ * @return `true` if the bridge saw exactly the expected configurations.
+ */
+static bool runNegotiator(void)
+{
+    // Negotiator calls, with the calls the bridge must have seen and the configuration in use afterwards
+    enum { VIEW, THERMAL, START };
+    static const struct
+    {
+        const char* name;
+        int call;
+        int a, b;                 // View size, or thermal state in `a`
+        bool fail;                // Whether the bridge refuses the configuration
+        bool ret;                 // Value returned by the negotiator
+        int calls;                // Calls the bridge has received so far
+        int rebinds;              // Configurations applied so far
+        cCameraConfig current;
+    } steps[] = {
+        { "view before start", VIEW, 640, 360, false, true, 0, 0, { 0 } },
+        { "start", START, 0, 0, false, true, 1, 1,
+          { 640, 360, 15, 60, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 } },
+        { "slightly larger view", VIEW, 660, 370, false, true, 1, 1,
+          { 640, 360, 15, 60, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 } },
+        { "full screen view", VIEW, 1920, 1080, false, true, 2, 2,
+          { 1280, 720, 15, 60, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 } },
+        { "moderate", THERMAL, THERMAL_STATUS_MODERATE, 0, false, true, 3, 3,
+          { 960, 540, 15, 30, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 } },
+        { "back to light", THERMAL, THERMAL_STATUS_LIGHT, 0, false, true, 4, 4,
+          { 1280, 720, 15, 60, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 } },
+        { "severe, refused", THERMAL, THERMAL_STATUS_SEVERE, 0, true, false, 5, 4,
+          { 1280, 720, 15, 60, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 } },
+        { "same view, retried", VIEW, 1920, 1080, false, true, 6, 5,
+          { 640, 360, 15, 20, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 0 } },
+        { "same view again", VIEW, 1920, 1080, false, true, 6, 5,
+          { 640, 360, 15, 20, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 0 } }
+    };
+
+    bool passed = true;
+    cCameraNegotiator* negotiator = NULL;
+    cCameraConfig requested = REQUESTED;
+    cBridge bridge;
+    SDL_zero(bridge);
+
+    if (!cCameraNegotiator_New(&negotiator, &requested, stubConfigureCamera, &bridge))
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < SDL_arraysize(steps); ++i)
+    {
+        bool ret;
+        bridge.fail = steps[i].fail;
+        switch (steps[i].call)
+        {
+            case VIEW:
+                ret = cCameraNegotiator_SetView(negotiator, steps[i].a, steps[i].b);
+                break;
+            case THERMAL:
+                ret = cCameraNegotiator_SetThermalStatus(negotiator, (cThermalStatus) steps[i].a);
+                break;
+            default:
+                ret = cCameraNegotiator_Start(negotiator);
+                break;
+        }
+
+        bool ok = ret == steps[i].ret && bridge.calls == steps[i].calls && negotiator->rebinds == steps[i].rebinds &&
+                  sameConfig(&negotiator->current, &steps[i].current);
+        SDL_Log("Negotiator, %s: %d calls, %d rebinds, %s", steps[i].name, bridge.calls, negotiator->rebinds,
+                ok ? "ok" : "unexpected");
+        if (!ok)
+        {
+            logConfig("current", &negotiator->current);
+            logConfig("expected", &steps[i].current);
+            passed = false;
+        }
+    }
+
+    // The camera must have received what is in use
+    passed = passed && sameConfig(&bridge.last, &negotiator->current);
+
+    cCameraNegotiator_Destroy(negotiator);
+    return passed;
+}
+
+int main(int argc, char* argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    bool passed = true;
+
+    for (size_t i = 0; i < SDL_arraysize(negotiations); ++i)
+    {
+        cCameraConfig result;
+        cCameraConfig_Negotiate(&negotiations[i].requested, &negotiations[i].budget, &result);
+        bool ok = sameConfig(&result, &negotiations[i].expected);
+        SDL_Log("Negotiate, %s: %s", negotiations[i].name, ok ? "ok" : "unexpected");
+        if (!ok)
+        {
+            logConfig("result", &result);
+            logConfig("expected", &negotiations[i].expected);
+            passed = false;
+        }
+    }
+
+    const cCameraConfig current = { 640, 360, 15, 60, LENS_FACING_FRONT, CAMERA_FORMAT_YUV_420_888, 2 };
+    for (size_t i = 0; i < SDL_arraysize(rebinds); ++i)
+    {
+        // The decision is symmetric for sizes, and only depends on the changed fields
+        bool forward = cCameraConfig_NeedsRebind(&current, &rebinds[i].next);
+        bool backward = cCameraConfig_NeedsRebind(&rebinds[i].next, &current);
+        bool ok = forward == rebinds[i].rebind && backward == rebinds[i].rebind;
+        SDL_Log("Rebind, %s: %s%s", rebinds[i].name, forward ? "rebind" : "keep", ok ? "" : ", unexpected");
+        passed = passed && ok;
+    }
+
+    passed = runNegotiator() && passed;
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Checks the per-frame camera metadata against the synthetic camera driver,
+ * which drops frames and jitters their timing: sequence gaps must match the
+ * reported drop counts, and timestamps must increase without going ahead of
+ * SDL_GetTicksNS().
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include <SDL3/SDL.h>
+
+#define RECEIVE_COUNT 80     // Frames acquired per run
+#define TIMEOUT_MS 20000     // Time after which a run gives up
+#define SLOW_DELAY_MS 25     // Time a slow consumer holds each frame, longer than the queue lasts
+
+// Consumers run against the camera
+static const struct
+{
+    bool borrow;   // Borrow the driver buffers instead of copying them
+    int delayMs;   // Time spent on each frame before releasing it
+} runs[] = {
+    { false, 0 },
+    { false, SLOW_DELAY_MS },
+    { true, SLOW_DELAY_MS }
+};
+
+/**
+ * @brief Opens the first camera, converting its frames to XRGB8888.
+ *
+ * @param borrow `true` to borrow the driver buffers.
+ * @return The camera, approved, or NULL on failure.
+ */
+static SDL_Camera* openCamera(bool borrow)
+{
+    SDL_Camera* camera = NULL;
+    int count = 0;
+    SDL_CameraID* cameras = SDL_GetCameras(&count);
+    if (cameras == NULL || count == 0)
+    {
+        SDL_Log("No synthetic camera: %s", SDL_GetError());
+        goto EXIT;
+    }
+
+    SDL_CameraSpec spec;
+    SDL_zero(spec);
+    spec.format = SDL_PIXELFORMAT_XRGB8888;
+    spec.width = 640;
+    spec.height = 360;
+    spec.framerate_numerator = 120;
+    spec.framerate_denominator = 1;
+
+    SDL_PropertiesID props = SDL_CreateProperties();
+    SDL_SetPointerProperty(props, SDL_PROP_CAMERA_CREATE_SPEC_POINTER, &spec);
+    SDL_SetBooleanProperty(props, SDL_PROP_CAMERA_CREATE_BORROW_FRAMES_BOOLEAN, borrow);
+    SDL_SetNumberProperty(props, SDL_PROP_CAMERA_CREATE_QUEUE_DEPTH_NUMBER, 3);
+    camera = SDL_OpenCameraWithProperties(cameras[0], props);
+    SDL_DestroyProperties(props);
+    if (camera == NULL)
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+
+    while (SDL_GetCameraPermissionState(camera) == 0)
+    {
+        SDL_Delay(1);
+    }
+    if (SDL_GetCameraPermissionState(camera) != 1)
+    {
+        SDL_Log("The synthetic camera was denied");
+        SDL_CloseCamera(camera);
+        camera = NULL;
+    }
+
+    EXIT:
+    SDL_free(cameras);
+    return camera;
+}
+
+/**
+ * @brief Acquires frames and checks their metadata.
+ *
+ * @param borrow `true` to borrow the driver buffers.
+ * @param delayMs Time to hold each frame.
+ * @return `true` if every frame was consistent.
+ */
+static bool runConsumer(bool borrow, int delayMs)
+{
+    SDL_Camera* camera = openCamera(borrow);
+    if (camera == NULL)
+    {
+        return false;
+    }
+
+    int frames = 0;
+    int errors = 0;
+    Sint64 first = 0;
+    Sint64 last = 0;
+    Sint64 dropped = 0;
+    Uint64 previousTimestamp = 0;
+    Uint64 start = SDL_GetTicks();
+
+    while (frames < RECEIVE_COUNT && SDL_GetTicks() - start < TIMEOUT_MS)
+    {
+        Uint64 timestamp = 0;
+        SDL_Surface* frame = SDL_AcquireCameraFrame(camera, &timestamp);
+        if (frame == NULL)
+        {
+            SDL_Delay(1);
+            continue;
+        }
+        Uint64 now = SDL_GetTicksNS();
+
+        SDL_PropertiesID props = SDL_GetSurfaceProperties(frame);
+        Sint64 sequence = SDL_GetNumberProperty(props, SDL_PROP_CAMERA_FRAME_SEQUENCE_NUMBER, -1);
+        if ((Uint64) SDL_GetNumberProperty(props, SDL_PROP_CAMERA_FRAME_TIMESTAMP_NUMBER, 0) != timestamp ||
+            timestamp > now || timestamp <= previousTimestamp || sequence < 0 || (frames > 0 && sequence <= last))
+        {
+            SDL_Log("Frame %" SDL_PRIs64 ": timestamp %" SDL_PRIu64 " after %" SDL_PRIu64 ", now %" SDL_PRIu64,
+                    sequence, timestamp, previousTimestamp, now);
+            ++errors;
+        }
+
+        // The first frame's count covers whatever came before the run
+        if (frames == 0)
+        {
+            first = sequence;
+        }
+        else
+        {
+            dropped += SDL_GetNumberProperty(props, SDL_PROP_CAMERA_FRAME_DROPPED_NUMBER, 0);
+        }
+        last = sequence;
+        previousTimestamp = timestamp;
+        ++frames;
+
+        SDL_Delay(delayMs);
+        SDL_ReleaseCameraFrame(camera, frame);
+    }
+    SDL_CloseCamera(camera);
+
+    Sint64 gaps = last - first + 1 - frames;
+    SDL_Log("%s consumer%s: %d frames, sequence %" SDL_PRIs64 " to %" SDL_PRIs64 ", %" SDL_PRIs64
+            " dropped for %" SDL_PRIs64 " missing, %d bad frames",
+            delayMs ? "Slow" : "Fast", borrow ? " borrowing" : "", frames, first, last, dropped, gaps, errors);
+
+    return frames == RECEIVE_COUNT && errors == 0 && dropped == gaps;
+}
+
+int main(int argc, char* argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    SDL_SetHint(SDL_HINT_CAMERA_DRIVER, "synthetic");
+    SDL_SetHint(SDL_HINT_CAMERA_SYNTHETIC_SPECS, "NV12 640x360@120");
+    SDL_SetHint(SDL_HINT_CAMERA_SYNTHETIC_DROP_RATE, "0.1");
+    SDL_SetHint(SDL_HINT_CAMERA_SYNTHETIC_JITTER, "2");
+    if (!SDL_Init(SDL_INIT_CAMERA))
+    {
+        SDL_Log("%s", SDL_GetError());
+        return 1;
+    }
+
+    bool passed = true;
+    for (size_t i = 0; i < SDL_arraysize(runs); ++i)
+    {
+        passed = runConsumer(runs[i].borrow, runs[i].delayMs) && passed;
+    }
+
+    SDL_Quit();
+    return passed ? 0 : 1;
+}
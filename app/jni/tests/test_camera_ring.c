@@ -0,0 +1,390 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Checks the ring that hands camera frames to the app, on the synthetic
+ * camera driver: the requested queue depth is clamped, each overflow policy
+ * keeps the frames it promises while the app does not acquire any and counts
+ * the others, and consumer threads acquiring concurrently each get their own
+ * frames, in order, none of them lost when the camera blocks.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include <SDL3/SDL.h>
+
+#include <stdlib.h>
+
+#define SPEC "YUY2 64x48@0"     // Uncapped, so that the ring overflows at once
+#define CAPACITY 4              // Queue depth of the overflow runs
+#define OVERFLOW_MS 200         // Time the app leaves the ring alone
+#define TIMEOUT_MS 5000         // Time after which a run gives up
+#define CONSUMERS 3             // Threads acquiring from the same camera
+#define CONSUMED_FRAMES 3000    // Frames acquired by all the consumers together
+
+// Requested queue depths and the capacity they give
+static const struct
+{
+    Sint64 requested;           // -1 leaves the property unset
+    Sint64 capacity;
+} depths[] = {
+    { -1, 8 },
+    { 0, 2 },
+    { 1, 2 },
+    { 5, 5 },
+    { 64, 64 },
+    { 1000, 64 }
+};
+
+// Overflow policies, with the frames they keep
+static const struct
+{
+    SDL_CameraOverflowPolicy policy;
+    const char* name;
+    bool drops;                 // Frames are dropped rather than waited for
+    bool keepsNewest;           // The queued frames are the latest ones
+} policies[] = {
+    { SDL_CAMERA_OVERFLOW_DROP_NEWEST, "drop newest", true, false },
+    { SDL_CAMERA_OVERFLOW_DROP_OLDEST, "drop oldest", true, true },
+    { SDL_CAMERA_OVERFLOW_BLOCK, "block", false, false }
+};
+
+// Ring statistics of a camera
+typedef struct stats_s
+{
+    Sint64 capacity;
+    Sint64 depth;
+    Sint64 peak;
+    Sint64 dropped;
+    Sint64 waitNS;
+} cStats;
+
+// One of the consumer threads
+typedef struct consumer_s
+{
+    SDL_Camera* camera;
+    SDL_AtomicInt* remaining;   // Frames left to acquire by all the consumers
+    Sint64* sequences;          // Sequence numbers of the acquired frames, in order
+    int count;                  // Frames acquired
+    int errors;                 // Frames acquired out of order
+} cConsumer;
+
+/**
+ * @brief Opens the first camera with ring properties, and waits for its approval.
+ *
+ * @param depth Requested queue depth, or -1 to leave it unset.
+ * @return The camera, or NULL on failure.
+ */
+static SDL_Camera* openCamera(Sint64 depth, SDL_CameraOverflowPolicy policy)
+{
+    SDL_Camera* camera = NULL;
+    int count = 0;
+    SDL_CameraID* cameras = SDL_GetCameras(&count);
+    SDL_PropertiesID props = SDL_CreateProperties();
+    if (cameras == NULL || count == 0 || props == 0)
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+
+    if (depth >= 0)
+    {
+        SDL_SetNumberProperty(props, SDL_PROP_CAMERA_CREATE_QUEUE_DEPTH_NUMBER, depth);
+    }
+    SDL_SetNumberProperty(props, SDL_PROP_CAMERA_CREATE_OVERFLOW_POLICY_NUMBER, policy);
+    if ((camera = SDL_OpenCameraWithProperties(cameras[0], props)) == NULL)
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+
+    while (SDL_GetCameraPermissionState(camera) == 0)
+    {
+        SDL_Delay(1);
+    }
+    if (SDL_GetCameraPermissionState(camera) != 1)
+    {
+        SDL_Log("The synthetic camera was denied");
+        SDL_CloseCamera(camera);
+        camera = NULL;
+    }
+
+    EXIT:
+    SDL_DestroyProperties(props);
+    SDL_free(cameras);
+    return camera;
+}
+
+/**
+ * @brief Reads the ring statistics of a camera.
+ */
+static void getStats(SDL_Camera* camera, cStats* stats)
+{
+    SDL_PropertiesID props = SDL_GetCameraProperties(camera);
+    stats->capacity = SDL_GetNumberProperty(props, SDL_PROP_CAMERA_QUEUE_CAPACITY_NUMBER, -1);
+    stats->depth = SDL_GetNumberProperty(props, SDL_PROP_CAMERA_QUEUE_DEPTH_NUMBER, -1);
+    stats->peak = SDL_GetNumberProperty(props, SDL_PROP_CAMERA_QUEUE_PEAK_DEPTH_NUMBER, -1);
+    stats->dropped = SDL_GetNumberProperty(props, SDL_PROP_CAMERA_FRAMES_DROPPED_NUMBER, -1);
+    stats->waitNS = SDL_GetNumberProperty(props, SDL_PROP_CAMERA_QUEUE_WAIT_NS_NUMBER, -1);
+}
+
+/**
+ * @brief Acquires a frame, waiting for one if needed.
+ *
+ * @param sequence Receives the sequence number of the frame.
+ * @return The frame, or NULL on time out.
+ */
+static SDL_Surface* acquireFrame(SDL_Camera* camera, Sint64* sequence)
+{
+    Uint64 end = SDL_GetTicks() + TIMEOUT_MS;
+    SDL_Surface* frame;
+    while ((frame = SDL_AcquireCameraFrame(camera, NULL)) == NULL && SDL_GetTicks() < end)
+    {
+        SDL_Delay(1);
+    }
+    if (frame != NULL)
+    {
+        *sequence = SDL_GetNumberProperty(SDL_GetSurfaceProperties(frame), SDL_PROP_CAMERA_FRAME_SEQUENCE_NUMBER, -1);
+    }
+    return frame;
+}
+
+/**
+ * @brief Checks that the requested queue depths are clamped to the supported range.
+ */
+static bool checkDepths(void)
+{
+    bool passed = true;
+    for (size_t i = 0; i < SDL_arraysize(depths); ++i)
+    {
+        cStats stats;
+        SDL_Camera* camera = openCamera(depths[i].requested, SDL_CAMERA_OVERFLOW_DROP_NEWEST);
+        if (camera == NULL)
+        {
+            return false;
+        }
+        getStats(camera, &stats);
+        SDL_CloseCamera(camera);
+
+        SDL_Log("Queue depth %" SDL_PRIs64 ": capacity %" SDL_PRIs64, depths[i].requested, stats.capacity);
+        passed = passed && stats.capacity == depths[i].capacity;
+    }
+    return passed;
+}
+
+/**
+ * @brief Leaves the ring full for a while, then checks what it kept.
+ *
+ * The ring must hold its capacity of frames: the first ones, consecutive, when
+ * dropping the newest or blocking, and later ones when dropping the oldest. Only
+ * the dropping policies may count dropped frames, and only blocking may wait.
+ */
+static bool checkPolicy(size_t index)
+{
+    bool passed = false;
+    cStats full, drained;
+    Sint64 sequences[CAPACITY + 1];
+    SDL_Surface* frames[CAPACITY];
+    int acquired = 0;
+    SDL_Camera* camera = openCamera(CAPACITY, policies[index].policy);
+    if (camera == NULL)
+    {
+        return false;
+    }
+
+    SDL_Delay(OVERFLOW_MS);
+    getStats(camera, &full);
+
+    // Hold every queued frame, so that the ring can only take new ones as they come
+    for (; acquired < CAPACITY; ++acquired)
+    {
+        if ((frames[acquired] = acquireFrame(camera, &sequences[acquired])) == NULL)
+        {
+            SDL_Log("%s: frame %d never came", policies[index].name, acquired);
+            goto EXIT;
+        }
+    }
+    getStats(camera, &drained);
+
+    // Dropping the oldest goes on while the app acquires, so only the order is kept then
+    bool ordered = true;
+    for (int i = 1; i < CAPACITY; ++i)
+    {
+        ordered = ordered && (policies[index].keepsNewest ? sequences[i] > sequences[i - 1] :
+                                                             sequences[i] == sequences[i - 1] + 1);
+    }
+
+    // The frame after the held ones follows them only if the camera waited for the app
+    for (int i = 0; i < CAPACITY; ++i)
+    {
+        SDL_ReleaseCameraFrame(camera, frames[i]);
+    }
+    acquired = 0;
+    SDL_Surface* next = acquireFrame(camera, &sequences[CAPACITY]);
+    if (next == NULL)
+    {
+        SDL_Log("%s: no frame after the held ones", policies[index].name);
+        goto EXIT;
+    }
+    SDL_ReleaseCameraFrame(camera, next);
+
+    SDL_Log("%s: depth %" SDL_PRIs64 ", peak %" SDL_PRIs64 ", %" SDL_PRIs64 " dropped, %.1f ms waited, "
+            "held %" SDL_PRIs64 "-%" SDL_PRIs64 ", then %" SDL_PRIs64, policies[index].name, full.depth, full.peak,
+            full.dropped, full.waitNS / 1e6, sequences[0], sequences[CAPACITY - 1], sequences[CAPACITY]);
+
+    bool drops = policies[index].drops;
+    // A frame dropped as the oldest leaves the ring for a moment before its slot is queued again
+    Sint64 minDepth = policies[index].keepsNewest ? CAPACITY - 1 : CAPACITY;
+    passed = full.depth >= minDepth && full.depth <= CAPACITY && full.peak == CAPACITY && drained.peak == CAPACITY && ordered &&
+             (drops ? full.dropped > 0 && full.waitNS == 0 : full.dropped == 0 && full.waitNS > 0) &&
+             (policies[index].keepsNewest ? sequences[0] > CAPACITY : sequences[0] <= CAPACITY) &&
+             (sequences[CAPACITY] == sequences[CAPACITY - 1] + 1) == !drops;
+
+    EXIT:
+    for (int i = 0; i < acquired; ++i)
+    {
+        SDL_ReleaseCameraFrame(camera, frames[i]);
+    }
+    SDL_CloseCamera(camera);
+    return passed;
+}
+
+/**
+ * @brief Consumer thread: acquires and releases frames until enough were taken.
+ */
+static int SDLCALL consume(void* data)
+{
+    cConsumer* me = data;
+    Uint64 end = SDL_GetTicks() + TIMEOUT_MS;
+    while (SDL_GetAtomicInt(me->remaining) > 0 && SDL_GetTicks() < end)
+    {
+        SDL_Surface* frame = SDL_AcquireCameraFrame(me->camera, NULL);
+        if (frame == NULL)
+        {
+            SDL_Delay(0);
+            continue;
+        }
+
+        Sint64 sequence = SDL_GetNumberProperty(SDL_GetSurfaceProperties(frame),
+                                                SDL_PROP_CAMERA_FRAME_SEQUENCE_NUMBER, -1);
+        if (me->count > 0 && sequence <= me->sequences[me->count - 1])
+        {
+            ++me->errors;
+        }
+        if (SDL_AddAtomicInt(me->remaining, -1) > 0)
+        {
+            me->sequences[me->count++] = sequence;
+        }
+        SDL_ReleaseCameraFrame(me->camera, frame);
+    }
+    return 0;
+}
+
+/**
+ * @brief qsort comparison of sequence numbers.
+ */
+static int compareSequences(const void* a, const void* b)
+{
+    Sint64 left = *(const Sint64*) a;
+    Sint64 right = *(const Sint64*) b;
+    return (left > right) - (left < right);
+}
+
+/**
+ * @brief Lets several threads acquire from the same blocking camera.
+ *
+ * Each thread must see its frames in order, no frame may go to two threads,
+ * and since the camera waits for them, together they must see every frame.
+ */
+static bool checkConsumers(void)
+{
+    bool passed = false;
+    SDL_AtomicInt remaining;
+    SDL_Thread* threads[CONSUMERS];
+    cConsumer consumers[CONSUMERS];
+    SDL_zeroa(threads);
+    SDL_zeroa(consumers);
+    SDL_SetAtomicInt(&remaining, CONSUMED_FRAMES);
+
+    Sint64* sequences = malloc(sizeof(Sint64) * CONSUMED_FRAMES * CONSUMERS);
+    SDL_Camera* camera = openCamera(CAPACITY, SDL_CAMERA_OVERFLOW_BLOCK);
+    if (sequences == NULL || camera == NULL)
+    {
+        goto EXIT;
+    }
+
+    Uint64 start = SDL_GetTicksNS();
+    for (int i = 0; i < CONSUMERS; ++i)
+    {
+        consumers[i].camera = camera;
+        consumers[i].remaining = &remaining;
+        consumers[i].sequences = sequences + (size_t) i * CONSUMED_FRAMES;
+        threads[i] = SDL_CreateThread(consume, "consumer", &consumers[i]);
+    }
+
+    // Gather the frames of every thread
+    int count = 0;
+    int errors = 0;
+    for (int i = 0; i < CONSUMERS; ++i)
+    {
+        SDL_WaitThread(threads[i], NULL);
+        for (int j = 0; j < consumers[i].count; ++j)
+        {
+            sequences[count++] = consumers[i].sequences[j];
+        }
+        errors += consumers[i].errors;
+    }
+    Uint64 elapsed = SDL_GetTicksNS() - start;
+
+    int duplicates = 0;
+    int gaps = 0;
+    qsort(sequences, count, sizeof(Sint64), compareSequences);
+    for (int i = 1; i < count; ++i)
+    {
+        duplicates += sequences[i] == sequences[i - 1];
+        gaps += sequences[i] > sequences[i - 1] + 1;
+    }
+
+    cStats stats;
+    getStats(camera, &stats);
+    SDL_Log("%d consumers: %d frames in %.1f ms, %d out of order, %d duplicated, %d gaps, %" SDL_PRIs64 " dropped",
+            CONSUMERS, count, elapsed / 1e6, errors, duplicates, gaps, stats.dropped);
+    passed = count == CONSUMED_FRAMES && errors == 0 && duplicates == 0 && gaps == 0 && stats.dropped == 0;
+
+    EXIT:
+    SDL_CloseCamera(camera);
+    free(sequences);
+    return passed;
+}
+
+int main(int argc, char* argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    bool passed = false;
+
+    SDL_SetHint(SDL_HINT_CAMERA_DRIVER, "synthetic");
+    SDL_SetHint(SDL_HINT_CAMERA_SYNTHETIC_SPECS, SPEC);
+    if (!SDL_Init(SDL_INIT_CAMERA))
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+
+    passed = checkDepths();
+    for (size_t i = 0; i < SDL_arraysize(policies); ++i)
+    {
+        passed = checkPolicy(i) && passed;
+    }
+    passed = checkConsumers() && passed;
+
+    EXIT:
+    SDL_Quit();
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,512 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Checks the per-plane scaler of the cameras on the synthetic camera driver:
+ * a random frame of the device format is replayed, the app requests another
+ * size in the same format, and every plane of the frame it gets is compared
+ * with a double precision area average or bilinear reference, inside the
+ * letterbox or crop rectangles, with black bars around. The scaling time is
+ * then benchmarked against the nearest neighbour stretch it replaced.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include <SDL3/SDL.h>
+
+#include <stdlib.h>
+
+#define REPLAY_FILE "test_camera_scale.raw" // Raw frame written then replayed, in the working directory
+#define MAX_ERROR 1           // Fixed point rounding allowed against the reference
+#define MAX_PLANES 2
+#define TIMEOUT_MS 5000       // Time after which a frame is given up on
+#define BENCHMARK_FRAMES 10   // Frames timed for each benchmark
+
+// Scaling cases: device spec, requested size and fit, and where the frame must land
+static const struct
+{
+    SDL_PixelFormat format;
+    int srcWidth, srcHeight;  // Device spec
+    int dstWidth, dstHeight;  // Requested spec
+    SDL_CameraFit fit;
+    SDL_Rect srcRect;         // Part of the device frame scaled
+    SDL_Rect dstRect;         // Where it lands, black around
+} cases[] = {
+    // Area average both ways, then bilinear, then mixed, then upscale
+    { SDL_PIXELFORMAT_XRGB8888, 160, 120, 40, 30, SDL_CAMERA_FIT_STRETCH, { 0, 0, 160, 120 }, { 0, 0, 40, 30 } },
+    { SDL_PIXELFORMAT_XRGB8888, 160, 120, 100, 75, SDL_CAMERA_FIT_STRETCH, { 0, 0, 160, 120 }, { 0, 0, 100, 75 } },
+    { SDL_PIXELFORMAT_XRGB8888, 160, 120, 64, 100, SDL_CAMERA_FIT_STRETCH, { 0, 0, 160, 120 }, { 0, 0, 64, 100 } },
+    { SDL_PIXELFORMAT_XRGB8888, 160, 120, 240, 180, SDL_CAMERA_FIT_STRETCH, { 0, 0, 160, 120 }, { 0, 0, 240, 180 } },
+    { SDL_PIXELFORMAT_XRGB8888, 160, 120, 100, 100, SDL_CAMERA_FIT_LETTERBOX, { 0, 0, 160, 120 }, { 0, 12, 100, 75 } },
+    { SDL_PIXELFORMAT_XRGB8888, 160, 120, 100, 100, SDL_CAMERA_FIT_CROP, { 20, 0, 120, 120 }, { 0, 0, 100, 100 } },
+    { SDL_PIXELFORMAT_XRGB8888, 120, 160, 100, 100, SDL_CAMERA_FIT_LETTERBOX, { 0, 0, 120, 160 }, { 12, 0, 75, 100 } },
+    // Subsampled chroma, with even rectangles
+    { SDL_PIXELFORMAT_NV12, 160, 120, 40, 30, SDL_CAMERA_FIT_STRETCH, { 0, 0, 160, 120 }, { 0, 0, 40, 30 } },
+    { SDL_PIXELFORMAT_NV12, 160, 120, 100, 75, SDL_CAMERA_FIT_STRETCH, { 0, 0, 160, 120 }, { 0, 0, 100, 75 } },
+    { SDL_PIXELFORMAT_NV12, 160, 120, 100, 100, SDL_CAMERA_FIT_LETTERBOX, { 0, 0, 160, 120 }, { 0, 12, 100, 74 } },
+    { SDL_PIXELFORMAT_NV12, 160, 120, 90, 120, SDL_CAMERA_FIT_CROP, { 34, 0, 90, 120 }, { 0, 0, 90, 120 } },
+    { SDL_PIXELFORMAT_NV12, 80, 60, 200, 150, SDL_CAMERA_FIT_STRETCH, { 0, 0, 80, 60 }, { 0, 0, 200, 150 } },
+    // Packed 4:2:2, samples apart from each other
+    { SDL_PIXELFORMAT_YUY2, 160, 120, 60, 44, SDL_CAMERA_FIT_STRETCH, { 0, 0, 160, 120 }, { 0, 0, 60, 44 } },
+    { SDL_PIXELFORMAT_YUY2, 160, 120, 120, 120, SDL_CAMERA_FIT_LETTERBOX, { 0, 0, 160, 120 }, { 0, 14, 120, 90 } },
+    { SDL_PIXELFORMAT_UYVY, 160, 120, 100, 75, SDL_CAMERA_FIT_STRETCH, { 0, 0, 160, 120 }, { 0, 0, 100, 75 } }
+};
+
+// Benchmarked downscales, from the device spec to the requested one
+static const struct
+{
+    SDL_PixelFormat format;
+    int srcWidth, srcHeight;
+    int dstWidth, dstHeight;
+} benchmarks[] = {
+    { SDL_PIXELFORMAT_NV12, 1280, 720, 640, 360 },
+    { SDL_PIXELFORMAT_NV12, 1280, 720, 960, 540 },
+    { SDL_PIXELFORMAT_XRGB8888, 1280, 720, 640, 360 },
+    { SDL_PIXELFORMAT_XRGB8888, 1280, 720, 960, 540 }
+};
+
+// Where the samples of one plane are in a frame
+typedef struct plane_s
+{
+    const Uint8* pixels;      // First byte of the plane
+    int pitch;                // Bytes between two rows
+    int sampleStride;         // Bytes between two samples of a row
+    int channelStride;        // Bytes between two channels of a sample
+    int channels;
+    int xShift, yShift;       // Subsampling of the plane
+} cPlane;
+
+/**
+ * @brief Finds the planes of a frame in one of the tested formats.
+ *
+ * @return The number of planes.
+ */
+static int getPlanes(SDL_PixelFormat format, const Uint8* pixels, int pitch, int height, cPlane* planes)
+{
+    SDL_memset(planes, 0, sizeof(cPlane) * MAX_PLANES);
+    planes[0] = (cPlane) { pixels, pitch, 1, 1, 1, 0, 0 };
+    switch (format)
+    {
+    case SDL_PIXELFORMAT_NV12:
+        planes[1] = (cPlane) { pixels + (size_t) pitch * height, 2 * ((pitch + 1) / 2), 2, 1, 2, 1, 1 };
+        return 2;
+    case SDL_PIXELFORMAT_YUY2:
+        planes[0] = (cPlane) { pixels, pitch, 2, 1, 1, 0, 0 };
+        planes[1] = (cPlane) { pixels + 1, pitch, 4, 2, 2, 1, 0 };
+        return 2;
+    case SDL_PIXELFORMAT_UYVY:
+        planes[0] = (cPlane) { pixels + 1, pitch, 2, 1, 1, 0, 0 };
+        planes[1] = (cPlane) { pixels, pitch, 4, 2, 2, 1, 0 };
+        return 2;
+    default:
+        planes[0] = (cPlane) { pixels, pitch, 4, 1, 4, 0, 0 };
+        return 1;
+    }
+}
+
+/**
+ * @brief Scales a rectangle of the full frame down to a subsampled plane, covering every sample it touches.
+ */
+static SDL_Rect planeRect(const SDL_Rect* rect, int xShift, int yShift)
+{
+    SDL_Rect result;
+    result.x = rect->x >> xShift;
+    result.y = rect->y >> yShift;
+    result.w = ((rect->x + rect->w + (1 << xShift) - 1) >> xShift) - result.x;
+    result.h = ((rect->y + rect->h + (1 << yShift) - 1) >> yShift) - result.y;
+    return result;
+}
+
+/**
+ * @brief Reference weights of the source samples feeding one destination sample along an axis.
+ *
+ * Area average when the axis shrinks by 2 or more, centre aligned bilinear otherwise.
+ *
+ * @param weights Receives the weight of each of these source samples, in order.
+ * @param first Receives the first source sample.
+ * @return The number of source samples.
+ */
+static int axisWeights(int srcLength, int dstLength, int i, double* weights, int* first)
+{
+    double ratio = (double) srcLength / dstLength;
+    int count = 0;
+
+    if (ratio >= 2.0)
+    {
+        double low = i * ratio;
+        double high = SDL_min((i + 1) * ratio, (double) srcLength);
+        *first = (int) low;
+        for (int k = *first; k < srcLength && k < high; ++k)
+        {
+            weights[count++] = (SDL_min(high, k + 1.0) - SDL_max(low, (double) k)) / ratio;
+        }
+        return count;
+    }
+
+    // Centres past the first or last sample take that sample alone
+    double position = SDL_clamp((i + 0.5) * ratio - 0.5, 0.0, (double) (srcLength - 1));
+    *first = (int) position;
+    weights[count++] = 1.0 - (position - *first);
+    if (position > *first)
+    {
+        weights[count++] = position - *first;
+    }
+    return count;
+}
+
+/**
+ * @brief Compares a plane of the scaled frame with the reference, and its bars with the cleared frame.
+ *
+ * @param black Plane of a frame of the requested size cleared to black.
+ * @return The largest difference found.
+ */
+static int comparePlane(const cPlane* src, const cPlane* dst, const cPlane* black, const SDL_Rect* srcRect,
+                        const SDL_Rect* dstRect, int dstWidth, int dstHeight)
+{
+    SDL_Rect from = planeRect(srcRect, src->xShift, src->yShift);
+    SDL_Rect to = planeRect(dstRect, dst->xShift, dst->yShift);
+    int width = (dstWidth + (1 << dst->xShift) - 1) >> dst->xShift;
+    int height = (dstHeight + (1 << dst->yShift) - 1) >> dst->yShift;
+    double* xWeights = malloc(sizeof(double) * from.w);
+    double* yWeights = malloc(sizeof(double) * from.h);
+    int maxError = 0;
+    if (xWeights == NULL || yWeights == NULL)
+    {
+        maxError = 256;
+        goto EXIT;
+    }
+
+    for (int y = 0; y < height; ++y)
+    {
+        int yFirst = 0;
+        int yCount = 0;
+        bool rowInside = y >= to.y && y < to.y + to.h;
+        if (rowInside)
+        {
+            yCount = axisWeights(from.h, to.h, y - to.y, yWeights, &yFirst);
+        }
+        for (int x = 0; x < width; ++x)
+        {
+            int xFirst = 0;
+            int xCount = 0;
+            bool inside = rowInside && x >= to.x && x < to.x + to.w;
+            if (inside)
+            {
+                xCount = axisWeights(from.w, to.w, x - to.x, xWeights, &xFirst);
+            }
+            for (int c = 0; c < dst->channels; ++c)
+            {
+                size_t at = (size_t) y * dst->pitch + (size_t) x * dst->sampleStride + (size_t) c * dst->channelStride;
+                int expected = black->pixels[at];
+                if (inside)
+                {
+                    double sum = 0.0;
+                    for (int j = 0; j < yCount; ++j)
+                    {
+                        const Uint8* row = src->pixels + (size_t) (from.y + yFirst + j) * src->pitch +
+                                           (size_t) c * src->channelStride;
+                        for (int i = 0; i < xCount; ++i)
+                        {
+                            sum += yWeights[j] * xWeights[i] * row[(size_t) (from.x + xFirst + i) * src->sampleStride];
+                        }
+                    }
+                    expected = (int) SDL_lround(sum);
+                }
+                maxError = SDL_max(maxError, abs(dst->pixels[at] - expected));
+            }
+        }
+    }
+
+    EXIT:
+    free(xWeights);
+    free(yWeights);
+    return maxError;
+}
+
+/**
+ * @brief Writes a raw frame for the synthetic camera to replay.
+ */
+static bool writeFrame(const void* pixels, size_t size)
+{
+    SDL_IOStream* file = SDL_IOFromFile(REPLAY_FILE, "wb");
+    bool written = file != NULL && SDL_WriteIO(file, pixels, size) == size;
+    if (file == NULL || !SDL_CloseIO(file) || !written)
+    {
+        SDL_Log("%s", SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Starts the camera subsystem with a single device spec, replaying a random frame of it.
+ *
+ * @param frame Receives the replayed frame, to be given to closeCamera().
+ * @return The camera, approved, or NULL on failure.
+ */
+static SDL_Camera* openCamera(SDL_PixelFormat format, int srcWidth, int srcHeight, int dstWidth, int dstHeight,
+                              SDL_CameraFit fit, SDL_Surface** frame)
+{
+    SDL_Camera* camera = NULL;
+    SDL_CameraID* cameras = NULL;
+    SDL_PropertiesID props = 0;
+    int count = 0;
+    size_t size = 0;
+    char specs[64];
+    *frame = NULL;
+
+    // The driver replays frames of the smallest size the format allows
+    SDL_snprintf(specs, sizeof(specs), "%s %dx%d@0", SDL_GetPixelFormatName(format) + SDL_strlen("SDL_PIXELFORMAT_"),
+                 srcWidth, srcHeight);
+    int pitch = SDL_ISPIXELFORMAT_FOURCC(format) ? (format == SDL_PIXELFORMAT_NV12 ? srcWidth : (srcWidth + 1) / 2 * 4) :
+                                                   srcWidth * SDL_BYTESPERPIXEL(format);
+    size = (size_t) pitch * srcHeight + (format == SDL_PIXELFORMAT_NV12 ? (size_t) pitch * ((srcHeight + 1) / 2) : 0);
+    Uint8* pixels = malloc(size);
+    if (pixels == NULL || (*frame = SDL_CreateSurfaceFrom(srcWidth, srcHeight, format, pixels, pitch)) == NULL)
+    {
+        SDL_Log("%s", SDL_GetError());
+        free(pixels);
+        goto EXIT;
+    }
+    for (size_t i = 0; i < size; ++i)
+    {
+        pixels[i] = (Uint8) SDL_rand(256);
+    }
+
+    if (!writeFrame(pixels, size))
+    {
+        goto EXIT;
+    }
+    SDL_SetHint(SDL_HINT_CAMERA_SYNTHETIC_SPECS, specs);
+    SDL_SetHint(SDL_HINT_CAMERA_SYNTHETIC_FILE, REPLAY_FILE);
+    if (!SDL_InitSubSystem(SDL_INIT_CAMERA) || (cameras = SDL_GetCameras(&count)) == NULL || count == 0 ||
+        (props = SDL_CreateProperties()) == 0)
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+
+    const SDL_CameraSpec spec = { format, SDL_COLORSPACE_UNKNOWN, dstWidth, dstHeight, 0, 1 };
+    SDL_SetPointerProperty(props, SDL_PROP_CAMERA_CREATE_SPEC_POINTER, (void*) &spec);
+    SDL_SetNumberProperty(props, SDL_PROP_CAMERA_CREATE_FIT_NUMBER, fit);
+    if ((camera = SDL_OpenCameraWithProperties(cameras[0], props)) == NULL)
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+    while (SDL_GetCameraPermissionState(camera) == 0)
+    {
+        SDL_Delay(1);
+    }
+    if (SDL_GetCameraPermissionState(camera) != 1)
+    {
+        SDL_Log("The synthetic camera was denied");
+        SDL_CloseCamera(camera);
+        camera = NULL;
+    }
+
+    EXIT:
+    SDL_DestroyProperties(props);
+    SDL_free(cameras);
+    return camera;
+}
+
+/**
+ * @brief Stops the camera subsystem started by openCamera().
+ */
+static void closeCamera(SDL_Camera* camera, SDL_Surface* frame)
+{
+    SDL_CloseCamera(camera);
+    SDL_QuitSubSystem(SDL_INIT_CAMERA);
+    SDL_ResetHint(SDL_HINT_CAMERA_SYNTHETIC_SPECS);
+    SDL_ResetHint(SDL_HINT_CAMERA_SYNTHETIC_FILE);
+    SDL_RemovePath(REPLAY_FILE);
+    if (frame != NULL)
+    {
+        free(frame->pixels);
+        SDL_DestroySurface(frame);
+    }
+}
+
+/**
+ * @brief Acquires a frame, waiting for one if needed.
+ *
+ * @return The frame, or NULL on time out.
+ */
+static SDL_Surface* acquireFrame(SDL_Camera* camera)
+{
+    Uint64 end = SDL_GetTicks() + TIMEOUT_MS;
+    SDL_Surface* frame;
+    while ((frame = SDL_AcquireCameraFrame(camera, NULL)) == NULL && SDL_GetTicks() < end)
+    {
+        SDL_Delay(1);
+    }
+    return frame;
+}
+
+/**
+ * @brief Scales a random frame through the camera and checks every plane of the result.
+ */
+static bool checkCase(size_t index)
+{
+    bool passed = false;
+    SDL_Surface* source = NULL;
+    SDL_Surface* frame = NULL;
+    SDL_Surface* black = NULL;
+    SDL_Camera* camera = openCamera(cases[index].format, cases[index].srcWidth, cases[index].srcHeight,
+                                    cases[index].dstWidth, cases[index].dstHeight, cases[index].fit, &source);
+    if (camera == NULL || (frame = acquireFrame(camera)) == NULL)
+    {
+        goto EXIT;
+    }
+    if (frame->format != cases[index].format || frame->w != cases[index].dstWidth || frame->h != cases[index].dstHeight)
+    {
+        SDL_Log("Got a %s %dx%d frame", SDL_GetPixelFormatName(frame->format), frame->w, frame->h);
+        goto EXIT;
+    }
+
+    // Bars hold whatever black is in the colorspace of the frame
+    black = SDL_CreateSurface(frame->w, frame->h, frame->format);
+    if (black == NULL || black->pitch != frame->pitch ||
+        !SDL_SetSurfaceColorspace(black, SDL_GetSurfaceColorspace(frame)) ||
+        !SDL_ClearSurface(black, 0.0f, 0.0f, 0.0f, 1.0f))
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+
+    cPlane srcPlanes[MAX_PLANES], dstPlanes[MAX_PLANES], blackPlanes[MAX_PLANES];
+    int planes = getPlanes(source->format, source->pixels, source->pitch, source->h, srcPlanes);
+    getPlanes(frame->format, frame->pixels, frame->pitch, frame->h, dstPlanes);
+    getPlanes(black->format, black->pixels, black->pitch, black->h, blackPlanes);
+    int maxError = 0;
+    for (int i = 0; i < planes; ++i)
+    {
+        maxError = SDL_max(maxError, comparePlane(&srcPlanes[i], &dstPlanes[i], &blackPlanes[i],
+                                                  &cases[index].srcRect, &cases[index].dstRect,
+                                                  frame->w, frame->h));
+    }
+
+    static const char* const fits[] = { "stretch", "letterbox", "crop" };
+    SDL_Log("%s %dx%d -> %dx%d %s: largest error %d", SDL_GetPixelFormatName(cases[index].format),
+            cases[index].srcWidth, cases[index].srcHeight, cases[index].dstWidth, cases[index].dstHeight,
+            fits[cases[index].fit], maxError);
+    passed = maxError <= MAX_ERROR;
+
+    EXIT:
+    SDL_DestroySurface(black);
+    if (frame != NULL)
+    {
+        SDL_ReleaseCameraFrame(camera, frame);
+    }
+    closeCamera(camera, source);
+    return passed;
+}
+
+/**
+ * @brief Stretches a frame the way the cameras did before the scaler, with nearest neighbour sampling.
+ *
+ * RGB frames were stretched as they were, and YUV frames were converted to
+ * XRGB8888, stretched, and converted back.
+ *
+ * @param rgb Scratch frames of the source and destination sizes in XRGB8888, for YUV frames.
+ * @return `true` on success.
+ */
+static bool stretchNearest(SDL_Surface* src, SDL_Surface* dst, SDL_Surface* const* rgb)
+{
+    if (!SDL_ISPIXELFORMAT_FOURCC(src->format))
+    {
+        return SDL_BlitSurfaceScaled(src, NULL, dst, NULL, SDL_SCALEMODE_NEAREST);
+    }
+    return SDL_ConvertPixels(src->w, src->h, src->format, src->pixels, src->pitch,
+                             rgb[0]->format, rgb[0]->pixels, rgb[0]->pitch) &&
+           SDL_BlitSurfaceScaled(rgb[0], NULL, rgb[1], NULL, SDL_SCALEMODE_NEAREST) &&
+           SDL_ConvertPixels(dst->w, dst->h, rgb[1]->format, rgb[1]->pixels, rgb[1]->pitch,
+                             dst->format, dst->pixels, dst->pitch);
+}
+
+/**
+ * @brief Times the scaler of the camera against the former nearest neighbour stretch, on the same frames.
+ *
+ * The camera thread reports the time it spent on each frame, which is all scaling with no conversion.
+ */
+static bool benchmark(size_t index)
+{
+    bool passed = false;
+    SDL_Surface* source = NULL;
+    SDL_Surface* nearest = NULL;
+    SDL_Surface* rgb[2] = { NULL, NULL };
+    Uint64 scaler = 0;
+    Uint64 stretch = 0;
+    SDL_Camera* camera = openCamera(benchmarks[index].format, benchmarks[index].srcWidth, benchmarks[index].srcHeight,
+                                    benchmarks[index].dstWidth, benchmarks[index].dstHeight, SDL_CAMERA_FIT_STRETCH,
+                                    &source);
+    if (camera == NULL ||
+        (nearest = SDL_CreateSurface(benchmarks[index].dstWidth, benchmarks[index].dstHeight,
+                                     benchmarks[index].format)) == NULL ||
+        (rgb[0] = SDL_CreateSurface(source->w, source->h, SDL_PIXELFORMAT_XRGB8888)) == NULL ||
+        (rgb[1] = SDL_CreateSurface(nearest->w, nearest->h, SDL_PIXELFORMAT_XRGB8888)) == NULL)
+    {
+        goto EXIT;
+    }
+    SDL_SetSurfaceBlendMode(source, SDL_BLENDMODE_NONE);
+
+    for (int i = 0; i < BENCHMARK_FRAMES; ++i)
+    {
+        SDL_Surface* frame = acquireFrame(camera);
+        if (frame == NULL)
+        {
+            goto EXIT;
+        }
+        scaler += SDL_GetNumberProperty(SDL_GetSurfaceProperties(frame), SDL_PROP_CAMERA_FRAME_CONVERSION_NS_NUMBER, 0);
+        SDL_ReleaseCameraFrame(camera, frame);
+
+        Uint64 start = SDL_GetTicksNS();
+        if (!stretchNearest(source, nearest, rgb))
+        {
+            SDL_Log("%s", SDL_GetError());
+            goto EXIT;
+        }
+        stretch += SDL_GetTicksNS() - start;
+    }
+
+    SDL_Log("%s %dx%d -> %dx%d: %.3f ms per frame with the scaler, %.3f ms with the nearest stretch",
+            SDL_GetPixelFormatName(benchmarks[index].format), benchmarks[index].srcWidth, benchmarks[index].srcHeight,
+            benchmarks[index].dstWidth, benchmarks[index].dstHeight, scaler / 1e6 / BENCHMARK_FRAMES,
+            stretch / 1e6 / BENCHMARK_FRAMES);
+    passed = scaler > 0;
+
+    EXIT:
+    SDL_DestroySurface(rgb[0]);
+    SDL_DestroySurface(rgb[1]);
+    SDL_DestroySurface(nearest);
+    closeCamera(camera, source);
+    return passed;
+}
+
+int main(int argc, char* argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    bool passed = true;
+
+    SDL_srand(1);
+    SDL_SetHint(SDL_HINT_CAMERA_DRIVER, "synthetic");
+    for (size_t i = 0; i < SDL_arraysize(cases); ++i)
+    {
+        passed = checkCase(i) && passed;
+    }
+    for (size_t i = 0; i < SDL_arraysize(benchmarks); ++i)
+    {
+        passed = benchmark(i) && passed;
+    }
+
+    SDL_Quit();
+    return passed ? 0 : 1;
+}
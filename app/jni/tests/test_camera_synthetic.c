@@ -0,0 +1,300 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Checks the synthetic camera driver through the public camera API: the
+ * advertised specs follow SDL_HINT_CAMERA_SYNTHETIC_SPECS, frames come at the
+ * requested rate on the slot grid of their sequence numbers, jitter stays in
+ * its bound, drops happen at the requested rate, and a raw file is replayed
+ * frame for frame. Frame rates are logged as a benchmark of the acquire path.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include <SDL3/SDL.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SPECS "NV12 320x240@60,YUY2 160x120@0,XRGB8888 64x48@29.97"
+#define REPLAY_FILE "test_camera_synthetic.raw" // Raw frames written then replayed, in the working directory
+#define REPLAY_FRAMES 3       // Frames in the replayed file
+#define RUN_MS 1000           // Duration of the timed runs
+#define TIMEOUT_MS 10000      // Time after which a run gives up
+#define MIN_RATE 0.75         // Share of the nominal frame rate a run must reach
+#define JITTER "3"            // Jitter of the jittered run, in ms
+#define JITTER_NS 3000000     // The same in ns
+#define DROP_RATE "0.25"      // Drop rate of the jittered run
+#define DROP_SHARE 0.25       // The same as a share
+#define SLOT_TOLERANCE_NS 1000 // Rounding allowed on the distance between two slots
+
+// Specs the driver must advertise for SPECS
+static const SDL_CameraSpec advertised[] = {
+    { SDL_PIXELFORMAT_NV12, SDL_COLORSPACE_UNKNOWN, 320, 240, 60, 1 },
+    { SDL_PIXELFORMAT_YUY2, SDL_COLORSPACE_UNKNOWN, 160, 120, 0, 1 },
+    { SDL_PIXELFORMAT_XRGB8888, SDL_COLORSPACE_UNKNOWN, 64, 48, 29970, 1000 }
+};
+
+// What a run saw
+typedef struct run_s
+{
+    int frames;               // Frames acquired
+    Sint64 firstSequence;     // Sequence number of the first frame
+    Sint64 lastSequence;      // Sequence number of the last frame
+    Uint64 maxSlotError;      // Largest distance between a frame and the slot grid, in ns
+    Uint64 elapsed;           // Duration of the run in ns
+    int errors;               // Frames out of order or with the wrong pixels
+} cRun;
+
+/**
+ * @brief Opens the first camera in one of its own specs, so that frames are not converted.
+ *
+ * @return The camera, approved, or NULL on failure.
+ */
+static SDL_Camera* openCamera(const SDL_CameraSpec* spec)
+{
+    SDL_Camera* camera = NULL;
+    int count = 0;
+    SDL_CameraID* cameras = SDL_GetCameras(&count);
+    if (cameras == NULL || count == 0 || (camera = SDL_OpenCamera(cameras[0], spec)) == NULL)
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+
+    while (SDL_GetCameraPermissionState(camera) == 0)
+    {
+        SDL_Delay(1);
+    }
+    if (SDL_GetCameraPermissionState(camera) != 1)
+    {
+        SDL_Log("The synthetic camera was denied");
+        SDL_CloseCamera(camera);
+        camera = NULL;
+    }
+
+    EXIT:
+    SDL_free(cameras);
+    return camera;
+}
+
+/**
+ * @brief Checks that the advertised specs are those of the hint.
+ *
+ * @return `true` if every spec was found, and nothing else.
+ */
+static bool checkSpecs(void)
+{
+    int cameraCount = 0;
+    int count = 0;
+    SDL_CameraID* cameras = SDL_GetCameras(&cameraCount);
+    SDL_CameraSpec** specs = (cameraCount > 0) ? SDL_GetCameraSupportedFormats(cameras[0], &count) : NULL;
+    bool passed = specs != NULL && count == (int) SDL_arraysize(advertised);
+
+    for (size_t i = 0; passed && i < SDL_arraysize(advertised); ++i)
+    {
+        bool found = false;
+        for (int j = 0; j < count; ++j)
+        {
+            const SDL_CameraSpec* spec = specs[j];
+            found = found || (spec->format == advertised[i].format && spec->width == advertised[i].width &&
+                              spec->height == advertised[i].height &&
+                              spec->framerate_numerator == advertised[i].framerate_numerator &&
+                              spec->framerate_denominator == advertised[i].framerate_denominator);
+        }
+        SDL_Log("Spec %s %dx%d@%d/%d: %s", SDL_GetPixelFormatName(advertised[i].format), advertised[i].width,
+                advertised[i].height, advertised[i].framerate_numerator, advertised[i].framerate_denominator,
+                found ? "advertised" : "missing");
+        passed = found;
+    }
+
+    SDL_free(specs);
+    SDL_free(cameras);
+    return passed;
+}
+
+/**
+ * @brief Acquires frames for a while and gathers their timing.
+ *
+ * @param spec Spec to open, one of the advertised ones.
+ * @param minFrames Frames to acquire at least, whatever the duration.
+ * @param replay Frames of the replayed file to compare with, or NULL.
+ * @param run Receives what the run saw.
+ * @return `false` if the camera could not be opened.
+ */
+static bool runCamera(const SDL_CameraSpec* spec, int minFrames, const Uint8* replay, cRun* run)
+{
+    SDL_Camera* camera = openCamera(spec);
+    if (camera == NULL)
+    {
+        return false;
+    }
+
+    Uint64 interval = spec->framerate_numerator ?
+                      SDL_NS_PER_SECOND * spec->framerate_denominator / spec->framerate_numerator : 0;
+    Uint64 firstTimestamp = 0;
+    Uint64 start = SDL_GetTicksNS();
+    SDL_zerop(run);
+
+    while ((SDL_GetTicksNS() - start < SDL_MS_TO_NS(RUN_MS) || run->frames < minFrames) &&
+           SDL_GetTicksNS() - start < SDL_MS_TO_NS(TIMEOUT_MS))
+    {
+        SDL_Surface* frame = SDL_AcquireCameraFrame(camera, NULL);
+        if (frame == NULL)
+        {
+            SDL_Delay(1);
+            continue;
+        }
+
+        SDL_PropertiesID props = SDL_GetSurfaceProperties(frame);
+        Sint64 sequence = SDL_GetNumberProperty(props, SDL_PROP_CAMERA_FRAME_SEQUENCE_NUMBER, -1);
+        Uint64 timestamp = (Uint64) SDL_GetNumberProperty(props, SDL_PROP_CAMERA_FRAME_DRIVER_TIMESTAMP_NUMBER, 0);
+        if (run->frames == 0)
+        {
+            run->firstSequence = sequence;
+            firstTimestamp = timestamp;
+        }
+        else if (sequence <= run->lastSequence)
+        {
+            ++run->errors;
+        }
+
+        // Each frame belongs to the slot of its sequence number
+        if (interval)
+        {
+            Sint64 slot = (Sint64) firstTimestamp + (sequence - run->firstSequence) * (Sint64) interval;
+            Sint64 error = (Sint64) timestamp - slot;
+            run->maxSlotError = SDL_max(run->maxSlotError, (Uint64) (error < 0 ? -error : error));
+        }
+
+        // Replayed frames loop over the file, following the sequence numbers
+        if (replay != NULL)
+        {
+            size_t size = (size_t) frame->pitch * frame->h;
+            if (memcmp(frame->pixels, replay + (size_t) (sequence % REPLAY_FRAMES) * size, size) != 0)
+            {
+                ++run->errors;
+            }
+        }
+
+        run->lastSequence = sequence;
+        run->frames++;
+        SDL_ReleaseCameraFrame(camera, frame);
+    }
+
+    run->elapsed = SDL_GetTicksNS() - start;
+    SDL_CloseCamera(camera);
+    return true;
+}
+
+/**
+ * @brief Frames per second of a run.
+ */
+static double frameRate(const cRun* run)
+{
+    return (double) run->frames * SDL_NS_PER_SECOND / (double) run->elapsed;
+}
+
+/**
+ * @brief Share of the slots of a run that had no frame.
+ */
+static double missingShare(const cRun* run)
+{
+    return 1.0 - (double) run->frames / (double) (run->lastSequence - run->firstSequence + 1);
+}
+
+int main(int argc, char* argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    bool passed = false;
+    cRun run;
+    size_t replaySize = (size_t) advertised[2].width * advertised[2].height * 4;
+    Uint8* replay = malloc(replaySize * REPLAY_FRAMES);
+
+    SDL_SetHint(SDL_HINT_CAMERA_DRIVER, "synthetic");
+    SDL_SetHint(SDL_HINT_CAMERA_SYNTHETIC_SPECS, SPECS);
+    if (replay == NULL || !SDL_Init(SDL_INIT_CAMERA))
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+
+    passed = checkSpecs();
+
+    // Steady frames: the nominal rate, every frame exactly on its slot
+    if (!runCamera(&advertised[0], 0, NULL, &run))
+    {
+        passed = false;
+        goto EXIT;
+    }
+    SDL_Log("NV12 320x240 at 60 fps: %d frames, %.1f fps, %.1f%% missing, %d errors, %.3f ms off the grid",
+            run.frames, frameRate(&run), missingShare(&run) * 100.0, run.errors, run.maxSlotError / 1e6);
+    passed = passed && run.errors == 0 && frameRate(&run) >= 60.0 * MIN_RATE && frameRate(&run) <= 61.0 &&
+             run.maxSlotError <= SLOT_TOLERANCE_NS;
+
+    // Jittered and dropping frames: off the grid by twice the jitter at most, as the first frame is
+    // jittered too, and a quarter of the slots empty
+    SDL_SetHint(SDL_HINT_CAMERA_SYNTHETIC_JITTER, JITTER);
+    SDL_SetHint(SDL_HINT_CAMERA_SYNTHETIC_DROP_RATE, DROP_RATE);
+    if (!runCamera(&advertised[0], 100, NULL, &run))
+    {
+        passed = false;
+        goto EXIT;
+    }
+    SDL_ResetHint(SDL_HINT_CAMERA_SYNTHETIC_JITTER);
+    SDL_ResetHint(SDL_HINT_CAMERA_SYNTHETIC_DROP_RATE);
+    SDL_Log("Jitter " JITTER " ms, drop rate " DROP_RATE ": %d frames, %.1f fps, %.1f%% missing, %d errors, "
+            "%.3f ms off the grid", run.frames, frameRate(&run), missingShare(&run) * 100.0, run.errors,
+            run.maxSlotError / 1e6);
+    passed = passed && run.errors == 0 && run.maxSlotError > SLOT_TOLERANCE_NS &&
+             run.maxSlotError <= 2 * JITTER_NS + SLOT_TOLERANCE_NS &&
+             missingShare(&run) >= DROP_SHARE - 0.1 && missingShare(&run) <= DROP_SHARE + 0.15;
+
+    // Replay of a raw file, at a rate that is not a whole number
+    SDL_srand(1);
+    for (size_t i = 0; i < replaySize * REPLAY_FRAMES; ++i)
+    {
+        replay[i] = (Uint8) SDL_rand(256);
+    }
+    SDL_IOStream* file = SDL_IOFromFile(REPLAY_FILE, "wb");
+    bool written = file != NULL && SDL_WriteIO(file, replay, replaySize * REPLAY_FRAMES) == replaySize * REPLAY_FRAMES;
+    if (file == NULL || !SDL_CloseIO(file) || !written)
+    {
+        SDL_Log("%s", SDL_GetError());
+        passed = false;
+        goto EXIT;
+    }
+    SDL_SetHint(SDL_HINT_CAMERA_SYNTHETIC_FILE, REPLAY_FILE);
+    bool opened = runCamera(&advertised[2], 0, replay, &run);
+    SDL_ResetHint(SDL_HINT_CAMERA_SYNTHETIC_FILE);
+    SDL_RemovePath(REPLAY_FILE);
+    if (!opened)
+    {
+        passed = false;
+        goto EXIT;
+    }
+    SDL_Log("Replay of %d XRGB8888 64x48 frames at 29.97 fps: %d frames, %.1f fps, %d wrong frames",
+            REPLAY_FRAMES, run.frames, frameRate(&run), run.errors);
+    passed = passed && run.errors == 0 && frameRate(&run) >= 29.97 * MIN_RATE;
+
+    // Uncapped pattern, as fast as the frames are consumed
+    if (!runCamera(&advertised[1], 0, NULL, &run))
+    {
+        passed = false;
+        goto EXIT;
+    }
+    SDL_Log("YUY2 160x120 uncapped: %d frames, %.1f fps, %d errors", run.frames, frameRate(&run), run.errors);
+    passed = passed && run.errors == 0 && frameRate(&run) > 60.0;
+
+    EXIT:
+    SDL_Quit();
+    free(replay);
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,239 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Headless run of the compositor on the software renderer of the dummy video
+ * driver: one producer thread per stream publishes synthetic NV12 frames at its
+ * own size and rate while the render loop composites every stream, and the
+ * time taken by each composited frame is reported for every layout.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "compositor.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SCREEN_WIDTH 640
+#define SCREEN_HEIGHT 360
+#define RUN_MS 1000          // Duration of the render loop for each run
+#define MAX_FRAMES 10000     // Composited frames timed per run at most
+
+// Layouts and stream counts run in turn
+static const struct
+{
+    cLayoutMode mode;
+    int streams;
+} runs[] = {
+    { LAYOUT_SINGLE, 1 },
+    { LAYOUT_PICTURE_IN_PICTURE, 2 },
+    { LAYOUT_PICTURE_IN_PICTURE, 4 },
+    { LAYOUT_GRID, 4 },
+    { LAYOUT_GRID, 8 }
+};
+
+// A producer thread and the stream it feeds
+typedef struct producer_s
+{
+    cImage* image;
+    int width;
+    int height;
+    int delayMs;           // Pause after each frame, so that every producer has its own rate
+    SDL_AtomicInt* stop;
+    SDL_Thread* thread;
+    int frames;            // Frames published
+} cProducer;
+
+/**
+ * @brief Producer thread: publishes NV12 frames with a moving gradient.
+ *
+ * @param data Pointer to the `cProducer`.
+ * @return 0 on success, 1 if a frame could not be written.
+ */
+static int SDLCALL produce(void* data)
+{
+    cProducer* me = data;
+    size_t lumaSize = (size_t) me->width * me->height;
+    uint8_t* pixels = malloc(lumaSize + (size_t) ((me->width + 1) / 2 * 2) * ((me->height + 1) / 2));
+    if (pixels == NULL)
+    {
+        return 1;
+    }
+
+    while (!SDL_GetAtomicInt(me->stop))
+    {
+        memset(pixels, me->frames * 8, lumaSize);
+        memset(pixels + lumaSize, 128, (size_t) ((me->width + 1) / 2 * 2) * ((me->height + 1) / 2));
+        const uint8_t* uvPlane = pixels + lumaSize;
+        if (!cImage_WritePlanes(me->image, pixels, uvPlane, uvPlane + 1,
+                                me->width, (me->width + 1) / 2 * 2, 2, me->width, me->height, SDL_GetTicksNS()))
+        {
+            free(pixels);
+            return 1;
+        }
+        me->frames++;
+        SDL_Delay(me->delayMs);
+    }
+
+    free(pixels);
+    return 0;
+}
+
+/**
+ * @brief Orders two frame times.
+ */
+static int SDLCALL compareTimes(const void* a, const void* b)
+{
+    Uint64 left = *(const Uint64*) a;
+    Uint64 right = *(const Uint64*) b;
+    return (left < right) ? -1 : (left > right);
+}
+
+/**
+ * @brief Checks that the draw order goes up by layer, then by stream.
+ */
+static bool checkDrawOrder(const cCompositor* compositor)
+{
+    int drawn = 0;
+    for (int i = 0; i < compositor->count; ++i)
+    {
+        drawn += compositor->streams[i].visible && compositor->streams[i].image->texture != NULL;
+    }
+    for (int i = 1; i < drawn; ++i)
+    {
+        const cStream* previous = compositor->drawOrder[i - 1];
+        const cStream* current = compositor->drawOrder[i];
+        if (previous->layer > current->layer || (previous->layer == current->layer && previous >= current))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Composites the streams of one layout while producers feed them.
+ *
+ * @param times Room for MAX_FRAMES frame times.
+ * @return `true` if every visible stream was drawn and the draw order held.
+ */
+static bool runLayout(SDL_Renderer* renderer, cLayoutMode mode, int count, Uint64* times)
+{
+    static const char* const modeNames[] = { "single", "grid", "picture in picture" };
+    bool passed = false;
+    cCompositor* compositor = NULL;
+    cProducer producers[COMPOSITOR_MAX_STREAMS];
+    SDL_AtomicInt stop;
+    int started = 0;
+    int frames = 0;
+
+    SDL_zeroa(producers);
+    SDL_SetAtomicInt(&stop, 0);
+    if (!cCompositor_New(&compositor, renderer, count, mode))
+    {
+        goto EXIT;
+    }
+    SDL_FRect screen = { 0.0f, 0.0f, SCREEN_WIDTH, SCREEN_HEIGHT };
+    cCompositor_Resize(compositor, &screen, 0);
+
+    for (int i = 0; i < count; ++i)
+    {
+        producers[i].image = cCompositor_GetImage(compositor, i);
+        producers[i].width = (i % 2) ? 160 : 320;
+        producers[i].height = (i % 2) ? 120 : 240;
+        producers[i].delayMs = 10 + 7 * i;
+        producers[i].stop = &stop;
+        producers[i].thread = SDL_CreateThread(produce, "producer", &producers[i]);
+        if (producers[i].thread == NULL)
+        {
+            SDL_Log("%s", SDL_GetError());
+            goto EXIT;
+        }
+        started++;
+    }
+
+    passed = true;
+    Uint64 end = SDL_GetTicks() + RUN_MS;
+    while (SDL_GetTicks() < end && frames < MAX_FRAMES)
+    {
+        Uint64 start = SDL_GetTicksNS();
+        if (!SDL_RenderClear(renderer) || !cCompositor_Render(compositor) || !SDL_RenderPresent(renderer))
+        {
+            passed = false;
+            break;
+        }
+        times[frames++] = SDL_GetTicksNS() - start;
+        passed = passed && checkDrawOrder(compositor);
+
+        // Leave the producers some of the single CPU a test machine may have
+        SDL_Delay(1);
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        const cStream* stream = &compositor->streams[i];
+        if (stream->visible && stream->image->texture == NULL)
+        {
+            SDL_Log("Stream %d was never drawn", i);
+            passed = false;
+        }
+    }
+
+    if (frames > 0)
+    {
+        SDL_qsort(times, frames, sizeof(*times), compareTimes);
+        SDL_Log("%s layout, %d stream(s): %d frames composited, median %.3f ms, 95th percentile %.3f ms, max %.3f ms",
+                modeNames[mode], count, frames, times[frames / 2] / 1e6, times[frames * 95 / 100] / 1e6,
+                times[frames - 1] / 1e6);
+    }
+
+    EXIT:
+    SDL_SetAtomicInt(&stop, 1);
+    for (int i = 0; i < started; ++i)
+    {
+        int status = 0;
+        SDL_WaitThread(producers[i].thread, &status);
+        passed = passed && status == 0 && producers[i].frames > 0;
+    }
+    cCompositor_Destroy(compositor);
+    return passed;
+}
+
+int main(int argc, char* argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    bool passed = false;
+    SDL_Window* window = NULL;
+    SDL_Renderer* renderer = NULL;
+    Uint64* times = malloc(sizeof(*times) * MAX_FRAMES);
+
+    SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "dummy");
+    if (times == NULL || !SDL_Init(SDL_INIT_VIDEO) ||
+        (window = SDL_CreateWindow("test_compositor", SCREEN_WIDTH, SCREEN_HEIGHT, 0)) == NULL ||
+        (renderer = SDL_CreateRenderer(window, SDL_SOFTWARE_RENDERER)) == NULL)
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+
+    passed = true;
+    for (size_t i = 0; i < SDL_arraysize(runs); ++i)
+    {
+        passed = runLayout(renderer, runs[i].mode, runs[i].streams, times) && passed;
+    }
+
+    EXIT:
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    free(times);
+    return passed ? 0 : 1;
+}
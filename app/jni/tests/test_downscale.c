@@ -0,0 +1,308 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Checks the area and Lanczos downscaling of SDL_BlitSurfaceScaled against a
+ * double precision reference, under every SIMD level of the CPU.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "simd_check.h"
+
+#include <stdlib.h>
+
+#define CHANNELS 4         // Bytes per pixel of the images, each filtered on its own
+#define MIN_PSNR 50.0      // Lowest PSNR accepted against the reference, in dB
+#define MAX_ERROR 1.0      // Largest difference accepted on any sample
+#define LANCZOS_LOBES 3.0
+
+// Values of SDL_HINT_SURFACE_DOWNSCALE_FILTER, with the filter of the reference
+static const struct
+{
+    const char* hint;
+    bool lanczos;
+} filters[] = {
+    { "area", false },
+    { "lanczos", true }
+};
+
+// Source and destination sizes: integer and odd ratios, and one axis barely shrinking
+static const struct
+{
+    int srcWidth, srcHeight, dstWidth, dstHeight;
+} sizes[] = {
+    { 640, 480, 160, 120 },
+    { 1000, 700, 333, 301 },
+    { 643, 487, 211, 97 },
+    { 400, 300, 100, 299 },
+    { 97, 61, 13, 7 }
+};
+
+/**
+ * @brief Lanczos-3 kernel.
+ */
+static double lanczos(double x)
+{
+    if (x == 0.0)
+    {
+        return 1.0;
+    }
+    if (SDL_fabs(x) >= LANCZOS_LOBES)
+    {
+        return 0.0;
+    }
+    double a = SDL_PI_D * x;
+    double b = a / LANCZOS_LOBES;
+    return SDL_sin(a) / a * SDL_sin(b) / b;
+}
+
+/**
+ * @brief Normalized weights of the source samples of one destination sample.
+ *
+ * Samples are aligned on their centers and the edges are clamped, as in SDL.
+ * Shrinking, area weighs each source sample by how much of it the destination
+ * sample covers, and Lanczos stretches its kernel by the ratio. Growing, area
+ * interpolates linearly.
+ *
+ * @param useLanczos `true` for the Lanczos filter, `false` for area.
+ * @param srcLength Number of source samples on the axis.
+ * @param dstLength Number of destination samples on the axis.
+ * @param i Index of the destination sample.
+ * @param first Receives the index of the first source sample, possibly outside of the axis.
+ * @param weights Receives the weights, enough room for the whole support.
+ * @return Number of weights.
+ */
+static int axisWeights(bool useLanczos, int srcLength, int dstLength, int i, int* first, double* weights)
+{
+    double ratio = (double) srcLength / dstLength;
+    double stretch = ratio > 1.0 ? ratio : 1.0;
+    double center = (i + 0.5) * ratio - 0.5;
+    double support = useLanczos ? LANCZOS_LOBES * stretch : (ratio >= 1.0 ? ratio / 2.0 : 1.0);
+    int lo = (int) SDL_floor(center - support);
+    int hi = (int) SDL_ceil(center + support);
+    double total = 0.0;
+
+    for (int k = lo; k <= hi; ++k)
+    {
+        double weight;
+        if (useLanczos)
+        {
+            weight = lanczos((k - center) / stretch);
+        }
+        else if (ratio >= 1.0)
+        {
+            weight = SDL_max(SDL_min((i + 1) * ratio, k + 1.0) - SDL_max(i * ratio, (double) k), 0.0);
+        }
+        else
+        {
+            weight = SDL_max(1.0 - SDL_fabs(k - center), 0.0);
+        }
+        weights[k - lo] = weight;
+        total += weight;
+    }
+    for (int k = lo; k <= hi; ++k)
+    {
+        weights[k - lo] /= total;
+    }
+
+    *first = lo;
+    return hi - lo + 1;
+}
+
+/**
+ * @brief Resamples an image in double precision, vertically then horizontally.
+ *
+ * @param useLanczos `true` for the Lanczos filter, `false` for area.
+ * @param src Source image.
+ * @param out Receives `dst->w * dst->h * CHANNELS` samples, unclamped.
+ * @param dst Destination image, for its size.
+ * @return `false` if out of memory.
+ */
+static bool resample(bool useLanczos, const SDL_Surface* src, double* out, const SDL_Surface* dst)
+{
+    const int rowLength = src->w * CHANNELS;
+    int support = (int) (2.0 * LANCZOS_LOBES * SDL_max(src->w, src->h)) + 4;
+    double* rows = malloc(sizeof(double) * rowLength * dst->h);
+    double* weights = malloc(sizeof(double) * support);
+    if (rows == NULL || weights == NULL)
+    {
+        free(rows);
+        free(weights);
+        return false;
+    }
+
+    for (int y = 0; y < dst->h; ++y)
+    {
+        int first;
+        int count = axisWeights(useLanczos, src->h, dst->h, y, &first, weights);
+        for (int x = 0; x < rowLength; ++x)
+        {
+            double sum = 0.0;
+            for (int k = 0; k < count; ++k)
+            {
+                int row = SDL_clamp(first + k, 0, src->h - 1);
+                sum += weights[k] * ((const Uint8*) src->pixels)[row * src->pitch + x];
+            }
+            rows[y * rowLength + x] = sum;
+        }
+    }
+
+    for (int x = 0; x < dst->w; ++x)
+    {
+        int first;
+        int count = axisWeights(useLanczos, src->w, dst->w, x, &first, weights);
+        for (int y = 0; y < dst->h; ++y)
+        for (int c = 0; c < CHANNELS; ++c)
+        {
+            double sum = 0.0;
+            for (int k = 0; k < count; ++k)
+            {
+                int column = SDL_clamp(first + k, 0, src->w - 1);
+                sum += weights[k] * rows[y * rowLength + column * CHANNELS + c];
+            }
+            out[(y * dst->w + x) * CHANNELS + c] = sum;
+        }
+    }
+
+    free(rows);
+    free(weights);
+    return true;
+}
+
+/**
+ * @brief Fills an image with a zone plate or a noisy photo-like pattern.
+ *
+ * The zone plate sweeps every frequency, so it shows aliasing; the photo-like
+ * image mixes smooth gradients, fine stripes, noise and a random alpha.
+ */
+static void fillPattern(SDL_Surface* image, bool zonePlate)
+{
+    for (int y = 0; y < image->h; ++y)
+    {
+        Uint8* row = (Uint8*) image->pixels + y * image->pitch;
+        for (int x = 0; x < image->w; ++x)
+        {
+            Uint8* pixel = row + x * CHANNELS;
+            if (zonePlate)
+            {
+                double dx = x - image->w / 2.0;
+                double dy = y - image->h / 2.0;
+                double value = 0.5 + 0.5 * SDL_cos(SDL_PI_D * (dx * dx + dy * dy) / image->w);
+                pixel[0] = pixel[1] = pixel[2] = (Uint8) (value * 255.0 + 0.5);
+                pixel[3] = 255;
+            }
+            else
+            {
+                double value = 128.0 + 60.0 * SDL_sin(x * 0.03) * SDL_cos(y * 0.02);
+                if (((x / 3) & 1) && (y % 97) < 40)
+                {
+                    value += 50.0;
+                }
+                value += SDL_rand(21) - 10;
+                pixel[0] = (Uint8) SDL_clamp(value, 0.0, 255.0);
+                pixel[1] = (Uint8) (x * 255 / image->w);
+                pixel[2] = (Uint8) (y * 255 / image->h);
+                pixel[3] = (Uint8) SDL_rand(256);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Compares a scaled image with the reference.
+ *
+ * @param image Image scaled by SDL.
+ * @param reference Reference samples, clamped to the byte range here.
+ * @param maxError Receives the largest difference on any sample.
+ * @return The PSNR in dB, or a large value if both are identical.
+ */
+static double psnr(const SDL_Surface* image, const double* reference, double* maxError)
+{
+    double squares = 0.0;
+    *maxError = 0.0;
+
+    for (int y = 0; y < image->h; ++y)
+    for (int x = 0; x < image->w * CHANNELS; ++x)
+    {
+        double expected = SDL_clamp(reference[y * image->w * CHANNELS + x], 0.0, 255.0);
+        double error = ((const Uint8*) image->pixels)[y * image->pitch + x] - expected;
+        squares += error * error;
+        *maxError = SDL_max(*maxError, SDL_fabs(error));
+    }
+
+    double mean = squares / ((double) image->w * image->h * CHANNELS);
+    return mean > 0.0 ? 10.0 * SDL_log10(255.0 * 255.0 / mean) : 1000.0;
+}
+
+/**
+ * @brief Scales both patterns at every size with every filter.
+ *
+ * Each case is reported for the comparison across SIMD levels, and checked
+ * against the reference in every run.
+ *
+ * @return `false` if a case was out of tolerance or could not run.
+ */
+static bool scaleCases(void)
+{
+    bool passed = true;
+
+    SDL_srand(1);
+
+    for (size_t s = 0; s < SDL_arraysize(sizes); ++s)
+    for (int zonePlate = 0; zonePlate < 2; ++zonePlate)
+    {
+        SDL_Surface* src = SDL_CreateSurface(sizes[s].srcWidth, sizes[s].srcHeight, SDL_PIXELFORMAT_ARGB8888);
+        SDL_Surface* dst = SDL_CreateSurface(sizes[s].dstWidth, sizes[s].dstHeight, SDL_PIXELFORMAT_ARGB8888);
+        double* reference = malloc(sizeof(double) * sizes[s].dstWidth * sizes[s].dstHeight * CHANNELS);
+        if (src == NULL || dst == NULL || reference == NULL)
+        {
+            passed = false;
+            goto NEXT;
+        }
+        fillPattern(src, zonePlate);
+        SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_NONE);
+
+        for (size_t f = 0; f < SDL_arraysize(filters); ++f)
+        {
+            SDL_SetHint(SDL_HINT_SURFACE_DOWNSCALE_FILTER, filters[f].hint);
+            if (!resample(filters[f].lanczos, src, reference, dst) ||
+                !SDL_BlitSurfaceScaled(src, NULL, dst, NULL, SDL_SCALEMODE_LINEAR))
+            {
+                SDL_Log("%s", SDL_GetError());
+                passed = false;
+                continue;
+            }
+
+            char name[128];
+            SDL_snprintf(name, sizeof(name), "%dx%d->%dx%d/%s/%s", src->w, src->h, dst->w, dst->h,
+                         zonePlate ? "zone" : "photo", filters[f].hint);
+            cSimdCheck_Report(name, dst->pixels, (size_t) dst->pitch * dst->h);
+
+            double maxError;
+            double quality = psnr(dst, reference, &maxError);
+            if (quality < MIN_PSNR || maxError > MAX_ERROR)
+            {
+                SDL_Log("%s: %.2f dB, max error %g", name, quality, maxError);
+                passed = false;
+            }
+        }
+
+        NEXT:
+        SDL_DestroySurface(src);
+        SDL_DestroySurface(dst);
+        free(reference);
+    }
+
+    return passed;
+}
+
+int main(int argc, char* argv[])
+{
+    return cSimdCheck_Main(argc, argv, scaleCases);
+}
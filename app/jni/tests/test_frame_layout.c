@@ -0,0 +1,257 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Checks how cFrame_WritePlanes classifies synthetic YUV_420_888 plane
+ * layouts, and that it copies every sample of them.
+ *
+ * Every plane buffer is allocated to end on its last sample, as CameraX
+ * delivers them, so that a copy reaching past a plane reads out of its buffer
+ * (and shows up under AddressSanitizer or Valgrind). Semi-planar chroma lives
+ * in one buffer the U and V planes both point into, which is what lets the
+ * interleaved plane be copied in one piece, one byte past the end of the
+ * plane that comes first.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "frame.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Chroma arrangements of the synthetic frames
+typedef enum
+{
+    CHROMA_UV,        // Interleaved in one buffer, U first
+    CHROMA_VU,        // Interleaved in one buffer, V first
+    CHROMA_PLANAR,    // Pixel stride 1, separate buffers
+    CHROMA_SEPARATE   // Pixel stride 2, separate buffers that do not overlap
+} cChroma;
+
+// Layouts checked, with the format the frame must end up in
+static const struct
+{
+    const char* name;
+    cChroma chroma;
+    int width, height;
+    int yPadding;       // Bytes past the end of every luma row
+    int uvPadding;      // Bytes past the end of every chroma row
+    SDL_PixelFormat expected;
+    bool repacked;      // Copied into tightly packed NV12 rather than kept as delivered
+} layouts[] = {
+    { "NV12", CHROMA_UV, 64, 48, 0, 0, SDL_PIXELFORMAT_NV12, false },
+    { "NV21", CHROMA_VU, 64, 48, 0, 0, SDL_PIXELFORMAT_NV21, false },
+    { "I420", CHROMA_PLANAR, 64, 48, 0, 0, SDL_PIXELFORMAT_IYUV, false },
+    { "NV12, odd size", CHROMA_UV, 37, 23, 0, 0, SDL_PIXELFORMAT_NV12, false },
+    { "NV12, padded rows", CHROMA_UV, 37, 23, 27, 11, SDL_PIXELFORMAT_NV12, false },
+    { "NV21, padded rows", CHROMA_VU, 64, 48, 64, 64, SDL_PIXELFORMAT_NV21, false },
+    { "I420, padded rows", CHROMA_PLANAR, 37, 23, 11, 13, SDL_PIXELFORMAT_IYUV, false },
+    { "pixel stride 2, separate buffers", CHROMA_SEPARATE, 64, 48, 0, 0, SDL_PIXELFORMAT_NV12, true },
+    { "pixel stride 2, separate buffers, padded rows", CHROMA_SEPARATE, 37, 23, 9, 6, SDL_PIXELFORMAT_NV12, true }
+};
+
+// Synthetic planes; unused buffers are NULL
+typedef struct planes_s
+{
+    uint8_t* buffers[3];  // Allocations of the luma, first chroma and second chroma planes
+    const uint8_t* y;
+    const uint8_t* u;
+    const uint8_t* v;
+    int yRowStride;
+    int uvRowStride;
+    int uvPixelStride;
+} cPlanes;
+
+/**
+ * @brief Allocates a buffer of random bytes, padding included.
+ */
+static uint8_t* randomBuffer(size_t length)
+{
+    uint8_t* buffer = malloc(length);
+    for (size_t i = 0; buffer != NULL && i < length; ++i)
+    {
+        buffer[i] = (uint8_t) SDL_rand(256);
+    }
+    return buffer;
+}
+
+/**
+ * @brief Builds the planes of a layout, each buffer ending on its last sample.
+ *
+ * @return `false` if out of memory.
+ */
+static bool makePlanes(cPlanes* planes, cChroma chroma, int width, int height, int yPadding, int uvPadding)
+{
+    int chromaWidth = (width + 1) / 2;
+    int chromaHeight = (height + 1) / 2;
+    planes->uvPixelStride = (chroma == CHROMA_PLANAR) ? 1 : 2;
+    planes->yRowStride = width + yPadding;
+    planes->uvRowStride = chromaWidth * planes->uvPixelStride + uvPadding;
+
+    size_t lumaSpan = (size_t) (height - 1) * planes->yRowStride + width;
+    size_t chromaSpan = (size_t) (chromaHeight - 1) * planes->uvRowStride +
+                        (size_t) (chromaWidth - 1) * planes->uvPixelStride + 1;
+
+    planes->buffers[0] = randomBuffer(lumaSpan);
+    planes->y = planes->buffers[0];
+    switch (chroma)
+    {
+        case CHROMA_UV:
+        case CHROMA_VU:
+        {
+            // One buffer, the second plane starting one byte into it
+            planes->buffers[1] = randomBuffer(chromaSpan + 1);
+            planes->u = planes->buffers[1] + (chroma == CHROMA_VU);
+            planes->v = planes->buffers[1] + (chroma == CHROMA_UV);
+            break;
+        }
+        default:
+        {
+            planes->buffers[1] = randomBuffer(chromaSpan);
+            planes->buffers[2] = randomBuffer(chromaSpan);
+            planes->u = planes->buffers[1];
+            planes->v = planes->buffers[2];
+            break;
+        }
+    }
+
+    return planes->buffers[0] != NULL && planes->buffers[1] != NULL &&
+           (chroma == CHROMA_UV || chroma == CHROMA_VU || planes->buffers[2] != NULL);
+}
+
+/**
+ * @brief Reads a chroma sample pair back from a frame, according to its format.
+ */
+static void frameChroma(const cFrame* frame, int x, int y, uint8_t* u, uint8_t* v)
+{
+    const uint8_t* first = frame->data + frame->offsets[1] + (size_t) y * frame->pitches[1];
+    if (frame->format == SDL_PIXELFORMAT_IYUV)
+    {
+        *u = first[x];
+        *v = frame->data[frame->offsets[2] + (size_t) y * frame->pitches[2] + x];
+    }
+    else if (frame->format == SDL_PIXELFORMAT_NV21)
+    {
+        *v = first[x * 2];
+        *u = first[x * 2 + 1];
+    }
+    else
+    {
+        *u = first[x * 2];
+        *v = first[x * 2 + 1];
+    }
+}
+
+/**
+ * @brief Checks the layout and every sample of a frame against its planes.
+ *
+ * @return Number of mismatches found, 0 if the frame is right.
+ */
+static int checkFrame(const cFrame* frame, const cPlanes* planes, int width, int height,
+                      SDL_PixelFormat expected, bool repacked)
+{
+    int errors = 0;
+
+    if (frame->format != expected || frame->width != width || frame->height != height)
+    {
+        SDL_Log("  format %s %dx%d, expected %s %dx%d", SDL_GetPixelFormatName(frame->format),
+                frame->width, frame->height, SDL_GetPixelFormatName(expected), width, height);
+        return 1;
+    }
+
+    // Recognized layouts keep the camera pitches, repacked ones are tight
+    int yPitch = repacked ? width : planes->yRowStride;
+    int uvPitch = repacked ? (width + 1) / 2 * 2 : planes->uvRowStride;
+    if (frame->pitches[0] != yPitch || frame->pitches[1] != uvPitch ||
+        (expected == SDL_PIXELFORMAT_IYUV && frame->pitches[2] != uvPitch))
+    {
+        SDL_Log("  pitches %d/%d/%d, expected %d/%d", frame->pitches[0], frame->pitches[1], frame->pitches[2],
+                yPitch, uvPitch);
+        ++errors;
+    }
+
+    for (int y = 0; y < height; ++y)
+    for (int x = 0; x < width; ++x)
+    {
+        if (frame->data[frame->offsets[0] + (size_t) y * frame->pitches[0] + x] !=
+            planes->y[(size_t) y * planes->yRowStride + x])
+        {
+            ++errors;
+        }
+    }
+
+    for (int y = 0; y < (height + 1) / 2; ++y)
+    for (int x = 0; x < (width + 1) / 2; ++x)
+    {
+        size_t offset = (size_t) y * planes->uvRowStride + (size_t) x * planes->uvPixelStride;
+        uint8_t u, v;
+        frameChroma(frame, x, y, &u, &v);
+        if (u != planes->u[offset] || v != planes->v[offset])
+        {
+            ++errors;
+        }
+    }
+
+    // The interleaved plane is one copy of the shared chroma buffer, both of its ends included
+    if (!repacked && (expected == SDL_PIXELFORMAT_NV12 || expected == SDL_PIXELFORMAT_NV21))
+    {
+        size_t chromaSpan = (size_t) ((height + 1) / 2 - 1) * planes->uvRowStride + (size_t) ((width + 1) / 2 - 1) * 2 + 1;
+        if (memcmp(frame->data + frame->offsets[1], planes->buffers[1], chromaSpan + 1) != 0)
+        {
+            SDL_Log("  the interleaved plane differs from the chroma buffer");
+            ++errors;
+        }
+    }
+
+    return errors;
+}
+
+int main(int argc, char* argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    bool passed = true;
+    cFrame frame;
+    SDL_zero(frame);
+
+    SDL_srand(1);
+
+    // Layouts follow each other in the same frame, as they would across resolution changes
+    for (size_t i = 0; i < SDL_arraysize(layouts); ++i)
+    {
+        cPlanes planes;
+        SDL_zero(planes);
+
+        if (!makePlanes(&planes, layouts[i].chroma, layouts[i].width, layouts[i].height,
+                        layouts[i].yPadding, layouts[i].uvPadding) ||
+            !cFrame_WritePlanes(&frame, planes.y, planes.u, planes.v,
+                                planes.yRowStride, planes.uvRowStride, planes.uvPixelStride,
+                                layouts[i].width, layouts[i].height, 0))
+        {
+            SDL_Log("%s: out of memory", layouts[i].name);
+            passed = false;
+        }
+        else
+        {
+            int errors = checkFrame(&frame, &planes, layouts[i].width, layouts[i].height,
+                                    layouts[i].expected, layouts[i].repacked);
+            SDL_Log("%s %dx%d: %s, %s", layouts[i].name, layouts[i].width, layouts[i].height,
+                    SDL_GetPixelFormatName(frame.format), errors ? "mismatch" : "ok");
+            passed = passed && errors == 0;
+        }
+
+        free(planes.buffers[0]);
+        free(planes.buffers[1]);
+        free(planes.buffers[2]);
+    }
+
+    free(frame.data);
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,254 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Benchmark of the frame ingest: 1080p YUV_420_888 frames with synthetic planes
+ * are handed over the way processYUVPlanes does, straight from the plane
+ * memory, and the way the former byte[] path did, through a fresh array the
+ * planes are concatenated into then copied out of.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "mailbox.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define FRAME_WIDTH 1920
+#define FRAME_HEIGHT 1080
+#define ROW_PADDING 64   // Bytes past the end of every row, as sensors commonly deliver
+#define FRAME_COUNT 120  // Frames ingested per path and layout
+
+// Synthetic planes of a YUV_420_888 frame
+typedef struct planes_s
+{
+    const char* name;
+    uint8_t* buffers[3];   // Memory of the Y, U and V planes; V may point into U's
+    size_t lengths[3];     // Bytes from the start of each plane to the end of its buffer
+    int yRowStride;
+    int uvRowStride;
+    int uvPixelStride;
+} cPlanes;
+
+/**
+ * @brief Fills a buffer with a position dependent pattern.
+ */
+static void fillPattern(uint8_t* buffer, size_t length, int seed)
+{
+    for (size_t i = 0; i < length; ++i)
+    {
+        buffer[i] = (uint8_t) (i * 31 + seed);
+    }
+}
+
+/**
+ * @brief Builds padded semi-planar planes, with V one byte after U in the same buffer.
+ */
+static bool makeSemiPlanar(cPlanes* planes)
+{
+    int stride = FRAME_WIDTH + ROW_PADDING;
+    size_t uvLength = (size_t) stride * (FRAME_HEIGHT / 2);
+
+    planes->name = "semi-planar, padded rows";
+    planes->yRowStride = stride;
+    planes->uvRowStride = stride;
+    planes->uvPixelStride = 2;
+    planes->lengths[0] = (size_t) stride * FRAME_HEIGHT;
+    planes->buffers[0] = malloc(planes->lengths[0]);
+    planes->buffers[1] = malloc(uvLength);
+    planes->buffers[2] = NULL;
+    if (planes->buffers[0] == NULL || planes->buffers[1] == NULL)
+    {
+        return false;
+    }
+    fillPattern(planes->buffers[0], planes->lengths[0], 1);
+    fillPattern(planes->buffers[1], uvLength, 2);
+
+    // Like CameraX, each view stops at the last sample it can reach
+    planes->lengths[1] = uvLength - 1;
+    planes->lengths[2] = uvLength - 1;
+    return true;
+}
+
+/**
+ * @brief Builds tightly packed planar planes, each in its own buffer.
+ */
+static bool makePlanar(cPlanes* planes)
+{
+    size_t uvLength = (size_t) (FRAME_WIDTH / 2) * (FRAME_HEIGHT / 2);
+
+    planes->name = "planar";
+    planes->yRowStride = FRAME_WIDTH;
+    planes->uvRowStride = FRAME_WIDTH / 2;
+    planes->uvPixelStride = 1;
+    planes->lengths[0] = (size_t) FRAME_WIDTH * FRAME_HEIGHT;
+    planes->lengths[1] = uvLength;
+    planes->lengths[2] = uvLength;
+    for (int i = 0; i < 3; ++i)
+    {
+        planes->buffers[i] = malloc(planes->lengths[i]);
+        if (planes->buffers[i] == NULL)
+        {
+            return false;
+        }
+        fillPattern(planes->buffers[i], planes->lengths[i], i);
+    }
+    return true;
+}
+
+/**
+ * @brief Pointer to the first sample of a plane.
+ */
+static const uint8_t* planeStart(const cPlanes* planes, int plane)
+{
+    // The V samples of semi-planar planes start one byte into the U buffer
+    if (plane == 2 && planes->buffers[2] == NULL)
+    {
+        return planes->buffers[1] + 1;
+    }
+    return planes->buffers[plane];
+}
+
+/**
+ * @brief Ingests one frame straight from the plane memory, as processYUVPlanes does.
+ */
+static bool ingestDirect(cMailbox* mailbox, const cPlanes* planes)
+{
+    cFrame* frame = cMailbox_BeginWrite(mailbox);
+    if (!cFrame_WritePlanes(frame, planeStart(planes, 0), planeStart(planes, 1), planeStart(planes, 2),
+                            planes->yRowStride, planes->uvRowStride, planes->uvPixelStride,
+                            FRAME_WIDTH, FRAME_HEIGHT, 0))
+    {
+        return false;
+    }
+    cMailbox_Publish(mailbox);
+    return true;
+}
+
+/**
+ * @brief Ingests one frame through a fresh array, as the byte[] path did.
+ *
+ * Java allocated a zeroed array per frame and concatenated the remaining bytes
+ * of every plane into it; the native side then copied the array into the frame.
+ */
+static bool ingestArray(cMailbox* mailbox, const cPlanes* planes)
+{
+    size_t length = planes->lengths[0] + planes->lengths[1] + planes->lengths[2];
+    uint8_t* array = calloc(length, 1);
+    if (array == NULL)
+    {
+        return false;
+    }
+    size_t offset = 0;
+    for (int plane = 0; plane < 3; ++plane)
+    {
+        memcpy(array + offset, planeStart(planes, plane), planes->lengths[plane]);
+        offset += planes->lengths[plane];
+    }
+
+    cFrame* frame = cMailbox_BeginWrite(mailbox);
+    bool ret = cFrame_Reserve(frame, length);
+    if (ret)
+    {
+        memcpy(frame->data, array, length);
+        frame->width = FRAME_WIDTH;
+        frame->height = FRAME_HEIGHT;
+        cMailbox_Publish(mailbox);
+    }
+    free(array);
+    return ret;
+}
+
+/**
+ * @brief Checks that the newest frame holds the luma of the planes, row by row.
+ */
+static bool checkLuma(cMailbox* mailbox, const cPlanes* planes)
+{
+    cFrame* frame = cMailbox_Acquire(mailbox);
+    if (frame == NULL)
+    {
+        return false;
+    }
+    for (int row = 0; row < FRAME_HEIGHT; ++row)
+    {
+        if (memcmp(frame->data + frame->offsets[0] + (size_t) row * frame->pitches[0],
+                   planes->buffers[0] + (size_t) row * planes->yRowStride, FRAME_WIDTH) != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Ingests the frames through one path and returns the mean time per frame in ns.
+ */
+static Uint64 timePath(cMailbox* mailbox, const cPlanes* planes, bool (*ingest)(cMailbox*, const cPlanes*))
+{
+    Uint64 start = SDL_GetTicksNS();
+    for (int i = 0; i < FRAME_COUNT; ++i)
+    {
+        if (!ingest(mailbox, planes))
+        {
+            return 0;
+        }
+    }
+    return (SDL_GetTicksNS() - start) / FRAME_COUNT;
+}
+
+int main(int argc, char* argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    bool passed = true;
+    cPlanes layouts[2];
+    SDL_zeroa(layouts);
+    cMailbox* mailbox = NULL;
+
+    if (!makeSemiPlanar(&layouts[0]) || !makePlanar(&layouts[1]) || !cMailbox_New(&mailbox))
+    {
+        SDL_Log("Out of memory");
+        passed = false;
+        goto EXIT;
+    }
+
+    for (size_t i = 0; i < SDL_arraysize(layouts); ++i)
+    {
+        const cPlanes* planes = &layouts[i];
+
+        // Warm both paths up so that the frame buffers are allocated
+        if (!ingestArray(mailbox, planes) || !ingestDirect(mailbox, planes) || !checkLuma(mailbox, planes))
+        {
+            SDL_Log("%s: the direct path lost the luma plane", planes->name);
+            passed = false;
+            continue;
+        }
+
+        Uint64 array = timePath(mailbox, planes, ingestArray);
+        Uint64 direct = timePath(mailbox, planes, ingestDirect);
+        if (array == 0 || direct == 0)
+        {
+            passed = false;
+            continue;
+        }
+        SDL_Log("%s %dx%d: byte[] %.3f ms, direct %.3f ms per frame, %.1fx faster",
+                planes->name, FRAME_WIDTH, FRAME_HEIGHT, array / 1e6, direct / 1e6, (double) array / direct);
+    }
+
+    EXIT:
+    cMailbox_Destroy(mailbox);
+    for (size_t i = 0; i < SDL_arraysize(layouts); ++i)
+    {
+        free(layouts[i].buffers[0]);
+        free(layouts[i].buffers[1]);
+        free(layouts[i].buffers[2]);
+    }
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,182 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Stress test of the frame mailbox: a producer and a consumer running at
+ * mismatched rates must never see a torn frame, nor go back in time.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "mailbox.h"
+
+#include <string.h>
+
+#define RECEIVE_COUNT 300 // Frames the consumer checks per run
+#define FAST_DELAY_MS 0    // Pause of the fast side after each frame, just giving the CPU away
+#define SLOW_DELAY_MS 1    // Pause of the slow side after each frame
+
+// Parameters and results of one run
+typedef struct stress_s
+{
+    cMailbox* mailbox;
+    bool slowProducer;      // Pause the producer rather than the consumer
+    SDL_AtomicInt stop;     // Set by the consumer once it checked enough frames
+    SDL_AtomicInt finished; // Set once the producer published its last frame
+    int published;          // Sequence number of the last frame published
+    int received;           // Frames acquired by the consumer
+    int torn;               // Frames whose content does not match their sequence number
+    int reordered;          // Frames older than or equal to the previous one
+} cStress;
+
+/**
+ * @brief Size of the frame with the given sequence number.
+ *
+ * Sizes vary so that slots get reallocated while the consumer runs.
+ *
+ * @param sequence Sequence number of the frame.
+ * @return Number of bytes written into the frame.
+ */
+static size_t frameLength(int sequence)
+{
+    return 256 + (size_t) (sequence % 7) * 1024;
+}
+
+/**
+ * @brief Producer thread: publishes frames filled with their sequence number.
+ *
+ * @param data Pointer to the `cStress`.
+ * @return Always 0.
+ */
+static int SDLCALL produce(void* data)
+{
+    cStress* me = data;
+
+    for (int sequence = 1; !SDL_GetAtomicInt(&me->stop); ++sequence)
+    {
+        cFrame* frame = cMailbox_BeginWrite(me->mailbox);
+        size_t length = frameLength(sequence);
+        if (!cFrame_Reserve(frame, length))
+        {
+            break;
+        }
+        memset(frame->data, sequence & 0xff, length);
+        frame->width = sequence;
+        frame->height = (int) length;
+        cMailbox_Publish(me->mailbox);
+        me->published = sequence;
+
+        SDL_Delay(me->slowProducer ? SLOW_DELAY_MS : FAST_DELAY_MS);
+    }
+
+    SDL_SetAtomicInt(&me->finished, 1);
+    return 0;
+}
+
+/**
+ * @brief Checks one acquired frame against the previous one.
+ *
+ * @param me Pointer to the `cStress`.
+ * @param frame Frame returned by `cMailbox_Acquire`.
+ * @param last Sequence number of the previous frame, updated.
+ */
+static void checkFrame(cStress* me, const cFrame* frame, int* last)
+{
+    int sequence = frame->width;
+
+    if ((size_t) frame->height != frameLength(sequence))
+    {
+        ++me->torn;
+    }
+    else
+    {
+        for (int i = 0; i < frame->height; ++i)
+        {
+            if (frame->data[i] != (sequence & 0xff))
+            {
+                ++me->torn;
+                break;
+            }
+        }
+    }
+
+    if (sequence <= *last)
+    {
+        ++me->reordered;
+    }
+    *last = sequence;
+    ++me->received;
+}
+
+/**
+ * @brief Runs the producer against a consumer on the calling thread.
+ *
+ * @param slowProducer `true` to pause the producer, `false` to pause the consumer.
+ * @return `true` if every frame the consumer saw was intact and in order.
+ */
+static bool runStress(bool slowProducer)
+{
+    cStress stress;
+    SDL_zero(stress);
+    stress.slowProducer = slowProducer;
+
+    if (!cMailbox_New(&stress.mailbox))
+    {
+        return false;
+    }
+
+    SDL_Thread* thread = SDL_CreateThread(produce, "MailboxProducer", &stress);
+    if (thread == NULL)
+    {
+        SDL_Log("%s", SDL_GetError());
+        cMailbox_Destroy(stress.mailbox);
+        return false;
+    }
+
+    int last = 0;
+    for (;;)
+    {
+        // Read the flag first, so a frame published just before it is still acquired
+        bool finished = SDL_GetAtomicInt(&stress.finished) != 0;
+        cFrame* frame = cMailbox_Acquire(stress.mailbox);
+        if (frame != NULL)
+        {
+            checkFrame(&stress, frame, &last);
+            if (stress.received == RECEIVE_COUNT)
+            {
+                SDL_SetAtomicInt(&stress.stop, 1);
+            }
+        }
+        else if (finished)
+        {
+            break;
+        }
+
+        SDL_Delay(slowProducer ? FAST_DELAY_MS : SLOW_DELAY_MS);
+    }
+
+    SDL_WaitThread(thread, NULL);
+    cMailbox_Destroy(stress.mailbox);
+
+    SDL_Log("%s producer: %d of %d frames received, %d torn, %d out of order",
+            slowProducer ? "Slow" : "Fast", stress.received, stress.published, stress.torn, stress.reordered);
+
+    // The newest frame always reaches the consumer
+    return stress.torn == 0 && stress.reordered == 0 && last == stress.published;
+}
+
+int main(int argc, char* argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    bool passed = runStress(false);
+    passed = runStress(true) && passed;
+    SDL_Quit();
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Headless run of the event-driven pacer with the dummy video driver: the
+ * loop of SDL_AppIterate and SDL_AppEvent is reproduced around it while no
+ * frames arrive, then while a producer thread publishes frames, with and
+ * without a frame rate cap. While idle the loop must neither render nor spin,
+ * and take next to no CPU time.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "pacer.h"
+
+#include <time.h>
+
+#define IDLE_MS 1500          // Duration of the idle phases, longer than an idle timeout
+#define FRAMES_MS 1000        // Duration of the phases with frames
+#define FRAME_DELAY_MS 5      // Pause of the producer between two frames
+#define CAPPED_FPS 20.0f      // Frame rate cap of the capped run
+#define MAX_IDLE_CPU 0.05     // Largest share of one CPU the idle loop may take
+
+// Producer thread state
+typedef struct producer_s
+{
+    cPacer* pacer;
+    SDL_AtomicInt stop;
+    int frames;               // Frames notified
+} cProducer;
+
+// What the loop did during one phase
+typedef struct phase_s
+{
+    Uint64 iterations;        // Calls to cPacer_ShouldRender
+    Uint64 presented;         // Frames presented
+    int skipped;              // Frames superseded before being drawn
+    double cpu;               // Share of one CPU used by the process
+} cPhase;
+
+/**
+ * @brief Producer thread: notifies the pacer of a new frame every FRAME_DELAY_MS.
+ *
+ * @param data Pointer to the `cProducer`.
+ * @return Always 0.
+ */
+static int SDLCALL produce(void* data)
+{
+    cProducer* me = data;
+    while (!SDL_GetAtomicInt(&me->stop))
+    {
+        cPacer_NotifyFrame(me->pacer);
+        me->frames++;
+        SDL_Delay(FRAME_DELAY_MS);
+    }
+    return 0;
+}
+
+/**
+ * @brief Runs the application loop around the pacer for some time.
+ *
+ * Events are handed to the pacer as SDL_AppEvent does, and every iteration
+ * the pacer allows stands for a render and present.
+ */
+static void runLoop(cPacer* pacer, Uint64 durationMs, cPhase* phase)
+{
+    Uint64 presented = pacer->presented;
+    int skipped = SDL_GetAtomicInt(&pacer->skipped);
+    clock_t cpuStart = clock();
+    Uint64 start = SDL_GetTicks();
+
+    phase->iterations = 0;
+    while (SDL_GetTicks() - start < durationMs)
+    {
+        SDL_Event event;
+        while (SDL_PollEvent(&event))
+        {
+            cPacer_HandleEvent(pacer, &event);
+        }
+
+        phase->iterations++;
+        if (cPacer_ShouldRender(pacer))
+        {
+            cPacer_Presented(pacer);
+        }
+    }
+
+    phase->cpu = (double) (clock() - cpuStart) / CLOCKS_PER_SEC / ((SDL_GetTicks() - start) / 1000.0);
+    phase->presented = pacer->presented - presented;
+    phase->skipped = SDL_GetAtomicInt(&pacer->skipped) - skipped;
+}
+
+/**
+ * @brief Idles, receives frames, then idles again with one pacer.
+ *
+ * @param maxFps Frame rate cap of the pacer, 0 for none.
+ * @return `true` if the pacer behaved.
+ */
+static bool runPacer(float maxFps)
+{
+    bool passed = false;
+    cPacer* pacer = NULL;
+    cProducer producer;
+    cPhase idle, frames, settle, idleAgain;
+
+    SDL_zero(producer);
+    if (!cPacer_New(&pacer, true, maxFps))
+    {
+        return false;
+    }
+
+    // Let the first frame and the window events be drawn, then nothing should happen
+    runLoop(pacer, 200, &idle);
+    runLoop(pacer, IDLE_MS, &idle);
+
+    producer.pacer = pacer;
+    SDL_Thread* thread = SDL_CreateThread(produce, "producer", &producer);
+    if (thread == NULL)
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+    runLoop(pacer, FRAMES_MS, &frames);
+    SDL_SetAtomicInt(&producer.stop, 1);
+    SDL_WaitThread(thread, NULL);
+
+    // Draw what the producer left pending, then idle again
+    runLoop(pacer, 200, &settle);
+    frames.presented += settle.presented;
+    frames.skipped += settle.skipped;
+    runLoop(pacer, IDLE_MS, &idleAgain);
+
+    // An idle loop sleeps through PACER_IDLE_TIMEOUT_MS at a time
+    Uint64 idleIterations = IDLE_MS / PACER_IDLE_TIMEOUT_MS + 2;
+    SDL_Log("%.0f fps cap: idle %" SDL_PRIu64 " renders in %" SDL_PRIu64 " iterations, %.2f%% CPU; "
+            "%d frames: %" SDL_PRIu64 " renders, %d skipped; idle again %" SDL_PRIu64 " renders, %.2f%% CPU",
+            maxFps, idle.presented, idle.iterations, idle.cpu * 100.0, producer.frames, frames.presented,
+            frames.skipped, idleAgain.presented, idleAgain.cpu * 100.0);
+
+    passed = true;
+    if (idle.presented != 0 || idleAgain.presented != 0 ||
+        idle.iterations > idleIterations || idleAgain.iterations > idleIterations ||
+        idle.cpu > MAX_IDLE_CPU || idleAgain.cpu > MAX_IDLE_CPU)
+    {
+        SDL_Log("The idle loop rendered or kept the CPU busy");
+        passed = false;
+    }
+    if (frames.presented == 0 || frames.presented + (Uint64) frames.skipped != (Uint64) producer.frames)
+    {
+        SDL_Log("Renders and skipped frames do not add up to the frames received");
+        passed = false;
+    }
+    if (maxFps > 0.0f && frames.presented > (Uint64) (maxFps * FRAMES_MS / 1000.0f) + 2)
+    {
+        SDL_Log("The frame rate cap was exceeded");
+        passed = false;
+    }
+
+    EXIT:
+    cPacer_Destroy(pacer);
+    return passed;
+}
+
+int main(int argc, char* argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    bool passed = false;
+    SDL_Window* window = NULL;
+
+    SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "dummy");
+    if (!SDL_Init(SDL_INIT_VIDEO) || (window = SDL_CreateWindow("test_pacer", 320, 240, 0)) == NULL)
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+
+    passed = runPacer(0.0f);
+    passed = runPacer(CAPPED_FPS) && passed;
+
+    EXIT:
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return passed ? 0 : 1;
+}
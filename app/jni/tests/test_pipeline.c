@@ -0,0 +1,264 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Runs a recorded YUV file through the frame-processing pipeline: synthetic
+ * frames of several sizes, some smaller than a downscale block, are recorded
+ * with a cRecorder, replayed as fast as possible into a pipeline made of the
+ * luma histogram and box downscale stages, and every processed frame is
+ * checked against a reference computed from the replayed planes.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "pipeline.h"
+#include "replay.h"
+#include "stages.h"
+
+#include <stdlib.h>
+
+#define RECORDING "test_pipeline.yuv" // Recording written then replayed, in the working directory
+#define DOWNSCALE_FACTOR 4
+#define TIMEOUT_MS 5000               // Longest wait for the pipeline or the replay
+
+// Sizes of the recorded frames, in turn: multiples of the block, odd, and smaller than a block
+static const struct
+{
+    int width, height;
+} sizes[] = {
+    { 64, 48 },
+    { 37, 23 },
+    { 3, 2 },
+    { 2, 7 },
+    { 1, 1 },
+    { 64, 48 }
+};
+
+// What the replayed frames are checked against
+typedef struct check_s
+{
+    cPipeline* pipeline;
+    cImage* image;        // Output of the pipeline
+    cStage* histogram;    // Histogram stage, owned by the pipeline
+    SDL_Semaphore* published; // Signaled for every processed frame
+    int frames;           // Frames checked
+    int errors;           // Frames that differ from the reference
+} cCheck;
+
+/**
+ * @brief Pipeline notification: wakes up the replay thread waiting for its frame.
+ */
+static void SDLCALL onPublished(void* userdata)
+{
+    SDL_SignalSemaphore(((cCheck*) userdata)->published);
+}
+
+/**
+ * @brief Reads a chroma sample pair back from a frame, according to its format.
+ */
+static void frameChroma(const cFrame* frame, int x, int y, uint8_t* u, uint8_t* v)
+{
+    const uint8_t* first = frame->data + frame->offsets[1] + (size_t) y * frame->pitches[1];
+    if (frame->format == SDL_PIXELFORMAT_IYUV)
+    {
+        *u = first[x];
+        *v = frame->data[frame->offsets[2] + (size_t) y * frame->pitches[2] + x];
+    }
+    else if (frame->format == SDL_PIXELFORMAT_NV21)
+    {
+        *v = first[x * 2];
+        *u = first[x * 2 + 1];
+    }
+    else
+    {
+        *u = first[x * 2];
+        *v = first[x * 2 + 1];
+    }
+}
+
+/**
+ * @brief Reference box filter of one plane, blocks clamped to the plane edges.
+ *
+ * @param plane First sample of the plane.
+ * @param rowStride Distance in bytes between two rows.
+ * @param pixelStride Distance in bytes between two samples of a row.
+ * @param width Width of the plane in samples.
+ * @param height Height of the plane in samples.
+ * @param x Column of the output sample.
+ * @param y Row of the output sample.
+ * @return Average of the block.
+ */
+static uint8_t boxAverage(const uint8_t* plane, int rowStride, int pixelStride, int width, int height, int x, int y)
+{
+    const int area = DOWNSCALE_FACTOR * DOWNSCALE_FACTOR;
+    int sum = 0;
+    for (int j = 0; j < DOWNSCALE_FACTOR; ++j)
+    for (int i = 0; i < DOWNSCALE_FACTOR; ++i)
+    {
+        int sx = SDL_min(x * DOWNSCALE_FACTOR + i, width - 1);
+        int sy = SDL_min(y * DOWNSCALE_FACTOR + j, height - 1);
+        sum += plane[(size_t) sy * rowStride + (size_t) sx * pixelStride];
+    }
+    return (uint8_t) ((sum + area / 2) / area);
+}
+
+/**
+ * @brief Replay sink: runs the frame through the pipeline and checks the result.
+ *
+ * Waits for every frame to be processed before taking the next one, so that
+ * the pipeline drops none of them.
+ */
+static bool checkFrame(void* userdata,
+                       const uint8_t* yPlane, const uint8_t* uPlane, const uint8_t* vPlane,
+                       int yRowStride, int uvRowStride, int uvPixelStride,
+                       int width, int height, Uint64 captureTicks)
+{
+    cCheck* me = userdata;
+    if (!cPipeline_WritePlanes(me->pipeline, yPlane, uPlane, vPlane, yRowStride, uvRowStride, uvPixelStride,
+                               width, height, captureTicks) ||
+        !SDL_WaitSemaphoreTimeout(me->published, TIMEOUT_MS))
+    {
+        SDL_Log("Frame %d was not processed", me->frames);
+        return false;
+    }
+
+    const cFrame* frame = cMailbox_Acquire(me->image->mailbox);
+    int outWidth = SDL_max(width / DOWNSCALE_FACTOR, 1);
+    int outHeight = SDL_max(height / DOWNSCALE_FACTOR, 1);
+    int errors = 0;
+    if (frame == NULL || frame->width != outWidth || frame->height != outHeight)
+    {
+        SDL_Log("%dx%d: processed frame missing or of the wrong size", width, height);
+        me->errors++;
+        me->frames++;
+        return true;
+    }
+
+    for (int y = 0; y < outHeight; ++y)
+    for (int x = 0; x < outWidth; ++x)
+    {
+        errors += frame->data[frame->offsets[0] + (size_t) y * frame->pitches[0] + x] !=
+                  boxAverage(yPlane, yRowStride, 1, width, height, x, y);
+    }
+
+    for (int y = 0; y < (outHeight + 1) / 2; ++y)
+    for (int x = 0; x < (outWidth + 1) / 2; ++x)
+    {
+        uint8_t u, v;
+        frameChroma(frame, x, y, &u, &v);
+        errors += u != boxAverage(uPlane, uvRowStride, uvPixelStride, (width + 1) / 2, (height + 1) / 2, x, y);
+        errors += v != boxAverage(vPlane, uvRowStride, uvPixelStride, (width + 1) / 2, (height + 1) / 2, x, y);
+    }
+
+    // The histogram stage runs before the downscale, on the replayed luma
+    Uint32 bins[HISTOGRAM_BINS], expected[HISTOGRAM_BINS];
+    SDL_zeroa(expected);
+    for (int y = 0; y < height; ++y)
+    for (int x = 0; x < width; ++x)
+    {
+        expected[yPlane[(size_t) y * yRowStride + x]]++;
+    }
+    cStage_GetLumaHistogram(me->histogram, bins);
+    bool histogram = SDL_memcmp(bins, expected, sizeof(bins)) == 0;
+
+    SDL_Log("%dx%d -> %dx%d: %d samples differ, histogram %s", width, height, outWidth, outHeight, errors,
+            histogram ? "ok" : "differs");
+    me->errors += errors != 0 || !histogram;
+    me->frames++;
+    return true;
+}
+
+/**
+ * @brief Records one NV12 frame of random samples.
+ *
+ * @param recorder Recording receiving the frame.
+ * @param pixels Room for the frame.
+ * @return `true` if the frame was written.
+ */
+static bool recordFrame(cRecorder* recorder, uint8_t* pixels, int width, int height)
+{
+    int chromaPitch = (width + 1) / 2 * 2;
+    size_t length = (size_t) width * height + (size_t) chromaPitch * ((height + 1) / 2);
+    for (size_t i = 0; i < length; ++i)
+    {
+        pixels[i] = (uint8_t) SDL_rand(256);
+    }
+
+    const uint8_t* uvPlane = pixels + (size_t) width * height;
+    return cRecorder_WritePlanes(recorder, pixels, uvPlane, uvPlane + 1, width, chromaPitch, 2,
+                                 width, height, 0);
+}
+
+int main(int argc, char* argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    bool passed = false;
+    cRecorder* recorder = NULL;
+    cReplay* replay = NULL;
+    cStage* stage = NULL;
+    cCheck check;
+    SDL_zero(check);
+    uint8_t* pixels = malloc(64 * 48 * 2);
+
+    SDL_srand(1);
+
+    // Record the frames, then close the file
+    if (pixels == NULL || !cRecorder_New(&recorder, RECORDING))
+    {
+        goto EXIT;
+    }
+    for (size_t i = 0; i < SDL_arraysize(sizes); ++i)
+    {
+        if (!recordFrame(recorder, pixels, sizes[i].width, sizes[i].height))
+        {
+            goto EXIT;
+        }
+    }
+    cRecorder_Destroy(recorder);
+    recorder = NULL;
+
+    // Histogram then downscale, the histogram working in place on the input
+    if ((check.published = SDL_CreateSemaphore(0)) == NULL ||
+        !cImage_New(&check.image, NULL) ||
+        !cPipeline_New(&check.pipeline, check.image, onPublished, &check) ||
+        !cStage_NewLumaHistogram(&check.histogram) || !cPipeline_AddStage(check.pipeline, check.histogram) ||
+        !cStage_NewDownscale(&stage, DOWNSCALE_FACTOR) || !cPipeline_AddStage(check.pipeline, stage) ||
+        !cPipeline_Start(check.pipeline))
+    {
+        goto EXIT;
+    }
+
+    if (!cReplay_New(&replay, RECORDING, false, false, checkFrame, &check) || !cReplay_Start(replay))
+    {
+        goto EXIT;
+    }
+    Uint64 end = SDL_GetTicks() + TIMEOUT_MS;
+    while (!cReplay_IsFinished(replay) && SDL_GetTicks() < end)
+    {
+        SDL_Delay(10);
+    }
+
+    SDL_Log("%d of %d replayed frames checked, %d wrong", check.frames, (int) SDL_arraysize(sizes), check.errors);
+    passed = check.frames == (int) SDL_arraysize(sizes) && check.errors == 0;
+
+    EXIT:
+    if (!passed && check.frames == 0)
+    {
+        SDL_Log("%s", SDL_GetError());
+    }
+    cReplay_Destroy(replay);
+    cRecorder_Destroy(recorder);
+    cPipeline_Destroy(check.pipeline);
+    cImage_Destroy(check.image);
+    SDL_DestroySemaphore(check.published);
+    SDL_RemovePath(RECORDING);
+    free(pixels);
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,235 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Checks that the direct rotated copies of the software renderer write exactly
+ * the same pixels as its multi-pass path: scale, rotate, then blit. Nearest and
+ * linear scaling, negative and wrapped angles, and clip rectangles are covered,
+ * since those are where the direct copy departs from SDLgfx_rotateSurface.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include <SDL3/SDL.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define TARGET_WIDTH 97
+#define TARGET_HEIGHT 83
+#define IMAGE_WIDTH 37
+#define IMAGE_HEIGHT 30
+
+static const double angles[] = { 0.0, 90.0, 180.0, 270.0, -90.0, -180.0, -270.0, -360.0, -450.0, 450.0 };
+
+static const SDL_FlipMode flips[] = {
+    SDL_FLIP_NONE, SDL_FLIP_HORIZONTAL, SDL_FLIP_VERTICAL, SDL_FLIP_HORIZONTAL | SDL_FLIP_VERTICAL
+};
+
+static const SDL_ScaleMode scaleModes[] = { SDL_SCALEMODE_NEAREST, SDL_SCALEMODE_LINEAR };
+
+// Unscaled, down, up, stretched on one axis, and partly outside of the target
+static const SDL_FRect dstRects[] = {
+    { 20.0f, 10.0f, IMAGE_WIDTH, IMAGE_HEIGHT },
+    { 31.0f, 27.0f, 29.0f, 23.0f },
+    { 5.0f, 3.0f, 70.0f, 61.0f },
+    { 12.0f, 40.0f, 80.0f, 17.0f },
+    { -15.0f, 60.0f, 50.0f, 44.0f }
+};
+
+// No clipping, a clip rectangle cutting most destinations, and one inside some of them
+static const SDL_Rect clipRects[] = {
+    { 0, 0, 0, 0 },
+    { 9, 14, 61, 47 },
+    { 33, 29, 21, 13 }
+};
+
+// Whole image and a crop
+static const SDL_FRect srcRects[] = {
+    { 0.0f, 0.0f, IMAGE_WIDTH, IMAGE_HEIGHT },
+    { 3.0f, 5.0f, 21.0f, 17.0f }
+};
+
+// Pair of textures showing the same image
+typedef struct pair_s
+{
+    const char* name;
+    SDL_Texture* direct;    // Opaque texture, drawn by the direct path
+    SDL_Texture* reference; // ARGB8888 copy with opaque alpha, drawn by the multi-pass path
+} cPair;
+
+/**
+ * @brief Creates the ARGB8888 reference texture of an image.
+ *
+ * A texture with an alpha channel never takes the direct path, while its
+ * opaque pixels come out of the multi-pass path the same as the image's.
+ *
+ * @param renderer Renderer to create the texture on.
+ * @param image Image in any RGB or YUV format.
+ * @return The texture, or NULL on failure.
+ */
+static SDL_Texture* createReference(SDL_Renderer* renderer, SDL_Surface* image)
+{
+    SDL_Surface* argb = SDL_ConvertSurface(image, SDL_PIXELFORMAT_ARGB8888);
+    if (argb == NULL)
+    {
+        return NULL;
+    }
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, argb);
+    SDL_DestroySurface(argb);
+    return texture;
+}
+
+/**
+ * @brief Creates a pair of textures from random pixels.
+ *
+ * @param renderer Renderer to create the textures on.
+ * @param format Format of the direct texture.
+ * @param pair Pair to fill.
+ * @return `true` on success.
+ */
+static bool createPair(SDL_Renderer* renderer, SDL_PixelFormat format, cPair* pair)
+{
+    bool result = false;
+    SDL_Surface* image = SDL_CreateSurface(IMAGE_WIDTH, IMAGE_HEIGHT, format);
+    if (image == NULL)
+    {
+        goto EXIT;
+    }
+
+    // YUV surfaces are one block of planes, a pitch apart for the luma and the chroma rows
+    int rows = SDL_ISPIXELFORMAT_FOURCC(format) ? IMAGE_HEIGHT + (IMAGE_HEIGHT + 1) / 2 : IMAGE_HEIGHT;
+    Uint8* pixels = image->pixels;
+    for (int i = 0; i < image->pitch * rows; ++i)
+    {
+        pixels[i] = (Uint8) SDL_rand(256);
+    }
+
+    pair->name = SDL_GetPixelFormatName(format);
+    pair->direct = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_STATIC, IMAGE_WIDTH, IMAGE_HEIGHT);
+    pair->reference = createReference(renderer, image);
+    if (pair->direct == NULL || pair->reference == NULL ||
+        !SDL_UpdateTexture(pair->direct, NULL, image->pixels, image->pitch) ||
+        !SDL_SetTextureBlendMode(pair->direct, SDL_BLENDMODE_NONE) ||
+        !SDL_SetTextureBlendMode(pair->reference, SDL_BLENDMODE_NONE))
+    {
+        goto EXIT;
+    }
+    result = true;
+
+    EXIT:
+    if (!result)
+    {
+        SDL_Log("Couldn't create the %s textures: %s", SDL_GetPixelFormatName(format), SDL_GetError());
+    }
+    SDL_DestroySurface(image);
+    return result;
+}
+
+/**
+ * @brief Clears the whole target, draws a texture within a clip rectangle and copies the result.
+ *
+ * @param clip Clip rectangle, or an empty one for none.
+ * @return `true` on success.
+ */
+static bool draw(SDL_Renderer* renderer, SDL_Surface* target, SDL_Texture* texture, const SDL_FRect* srcRect,
+                 const SDL_FRect* dstRect, double angle, const SDL_FPoint* center, SDL_FlipMode flip,
+                 const SDL_Rect* clip, Uint8* pixels)
+{
+    SDL_SetRenderDrawColor(renderer, 10, 20, 30, 255);
+    if (!SDL_SetRenderClipRect(renderer, NULL) || !SDL_RenderClear(renderer) ||
+        !SDL_SetRenderClipRect(renderer, SDL_RectEmpty(clip) ? NULL : clip) ||
+        !SDL_RenderTextureRotated(renderer, texture, srcRect, dstRect, angle, center, flip) ||
+        !SDL_FlushRenderer(renderer))
+    {
+        SDL_Log("Draw failed: %s", SDL_GetError());
+        return false;
+    }
+    memcpy(pixels, target->pixels, (size_t) target->pitch * target->h);
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    int mismatches = 0;
+    int cases = 0;
+    cPair pairs[2];
+    SDL_zeroa(pairs);
+    SDL_Renderer* renderer = NULL;
+    Uint8* direct = NULL;
+    Uint8* reference = NULL;
+
+    SDL_srand(1);
+
+    SDL_Surface* target = SDL_CreateSurface(TARGET_WIDTH, TARGET_HEIGHT, SDL_PIXELFORMAT_ARGB8888);
+    if (target == NULL || (renderer = SDL_CreateSoftwareRenderer(target)) == NULL)
+    {
+        SDL_Log("%s", SDL_GetError());
+        mismatches = -1;
+        goto EXIT;
+    }
+    direct = malloc((size_t) target->pitch * target->h);
+    reference = malloc((size_t) target->pitch * target->h);
+    if (direct == NULL || reference == NULL ||
+        !createPair(renderer, SDL_PIXELFORMAT_XRGB8888, &pairs[0]) ||
+        !createPair(renderer, SDL_PIXELFORMAT_NV12, &pairs[1]))
+    {
+        mismatches = -1;
+        goto EXIT;
+    }
+
+    const SDL_FPoint corner = { 3.0f, 4.0f };
+    for (size_t p = 0; p < SDL_arraysize(pairs); ++p)
+    for (size_t m = 0; m < SDL_arraysize(scaleModes); ++m)
+    for (size_t s = 0; s < SDL_arraysize(srcRects); ++s)
+    for (size_t d = 0; d < SDL_arraysize(dstRects); ++d)
+    for (size_t a = 0; a < SDL_arraysize(angles); ++a)
+    for (size_t f = 0; f < SDL_arraysize(flips); ++f)
+    for (size_t k = 0; k < SDL_arraysize(clipRects); ++k)
+    for (int c = 0; c < 2; ++c)
+    {
+        const SDL_FPoint* center = c ? &corner : NULL;
+
+        SDL_SetTextureScaleMode(pairs[p].direct, scaleModes[m]);
+        SDL_SetTextureScaleMode(pairs[p].reference, scaleModes[m]);
+        if (!draw(renderer, target, pairs[p].direct, &srcRects[s], &dstRects[d], angles[a], center, flips[f],
+                  &clipRects[k], direct) ||
+            !draw(renderer, target, pairs[p].reference, &srcRects[s], &dstRects[d], angles[a], center, flips[f],
+                  &clipRects[k], reference))
+        {
+            mismatches = -1;
+            goto EXIT;
+        }
+
+        ++cases;
+        if (memcmp(direct, reference, (size_t) target->pitch * target->h) != 0)
+        {
+            SDL_Log("%s, scale mode %d, source %u, destination %u, %g degrees, flip %d, clip %u, center %d: mismatch",
+                    pairs[p].name, (int) scaleModes[m], (unsigned) s, (unsigned) d, angles[a], (int) flips[f],
+                    (unsigned) k, c);
+            ++mismatches;
+        }
+    }
+    SDL_Log("%d of %d rotated copies differ from the multi-pass path", mismatches, cases);
+
+    EXIT:
+    for (size_t p = 0; p < SDL_arraysize(pairs); ++p)
+    {
+        SDL_DestroyTexture(pairs[p].direct);
+        SDL_DestroyTexture(pairs[p].reference);
+    }
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroySurface(target);
+    free(direct);
+    free(reference);
+    SDL_Quit();
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,195 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Checks through the renderer properties that the scratch surface cache of
+ * the software renderer stops allocating once warmed up: every frame draws
+ * the same mix of rotated, scaled, modulated and clipped copies, which all
+ * need intermediate surfaces, serially and in parallel row bands.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include <SDL3/SDL.h>
+
+#define TARGET_WIDTH 320
+#define TARGET_HEIGHT 240
+#define IMAGE_WIDTH 64
+#define IMAGE_HEIGHT 48
+#define WARMUP_FRAMES 2     // Frames the cache is given to fill up
+#define STEADY_FRAMES 120   // Frames that must not allocate, two seconds at 60 fps
+
+// Values of SDL_HINT_RENDER_SOFTWARE_THREADS run in turn
+static const char* const threadCounts[] = { "1", "4" };
+
+// Textures drawn every frame
+typedef struct textures_s
+{
+    SDL_Texture* opaque;     // XRGB8888
+    SDL_Texture* alpha;      // ARGB8888 with a gradient alpha
+    SDL_Texture* yuv;        // NV12
+} cTextures;
+
+/**
+ * @brief Creates a texture filled with random pixels.
+ *
+ * @return The texture, or NULL on failure.
+ */
+static SDL_Texture* createTexture(SDL_Renderer* renderer, SDL_PixelFormat format)
+{
+    SDL_Surface* image = SDL_CreateSurface(IMAGE_WIDTH, IMAGE_HEIGHT, format);
+    if (image == NULL)
+    {
+        return NULL;
+    }
+
+    // YUV surfaces are one block of planes, a pitch apart for the luma and the chroma rows
+    int rows = SDL_ISPIXELFORMAT_FOURCC(format) ? IMAGE_HEIGHT + (IMAGE_HEIGHT + 1) / 2 : IMAGE_HEIGHT;
+    Uint8* pixels = image->pixels;
+    for (int i = 0; i < image->pitch * rows; ++i)
+    {
+        pixels[i] = (Uint8) SDL_rand(256);
+    }
+
+    SDL_Texture* texture = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_STATIC, IMAGE_WIDTH, IMAGE_HEIGHT);
+    if (texture != NULL && !SDL_UpdateTexture(texture, NULL, image->pixels, image->pitch))
+    {
+        SDL_DestroyTexture(texture);
+        texture = NULL;
+    }
+    SDL_DestroySurface(image);
+    return texture;
+}
+
+/**
+ * @brief Draws one frame; the sizes never change, only the positions move.
+ *
+ * @return `true` on success.
+ */
+static bool drawFrame(SDL_Renderer* renderer, const cTextures* textures, int frame)
+{
+    float shift = (float) (frame % 16);
+    const SDL_FRect scaled = { 10.0f + shift, 10.0f, 96.0f, 72.0f };
+    const SDL_FRect rotated = { 150.0f, 20.0f + shift, IMAGE_WIDTH, IMAGE_HEIGHT };
+    const SDL_FRect masked = { 40.0f + shift, 120.0f, 80.0f, 60.0f };
+    const SDL_FRect video = { 200.0f - shift, 130.0f, 72.0f, 96.0f };
+    const SDL_FRect offTarget = { -20.0f, 200.0f - shift, 100.0f, 75.0f };
+    const SDL_Rect clip = { 5, 5, 300, 220 };
+
+    SDL_SetRenderDrawColor(renderer, 10, 20, 30, 255);
+    SDL_SetTextureColorMod(textures->opaque, 255, 255, 255);
+    SDL_SetTextureBlendMode(textures->alpha, SDL_BLENDMODE_BLEND);
+    return SDL_SetRenderClipRect(renderer, NULL) && SDL_RenderClear(renderer) &&
+           SDL_SetRenderClipRect(renderer, &clip) &&
+           // Direct rotated copy of a linear upscale
+           SDL_RenderTextureRotated(renderer, textures->opaque, NULL, &scaled, 90.0, NULL, SDL_FLIP_NONE) &&
+           // Arbitrary angle, blended
+           SDL_RenderTextureRotated(renderer, textures->alpha, NULL, &rotated, 30.0, NULL, SDL_FLIP_HORIZONTAL) &&
+           // Arbitrary angle with alpha and no blending, which goes through the masks
+           SDL_SetTextureBlendMode(textures->alpha, SDL_BLENDMODE_NONE) &&
+           SDL_RenderTextureRotated(renderer, textures->alpha, NULL, &masked, 45.0, NULL, SDL_FLIP_NONE) &&
+           // Rotated camera frame
+           SDL_RenderTextureRotated(renderer, textures->yuv, NULL, &video, 270.0, NULL, SDL_FLIP_VERTICAL) &&
+           // Scaled copy reaching past the target
+           SDL_RenderTexture(renderer, textures->opaque, NULL, &offTarget) &&
+           // Modulated rotation
+           SDL_SetTextureColorMod(textures->opaque, 200, 255, 128) &&
+           SDL_RenderTextureRotated(renderer, textures->opaque, NULL, &rotated, 180.0, NULL, SDL_FLIP_NONE) &&
+           SDL_FlushRenderer(renderer);
+}
+
+/**
+ * @brief Reads the scratch surface counters of a software renderer.
+ */
+static void getCounters(SDL_Renderer* renderer, Sint64* allocations, Sint64* reuses)
+{
+    SDL_PropertiesID props = SDL_GetRendererProperties(renderer);
+    *allocations = SDL_GetNumberProperty(props, SDL_PROP_RENDERER_SOFTWARE_SCRATCH_ALLOCATIONS_NUMBER, -1);
+    *reuses = SDL_GetNumberProperty(props, SDL_PROP_RENDERER_SOFTWARE_SCRATCH_REUSES_NUMBER, -1);
+}
+
+/**
+ * @brief Warms the cache up, then draws the steady frames.
+ *
+ * @param threads Value of SDL_HINT_RENDER_SOFTWARE_THREADS.
+ * @return `true` if the steady frames reused the cache without allocating.
+ */
+static bool runFrames(const char* threads)
+{
+    bool passed = false;
+    SDL_Renderer* renderer = NULL;
+    cTextures textures;
+    SDL_zero(textures);
+
+    SDL_SetHint(SDL_HINT_RENDER_SOFTWARE_THREADS, threads);
+    SDL_Surface* target = SDL_CreateSurface(TARGET_WIDTH, TARGET_HEIGHT, SDL_PIXELFORMAT_XRGB8888);
+    if (target == NULL || (renderer = SDL_CreateSoftwareRenderer(target)) == NULL ||
+        (textures.opaque = createTexture(renderer, SDL_PIXELFORMAT_XRGB8888)) == NULL ||
+        (textures.alpha = createTexture(renderer, SDL_PIXELFORMAT_ARGB8888)) == NULL ||
+        (textures.yuv = createTexture(renderer, SDL_PIXELFORMAT_NV12)) == NULL)
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+
+    int frame = 0;
+    for (; frame < WARMUP_FRAMES; ++frame)
+    {
+        if (!drawFrame(renderer, &textures, frame))
+        {
+            SDL_Log("%s", SDL_GetError());
+            goto EXIT;
+        }
+    }
+
+    Sint64 warmAllocations, warmReuses;
+    getCounters(renderer, &warmAllocations, &warmReuses);
+
+    for (; frame < WARMUP_FRAMES + STEADY_FRAMES; ++frame)
+    {
+        if (!drawFrame(renderer, &textures, frame))
+        {
+            SDL_Log("%s", SDL_GetError());
+            goto EXIT;
+        }
+    }
+
+    Sint64 allocations, reuses;
+    getCounters(renderer, &allocations, &reuses);
+    SDL_Log("%s thread(s): %" SDL_PRIs64 " scratch surfaces allocated while warming up, %" SDL_PRIs64
+            " over %d frames, %.1f reuses per frame", threads, warmAllocations, allocations - warmAllocations,
+            STEADY_FRAMES, (double) (reuses - warmReuses) / STEADY_FRAMES);
+
+    // The counters must be published, used, and stop growing once the cache is warm
+    passed = warmAllocations > 0 && allocations == warmAllocations && reuses - warmReuses >= STEADY_FRAMES;
+
+    EXIT:
+    SDL_DestroyTexture(textures.opaque);
+    SDL_DestroyTexture(textures.alpha);
+    SDL_DestroyTexture(textures.yuv);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroySurface(target);
+    return passed;
+}
+
+int main(int argc, char* argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    bool passed = true;
+
+    SDL_srand(1);
+    for (size_t i = 0; i < SDL_arraysize(threadCounts); ++i)
+    {
+        passed = runFrames(threadCounts[i]) && passed;
+    }
+
+    SDL_Quit();
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Checks that the software renderer draws exactly the same pixels when its
+ * command queue runs in parallel row bands as when it runs serially.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include <SDL3/SDL.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define TARGET_WIDTH 643
+#define TARGET_HEIGHT 481
+#define SPRITE_SIZE 64
+
+// Values of SDL_HINT_RENDER_SOFTWARE_THREADS compared with the serial run
+static const char* const threadCounts[] = { "2", "3", "4", "7", "16" };
+
+/**
+ * @brief Returns a random float in [0, max).
+ */
+static float randomFloat(float max)
+{
+    return SDL_randf() * max;
+}
+
+/**
+ * @brief Creates a sprite with a radial alpha.
+ *
+ * @param renderer Renderer to create the texture on.
+ * @return The texture, or NULL on failure.
+ */
+static SDL_Texture* createSprite(SDL_Renderer* renderer)
+{
+    SDL_Surface* surface = SDL_CreateSurface(SPRITE_SIZE, SPRITE_SIZE, SDL_PIXELFORMAT_ARGB8888);
+    if (surface == NULL)
+    {
+        return NULL;
+    }
+    for (int y = 0; y < SPRITE_SIZE; ++y)
+    {
+        Uint32* row = (Uint32*) ((Uint8*) surface->pixels + y * surface->pitch);
+        for (int x = 0; x < SPRITE_SIZE; ++x)
+        {
+            int dx = x - SPRITE_SIZE / 2;
+            int dy = y - SPRITE_SIZE / 2;
+            int distance = dx * dx + dy * dy;
+            Uint32 alpha = distance > 1024 ? 0 : 255 - distance / 4;
+            row[x] = (alpha << 24) | ((Uint32) (x * 4) << 16) | ((Uint32) (y * 4) << 8) | 128;
+        }
+    }
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_DestroySurface(surface);
+    return texture;
+}
+
+/**
+ * @brief Creates a full-target background texture.
+ *
+ * @param renderer Renderer to create the texture on.
+ * @return The texture, or NULL on failure.
+ */
+static SDL_Texture* createBackground(SDL_Renderer* renderer)
+{
+    SDL_Surface* surface = SDL_CreateSurface(TARGET_WIDTH, TARGET_HEIGHT, SDL_PIXELFORMAT_XRGB8888);
+    if (surface == NULL)
+    {
+        return NULL;
+    }
+    for (int y = 0; y < TARGET_HEIGHT; ++y)
+    {
+        Uint32* row = (Uint32*) ((Uint8*) surface->pixels + y * surface->pitch);
+        for (int x = 0; x < TARGET_WIDTH; ++x)
+        {
+            row[x] = (Uint32) (x ^ y) * 0x010203;
+        }
+    }
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_DestroySurface(surface);
+    return texture;
+}
+
+/**
+ * @brief Draws a frame with every kind of command the renderer queues.
+ *
+ * Band-split commands (clears, fills, points, unscaled copies, geometry) and
+ * serial ones (lines, scaled and rotated copies) are interleaved, so the
+ * bands have to be flushed in queue order.
+ */
+static bool drawScene(SDL_Renderer* renderer, SDL_Texture* sprite, SDL_Texture* background)
+{
+    const float w = TARGET_WIDTH;
+    const float h = TARGET_HEIGHT;
+
+    SDL_srand(1);
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(renderer, 20, 30, 40, 255);
+    SDL_RenderClear(renderer);
+    SDL_RenderTexture(renderer, background, NULL, NULL);
+
+    // Blended sprites, some of them additive and modulated
+    for (int i = 0; i < 400; ++i)
+    {
+        SDL_FRect dst = { (float) (int) randomFloat(w + SPRITE_SIZE) - SPRITE_SIZE,
+                          (float) (int) randomFloat(h + SPRITE_SIZE) - SPRITE_SIZE, SPRITE_SIZE, SPRITE_SIZE };
+        SDL_SetTextureBlendMode(sprite, (i & 7) ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_ADD);
+        SDL_SetTextureColorMod(sprite, (Uint8) (128 + SDL_rand(127)), (Uint8) (128 + SDL_rand(127)), 255);
+        SDL_SetTextureAlphaMod(sprite, (Uint8) (128 + SDL_rand(127)));
+        SDL_RenderTexture(renderer, sprite, NULL, &dst);
+    }
+    SDL_SetTextureBlendMode(sprite, SDL_BLENDMODE_BLEND);
+    SDL_SetTextureColorMod(sprite, 255, 255, 255);
+    SDL_SetTextureAlphaMod(sprite, 255);
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 200, 50, 50, 100);
+    for (int i = 0; i < 50; ++i)
+    {
+        SDL_FRect rect = { randomFloat(w), randomFloat(h), randomFloat(300.0f), randomFloat(300.0f) };
+        SDL_RenderFillRect(renderer, &rect);
+    }
+    SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
+    for (int i = 0; i < 50; ++i)
+    {
+        SDL_RenderLine(renderer, randomFloat(w), randomFloat(h), randomFloat(w), randomFloat(h));
+    }
+    for (int i = 0; i < 20; ++i)
+    {
+        SDL_FRect dst = { randomFloat(w) - 100.0f, randomFloat(h) - 100.0f, 200.0f + randomFloat(100.0f), 150.0f };
+        SDL_RenderTexture(renderer, sprite, NULL, &dst);
+    }
+    for (int i = 0; i < 20; ++i)
+    {
+        SDL_FRect dst = { randomFloat(w), randomFloat(h), SPRITE_SIZE, SPRITE_SIZE };
+        SDL_RenderTextureRotated(renderer, sprite, NULL, &dst, randomFloat(360.0f), NULL, SDL_FLIP_NONE);
+    }
+
+    SDL_Vertex vertices[300];
+    for (int i = 0; i < 300; ++i)
+    {
+        vertices[i].position.x = randomFloat(w);
+        vertices[i].position.y = randomFloat(h);
+        vertices[i].color.r = SDL_randf();
+        vertices[i].color.g = SDL_randf();
+        vertices[i].color.b = SDL_randf();
+        vertices[i].color.a = SDL_randf();
+        vertices[i].tex_coord.x = SDL_randf();
+        vertices[i].tex_coord.y = SDL_randf();
+    }
+    SDL_RenderGeometry(renderer, NULL, vertices, 150, NULL, 0);
+    SDL_RenderGeometry(renderer, sprite, vertices + 150, 150, NULL, 0);
+
+    // Clip rect and viewport, which the bands have to apply like the serial path
+    SDL_Rect clip = { TARGET_WIDTH / 4, TARGET_HEIGHT / 4, TARGET_WIDTH / 2, TARGET_HEIGHT / 2 };
+    SDL_SetRenderClipRect(renderer, &clip);
+    for (int i = 0; i < 200; ++i)
+    {
+        SDL_FRect dst = { randomFloat(w), randomFloat(h), SPRITE_SIZE, SPRITE_SIZE };
+        SDL_RenderTexture(renderer, sprite, NULL, &dst);
+    }
+    SDL_FPoint points[500];
+    for (int i = 0; i < 500; ++i)
+    {
+        points[i].x = randomFloat(w);
+        points[i].y = randomFloat(h);
+    }
+    SDL_RenderPoints(renderer, points, 500);
+    SDL_SetRenderClipRect(renderer, NULL);
+
+    SDL_Rect viewport = { 37, 53, TARGET_WIDTH - 100, TARGET_HEIGHT - 120 };
+    SDL_SetRenderViewport(renderer, &viewport);
+    for (int i = 0; i < 200; ++i)
+    {
+        SDL_FRect dst = { randomFloat(w) - 40.0f, randomFloat(h) - 40.0f, SPRITE_SIZE, SPRITE_SIZE };
+        SDL_RenderTexture(renderer, sprite, NULL, &dst);
+    }
+    SDL_RenderGeometry(renderer, NULL, vertices, 150, NULL, 0);
+    SDL_SetRenderViewport(renderer, NULL);
+
+    if (!SDL_FlushRenderer(renderer))
+    {
+        SDL_Log("Draw failed: %s", SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    bool passed = false;
+    SDL_Renderer* renderer = NULL;
+    SDL_Texture* sprite = NULL;
+    SDL_Texture* background = NULL;
+    Uint8* serial = NULL;
+
+    SDL_Surface* target = SDL_CreateSurface(TARGET_WIDTH, TARGET_HEIGHT, SDL_PIXELFORMAT_ARGB8888);
+    if (target == NULL || (renderer = SDL_CreateSoftwareRenderer(target)) == NULL ||
+        (sprite = createSprite(renderer)) == NULL || (background = createBackground(renderer)) == NULL)
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+    size_t length = (size_t) target->pitch * target->h;
+    serial = malloc(length);
+    if (serial == NULL)
+    {
+        goto EXIT;
+    }
+
+    SDL_SetHint(SDL_HINT_RENDER_SOFTWARE_THREADS, "1");
+    if (!drawScene(renderer, sprite, background))
+    {
+        goto EXIT;
+    }
+    memcpy(serial, target->pixels, length);
+
+    passed = true;
+    SDL_PropertiesID props = SDL_GetRendererProperties(renderer);
+    for (size_t i = 0; i < SDL_arraysize(threadCounts); ++i)
+    {
+        Sint64 tiled = SDL_GetNumberProperty(props, SDL_PROP_RENDERER_SOFTWARE_TILED_COMMANDS_NUMBER, 0);
+
+        SDL_SetHint(SDL_HINT_RENDER_SOFTWARE_THREADS, threadCounts[i]);
+        if (!drawScene(renderer, sprite, background))
+        {
+            passed = false;
+            break;
+        }
+
+        // A run that never split a command would compare the serial path with itself
+        tiled = SDL_GetNumberProperty(props, SDL_PROP_RENDERER_SOFTWARE_TILED_COMMANDS_NUMBER, 0) - tiled;
+        bool same = memcmp(serial, target->pixels, length) == 0;
+        SDL_Log("%s threads: %" SDL_PRIs64 " commands drawn in bands, %s the serial path",
+                threadCounts[i], tiled, same ? "same pixels as" : "different pixels from");
+        if (tiled == 0 || !same)
+        {
+            passed = false;
+        }
+    }
+
+    EXIT:
+    SDL_DestroyTexture(sprite);
+    SDL_DestroyTexture(background);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroySurface(target);
+    free(serial);
+    SDL_Quit();
+    return passed ? 0 : 1;
+}
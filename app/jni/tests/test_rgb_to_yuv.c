@@ -0,0 +1,101 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Checks that the SIMD RGB to YUV encoders of SDL_ConvertPixels write exactly
+ * the same bytes as the scalar loop, padding and row tails included.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "simd_check.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static const SDL_PixelFormat rgbFormats[] = {
+    SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_XRGB8888, SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_RGBA8888,
+    SDL_PIXELFORMAT_BGRA8888, SDL_PIXELFORMAT_BGRX8888, SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_BGR24
+};
+
+static const SDL_PixelFormat yuvFormats[] = {
+    SDL_PIXELFORMAT_IYUV, SDL_PIXELFORMAT_YV12, SDL_PIXELFORMAT_NV12, SDL_PIXELFORMAT_NV21,
+    SDL_PIXELFORMAT_YUY2, SDL_PIXELFORMAT_UYVY, SDL_PIXELFORMAT_YVYU
+};
+
+static const SDL_Colorspace colorspaces[] = {
+    SDL_COLORSPACE_BT601_LIMITED, SDL_COLORSPACE_BT601_FULL, SDL_COLORSPACE_BT709_LIMITED
+};
+
+// Widths around the 8 and 16 pixel steps of the encoders, so every tail length is covered
+static const int widths[] = { 1, 2, 3, 7, 8, 9, 15, 16, 17, 33, 64, 101, 640 };
+static const int heights[] = { 1, 2, 3, 9 };
+
+/**
+ * @brief Converts random RGB images of every size, format and colorspace.
+ *
+ * The source and destination colorspaces match, so the encoders run directly
+ * instead of going through a colorspace conversion first.
+ *
+ * @return Always `true`, as failed conversions are reported as cases.
+ */
+static bool convertCases(void)
+{
+    SDL_srand(1);
+
+    for (size_t s = 0; s < SDL_arraysize(rgbFormats); ++s)
+    for (size_t d = 0; d < SDL_arraysize(yuvFormats); ++d)
+    for (size_t c = 0; c < SDL_arraysize(colorspaces); ++c)
+    for (size_t w = 0; w < SDL_arraysize(widths); ++w)
+    for (size_t h = 0; h < SDL_arraysize(heights); ++h)
+    {
+        int width = widths[w];
+        int height = heights[h];
+        bool packed = SDL_BYTESPERPIXEL(yuvFormats[d]) == 2;
+
+        // Padded pitches, so that encoders reading or writing past a row show up
+        int srcPitch = width * SDL_BYTESPERPIXEL(rgbFormats[s]) + 5;
+        size_t srcLength = (size_t) srcPitch * height;
+        int dstPitch = packed ? (width + 1) / 2 * 4 + 3 : width + 3;
+        size_t dstLength = (size_t) dstPitch * (height + 1) * 2;
+
+        Uint8* src = malloc(srcLength);
+        Uint8* dst = malloc(dstLength);
+        if (src == NULL || dst == NULL)
+        {
+            free(src);
+            free(dst);
+            continue;
+        }
+        for (size_t i = 0; i < srcLength; ++i)
+        {
+            src[i] = (Uint8) SDL_rand(256);
+        }
+        memset(dst, 0xAB, dstLength);
+
+        bool converted = SDL_ConvertPixelsAndColorspace(width, height,
+                                                        rgbFormats[s], colorspaces[c], 0, src, srcPitch,
+                                                        yuvFormats[d], colorspaces[c], 0, dst, dstPitch);
+
+        char name[128];
+        SDL_snprintf(name, sizeof(name), "%s->%s/%u/%dx%d%s",
+                     SDL_GetPixelFormatName(rgbFormats[s]), SDL_GetPixelFormatName(yuvFormats[d]),
+                     (unsigned) c, width, height, converted ? "" : "/failed");
+        cSimdCheck_Report(name, dst, dstLength);
+
+        free(src);
+        free(dst);
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    return cSimdCheck_Main(argc, argv, convertCases);
+}
@@ -0,0 +1,123 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Checks the texture pool of a cImage on the software renderer of the dummy
+ * video driver: frames cycle through sizes and formats, and every upload must
+ * hit or evict exactly as a least-recently-used pool of TEXTURE_POOL_SIZE
+ * entries would.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "image.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_WIDTH 1920
+#define MAX_HEIGHT 1080
+
+// Frames uploaded in turn, with what the pool must do with each of them
+static const struct
+{
+    int width, height;
+    bool packed;     // RGBA32 rather than NV12
+    bool hit;        // Served by a pooled texture
+    bool evicts;     // Destroys the least recently used texture
+} steps[] = {
+    { 320, 240, false, false, false },   // A
+    { 320, 240, false, true, false },    // A again, the same texture
+    { 640, 480, false, false, false },   // B
+    { 1280, 720, false, false, false },  // C
+    { 640, 480, true, false, false },    // D, B's size in another format; the pool is now full
+    { 320, 240, false, true, false },    // A, now the most recently used
+    { 1920, 1080, false, false, true },  // E evicts B
+    { 640, 480, false, false, true },    // B evicts C
+    { 640, 480, true, true, false },     // D
+    { 320, 240, false, true, false },    // A
+    { 1280, 720, false, false, true },   // C evicts E
+    { 1920, 1080, false, false, true },  // E evicts B
+    { 1280, 720, false, true, false }    // C
+};
+
+/**
+ * @brief Writes a frame of the given size and format into the image mailbox.
+ *
+ * @param image Image receiving the frame.
+ * @param pixels Buffer large enough for the largest frame, in either format.
+ * @return `true` if the frame was written.
+ */
+static bool writeFrame(cImage* image, const uint8_t* pixels, int width, int height, bool packed)
+{
+    if (packed)
+    {
+        return cImage_WritePacked(image, pixels, width * 4, SDL_PIXELFORMAT_RGBA32, width, height, 0);
+    }
+
+    const uint8_t* uvPlane = pixels + (size_t) width * height;
+    return cImage_WritePlanes(image, pixels, uvPlane, uvPlane + 1, width, width, 2, width, height, 0);
+}
+
+int main(int argc, char* argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    bool passed = false;
+    SDL_Window* window = NULL;
+    SDL_Renderer* renderer = NULL;
+    cImage* image = NULL;
+    uint8_t* pixels = calloc((size_t) MAX_WIDTH * MAX_HEIGHT, 4);
+
+    SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "dummy");
+    if (pixels == NULL || !SDL_Init(SDL_INIT_VIDEO) ||
+        (window = SDL_CreateWindow("test_texture_pool", 320, 240, 0)) == NULL ||
+        (renderer = SDL_CreateRenderer(window, SDL_SOFTWARE_RENDERER)) == NULL ||
+        !cImage_New(&image, renderer))
+    {
+        SDL_Log("%s", SDL_GetError());
+        goto EXIT;
+    }
+
+    passed = true;
+    cTexturePool* pool = image->texturePool;
+    for (size_t i = 0; i < SDL_arraysize(steps); ++i)
+    {
+        Uint64 hits = pool->hits;
+        Uint64 evictions = pool->evictions;
+        SDL_PixelFormat format = steps[i].packed ? SDL_PIXELFORMAT_RGBA32 : SDL_PIXELFORMAT_NV12;
+
+        if (!writeFrame(image, pixels, steps[i].width, steps[i].height, steps[i].packed) ||
+            !cImage_TextureUpdate(image) || image->texture == NULL)
+        {
+            passed = false;
+            break;
+        }
+
+        float w, h;
+        SDL_GetTextureSize(image->texture, &w, &h);
+        bool hit = pool->hits > hits;
+        bool evicts = pool->evictions > evictions;
+        bool ok = (int) w == steps[i].width && (int) h == steps[i].height &&
+                  image->texture->format == format && hit == steps[i].hit && evicts == steps[i].evicts;
+        SDL_Log("%dx%d %s: %s%s%s", steps[i].width, steps[i].height, SDL_GetPixelFormatName(format),
+                hit ? "hit" : "miss", evicts ? ", eviction" : "", ok ? "" : ", unexpected");
+        passed = passed && ok;
+    }
+    SDL_Log("%" SDL_PRIu64 " hits and %" SDL_PRIu64 " evictions in %d uploads",
+            image->texturePool->hits, image->texturePool->evictions, (int) SDL_arraysize(steps));
+
+    EXIT:
+    cImage_Destroy(image);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    free(pixels);
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,202 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Checks that converting between YUV and RGB in parallel row bands writes
+ * exactly the same bytes as the single-threaded conversion, and times the
+ * conversion of a 1080p frame for each thread count.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include <SDL3/SDL.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCHMARK_RUNS 10 // Conversions timed per thread count, the best one is kept
+
+static const SDL_PixelFormat yuvFormats[] = {
+    SDL_PIXELFORMAT_IYUV, SDL_PIXELFORMAT_YV12, SDL_PIXELFORMAT_NV12, SDL_PIXELFORMAT_NV21,
+    SDL_PIXELFORMAT_YUY2, SDL_PIXELFORMAT_UYVY, SDL_PIXELFORMAT_YVYU
+};
+
+static const SDL_PixelFormat rgbFormats[] = {
+    SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_XBGR8888, SDL_PIXELFORMAT_RGBA32, SDL_PIXELFORMAT_RGB24,
+    SDL_PIXELFORMAT_RGB565
+};
+
+// Values of SDL_HINT_YUV_CONVERSION_THREADS compared with the single-threaded run
+static const char* const threadCounts[] = { "2", "3", "7" };
+
+// Sizes above the banding threshold, with odd widths and heights
+static const struct
+{
+    int width, height;
+} sizes[] = {
+    { 256, 256 },
+    { 321, 243 },
+    { 383, 305 }
+};
+
+/**
+ * @brief Size of a buffer holding an image, with its planes for YUV formats.
+ *
+ * @param format Pixel format of the image.
+ * @param width Width of the image.
+ * @param height Height of the image.
+ * @param pitch Receives the pitch of the first plane.
+ * @return Number of bytes.
+ */
+static size_t imageLength(SDL_PixelFormat format, int width, int height, int* pitch)
+{
+    if (!SDL_ISPIXELFORMAT_FOURCC(format))
+    {
+        *pitch = width * SDL_BYTESPERPIXEL(format);
+        return (size_t) *pitch * height;
+    }
+    if (SDL_BYTESPERPIXEL(format) == 2)
+    {
+        *pitch = (width + 1) / 2 * 4;
+        return (size_t) *pitch * height;
+    }
+    *pitch = width;
+    return (size_t) width * height + (size_t) ((width + 1) / 2) * ((height + 1) / 2) * 2;
+}
+
+/**
+ * @brief Converts an image with the given thread count.
+ */
+static bool convert(const char* threads, int width, int height, SDL_PixelFormat srcFormat, const void* src,
+                    int srcPitch, SDL_PixelFormat dstFormat, void* dst, int dstPitch)
+{
+    SDL_SetHint(SDL_HINT_YUV_CONVERSION_THREADS, threads);
+    if (!SDL_ConvertPixels(width, height, srcFormat, src, srcPitch, dstFormat, dst, dstPitch))
+    {
+        SDL_Log("%s -> %s: %s", SDL_GetPixelFormatName(srcFormat), SDL_GetPixelFormatName(dstFormat), SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Converts random images one way with every thread count.
+ *
+ * @return Number of conversions that differ from the single-threaded one, or -1 on failure.
+ */
+static int compareThreads(int width, int height, SDL_PixelFormat srcFormat, SDL_PixelFormat dstFormat)
+{
+    int mismatches = -1;
+    int srcPitch, dstPitch;
+    size_t srcLength = imageLength(srcFormat, width, height, &srcPitch);
+    size_t dstLength = imageLength(dstFormat, width, height, &dstPitch);
+    Uint8* src = malloc(srcLength);
+    Uint8* serial = malloc(dstLength);
+    Uint8* banded = malloc(dstLength);
+    if (src == NULL || serial == NULL || banded == NULL)
+    {
+        goto EXIT;
+    }
+    for (size_t i = 0; i < srcLength; ++i)
+    {
+        src[i] = (Uint8) SDL_rand(256);
+    }
+
+    memset(serial, 0xAA, dstLength);
+    if (!convert("1", width, height, srcFormat, src, srcPitch, dstFormat, serial, dstPitch))
+    {
+        goto EXIT;
+    }
+
+    mismatches = 0;
+    for (size_t t = 0; t < SDL_arraysize(threadCounts); ++t)
+    {
+        memset(banded, 0xAA, dstLength);
+        if (!convert(threadCounts[t], width, height, srcFormat, src, srcPitch, dstFormat, banded, dstPitch))
+        {
+            mismatches = -1;
+            break;
+        }
+        if (memcmp(serial, banded, dstLength) != 0)
+        {
+            SDL_Log("%s -> %s %dx%d, %s threads: mismatch", SDL_GetPixelFormatName(srcFormat),
+                    SDL_GetPixelFormatName(dstFormat), width, height, threadCounts[t]);
+            ++mismatches;
+        }
+    }
+
+    EXIT:
+    free(src);
+    free(serial);
+    free(banded);
+    return mismatches;
+}
+
+/**
+ * @brief Logs the best time of a 1080p NV12 to RGBA conversion for each thread count.
+ */
+static void benchmark(void)
+{
+    const char* const counts[] = { "1", "2", "4", "8" };
+    const int width = 1920;
+    const int height = 1080;
+    int srcPitch, dstPitch;
+    size_t srcLength = imageLength(SDL_PIXELFORMAT_NV12, width, height, &srcPitch);
+    size_t dstLength = imageLength(SDL_PIXELFORMAT_RGBA32, width, height, &dstPitch);
+    Uint8* src = calloc(srcLength, 1);
+    Uint8* dst = malloc(dstLength);
+
+    for (size_t c = 0; src != NULL && dst != NULL && c < SDL_arraysize(counts); ++c)
+    {
+        Uint64 best = SDL_MAX_UINT64;
+        for (int run = 0; run < BENCHMARK_RUNS; ++run)
+        {
+            Uint64 start = SDL_GetTicksNS();
+            convert(counts[c], width, height, SDL_PIXELFORMAT_NV12, src, srcPitch, SDL_PIXELFORMAT_RGBA32, dst, dstPitch);
+            best = SDL_min(best, SDL_GetTicksNS() - start);
+        }
+        SDL_Log("NV12 -> RGBA32 %dx%d, %s threads: %.2f ms", width, height, counts[c], best / 1e6);
+    }
+
+    free(src);
+    free(dst);
+}
+
+int main(int argc, char* argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    int mismatches = 0;
+    int cases = 0;
+
+    SDL_srand(1);
+
+    for (size_t s = 0; s < SDL_arraysize(sizes) && mismatches >= 0; ++s)
+    for (size_t y = 0; y < SDL_arraysize(yuvFormats) && mismatches >= 0; ++y)
+    for (size_t r = 0; r < SDL_arraysize(rgbFormats) && mismatches >= 0; ++r)
+    for (int toRGB = 0; toRGB < 2; ++toRGB)
+    {
+        SDL_PixelFormat srcFormat = toRGB ? yuvFormats[y] : rgbFormats[r];
+        SDL_PixelFormat dstFormat = toRGB ? rgbFormats[r] : yuvFormats[y];
+        int result = compareThreads(sizes[s].width, sizes[s].height, srcFormat, dstFormat);
+        if (result < 0)
+        {
+            mismatches = -1;
+            break;
+        }
+        mismatches += result;
+        cases += (int) SDL_arraysize(threadCounts);
+    }
+    SDL_Log("%d of %d banded conversions differ from the single-threaded one", SDL_max(mismatches, 0), cases);
+
+    benchmark();
+
+    SDL_Quit();
+    return mismatches == 0 ? 0 : 1;
+}
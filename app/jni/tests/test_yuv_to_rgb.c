@@ -0,0 +1,130 @@
+/*
+ * Program Name: CameraXSDL3
+ * Description:
+ * Checks that the SIMD YUV to RGB kernels of SDL_ConvertPixels write exactly
+ * the same bytes as the scalar loops, padding and row tails included.
+ *
+ * License: This software is provided 'as-is,' without any express or implied warranty.
+ * Permission is granted for use, modification, and distribution under the terms stated
+ * in camera.c.
+ *
+ * Author: Emmanuel Pinot
+ * Email: manu.pinot@gmail.com
+ * Year: 2024
+ */
+
+#include "simd_check.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static const SDL_PixelFormat yuvFormats[] = {
+    SDL_PIXELFORMAT_IYUV, SDL_PIXELFORMAT_YV12, SDL_PIXELFORMAT_NV12, SDL_PIXELFORMAT_NV21,
+    SDL_PIXELFORMAT_YUY2, SDL_PIXELFORMAT_UYVY, SDL_PIXELFORMAT_YVYU
+};
+
+static const SDL_PixelFormat rgbFormats[] = {
+    SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_RGBA32, SDL_PIXELFORMAT_BGRA32,
+    SDL_PIXELFORMAT_ARGB32, SDL_PIXELFORMAT_ABGR32, SDL_PIXELFORMAT_XRGB8888, SDL_PIXELFORMAT_XBGR8888
+};
+
+// The YUV colorspaces SDL converts to sRGB
+static const SDL_Colorspace colorspaces[] = {
+    SDL_COLORSPACE_JPEG, SDL_COLORSPACE_BT709_LIMITED
+};
+
+// Widths around the 16 and 32 pixel steps of the kernels, so every tail length is covered
+static const int widths[] = { 1, 2, 15, 16, 17, 31, 32, 33, 47, 63, 64, 65, 641 };
+static const int heights[] = { 1, 3, 8 };
+
+/**
+ * @brief Fills a YUV image with random samples in the video range.
+ *
+ * The scalar and vector loops of SDL only agree on samples they were written
+ * for: luma or chroma far outside the video range overflows their fixed-point
+ * math differently, so such samples are left out of the comparison.
+ *
+ * @param format YUV format of the image.
+ * @param pixels Pointer to the image, at least `length` bytes.
+ * @param length Number of bytes to fill.
+ * @param lumaLength Number of bytes of the luma plane, for the planar formats.
+ */
+static void fillYUV(SDL_PixelFormat format, Uint8* pixels, size_t length, size_t lumaLength)
+{
+    for (size_t i = 0; i < length; ++i)
+    {
+        bool luma;
+        switch (format)
+        {
+            case SDL_PIXELFORMAT_YUY2:
+            case SDL_PIXELFORMAT_YVYU:
+                luma = (i % 2) == 0;
+                break;
+            case SDL_PIXELFORMAT_UYVY:
+                luma = (i % 2) == 1;
+                break;
+            default:
+                luma = i < lumaLength;
+                break;
+        }
+        pixels[i] = (Uint8) (luma ? 16 + SDL_rand(220) : 88 + SDL_rand(81));
+    }
+}
+
+/**
+ * @brief Converts random YUV images of every size, format and colorspace.
+ *
+ * @return Always `true`, as failed conversions are reported as cases.
+ */
+static bool convertCases(void)
+{
+    SDL_srand(1);
+
+    for (size_t s = 0; s < SDL_arraysize(yuvFormats); ++s)
+    for (size_t d = 0; d < SDL_arraysize(rgbFormats); ++d)
+    for (size_t c = 0; c < SDL_arraysize(colorspaces); ++c)
+    for (size_t w = 0; w < SDL_arraysize(widths); ++w)
+    for (size_t h = 0; h < SDL_arraysize(heights); ++h)
+    {
+        int width = widths[w];
+        int height = heights[h];
+        bool packed = SDL_ISPIXELFORMAT_FOURCC(yuvFormats[s]) && SDL_BYTESPERPIXEL(yuvFormats[s]) == 2;
+
+        // Padded pitches, so that kernels reading or writing past a row show up
+        int srcPitch = packed ? (width + 1) / 2 * 4 + 4 : width + 3;
+        size_t srcLength = (size_t) srcPitch * (height + 1) * 2;
+        int dstPitch = width * SDL_BYTESPERPIXEL(rgbFormats[d]) + 7;
+        size_t dstLength = (size_t) dstPitch * height;
+
+        Uint8* src = malloc(srcLength);
+        Uint8* dst = malloc(dstLength);
+        if (src == NULL || dst == NULL)
+        {
+            free(src);
+            free(dst);
+            continue;
+        }
+        fillYUV(yuvFormats[s], src, srcLength, (size_t) srcPitch * height);
+        memset(dst, 0xAA, dstLength);
+
+        bool converted = SDL_ConvertPixelsAndColorspace(width, height,
+                                                        yuvFormats[s], colorspaces[c], 0, src, srcPitch,
+                                                        rgbFormats[d], SDL_COLORSPACE_SRGB, 0, dst, dstPitch);
+
+        char name[128];
+        SDL_snprintf(name, sizeof(name), "%s->%s/%u/%dx%d%s",
+                     SDL_GetPixelFormatName(yuvFormats[s]), SDL_GetPixelFormatName(rgbFormats[d]),
+                     (unsigned) c, width, height, converted ? "" : "/failed");
+        cSimdCheck_Report(name, dst, dstLength);
+
+        free(src);
+        free(dst);
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    return cSimdCheck_Main(argc, argv, convertCases);
+}
@@ -16,12 +16,18 @@
 
 package com.example.cameraxsdl3;
 
+import android.graphics.PixelFormat;
+import android.hardware.camera2.CaptureRequest;
+import android.os.Build;
 import android.os.Bundle;
+import android.os.PowerManager;
 import android.util.Log;
+import android.util.Range;
 import android.util.Size;
 
 import androidx.annotation.NonNull;
 import androidx.annotation.OptIn;
+import androidx.camera.camera2.interop.Camera2Interop;
 import androidx.camera.camera2.interop.ExperimentalCamera2Interop;
 import androidx.camera.core.CameraSelector;
 import androidx.camera.core.ImageAnalysis;
@@ -51,10 +57,26 @@ public class CameraXsdl3Activity extends SDLActivity implements LifecycleOwner
     private LifecycleRegistry lifecycleRegistry; // Manages the lifecycle states
     private ExecutorService cameraExecutor;      // Executes camera tasks asynchronously
     private ProcessCameraProvider cameraProvider; // Provides camera access and control
+    private PowerManager.OnThermalStatusChangedListener thermalListener; // Forwards thermal changes to native code
 
     // Declare the native method to process YUV image data in C
     public native void processYUVImage(byte[] yuvData, int width, int height);
 
+    // Index of the native compositor stream fed by this activity's camera
+    private static final int CAMERA_STREAM = 0;
+
+    // Declare the native method reading the YUV planes in place from direct buffers
+    public native void processYUVPlanes(int stream, ByteBuffer yBuffer, ByteBuffer uBuffer, ByteBuffer vBuffer,
+                                        int yRowStride, int uvRowStride, int uvPixelStride,
+                                        int width, int height, long timestampNs);
+
+    // Declare the native method reading an RGBA_8888 frame in place from a direct buffer
+    public native void processRGBAImage(int stream, ByteBuffer buffer, int rowStride,
+                                        int width, int height, long timestampNs);
+
+    // Declare the native method receiving the thermal state used to negotiate the camera configuration
+    public native void onThermalStatusChanged(int status);
+
     @Override
     protected void onCreate(Bundle savedInstanceState) {
         super.onCreate(savedInstanceState);
@@ -65,15 +87,29 @@ public class CameraXsdl3Activity extends SDLActivity implements LifecycleOwner
 
         // Initialize a single-threaded executor for handling camera tasks
         cameraExecutor = Executors.newSingleThreadExecutor();
+
+        // Report the thermal state so that native code can lower the camera configuration
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.Q) {
+            PowerManager powerManager = getSystemService(PowerManager.class);
+            thermalListener = this::onThermalStatusChanged;
+            powerManager.addThermalStatusListener(ContextCompat.getMainExecutor(this), thermalListener);
+        }
     }
 
     /**
-     * Starts the CameraX with the specified width and height for image resolution.
+     * (Re)configures the camera; called from native code whenever the negotiated
+     * configuration changes.
      *
-     * @param width  The desired width for the camera feed.
-     * @param height The desired height for the camera feed.
+     * @param width        The desired width for the camera feed.
+     * @param height       The desired height for the camera feed.
+     * @param minFps       The lower bound of the frame rate range.
+     * @param maxFps       The upper bound of the frame rate range.
+     * @param lensFacing   One of the CameraSelector.LENS_FACING_* values.
+     * @param outputFormat One of the ImageAnalysis.OUTPUT_IMAGE_FORMAT_* values.
+     * @param queueDepth   Number of frames the camera may queue, 0 to keep only the latest one.
      */
-    private void startCameraX(int width, int height) {
+    private void configureCamera(int width, int height, int minFps, int maxFps,
+                                 int lensFacing, int outputFormat, int queueDepth) {
         // Get an instance of ProcessCameraProvider for camera control
         ListenableFuture<ProcessCameraProvider> cameraProviderFuture =
             ProcessCameraProvider.getInstance(this);
@@ -83,7 +119,8 @@ public class CameraXsdl3Activity extends SDLActivity implements LifecycleOwner
             try {
                 // Retrieve the camera provider instance
                 cameraProvider = cameraProviderFuture.get();
-                bindImageAnalysis(cameraProvider, width, height); // Bind the ImageAnalysis use case
+                bindImageAnalysis(cameraProvider, width, height, minFps, maxFps,
+                                  lensFacing, outputFormat, queueDepth); // Bind the ImageAnalysis use case
             } catch (Exception e) {
                 Log.e("CameraX", "Error binding camera provider", e);
             }
@@ -91,25 +128,43 @@ public class CameraXsdl3Activity extends SDLActivity implements LifecycleOwner
     }
 
     /**
-     * Binds ImageAnalysis use case to capture and process frames in the specified resolution.
+     * Binds ImageAnalysis use case to capture and process frames with the given configuration.
      *
      * @param cameraProvider The camera provider instance.
      * @param width          The desired width for image analysis.
      * @param height         The desired height for image analysis.
+     * @param minFps         The lower bound of the frame rate range.
+     * @param maxFps         The upper bound of the frame rate range.
+     * @param lensFacing     One of the CameraSelector.LENS_FACING_* values.
+     * @param outputFormat   One of the ImageAnalysis.OUTPUT_IMAGE_FORMAT_* values.
+     * @param queueDepth     Number of frames the camera may queue, 0 to keep only the latest one.
      */
     @OptIn(markerClass = ExperimentalCamera2Interop.class)
-    private void bindImageAnalysis(@NonNull ProcessCameraProvider cameraProvider, int width, int height) {
+    private void bindImageAnalysis(@NonNull ProcessCameraProvider cameraProvider, int width, int height,
+                                   int minFps, int maxFps, int lensFacing, int outputFormat, int queueDepth) {
         // Set up a ResolutionSelector to specify resolution strategy
         ResolutionSelector resolutionSelector = new ResolutionSelector.Builder()
             .setResolutionStrategy(new ResolutionStrategy(new Size(width, height),
                 ResolutionStrategy.FALLBACK_RULE_CLOSEST_LOWER_THEN_HIGHER))
             .build();
 
-        // Configure ImageAnalysis with a resolution selector and backpressure strategy
-        ImageAnalysis imageAnalysis = new ImageAnalysis.Builder()
-            .setBackpressureStrategy(ImageAnalysis.STRATEGY_KEEP_ONLY_LATEST)
+        // Configure ImageAnalysis with a resolution selector, output format and backpressure strategy;
+        // a queue depth of 0 keeps only the latest frame, otherwise the camera waits for the analyzer
+        ImageAnalysis.Builder builder = new ImageAnalysis.Builder()
             .setResolutionSelector(resolutionSelector)
-            .build();
+            .setOutputImageFormat(outputFormat);
+        if (queueDepth > 0) {
+            builder.setBackpressureStrategy(ImageAnalysis.STRATEGY_BLOCK_PRODUCER)
+                   .setImageQueueDepth(queueDepth);
+        } else {
+            builder.setBackpressureStrategy(ImageAnalysis.STRATEGY_KEEP_ONLY_LATEST);
+        }
+
+        // Ask the sensor for the negotiated frame rate range
+        new Camera2Interop.Extender<>(builder)
+            .setCaptureRequestOption(CaptureRequest.CONTROL_AE_TARGET_FPS_RANGE, new Range<>(minFps, maxFps));
+
+        ImageAnalysis imageAnalysis = builder.build();
 
         // Set up an analyzer to process each frame asynchronously
         imageAnalysis.setAnalyzer(cameraExecutor, imageProxy -> {
@@ -117,8 +172,10 @@ public class CameraXsdl3Activity extends SDLActivity implements LifecycleOwner
             imageProxy.close();        // Close imageProxy to free resources
         });
 
-        // Select the front-facing camera for analysis
-        CameraSelector cameraSelector = CameraSelector.DEFAULT_FRONT_CAMERA;
+        // Select the requested camera for analysis
+        CameraSelector cameraSelector = new CameraSelector.Builder()
+            .requireLensFacing(lensFacing)
+            .build();
 
         try {
             // Unbind any existing use cases before rebinding
@@ -141,26 +198,19 @@ public class CameraXsdl3Activity extends SDLActivity implements LifecycleOwner
         // Retrieve the Y, U, and V planes from the image
         ImageProxy.PlaneProxy[] planes = image.getPlanes();
 
-        // Calculate total size needed for YUV data storage
-        int totalSize = 0;
-        for (ImageProxy.PlaneProxy plane : planes) {
-            totalSize += plane.getBuffer().remaining();
-        }
-
-        // Create a byte array to hold the YUV data
-        byte[] data = new byte[totalSize];
-
-        // Copy data from each plane into the byte array
-        int offset = 0;
-        for (ImageProxy.PlaneProxy plane : planes) {
-            ByteBuffer buffer = plane.getBuffer();
-            int remaining = buffer.remaining();
-            buffer.get(data, offset, remaining);
-            offset += remaining;
+        // RGBA_8888 output comes as a single packed plane
+        if (image.getFormat() == PixelFormat.RGBA_8888) {
+            processRGBAImage(CAMERA_STREAM, planes[0].getBuffer(), planes[0].getRowStride(),
+                             image.getWidth(), image.getHeight(), image.getImageInfo().getTimestamp());
+            return;
         }
 
-        // Pass the YUV data and dimensions to the native method for processing
-        processYUVImage(data, image.getWidth(), image.getHeight());
+        // Hand the direct plane buffers, their strides and the capture time stamp to
+        // native code, which reads them in place; no Java-side copy or allocation
+        // happens per frame
+        processYUVPlanes(CAMERA_STREAM, planes[0].getBuffer(), planes[1].getBuffer(), planes[2].getBuffer(),
+                         planes[0].getRowStride(), planes[1].getRowStride(), planes[1].getPixelStride(),
+                         image.getWidth(), image.getHeight(), image.getImageInfo().getTimestamp());
     }
 
     @Override
@@ -192,6 +242,12 @@ public class CameraXsdl3Activity extends SDLActivity implements LifecycleOwner
         super.onDestroy();
         lifecycleRegistry.setCurrentState(Lifecycle.State.DESTROYED); // Set lifecycle to destroyed
 
+        // Stop reporting the thermal state
+        if (thermalListener != null) {
+            getSystemService(PowerManager.class).removeThermalStatusListener(thermalListener);
+            thermalListener = null;
+        }
+
         // Shut down the camera executor to free up resources
         cameraExecutor.shutdown();
     }